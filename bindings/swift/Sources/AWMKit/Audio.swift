@@ -199,7 +199,41 @@ public class AWMAudio {
         guard code == AWM_SUCCESS.rawValue else {
             return nil
         }
+        return Self.convertSnapshot(cSnapshot)
+    }
+
+    /// Progress of one specific operation; idle snapshot when `opId` is unknown.
+    public func progressSnapshot(opId: UInt64) -> AWMProgressSnapshotSwift? {
+        guard let handle = handle else { return nil }
+
+        var cSnapshot = AWMProgressSnapshot()
+        let code = awm_audio_progress_get_op(handle, opId, &cSnapshot)
+        guard code == AWM_SUCCESS.rawValue else {
+            return nil
+        }
+        return Self.convertSnapshot(cSnapshot)
+    }
+
+    /// Operation ids that currently hold a progress slot (ascending).
+    public func progressOperationIds() -> [UInt64] {
+        guard let handle = handle else { return [] }
+
+        var required = 0
+        guard awm_audio_progress_list_ops(handle, nil, 0, &required) == AWM_SUCCESS.rawValue,
+              required > 0 else {
+            return []
+        }
+        var ids = [UInt64](repeating: 0, count: required)
+        let code = ids.withUnsafeMutableBufferPointer { buf in
+            awm_audio_progress_list_ops(handle, buf.baseAddress, buf.count, &required)
+        }
+        guard code == AWM_SUCCESS.rawValue else {
+            return []
+        }
+        return Array(ids.prefix(required))
+    }
 
+    private static func convertSnapshot(_ cSnapshot: AWMProgressSnapshot) -> AWMProgressSnapshotSwift {
         let phaseLabel = withUnsafePointer(to: cSnapshot.phase_label) { ptr in
             ptr.withMemoryRebound(to: CChar.self, capacity: 64) { charPtr in
                 String(cString: charPtr)
@@ -225,6 +259,18 @@ public class AWMAudio {
         awm_audio_progress_clear(handle)
     }
 
+    /// Cancel in-flight operations; they throw `AWMError.cancelled`.
+    public func cancel() {
+        guard let handle = handle else { return }
+        awm_audio_cancel(handle)
+    }
+
+    /// Re-arm the handle after `cancel()` so new operations can run.
+    public func resetCancellation() {
+        guard let handle = handle else { return }
+        awm_audio_cancel_reset(handle)
+    }
+
     /// Check if audiowmark is available
     public var isAvailable: Bool {
         guard let handle = handle else { return false }
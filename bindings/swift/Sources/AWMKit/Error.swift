@@ -17,6 +17,7 @@ public enum AWMError: Error, LocalizedError {
     case admUnsupported(String)
     case admPreserveFailed(String)
     case admPcmFormatUnsupported(String)
+    case cancelled
     case unknown(Int32)
 
     init(code: Int32) {
@@ -49,6 +50,8 @@ public enum AWMError: Error, LocalizedError {
             self = .admPreserveFailed("failed to preserve ADM/BWF metadata while embedding")
         case AWM_ERROR_ADM_PCM_FORMAT_UNSUPPORTED.rawValue:
             self = .admPcmFormatUnsupported("unsupported ADM/BWF PCM format (only 16/24/32-bit PCM)")
+        case AWM_ERROR_CANCELLED.rawValue:
+            self = .cancelled
         default:
             self = .unknown(code)
         }
@@ -84,6 +87,8 @@ public enum AWMError: Error, LocalizedError {
             return "ADM/BWF preserve failed: \(message)"
         case .admPcmFormatUnsupported(let message):
             return "ADM/BWF PCM format unsupported: \(message)"
+        case .cancelled:
+            return "Operation cancelled"
         case .unknown(let code):
             return "Unknown error: \(code)"
         }
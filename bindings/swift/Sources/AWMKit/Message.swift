@@ -257,6 +257,83 @@ public enum AWMMessage {
     }
 }
 
+// MARK: - Batch Operations
+
+extension AWMMessage {
+    /// Encode many watermark messages sharing one key and key slot (current timestamp)
+    ///
+    /// - Parameters:
+    ///   - version: Protocol version
+    ///   - tags: Tags to encode
+    ///   - key: HMAC key
+    ///   - keySlot: Key slot (0-31 for v2, 0 for v1)
+    /// - Returns: One 16-byte message per tag, in order
+    public static func encodeBatch(
+        version: UInt8 = currentVersion,
+        tags: [AWMTag],
+        key: Data,
+        keySlot: UInt8
+    ) throws -> [Data] {
+        let cTags = tags.map { strdup($0.value) }
+        defer { cTags.forEach { free($0) } }
+        let tagPtrs: [UnsafePointer<CChar>?] = cTags.map { UnsafePointer($0) }
+        var output = [UInt8](repeating: 0, count: tags.count * 16)
+
+        let result = tagPtrs.withUnsafeBufferPointer { tagsPtr in
+            key.withUnsafeBytes { keyPtr in
+                awm_message_encode_batch(
+                    version,
+                    tagsPtr.baseAddress,
+                    tags.count,
+                    keyPtr.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                    keyPtr.count,
+                    keySlot,
+                    &output
+                )
+            }
+        }
+
+        if result != AWM_SUCCESS.rawValue {
+            throw AWMError(code: result)
+        }
+
+        return stride(from: 0, to: output.count, by: 16).map { Data(output[$0..<$0 + 16]) }
+    }
+
+    /// Verify the HMAC of many messages against one key
+    ///
+    /// - Parameters:
+    ///   - messages: 16-byte messages (other lengths verify as false)
+    ///   - key: HMAC key
+    /// - Returns: One result per message, in order
+    public static func verifyBatch(
+        _ messages: [Data],
+        key: Data
+    ) -> [Bool] {
+        var packed = [UInt8]()
+        packed.reserveCapacity(messages.count * 16)
+        for message in messages {
+            packed.append(contentsOf: message.count == 16 ? [UInt8](message) : [UInt8](repeating: 0, count: 16))
+        }
+        var valid = [Bool](repeating: false, count: messages.count)
+
+        let result = key.withUnsafeBytes { keyPtr in
+            awm_message_verify_batch(
+                packed,
+                messages.count,
+                keyPtr.baseAddress?.assumingMemoryBound(to: UInt8.self),
+                keyPtr.count,
+                &valid
+            )
+        }
+
+        guard result == AWM_SUCCESS.rawValue else {
+            return [Bool](repeating: false, count: messages.count)
+        }
+        return zip(messages, valid).map { $0.count == 16 && $1 }
+    }
+}
+
 // MARK: - Hex Encoding
 
 extension Data {
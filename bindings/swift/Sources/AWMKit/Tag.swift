@@ -65,6 +65,59 @@ public struct AWMTag: Equatable, Hashable, CustomStringConvertible {
     }
 }
 
+// MARK: - Batch Operations
+
+extension AWMTag {
+    /// Verify many 8-character tags at once
+    ///
+    /// - Parameter tags: Candidate tag strings (other lengths verify as false)
+    /// - Returns: One result per tag, in order
+    public static func verifyBatch(_ tags: [String]) -> [Bool] {
+        let packed = pack(tags)
+        var valid = [Bool](repeating: false, count: tags.count)
+        let result = packed.withUnsafeBufferPointer { ptr in
+            awm_tag_verify_batch(ptr.baseAddress, tags.count, &valid)
+        }
+        guard result == AWM_SUCCESS.rawValue else {
+            return [Bool](repeating: false, count: tags.count)
+        }
+        return zip(tags, valid).map { $0.utf8.count == 8 && $1 }
+    }
+
+    /// Extract identities from many 8-character tags at once
+    ///
+    /// - Parameter tags: Candidate tag strings
+    /// - Returns: One identity per tag, `nil` for invalid tags
+    public static func identityBatch(_ tags: [String]) -> [String?] {
+        let packed = pack(tags)
+        var output = [CChar](repeating: 0, count: tags.count * 8)
+        var valid = [Bool](repeating: false, count: tags.count)
+        let result = packed.withUnsafeBufferPointer { ptr in
+            awm_tag_identity_batch(ptr.baseAddress, tags.count, &output, &valid)
+        }
+        guard result == AWM_SUCCESS.rawValue else {
+            return [String?](repeating: nil, count: tags.count)
+        }
+        return tags.indices.map { index in
+            guard valid[index], tags[index].utf8.count == 8 else { return nil }
+            let slot = Array(output[index * 8..<index * 8 + 8])
+            return String(cString: slot)
+        }
+    }
+
+    /// Pack tags back to back, 8 bytes each (wrong-length tags become an invalid slot)
+    private static func pack(_ tags: [String]) -> [CChar] {
+        var packed = [CChar]()
+        packed.reserveCapacity(tags.count * 8)
+        for tag in tags {
+            let bytes = Array(tag.utf8)
+            let slot = bytes.count == 8 ? bytes : [UInt8](repeating: 0, count: 8)
+            packed.append(contentsOf: slot.map { CChar(bitPattern: $0) })
+        }
+        return packed
+    }
+}
+
 extension AWMTag: LosslessStringConvertible {
     public init?(_ description: String) {
         do {
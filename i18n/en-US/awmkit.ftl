@@ -14,8 +14,10 @@ cli-error-io = File operation failed. Next: verify file path and permissions.
 cli-error-hex = Hex input is invalid. Next: provide an even-length hexadecimal string.
 cli-error-audio = Audio processing failed. Next: verify input format support and rerun with `--verbose`.
 cli-error-json = JSON parse/serialize failed. Next: rerun with `--json` and validate the payload format.
+cli-error-cancelled = Interrupted. Finished files and their evidence were kept; partial outputs and temp files were removed. Next: rerun the same command to process the remaining files.
 
 cli-util-no_input_files = No input files were provided. Next: pass one or more input paths or glob patterns.
+cli-util-watch_not_directory = --watch only watches directories, but { $path } is not one. Next: pass the drop folder instead of files or glob patterns.
 
 cli-init-ok_generated = Key generated for the active slot. Next: run `awmkit key show` to verify key details.
 cli-init-ok_stored = Key stored in key backend ({ $bytes } bytes). Next: run `awmkit embed ...` to start embedding.
@@ -78,6 +80,9 @@ cli-status-db-evidence = Evidence records: { $count }. Next: run `awmkit evidenc
 cli-status-db-evidence-unavailable = Evidence records are unavailable. Next: run `awmkit status --doctor --verbose` and check database access. Reason: { $error }
 
 cli-embed-output_single = `--output` supports exactly one input file. Next: pass one input file or remove `--output`.
+cli-embed-recipients-single-input = `--recipients` embeds exactly one input file. Next: pass a single input file.
+cli-embed-recipients-empty = The recipient list has no entries. Next: add one `TAG OUTPUT` pair per line.
+cli-embed-recipients-invalid-line = Invalid recipient list entry at { $path }:{ $line }. Next: use one `TAG OUTPUT` pair per line.
 cli-embed-done = Embed run finished: { $success } succeeded, { $failed } failed. Next: rerun failed files with `--verbose` if needed.
 cli-embed-failed = Some files failed to embed. Next: rerun with `--verbose` to inspect diagnostics.
 cli-embed-intro-routing-detail = Diagnostic: multichannel embed routing is enabled; default route skips LFE.
@@ -88,9 +93,18 @@ cli-embed-precheck-adm-fallback-detail = Diagnostic: ADM precheck fallback on {
 cli-embed-evidence-store-unavailable-detail = Diagnostic: evidence store unavailable. error={ $error }
 cli-embed-evidence-proof-failed-detail = Diagnostic: failed to build evidence fingerprint ({ $input } -> { $output }). error={ $error }
 cli-embed-evidence-insert-failed-detail = Diagnostic: failed to insert evidence record ({ $input } -> { $output }). error={ $error }
+cli-embed-evidence-batch-failed-detail = Diagnostic: failed to record { $count } evidence rows in one batch. error={ $error }
+cli-embed-evidence-queue-unavailable-detail = Diagnostic: background evidence queue unavailable; recording evidence synchronously. error={ $error }
+cli-embed-evidence-queue-enqueue-failed-detail = Diagnostic: failed to enqueue evidence record ({ $input } -> { $output }); recorded synchronously instead. error={ $error }
+cli-embed-evidence-queue-summary-detail = Diagnostic: background evidence queue: { $recorded } recorded, { $failed } fingerprint failures, { $pending } deferred to the next run.
+cli-buffer-pool-summary-detail = Diagnostic: buffer pool: { $hits } reused, { $misses } allocated, { $retained } MiB retained before release.
 cli-embed-file-ok-snr = Watermark embedded successfully: { $input } -> { $output } (SNR { $snr } dB). Next: run `awmkit detect { $output }` to verify.
 cli-embed-file-ok = Watermark embedded successfully: { $input } -> { $output }. Next: run `awmkit detect { $output }` to verify.
 cli-embed-snr-unavailable-detail = Diagnostic: SNR calculation unavailable for { $input } -> { $output }. reason={ $reason }
+cli-embed-verify-file-failed = Verification failed: { $output } (route step { $step }) does not carry the embedded message. Next: re-embed from the source file or raise `--strength`.
+cli-embed-verify-ok-detail = Diagnostic: in-memory verification passed for { $output } (route step { $step }).
+cli-embed-verify-unavailable-detail = Diagnostic: in-memory verification is not available for { $output } (ADM input); run `awmkit detect` to check it.
+cli-embed-verify-failed = Some outputs failed verification. Next: re-embed the files listed above.
 cli-embed-file-failed = Embedding failed: { $path }. Next: rerun with `--verbose` to inspect the failure reason.
 cli-embed-file-failed-detail = Diagnostic: embed failed on { $path }. error={ $error }
 cli-embed-skipped-count = Files skipped in this run: { $count }. Next: review skipped files before rerunning.
@@ -115,6 +129,8 @@ cli-detect-file-error = Detect failed: { $path }. Next: rerun with `--verbose` t
 cli-detect-file-error-detail = Diagnostic: detect failed on { $path }. error={ $error }
 cli-detect-fallback-detail = Diagnostic fallback route for { $path }: route={ $route }, reason={ $reason }, outcome={ $outcome }
 
+cli-monitor-summary-detail = Monitor finished: { $windows } windows detected, { $dropped } skipped, { $failed } failed, mean latency { $latency } ms.
+
 cli-decode-version = Watermark version: { $version }.
 cli-decode-timestamp_minutes = Watermark timestamp (minutes): { $minutes }.
 cli-decode-timestamp_utc = Watermark timestamp (UTC seconds): { $seconds }.
@@ -152,6 +168,9 @@ cli-evidence-removed = Evidence record removed: { $id }. Next: run `awmkit evide
 cli-evidence-clear-refuse-all = Clear-all was refused. Next: provide at least one filter (`--identity`, `--tag`, or `--key-slot`).
 cli-evidence-cleared = Evidence records cleared: { $removed } (identity={ $identity }, tag={ $tag }, key_slot={ $key_slot }). Next: run `awmkit evidence list` to verify remaining rows.
 cli-evidence-requires-yes = { $action } was not executed. Next: rerun with `--yes` to confirm.
+cli-evidence-migrate-none = All evidence already has fingerprints for config { $config }.
+cli-evidence-migrate-done = Fingerprint migration to config { $config }: { $processed }/{ $total } processed, { $migrated } migrated, { $missing } source missing, { $changed } source changed, { $failed } failed. Rerun to resume; add `--retry-failed` to retry skipped rows.
+cli-evidence-archived = Moved { $archived } evidence rows to the cold archive ({ $segments } segments, { $bytes } bytes); cold archive now holds { $cold } rows. Clone checks still search archived rows.
 
 ui-window-title = AWMKit GUI
 ui-tabs-embed = Embed
@@ -14,8 +14,10 @@ cli-error-io = 文件操作失败。下一步：检查文件路径与权限。
 cli-error-hex = 十六进制输入无效。下一步：提供偶数长度的十六进制字符串。
 cli-error-audio = 音频处理失败。下一步：确认输入格式受支持，并使用 `--verbose` 重试。
 cli-error-json = JSON 处理失败。下一步：使用 `--json` 重试并检查载荷格式。
+cli-error-cancelled = 已中断。已完成的文件及其证据均已保留，未完成的输出与临时文件已清理。下一步：重新运行同一命令以处理剩余文件。
 
 cli-util-no_input_files = 未提供输入文件。下一步：传入一个或多个输入路径或通配符模式。
+cli-util-watch_not_directory = --watch 只能监视目录，{ $path } 不是目录。下一步：改为传入投递目录，而不是文件或通配符模式。
 
 cli-init-ok_generated = 已为当前激活槽位生成密钥。下一步：运行 `awmkit key show` 检查密钥信息。
 cli-init-ok_stored = 密钥已写入后端（{ $bytes } 字节）。下一步：运行 `awmkit embed ...` 开始嵌入。
@@ -78,6 +80,9 @@ cli-status-db-evidence = 证据记录数：{ $count }。下一步：运行 `awmk
 cli-status-db-evidence-unavailable = 证据记录不可用。下一步：运行 `awmkit status --doctor --verbose` 并检查数据库访问。原因：{ $error }
 
 cli-embed-output_single = `--output` 仅支持一个输入文件。下一步：传入单个输入文件，或移除 `--output`。
+cli-embed-recipients-single-input = `--recipients` 仅支持一个输入文件。下一步：传入单个输入文件。
+cli-embed-recipients-empty = 接收方清单为空。下一步：每行写入一个 `TAG OUTPUT`。
+cli-embed-recipients-invalid-line = 接收方清单格式错误：{ $path }:{ $line }。下一步：每行写入一个 `TAG OUTPUT`。
 cli-embed-done = 嵌入任务完成：{ $success } 成功，{ $failed } 失败。下一步：如需排障，请对失败文件使用 `--verbose` 重试。
 cli-embed-failed = 有文件嵌入失败。下一步：使用 `--verbose` 重试查看诊断信息。
 cli-embed-intro-routing-detail = 诊断：已启用多声道嵌入路由，默认路由会跳过 LFE。
@@ -88,9 +93,18 @@ cli-embed-precheck-adm-fallback-detail = 诊断：{ $path } 触发 ADM 预检回
 cli-embed-evidence-store-unavailable-detail = 诊断：证据库不可用。error={ $error }
 cli-embed-evidence-proof-failed-detail = 诊断：证据指纹构建失败（{ $input } -> { $output }）。error={ $error }
 cli-embed-evidence-insert-failed-detail = 诊断：证据记录写入失败（{ $input } -> { $output }）。error={ $error }
+cli-embed-evidence-batch-failed-detail = 诊断：批量写入 { $count } 条证据记录失败。error={ $error }
+cli-embed-evidence-queue-unavailable-detail = 诊断：后台证据队列不可用，改为同步记录证据。error={ $error }
+cli-embed-evidence-queue-enqueue-failed-detail = 诊断：证据记录入队失败（{ $input } -> { $output }），已改为同步记录。error={ $error }
+cli-embed-evidence-queue-summary-detail = 诊断：后台证据队列：已记录 { $recorded } 条，指纹失败 { $failed } 条，{ $pending } 条延后至下次运行。
+cli-buffer-pool-summary-detail = 诊断：缓冲池：复用 { $hits } 次，新分配 { $misses } 次，释放前保留 { $retained } MiB。
 cli-embed-file-ok-snr = 水印嵌入成功：{ $input } -> { $output }（SNR { $snr } dB）。下一步：运行 `awmkit detect { $output }` 验证结果。
 cli-embed-file-ok = 水印嵌入成功：{ $input } -> { $output }。下一步：运行 `awmkit detect { $output }` 验证结果。
 cli-embed-snr-unavailable-detail = 诊断：无法计算 SNR（{ $input } -> { $output }）。reason={ $reason }
+cli-embed-verify-file-failed = 校验失败：{ $output }（路由步骤 { $step }）未检出嵌入的消息。下一步：从源文件重新嵌入或提高 `--strength`。
+cli-embed-verify-ok-detail = 诊断：{ $output } 内存校验通过（路由步骤 { $step }）。
+cli-embed-verify-unavailable-detail = 诊断：{ $output } 不支持内存校验（ADM 输入）；请运行 `awmkit detect` 检查。
+cli-embed-verify-failed = 部分输出未通过校验。下一步：重新嵌入上方列出的文件。
 cli-embed-file-failed = 水印嵌入失败：{ $path }。下一步：使用 `--verbose` 重试查看失败原因。
 cli-embed-file-failed-detail = 诊断：{ $path } 嵌入失败。error={ $error }
 cli-embed-skipped-count = 本次跳过文件数：{ $count }。下一步：重试前请先确认这些文件是否需要处理。
@@ -115,6 +129,8 @@ cli-detect-file-error = 检测失败：{ $path }。下一步：使用 `--verbose
 cli-detect-file-error-detail = 诊断：{ $path } 检测失败。error={ $error }
 cli-detect-fallback-detail = 诊断：{ $path } 回退路径，route={ $route }，reason={ $reason }，outcome={ $outcome }
 
+cli-monitor-summary-detail = 监测结束：已检测 { $windows } 个窗口，跳过 { $dropped } 个，失败 { $failed } 个，平均延迟 { $latency } 毫秒。
+
 cli-decode-version = 水印版本：{ $version }。
 cli-decode-timestamp_minutes = 水印时间戳（分钟）：{ $minutes }。
 cli-decode-timestamp_utc = 水印时间戳（UTC 秒）：{ $seconds }。
@@ -152,6 +168,9 @@ cli-evidence-removed = 已删除证据记录：{ $id }。下一步：运行 `awm
 cli-evidence-clear-refuse-all = 已拒绝清空全部证据。下一步：至少提供一个过滤条件（`--identity`、`--tag` 或 `--key-slot`）。
 cli-evidence-cleared = 已清理证据记录：{ $removed } 条（identity={ $identity }，tag={ $tag }，key_slot={ $key_slot }）。下一步：运行 `awmkit evidence list` 核对剩余记录。
 cli-evidence-requires-yes = 未执行 { $action }。下一步：添加 `--yes` 后重试。
+cli-evidence-migrate-none = 所有证据均已具备指纹配置 { $config } 的指纹。
+cli-evidence-migrate-done = 指纹迁移至配置 { $config }：已处理 { $processed }/{ $total }，迁移 { $migrated }，源文件缺失 { $missing }，源文件已变化 { $changed }，失败 { $failed }。重新运行可续跑；添加 `--retry-failed` 可重试跳过的记录。
+cli-evidence-archived = 已将 { $archived } 条证据移入冷归档（{ $segments } 段，{ $bytes } 字节）；冷归档现有 { $cold } 条记录。clone 检查仍会检索已归档记录。
 
 ui-window-title = AWMKit GUI
 ui-tabs-embed = 水印嵌入
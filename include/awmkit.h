@@ -34,6 +34,7 @@ typedef enum {
     AWM_ERROR_ADM_UNSUPPORTED = -12,
     AWM_ERROR_ADM_PRESERVE_FAILED = -13,
     AWM_ERROR_ADM_PCM_FORMAT_UNSUPPORTED = -14,
+    AWM_ERROR_CANCELLED = -15,
 } AWMError;
 
 /**
@@ -92,6 +93,34 @@ bool awm_tag_verify(const char* tag);
  */
 int32_t awm_tag_identity(const char* tag, char* out);
 
+/**
+ * Verify many tags at once (table lookup, no per-tag allocation).
+ *
+ * @param tags       count * 8 bytes of tags packed back to back (no NUL separators,
+ *                   case-insensitive)
+ * @param count      Number of tags
+ * @param out_valid  Output array of `count` results
+ * @return           AWM_SUCCESS or error code
+ */
+int32_t awm_tag_verify_batch(const char* tags, size_t count, bool* out_valid);
+
+/**
+ * Extract identities from many tags at once.
+ *
+ * @param tags       count * 8 bytes of tags packed back to back (no NUL separators)
+ * @param count      Number of tags
+ * @param out        Output buffer (at least count * 8 bytes); slot i holds the
+ *                   NUL-terminated identity of tag i, or an empty string if invalid
+ * @param out_valid  Output array of `count` results
+ * @return           AWM_SUCCESS or error code
+ */
+int32_t awm_tag_identity_batch(
+    const char* tags,
+    size_t count,
+    char* out,
+    bool* out_valid
+);
+
 // ============================================================================
 // Message Operations
 // ============================================================================
@@ -196,6 +225,49 @@ bool awm_message_verify(
     size_t key_len
 );
 
+/**
+ * Encode many watermark messages at once (current timestamp, shared key slot).
+ *
+ * The HMAC key schedule is computed once and reused; large batches are
+ * spread across threads.
+ *
+ * @param version   Protocol version
+ * @param tags      Array of `count` 8-character tag strings
+ * @param count     Number of tags
+ * @param key       HMAC key bytes
+ * @param key_len   Key length
+ * @param key_slot  Key slot (0-31 for v2, 0 for v1)
+ * @param out       Output buffer (at least count * 16 bytes)
+ * @return          AWM_SUCCESS or error code (no output is written on error)
+ */
+int32_t awm_message_encode_batch(
+    uint8_t version,
+    const char* const* tags,
+    size_t count,
+    const uint8_t* key,
+    size_t key_len,
+    uint8_t key_slot,
+    uint8_t* out
+);
+
+/**
+ * Verify the HMAC of many messages against one key.
+ *
+ * @param data       count * 16 bytes of messages
+ * @param count      Number of messages
+ * @param key        HMAC key bytes
+ * @param key_len    Key length
+ * @param out_valid  Output array of `count` results
+ * @return           AWM_SUCCESS or error code
+ */
+int32_t awm_message_verify_batch(
+    const uint8_t* data,
+    size_t count,
+    const uint8_t* key,
+    size_t key_len,
+    bool* out_valid
+);
+
 // ============================================================================
 // Utility Functions
 // ============================================================================
@@ -216,6 +288,10 @@ size_t awm_message_length(void);
 
 /**
  * Opaque audio handle
+ *
+ * Embed/detect calls may run concurrently on one handle from multiple threads;
+ * each call gets its own op_id and progress slot. Setters (strength, key file,
+ * callback, cancel reset) must not race with in-flight operations.
  */
 typedef struct AWMAudioHandle AWMAudioHandle;
 
@@ -401,11 +477,92 @@ int32_t awm_audio_progress_get(
     AWMProgressSnapshot* result
 );
 
+/**
+ * Get progress snapshot of a specific operation (poll mode).
+ *
+ * Each embed/detect on a shared handle owns its own progress slot, keyed by
+ * AWMProgressSnapshot.op_id. Unknown or evicted ids yield an idle snapshot
+ * (op_id = 0) and AWM_SUCCESS.
+ */
+int32_t awm_audio_progress_get_op(
+    const AWMAudioHandle* handle,
+    uint64_t op_id,
+    AWMProgressSnapshot* result
+);
+
+/**
+ * List operation ids that currently hold a progress slot (ascending).
+ *
+ * Two-step usage:
+ * 1) call with out_ids = NULL and out_len = 0 to get out_required_len
+ * 2) allocate buffer and call again to fetch ids
+ *
+ * @param out_ids           Output buffer for operation ids
+ * @param out_len           Buffer capacity in elements
+ * @param out_required_len  Required element count
+ * @return                  AWM_SUCCESS or error code
+ */
+int32_t awm_audio_progress_list_ops(
+    const AWMAudioHandle* handle,
+    uint64_t* out_ids,
+    size_t out_len,
+    size_t* out_required_len
+);
+
 /**
  * Clear current progress state back to idle.
  */
 void awm_audio_progress_clear(AWMAudioHandle* handle);
 
+/**
+ * Cancel all in-flight operations on this handle.
+ *
+ * Running audiowmark children are killed and temp files removed; the
+ * interrupted calls return AWM_ERROR_CANCELLED. The handle stays cancelled
+ * (new calls fail fast) until awm_audio_cancel_reset is called.
+ * Safe to call from any thread.
+ */
+void awm_audio_cancel(const AWMAudioHandle* handle);
+
+/**
+ * Clear the cancelled state so the handle accepts new operations.
+ *
+ * Must not race with operations running on the same handle.
+ */
+void awm_audio_cancel_reset(AWMAudioHandle* handle);
+
+/**
+ * Process-wide buffer pool counters.
+ */
+typedef struct {
+    uint64_t hits;            // Buffers served from the pool
+    uint64_t misses;          // Buffers freshly allocated
+    uint64_t recycled;        // Buffers returned and kept
+    uint64_t discarded;       // Buffers returned and freed
+    uint64_t retained_bytes;  // Bytes currently held by the pool
+    uint64_t retained_limit;  // Upper bound on retained bytes
+} AWMBufferPoolStats;
+
+/**
+ * Get buffer pool counters.
+ */
+int32_t awm_buffer_pool_stats(AWMBufferPoolStats* result);
+
+/**
+ * Release all memory retained by the buffer pool.
+ *
+ * Call after a batch of files finishes; the pool refills on the next batch.
+ */
+void awm_buffer_pool_clear(void);
+
+/**
+ * Set the buffer pool retention cap in bytes (0 disables reuse).
+ *
+ * Buffers above the new cap are released immediately. The default is
+ * 128 MiB, or AWMKIT_BUFFER_POOL_MB when set.
+ */
+void awm_buffer_pool_set_limit(uint64_t bytes);
+
 /**
  * Embed watermark into audio file
  *
@@ -538,6 +695,65 @@ int32_t awm_evidence_record_embed_file_ex(
     AWMEmbedEvidenceResult* result
 );
 
+/**
+ * Background evidence queue counters.
+ */
+typedef struct {
+    uint64_t pending;   // Records not yet written to the evidence store
+    uint64_t recorded;  // Records written by this process
+    uint64_t failed;    // Records dropped because fingerprinting failed
+} AWMEvidenceQueueStats;
+
+/**
+ * Start the background evidence queue (idempotent).
+ *
+ * Replays records left in the on-disk journal by a previous run that exited
+ * before they were written.
+ */
+int32_t awm_evidence_queue_start(void);
+
+/**
+ * Enqueue evidence for an embedded output file and return immediately.
+ *
+ * The record is appended to a durable journal; fingerprint, SNR and the
+ * database insert happen on a background worker. Starts the queue on first use.
+ *
+ * @param input_path   Original input audio file path
+ * @param output_path  Embedded output audio file path
+ * @param raw_message  16-byte encoded message
+ * @param key          HMAC key bytes (only its key id is persisted)
+ * @param key_len      Key length
+ * @return             AWM_SUCCESS or error code
+ */
+int32_t awm_evidence_enqueue_embed_file(
+    const char* input_path,
+    const char* output_path,
+    const uint8_t* raw_message,
+    const uint8_t* key,
+    size_t key_len
+);
+
+/**
+ * Get background evidence queue counters (all zero when not started).
+ */
+int32_t awm_evidence_queue_stats(AWMEvidenceQueueStats* result);
+
+/**
+ * Wait up to timeout_ms for the queue to drain.
+ *
+ * @return true when no records are pending (or the queue is not started)
+ */
+bool awm_evidence_queue_wait_idle(uint32_t timeout_ms);
+
+/**
+ * Stop the background evidence queue.
+ *
+ * @param drain  true: write all pending records first (blocking);
+ *               false: stop after the current batch, leaving the rest in the
+ *               journal for replay on the next start
+ */
+void awm_evidence_queue_stop(bool drain);
+
 /**
  * Check if audiowmark is available
  *
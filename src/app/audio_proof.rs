@@ -1,8 +1,11 @@
 use crate::app::error::{Failure, Result};
+use crate::app::evidence_store::AudioEvidence;
+#[cfg(feature = "ffmpeg-decode")]
+use crate::cancel::CancellationToken;
 #[cfg(feature = "ffmpeg-decode")]
 use crate::media;
 use crate::multichannel::{AudioBuffer, SampleFormat};
-use rusty_chromaprint::{Configuration, Fingerprinter};
+use rusty_chromaprint::{match_fingerprints, Configuration, Fingerprinter};
 use sha2::{Digest, Sha256};
 use std::path::Path;
 
@@ -15,15 +18,66 @@ pub struct AudioProof {
     pub chromaprint: Vec<u32>,
     pub fp_config_id: u8,
 }
+/// 已解码并算出 PCM 哈希、尚未计算指纹的音频.
+///
+/// 证据写入先用哈希查唯一键，只有确实要写入新行时才调用 [`PcmDigest::into_proof`]
+/// 计算 chromaprint；重复记录同一输出时可省去指纹计算。.
+#[derive(Debug)]
+pub struct PcmDigest {
+    pub sample_rate: u32,
+    pub channels: u32,
+    pub sample_count: u64,
+    pub pcm_sha256: String,
+    /// Internal field.
+    samples: Vec<i32>,
+    /// Internal field.
+    sample_format: SampleFormat,
+}
+
+impl PcmDigest {
+    /// 计算指纹并生成完整证明.
+    ///
+    /// # Errors
+    /// 当音频为空或指纹计算失败时返回错误。.
+    pub fn into_proof(self) -> Result<AudioProof> {
+        let Self {
+            sample_rate,
+            channels,
+            sample_count,
+            pcm_sha256,
+            samples,
+            sample_format,
+        } = self;
+        let (chromaprint, fp_config_id) =
+            fingerprint_interleaved(sample_rate, channels, &samples, sample_format)?;
+        Ok(AudioProof {
+            sample_rate,
+            channels,
+            sample_count,
+            pcm_sha256,
+            chromaprint,
+            fp_config_id,
+        })
+    }
+}
+
 /// # Errors
 /// 当输入无法解码、样本不合法或指纹计算失败时返回错误。.
 pub fn build_proof<P: AsRef<Path>>(path: P) -> Result<AudioProof> {
+    digest_pcm(path)?.into_proof()
+}
+
+/// 解码并计算 PCM 哈希，不计算指纹.
+///
+/// # Errors
+/// 当输入无法解码或样本不合法时返回错误。.
+pub fn digest_pcm<P: AsRef<Path>>(path: P) -> Result<PcmDigest> {
     let path = path.as_ref();
 
     #[cfg(feature = "ffmpeg-decode")]
     {
-        match build_audio_proof_via_ffmpeg(path) {
-            Ok(proof) => return Ok(proof),
+        match digest_pcm_via_ffmpeg(path) {
+            Ok(digest) => return Ok(digest),
             Err(err) => {
                 // Keep legacy parser fallback for native WAV/FLAC in case FFmpeg runtime
                 // is missing, but surface FFmpeg decode errors for other extensions.
@@ -40,39 +94,59 @@ pub fn build_proof<P: AsRef<Path>>(path: P) -> Result<AudioProof> {
         .map_err(|_| Failure::Message("channel count overflow".to_string()))?;
     let sample_format = audio.sample_format();
     let interleaved = audio.interleaved_samples();
-    build_audio_proof_from_interleaved(sample_rate, channels, &interleaved, sample_format)
+    digest_interleaved(sample_rate, channels, interleaved, sample_format)
 }
 
 #[cfg(feature = "ffmpeg-decode")]
 /// Internal helper function.
-fn build_audio_proof_via_ffmpeg(path: &Path) -> Result<AudioProof> {
-    let decoded = media::decode_media_to_pcm_i32(path).map_err(Failure::from)?;
+fn digest_pcm_via_ffmpeg(path: &Path) -> Result<PcmDigest> {
+    let decoded =
+        media::decode_media_to_pcm_i32(path, &CancellationToken::new()).map_err(Failure::from)?;
     let channels = u32::from(decoded.channels);
-    build_audio_proof_from_interleaved(
+    digest_interleaved(
         decoded.sample_rate,
         channels,
-        &decoded.samples,
+        decoded.samples,
         SampleFormat::Int16,
     )
 }
 
 /// Internal helper function.
-fn build_audio_proof_from_interleaved(
+fn digest_interleaved(
     sample_rate: u32,
     channels: u32,
-    interleaved: &[i32],
+    samples: Vec<i32>,
     sample_format: SampleFormat,
-) -> Result<AudioProof> {
+) -> Result<PcmDigest> {
     let channels_usize = usize::try_from(channels)
         .map_err(|_| Failure::Message("channel count overflow".to_string()))?;
-    if channels_usize == 0 || !interleaved.len().is_multiple_of(channels_usize) {
+    if channels_usize == 0 || !samples.len().is_multiple_of(channels_usize) {
         return Err(Failure::Message(
             "interleaved sample length is not channel-aligned".to_string(),
         ));
     }
-    let sample_count = u64::try_from(interleaved.len() / channels_usize)
+    let sample_count = u64::try_from(samples.len() / channels_usize)
         .map_err(|_| Failure::Message("sample count overflow".to_string()))?;
-    let pcm_sha256 = pcm_sha256_for_interleaved(sample_rate, channels, sample_count, interleaved);
+    let pcm_sha256 = pcm_sha256_for_interleaved(sample_rate, channels, sample_count, &samples);
+    Ok(PcmDigest {
+        sample_rate,
+        channels,
+        sample_count,
+        pcm_sha256,
+        samples,
+        sample_format,
+    })
+}
+
+/// Internal helper function.
+fn fingerprint_interleaved(
+    sample_rate: u32,
+    channels: u32,
+    interleaved: &[i32],
+    sample_format: SampleFormat,
+) -> Result<(Vec<u32>, u8)> {
+    let channels_usize = usize::try_from(channels)
+        .map_err(|_| Failure::Message("channel count overflow".to_string()))?;
     let samples_i16 = to_i16_samples(interleaved, sample_format);
     if samples_i16.is_empty() {
         return Err(Failure::Message(
@@ -102,15 +176,7 @@ fn build_audio_proof_from_interleaved(
             "chromaprint fingerprint is empty".to_string(),
         ));
     }
-
-    Ok(AudioProof {
-        sample_rate,
-        channels,
-        sample_count,
-        pcm_sha256,
-        chromaprint,
-        fp_config_id: config.id(),
-    })
+    Ok((chromaprint, config.id()))
 }
 
 /// Internal helper function.
@@ -122,6 +188,43 @@ fn has_wav_or_flac_extension(path: &Path) -> bool {
     matches!(ext.as_deref(), Some("wav" | "flac"))
 }
 
+/// 较长的匹配优先，等长时分数更低者优先；元组为 `(证据 id, 分数, 匹配秒数)`.
+#[must_use]
+pub fn is_better_match(candidate: (i64, f64, f32), best: (i64, f64, f32)) -> bool {
+    let (_, score, duration) = candidate;
+    let (_, best_score, best_duration) = best;
+    duration > best_duration
+        || ((duration - best_duration).abs() < f32::EPSILON && score < best_score)
+}
+
+/// 在候选证据中找出与 `chromaprint` 最佳的匹配段，跳过其他指纹配置的候选.
+///
+/// # Errors
+/// 当指纹比对失败时返回错误。.
+pub fn best_fingerprint_match(
+    chromaprint: &[u32],
+    candidates: &[AudioEvidence],
+    config: &Configuration,
+) -> Result<Option<(i64, f64, f32)>> {
+    let mut best_match: Option<(i64, f64, f32)> = None;
+    for candidate in candidates {
+        if candidate.fp_config_id != config.id() {
+            continue;
+        }
+
+        let segments = match_fingerprints(chromaprint, &candidate.chromaprint, config)
+            .map_err(|e| Failure::Message(format!("match_error: {e}")))?;
+
+        for segment in segments {
+            let found = (candidate.id, segment.score, segment.duration(config));
+            if best_match.is_none_or(|best| is_better_match(found, best)) {
+                best_match = Some(found);
+            }
+        }
+    }
+    Ok(best_match)
+}
+
 /// Internal helper function.
 pub(crate) fn pcm_sha256_for_interleaved(
     sample_rate: u32,
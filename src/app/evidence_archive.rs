@@ -0,0 +1,569 @@
+//! 证据分层保留：热表（`SQLite`）与压缩冷归档.
+//!
+//! 超过保留期的证据行被整批写成一个 gzip member 追加到 `evidence-archive.jsonl.gz`
+//! （与 `awmkit.db` 同目录，可直接用 `zcat` 查看），随后在同一个 `SQLite` 事务内写入
+//! 冷索引并从热表删除。归档文件只追加：若进程在追加后、提交前退出，留下的 member
+//! 不被索引引用，下次运行会重新归档这些行。
+//!
+//! 冷索引保留 tag/identity/槽位/PCM 哈希与 member 位置：精确哈希命中无需解压，指纹比对
+//! 只解压候选所在的 member。指纹配置变更后，冷归档行与热表行一样参与指纹迁移：新配置
+//! 指纹写入 `audio_evidence_fingerprint`，归档 member 本身保持不变。.
+
+use crate::app::error::{Failure, Result};
+use crate::app::evidence_store::{
+    decode_chromaprint_blob, AudioEvidence, EvidenceStore, DEFAULT_CANDIDATE_LIMIT,
+};
+use flate2::read::GzDecoder;
+use flate2::write::GzEncoder;
+use flate2::Compression;
+use rusqlite::{params, OptionalExtension, Transaction, TransactionBehavior};
+use rusty_chromaprint::Configuration;
+use serde::{Deserialize, Serialize};
+use std::collections::{BTreeMap, BTreeSet};
+use std::fs::{File, OpenOptions};
+use std::io::{BufRead, BufReader, Read, Seek, SeekFrom, Write};
+use std::path::{Path, PathBuf};
+use std::time::{SystemTime, UNIX_EPOCH};
+
+/// 归档文件名（与 `awmkit.db` 同目录）.
+const ARCHIVE_FILE_NAME: &str = "evidence-archive.jsonl.gz";
+/// 每个 gzip member 包含的最大行数.
+const SEGMENT_ROWS: usize = 512;
+/// Internal constant.
+const SECONDS_PER_DAY: u64 = 86_400;
+
+/// 保留策略：热表只保留最近 `hot_days` 天的证据.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct RetentionPolicy {
+    pub hot_days: u32,
+}
+
+/// 一次归档的结果.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct ArchiveReport {
+    /// 移入冷归档的行数.
+    pub archived: usize,
+    /// 追加的 gzip member 数.
+    pub segments: usize,
+    /// 追加的压缩字节数.
+    pub bytes_written: u64,
+}
+
+/// 归档文件中的一行；字段与 [`AudioEvidence`] 一致.
+#[derive(Debug, Serialize, Deserialize)]
+struct ArchivedRow {
+    /// Internal field.
+    id: i64,
+    /// Internal field.
+    created_at: u64,
+    /// Internal field.
+    file_path: String,
+    /// Internal field.
+    tag: String,
+    /// Internal field.
+    identity: String,
+    /// Internal field.
+    version: u8,
+    /// Internal field.
+    key_slot: u8,
+    /// Internal field.
+    timestamp_minutes: u32,
+    /// Internal field.
+    message_hex: String,
+    /// Internal field.
+    sample_rate: u32,
+    /// Internal field.
+    channels: u32,
+    /// Internal field.
+    sample_count: u64,
+    /// Internal field.
+    pcm_sha256: String,
+    /// Internal field.
+    key_id: Option<String>,
+    /// Internal field.
+    is_forced_embed: bool,
+    /// Internal field.
+    snr_db: Option<f64>,
+    /// Internal field.
+    snr_status: String,
+    /// Internal field.
+    chromaprint: Vec<u32>,
+    /// Internal field.
+    fp_config_id: u8,
+}
+
+impl From<&AudioEvidence> for ArchivedRow {
+    fn from(row: &AudioEvidence) -> Self {
+        Self {
+            id: row.id,
+            created_at: row.created_at,
+            file_path: row.file_path.clone(),
+            tag: row.tag.clone(),
+            identity: row.identity.clone(),
+            version: row.version,
+            key_slot: row.key_slot,
+            timestamp_minutes: row.timestamp_minutes,
+            message_hex: row.message_hex.clone(),
+            sample_rate: row.sample_rate,
+            channels: row.channels,
+            sample_count: row.sample_count,
+            pcm_sha256: row.pcm_sha256.clone(),
+            key_id: row.key_id.clone(),
+            is_forced_embed: row.is_forced_embed,
+            snr_db: row.snr_db,
+            snr_status: row.snr_status.clone(),
+            chromaprint: row.chromaprint.clone(),
+            fp_config_id: row.fp_config_id,
+        }
+    }
+}
+
+impl From<ArchivedRow> for AudioEvidence {
+    fn from(row: ArchivedRow) -> Self {
+        Self {
+            id: row.id,
+            created_at: row.created_at,
+            file_path: row.file_path,
+            tag: row.tag,
+            identity: row.identity,
+            version: row.version,
+            key_slot: row.key_slot,
+            timestamp_minutes: row.timestamp_minutes,
+            message_hex: row.message_hex,
+            sample_rate: row.sample_rate,
+            channels: row.channels,
+            sample_count: row.sample_count,
+            pcm_sha256: row.pcm_sha256,
+            key_id: row.key_id,
+            is_forced_embed: row.is_forced_embed,
+            snr_db: row.snr_db,
+            snr_status: row.snr_status,
+            chromaprint: row.chromaprint,
+            fp_config_id: row.fp_config_id,
+        }
+    }
+}
+
+/// 把早于保留期的热表证据移入冷归档.
+///
+/// 已迁移到当前指纹配置的行以新配置指纹归档。.
+///
+/// # Errors
+/// 当系统时钟异常、归档文件写入失败或 `SQLite` 读写失败时返回错误。.
+pub fn apply_retention(store: &EvidenceStore, policy: RetentionPolicy) -> Result<ArchiveReport> {
+    let now = SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .map_err(|e| Failure::Message(format!("clock error: {e}")))?
+        .as_secs();
+    let cutoff = now.saturating_sub(u64::from(policy.hot_days).saturating_mul(SECONDS_PER_DAY));
+    archive_created_before(store, cutoff)
+}
+
+/// Internal helper function.
+fn archive_created_before(store: &EvidenceStore, cutoff: u64) -> Result<ArchiveReport> {
+    let archive_path = archive_path(store);
+    let fp_config_id = Configuration::default().id();
+    let mut report = ArchiveReport::default();
+    loop {
+        // IMMEDIATE 事务同时作为归档写锁，避免两个进程交错追加。
+        let tx = Transaction::new_unchecked(store.conn(), TransactionBehavior::Immediate)?;
+        let rows = store.list_created_before(cutoff, fp_config_id, SEGMENT_ROWS)?;
+        if rows.is_empty() {
+            tx.commit()?;
+            break;
+        }
+        let segment = encode_segment(&rows)?;
+        let offset = append_segment(&archive_path, &segment)?;
+        let segment_len = i64::try_from(segment.len())
+            .map_err(|_| Failure::Message("archive segment too large".to_string()))?;
+        let offset_i64 = i64::try_from(offset)
+            .map_err(|_| Failure::Message("archive offset overflow".to_string()))?;
+        for row in &rows {
+            index_and_remove(&tx, row, offset_i64, segment_len)?;
+        }
+        tx.commit()?;
+
+        report.archived = report.archived.saturating_add(rows.len());
+        report.segments = report.segments.saturating_add(1);
+        report.bytes_written = report.bytes_written.saturating_add(segment.len() as u64);
+    }
+    Ok(report)
+}
+
+/// Internal helper function.
+fn index_and_remove(
+    tx: &Transaction<'_>,
+    row: &AudioEvidence,
+    segment_offset: i64,
+    segment_len: i64,
+) -> Result<()> {
+    let created_at = i64::try_from(row.created_at)
+        .map_err(|_| Failure::Message("created_at overflow".to_string()))?;
+    let fingerprint_len = i64::try_from(row.chromaprint.len())
+        .map_err(|_| Failure::Message("fingerprint length overflow".to_string()))?;
+    tx.execute(
+        "INSERT OR IGNORE INTO audio_evidence_cold (
+            id, created_at, tag, identity, key_slot, key_id, pcm_sha256, fp_config_id,
+            fingerprint_len, segment_offset, segment_len
+         ) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11)",
+        params![
+            row.id,
+            created_at,
+            row.tag,
+            row.identity,
+            i64::from(row.key_slot),
+            row.key_id.as_deref().unwrap_or_default(),
+            row.pcm_sha256,
+            i64::from(row.fp_config_id),
+            fingerprint_len,
+            segment_offset,
+            segment_len,
+        ],
+    )?;
+    tx.execute("DELETE FROM audio_evidence WHERE id = ?1", params![row.id])?;
+    tx.execute(
+        "DELETE FROM audio_evidence_fingerprint WHERE evidence_id = ?1",
+        params![row.id],
+    )?;
+    Ok(())
+}
+
+/// Internal helper function.
+fn encode_segment(rows: &[AudioEvidence]) -> Result<Vec<u8>> {
+    let mut encoder = GzEncoder::new(Vec::new(), Compression::default());
+    for row in rows {
+        serde_json::to_writer(&mut encoder, &ArchivedRow::from(row))?;
+        encoder.write_all(b"\n")?;
+    }
+    Ok(encoder.finish()?)
+}
+
+/// 追加一个 member 并落盘，返回其起始偏移.
+fn append_segment(path: &Path, segment: &[u8]) -> Result<u64> {
+    let mut file = OpenOptions::new().create(true).append(true).open(path)?;
+    let offset = file.metadata()?.len();
+    file.write_all(segment)?;
+    file.sync_data()?;
+    Ok(offset)
+}
+
+/// Internal helper function.
+fn archive_path(store: &EvidenceStore) -> PathBuf {
+    store.path().parent().map_or_else(
+        || PathBuf::from(ARCHIVE_FILE_NAME),
+        |dir| dir.join(ARCHIVE_FILE_NAME),
+    )
+}
+
+impl EvidenceStore {
+    /// 在冷索引中按 PCM 哈希精确查找，返回证据 id（无需解压归档）.
+    ///
+    /// # Errors
+    /// 当 `SQLite` 查询失败时返回错误。.
+    pub fn find_cold_exact(
+        &self,
+        identity: &str,
+        key_slot: u8,
+        pcm_sha256: &str,
+    ) -> Result<Option<i64>> {
+        let id = self
+            .conn()
+            .query_row(
+                "SELECT id FROM audio_evidence_cold
+                 WHERE identity = ?1 AND key_slot = ?2 AND pcm_sha256 = ?3
+                 LIMIT 1",
+                params![identity, i64::from(key_slot), pcm_sha256],
+                |row| row.get(0),
+            )
+            .optional()?;
+        Ok(id)
+    }
+
+    /// 从冷归档加载 `fp_config_id` 配置下的候选证据（只解压相关 member）.
+    ///
+    /// 以旧配置归档、之后由指纹迁移补算了新配置指纹的行同样返回，并带迁移后的指纹。.
+    ///
+    /// # Errors
+    /// 当 `SQLite` 查询失败、归档文件读取失败或内容损坏时返回错误。.
+    pub fn list_cold_candidates(
+        &self,
+        identity: &str,
+        key_slot: u8,
+        fp_config_id: u8,
+    ) -> Result<Vec<AudioEvidence>> {
+        let limit_i64 = i64::try_from(DEFAULT_CANDIDATE_LIMIT)
+            .map_err(|_| Failure::Message("limit overflow".to_string()))?;
+        let mut stmt = self.conn().prepare(
+            "SELECT c.id, c.segment_offset, c.segment_len, f.chromaprint_blob
+             FROM audio_evidence_cold c
+             LEFT JOIN audio_evidence_fingerprint f
+               ON f.evidence_id = c.id
+              AND f.fp_config_id = ?3
+              AND f.status = 'ok'
+              AND c.fp_config_id != ?3
+             WHERE c.identity = ?1
+               AND c.key_slot = ?2
+               AND (c.fp_config_id = ?3 OR f.evidence_id IS NOT NULL)
+             ORDER BY c.created_at DESC
+             LIMIT ?4",
+        )?;
+        let rows = stmt.query_map(
+            params![
+                identity,
+                i64::from(key_slot),
+                i64::from(fp_config_id),
+                limit_i64
+            ],
+            |row| {
+                Ok((
+                    (
+                        row.get::<_, i64>(0)?,
+                        row.get::<_, i64>(1)?,
+                        row.get::<_, i64>(2)?,
+                    ),
+                    row.get::<_, Option<Vec<u8>>>(3)?,
+                ))
+            },
+        )?;
+        let mut refs = Vec::new();
+        let mut migrated = BTreeMap::new();
+        for row in rows {
+            let (member, blob) = row?;
+            if let Some(blob) = blob {
+                migrated.insert(member.0, decode_chromaprint_blob(&blob)?);
+            }
+            refs.push(member);
+        }
+
+        let mut out = Vec::new();
+        for row in self.read_archived(&refs)? {
+            let mut row = AudioEvidence::from(row);
+            if let Some(chromaprint) = migrated.remove(&row.id) {
+                row.chromaprint = chromaprint;
+                row.fp_config_id = fp_config_id;
+            }
+            out.push(row);
+        }
+        Ok(out)
+    }
+
+    /// 按 id 读取冷归档行的原文件路径（指纹迁移用）；`refs` 为 `(id, offset, len)`.
+    pub(crate) fn archived_file_paths(
+        &self,
+        refs: &[(i64, i64, i64)],
+    ) -> Result<BTreeMap<i64, String>> {
+        Ok(self
+            .read_archived(refs)?
+            .into_iter()
+            .map(|row| (row.id, row.file_path))
+            .collect())
+    }
+
+    /// 解压 `refs`（`(id, offset, len)`）涉及的 member，返回其中被引用的行.
+    fn read_archived(&self, refs: &[(i64, i64, i64)]) -> Result<Vec<ArchivedRow>> {
+        let mut segments: BTreeMap<(u64, u64), BTreeSet<i64>> = BTreeMap::new();
+        for &(id, offset, len) in refs {
+            let offset = u64::try_from(offset)
+                .map_err(|_| Failure::Message("archive offset out of range".to_string()))?;
+            let len = u64::try_from(len)
+                .map_err(|_| Failure::Message("archive segment out of range".to_string()))?;
+            segments.entry((offset, len)).or_default().insert(id);
+        }
+        if segments.is_empty() {
+            return Ok(Vec::new());
+        }
+
+        let mut file = File::open(archive_path(self))?;
+        let mut out = Vec::new();
+        for ((offset, len), ids) in segments {
+            file.seek(SeekFrom::Start(offset))?;
+            let reader = BufReader::new(GzDecoder::new((&mut file).take(len)));
+            for line in reader.lines() {
+                let row: ArchivedRow = serde_json::from_str(&line?)?;
+                if ids.contains(&row.id) {
+                    out.push(row);
+                }
+            }
+        }
+        Ok(out)
+    }
+
+    /// 冷归档中的证据行数.
+    ///
+    /// # Errors
+    /// 当 `SQLite` 查询失败或计数值无效时返回错误。.
+    pub fn count_cold(&self) -> Result<usize> {
+        let count: i64 =
+            self.conn()
+                .query_row("SELECT COUNT(*) FROM audio_evidence_cold", [], |row| {
+                    row.get(0)
+                })?;
+        usize::try_from(count)
+            .map_err(|_| Failure::Message("count must be non-negative".to_string()))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::app::evidence_store::{FingerprintStatus, NewAudioEvidence};
+    use std::fs;
+    use std::sync::atomic::{AtomicU64, Ordering};
+
+    static NEXT_ID: AtomicU64 = AtomicU64::new(0);
+
+    fn temp_dir() -> PathBuf {
+        let nanos = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .map_or(0, |duration| duration.as_nanos());
+        let id = NEXT_ID.fetch_add(1, Ordering::Relaxed);
+        std::env::temp_dir().join(format!("awmkit-archive-{nanos}-{id}"))
+    }
+
+    fn sample(identity: &str, sha: &str) -> NewAudioEvidence {
+        NewAudioEvidence {
+            file_path: "/tmp/a.wav".to_string(),
+            tag: "ABCDEFGH".to_string(),
+            identity: identity.to_string(),
+            version: 2,
+            key_slot: 0,
+            timestamp_minutes: 1234,
+            message_hex: "00112233445566778899aabbccddeeff".to_string(),
+            sample_rate: 44_100,
+            channels: 2,
+            sample_count: 10_000,
+            pcm_sha256: sha.to_string(),
+            key_id: "AAAAAAAAAA".to_string(),
+            is_forced_embed: false,
+            snr_db: Some(36.5),
+            snr_status: "ok".to_string(),
+            chromaprint: vec![7, 8, 9],
+            fp_config_id: Configuration::default().id(),
+        }
+    }
+
+    #[test]
+    fn archived_rows_leave_hot_table_and_stay_searchable() {
+        let dir = temp_dir();
+        let store = EvidenceStore::load_at(dir.join("awmkit.db"));
+        assert!(store.is_ok());
+        let Ok(store) = store else {
+            return;
+        };
+        assert!(store.insert(&sample("COLD", "c1")).is_ok());
+        assert!(store.insert(&sample("COLD", "c2")).is_ok());
+
+        // cutoff 在未来：所有行都视为过期。
+        let report = archive_created_before(&store, u64::MAX >> 1);
+        assert!(report.is_ok());
+        let Ok(report) = report else {
+            return;
+        };
+        assert_eq!(report.archived, 2);
+        assert_eq!(report.segments, 1);
+        assert!(store
+            .list_candidates("COLD", 0)
+            .is_ok_and(|rows| rows.is_empty()));
+        assert!(store.count_cold().is_ok_and(|count| count == 2));
+        assert!(store.usage_by_slot(0).is_ok_and(|usage| usage.count == 2));
+
+        assert!(store
+            .find_cold_exact("COLD", 0, "c2")
+            .is_ok_and(|id| id.is_some()));
+        assert!(store
+            .find_cold_exact("COLD", 0, "missing")
+            .is_ok_and(|id| id.is_none()));
+        let cold = store.list_cold_candidates("COLD", 0, Configuration::default().id());
+        assert!(cold.is_ok_and(|rows| {
+            rows.len() == 2 && rows.iter().all(|row| row.chromaprint == [7, 8, 9])
+        }));
+        let _ = fs::remove_dir_all(dir);
+    }
+
+    #[test]
+    fn cold_rows_block_duplicates_and_follow_deletes() {
+        let dir = temp_dir();
+        let store = EvidenceStore::load_at(dir.join("awmkit.db"));
+        assert!(store.is_ok());
+        let Ok(store) = store else {
+            return;
+        };
+        assert!(store.insert(&sample("COLD", "c1")).is_ok());
+        assert!(store.insert(&sample("COLD", "c2")).is_ok());
+        assert!(archive_created_before(&store, u64::MAX >> 1).is_ok());
+
+        // 唯一键已在冷索引中：不再写回热表。
+        assert!(store
+            .contains("COLD", 0, "AAAAAAAAAA", "c1")
+            .is_ok_and(|found| found));
+        assert!(store
+            .insert(&sample("COLD", "c1"))
+            .is_ok_and(|inserted| !inserted));
+        assert!(store.count_all().is_ok_and(|count| count == 0));
+
+        let id = store.find_cold_exact("COLD", 0, "c1");
+        assert!(id.is_ok());
+        let Ok(Some(id)) = id else {
+            return;
+        };
+        assert!(store.remove_by_id(id).is_ok_and(|removed| removed));
+        assert!(store.count_cold().is_ok_and(|count| count == 1));
+
+        assert!(store
+            .clear_filtered(None, Some("ABCDEFGH"), Some(0))
+            .is_ok_and(|removed| removed == 1));
+        assert!(store.count_cold().is_ok_and(|count| count == 0));
+        assert!(store.usage_by_slot(0).is_ok_and(|usage| usage.count == 0));
+        assert!(store
+            .find_cold_exact("COLD", 0, "c2")
+            .is_ok_and(|id| id.is_none()));
+        let _ = fs::remove_dir_all(dir);
+    }
+
+    #[test]
+    fn archived_rows_join_fingerprint_migration() {
+        let dir = temp_dir();
+        let store = EvidenceStore::load_at(dir.join("awmkit.db"));
+        assert!(store.is_ok());
+        let Ok(store) = store else {
+            return;
+        };
+        assert!(store.insert(&sample("COLD", "c1")).is_ok());
+        assert!(archive_created_before(&store, u64::MAX >> 1).is_ok());
+
+        // 指纹配置变更：归档行也必须进入迁移，且路径取自归档 member。
+        let next = Configuration::default().id().wrapping_add(1);
+        assert!(store
+            .count_fingerprint_pending(next, false)
+            .is_ok_and(|count| count == 1));
+        let pending = store.list_fingerprint_pending(next, 0, false, 10);
+        assert!(pending.is_ok());
+        let Ok(pending) = pending else {
+            return;
+        };
+        assert_eq!(pending.len(), 1);
+        assert_eq!(pending[0].file_path, "/tmp/a.wav");
+        assert_eq!(pending[0].pcm_sha256, "c1");
+        let results = vec![(pending[0].id, FingerprintStatus::Migrated, Some(vec![4, 5]))];
+        assert!(store.record_fingerprints(next, &results).is_ok());
+        assert!(store
+            .count_fingerprint_pending(next, true)
+            .is_ok_and(|count| count == 0));
+
+        let cold = store.list_cold_candidates("COLD", 0, next);
+        assert!(cold.is_ok_and(|rows| {
+            rows.len() == 1 && rows[0].fp_config_id == next && rows[0].chromaprint == [4, 5]
+        }));
+        // 旧配置仍看到归档时的指纹；清理其他行不丢失冷行的迁移结果。
+        assert!(store
+            .list_cold_candidates("COLD", 0, Configuration::default().id())
+            .is_ok_and(|rows| rows.len() == 1 && rows[0].chromaprint == [7, 8, 9]));
+        assert!(store
+            .clear_filtered(Some("OTHER"), None, None)
+            .is_ok_and(|removed| removed == 0));
+        assert!(store
+            .list_cold_candidates("COLD", 0, next)
+            .is_ok_and(|rows| rows.len() == 1));
+        let _ = fs::remove_dir_all(dir);
+    }
+}
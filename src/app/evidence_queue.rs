@@ -0,0 +1,621 @@
+//! 后台证据记录队列.
+//!
+//! 嵌入路径只把一条小记录追加到 journal（JSON Lines，逐条 fsync）后立即返回；后台
+//! worker 计算 proof/SNR 并以事务批量写入 `SQLite`，完成后追加 `done` 行确认。进程
+//! 崩溃或被中断时，下次启动从 journal 重放未确认的记录；`INSERT OR IGNORE` 的唯一约束
+//! 保证重放幂等，且重放时唯一键已存在的记录只算 PCM 哈希、不再计算指纹。同一 journal
+//! 同时只允许一个队列打开（独占文件锁），其余进程启动失败后回退为同步记录。.
+
+use crate::app::audio_proof::digest_pcm;
+use crate::app::error::{Failure, Result};
+use crate::app::evidence_store::{self, EvidenceStore, NewAudioEvidence};
+use crate::app::snr::analyze;
+use serde::{Deserialize, Serialize};
+use std::collections::{BTreeMap, VecDeque};
+use std::fs::{self, File, OpenOptions, TryLockError};
+use std::io::{BufRead, BufReader, BufWriter, Write};
+use std::path::{Path, PathBuf};
+use std::sync::{Arc, Condvar, Mutex, MutexGuard, PoisonError};
+use std::thread::JoinHandle;
+use std::time::{Duration, Instant};
+
+/// 单个写库事务包含的最大记录数.
+const BATCH_MAX: usize = 32;
+/// 数据库不可用时的重试间隔.
+const RETRY_DELAY: Duration = Duration::from_millis(500);
+/// journal 文件名（与 `awmkit.db` 同目录）.
+const JOURNAL_FILE_NAME: &str = "evidence-journal.jsonl";
+/// journal 锁文件扩展名（与 journal 同名）.
+const LOCK_EXTENSION: &str = "jsonl.lock";
+
+/// 待记录的一次嵌入结果；只保存 `key_id`，不落盘任何密钥材料.
+#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
+pub struct EvidenceJob {
+    pub input_path: String,
+    pub output_path: String,
+    pub tag: String,
+    pub identity: String,
+    pub version: u8,
+    pub key_slot: u8,
+    pub timestamp_minutes: u32,
+    pub message_hex: String,
+    pub key_id: String,
+    pub is_forced_embed: bool,
+}
+
+/// 队列计数快照.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct QueueStats {
+    /// 尚未写库的记录数（含正在处理的批次）.
+    pub pending: usize,
+    /// 本进程内实际写入（新增或提升）的行数.
+    pub recorded: usize,
+    /// 本进程内因 proof 计算失败而丢弃的记录数.
+    pub failed: usize,
+}
+
+/// Internal enum.
+#[derive(Debug, Serialize, Deserialize)]
+#[serde(tag = "op", rename_all = "snake_case")]
+enum JournalEntry {
+    /// Internal variant.
+    Enqueue { seq: u64, job: EvidenceJob },
+    /// Internal variant.
+    Done { seq: u64 },
+}
+
+/// Internal type alias.
+type StoreOpener = Box<dyn Fn() -> Result<EvidenceStore> + Send>;
+
+/// Internal struct.
+struct QueueState {
+    /// Internal field.
+    journal: File,
+    /// Internal field.
+    pending: VecDeque<(u64, EvidenceJob)>,
+    /// Internal field.
+    in_flight: usize,
+    /// Internal field.
+    next_seq: u64,
+    /// Internal field.
+    recorded: usize,
+    /// Internal field.
+    failed: usize,
+    /// Internal field.
+    closing: bool,
+    /// Internal field.
+    drain: bool,
+}
+
+impl QueueState {
+    /// Internal helper method.
+    fn is_idle(&self) -> bool {
+        self.pending.is_empty() && self.in_flight == 0
+    }
+}
+
+/// Internal struct.
+struct Shared {
+    /// Internal field.
+    state: Mutex<QueueState>,
+    /// Internal field.
+    wake: Condvar,
+    /// Internal field.
+    idle: Condvar,
+}
+
+impl Shared {
+    /// Internal helper method.
+    fn lock(&self) -> MutexGuard<'_, QueueState> {
+        self.state.lock().unwrap_or_else(PoisonError::into_inner)
+    }
+}
+
+/// 持久化后台证据队列；drop 时在当前批次结束后停止，剩余记录留在 journal 等待下次重放.
+pub struct EvidenceQueue {
+    /// Internal field.
+    shared: Arc<Shared>,
+    /// Internal field.
+    worker: Option<JoinHandle<()>>,
+    /// Internal field.
+    _journal_lock: File,
+}
+
+impl EvidenceQueue {
+    /// 打开默认 journal（重放上次未完成的记录）并启动后台 worker.
+    ///
+    /// # Errors
+    /// 当 journal 已被其他队列占用，或路径解析、读取/压缩、worker 线程创建失败时返回错误。.
+    pub fn start() -> Result<Self> {
+        Self::start_with(journal_path()?, Box::new(EvidenceStore::load))
+    }
+
+    /// Internal associated function.
+    fn start_with(path: PathBuf, open_store: StoreOpener) -> Result<Self> {
+        let journal_lock = lock_journal(&path)?;
+        let (pending, next_seq) = replay_journal(&path)?;
+        let journal = OpenOptions::new().create(true).append(true).open(&path)?;
+        let shared = Arc::new(Shared {
+            state: Mutex::new(QueueState {
+                journal,
+                pending,
+                in_flight: 0,
+                next_seq,
+                recorded: 0,
+                failed: 0,
+                closing: false,
+                drain: false,
+            }),
+            wake: Condvar::new(),
+            idle: Condvar::new(),
+        });
+        let worker_shared = Arc::clone(&shared);
+        let worker = std::thread::Builder::new()
+            .name("awmkit-evidence".to_string())
+            .spawn(move || worker_loop(&worker_shared, &open_store))?;
+        Ok(Self {
+            shared,
+            worker: Some(worker),
+            _journal_lock: journal_lock,
+        })
+    }
+
+    /// 追加一条记录到 journal 并唤醒 worker；返回时记录已持久化.
+    ///
+    /// # Errors
+    /// 当序列化或 journal 写入/同步失败时返回错误。.
+    pub fn enqueue(&self, job: EvidenceJob) -> Result<u64> {
+        let mut state = self.shared.lock();
+        let seq = state.next_seq;
+        let entry = JournalEntry::Enqueue {
+            seq,
+            job: job.clone(),
+        };
+        append_entries(&mut state.journal, std::slice::from_ref(&entry))?;
+        state.next_seq = seq.saturating_add(1);
+        state.pending.push_back((seq, job));
+        drop(state);
+        self.shared.wake.notify_one();
+        Ok(seq)
+    }
+
+    /// 返回当前计数快照.
+    #[must_use]
+    pub fn stats(&self) -> QueueStats {
+        let state = self.shared.lock();
+        QueueStats {
+            pending: state.pending.len().saturating_add(state.in_flight),
+            recorded: state.recorded,
+            failed: state.failed,
+        }
+    }
+
+    /// 等待队列清空；`timeout` 为 `None` 时无限等待。返回是否已清空.
+    #[must_use]
+    pub fn wait_idle(&self, timeout: Option<Duration>) -> bool {
+        let deadline = timeout.map(|value| Instant::now() + value);
+        let mut state = self.shared.lock();
+        while !state.is_idle() {
+            if state.closing && !state.drain {
+                return false;
+            }
+            match deadline {
+                None => {
+                    state = self
+                        .shared
+                        .idle
+                        .wait(state)
+                        .unwrap_or_else(PoisonError::into_inner);
+                }
+                Some(deadline) => {
+                    let now = Instant::now();
+                    if now >= deadline {
+                        return false;
+                    }
+                    state = self
+                        .shared
+                        .idle
+                        .wait_timeout(state, deadline - now)
+                        .unwrap_or_else(PoisonError::into_inner)
+                        .0;
+                }
+            }
+        }
+        true
+    }
+
+    /// 处理完所有剩余记录后停止 worker，返回最终计数.
+    ///
+    /// 数据库持续不可用时 worker 会放弃本轮，剩余记录仍保留在 journal 中。.
+    #[must_use]
+    pub fn finish(mut self) -> QueueStats {
+        self.stop(true);
+        self.stats()
+    }
+
+    /// Internal helper method.
+    fn stop(&mut self, drain: bool) {
+        {
+            let mut state = self.shared.lock();
+            state.closing = true;
+            state.drain = drain;
+        }
+        self.shared.wake.notify_all();
+        self.shared.idle.notify_all();
+        if let Some(worker) = self.worker.take() {
+            let _ = worker.join();
+        }
+    }
+}
+
+impl Drop for EvidenceQueue {
+    fn drop(&mut self) {
+        if self.worker.is_some() {
+            self.stop(false);
+        }
+    }
+}
+
+/// journal 默认路径（与证据库同目录）.
+///
+/// # Errors
+/// 当数据目录无法解析时返回错误。.
+pub fn journal_path() -> Result<PathBuf> {
+    let db = evidence_store::db_path()?;
+    let dir = db
+        .parent()
+        .ok_or_else(|| Failure::Message("invalid evidence db path".to_string()))?;
+    Ok(dir.join(JOURNAL_FILE_NAME))
+}
+
+/// Internal helper function.
+fn worker_loop(shared: &Shared, open_store: &StoreOpener) {
+    let mut store: Option<EvidenceStore> = None;
+    loop {
+        let batch: Vec<(u64, EvidenceJob)> = {
+            let mut state = shared.lock();
+            while state.pending.is_empty() && !state.closing {
+                state = shared
+                    .wake
+                    .wait(state)
+                    .unwrap_or_else(PoisonError::into_inner);
+            }
+            if state.pending.is_empty() || (state.closing && !state.drain) {
+                shared.idle.notify_all();
+                return;
+            }
+            let take = state.pending.len().min(BATCH_MAX);
+            let batch: Vec<_> = state.pending.drain(..take).collect();
+            state.in_flight = batch.len();
+            batch
+        };
+
+        let opened = match store.take() {
+            Some(existing) => Ok(existing),
+            None => open_store(),
+        };
+        let written = opened.and_then(|opened| {
+            let rows = build_rows(&batch, &opened);
+            let result = opened
+                .record_batch(&rows.inserts, &rows.promotions)
+                .map(|changed| (changed, rows.failed));
+            store = Some(opened);
+            result
+        });
+
+        let mut state = shared.lock();
+        state.in_flight = 0;
+        let Ok((changed, failed)) = written else {
+            // 连接可能已失效：下次重新打开；记录放回队首，顺序不变。
+            store = None;
+            for item in batch.into_iter().rev() {
+                state.pending.push_front(item);
+            }
+            if state.closing {
+                shared.idle.notify_all();
+                return;
+            }
+            drop(state);
+            std::thread::sleep(RETRY_DELAY);
+            continue;
+        };
+
+        let done: Vec<JournalEntry> = batch
+            .iter()
+            .map(|(seq, _)| JournalEntry::Done { seq: *seq })
+            .collect();
+        // 确认行写入失败只会导致下次重放重复插入，由唯一约束吸收。
+        let _ = append_entries(&mut state.journal, &done);
+        // 只计实际新增/提升的行：重放或并发写入时 INSERT OR IGNORE 会跳过已有行。
+        state.recorded = state.recorded.saturating_add(changed);
+        state.failed = state.failed.saturating_add(failed);
+        if state.pending.is_empty() {
+            let _ = state.journal.set_len(0);
+        }
+        if state.is_idle() {
+            shared.idle.notify_all();
+        }
+    }
+}
+
+/// 一批待写入的证据.
+struct BatchRows {
+    /// 需插入的新行（已含指纹）.
+    inserts: Vec<NewAudioEvidence>,
+    /// 唯一键已存在、只需提升的行（未计算指纹）.
+    promotions: Vec<NewAudioEvidence>,
+    /// 解码失败数.
+    failed: usize,
+}
+
+/// 计算 PCM 哈希/SNR 并组装待写入行；唯一键已存在的记录不再计算指纹.
+fn build_rows(batch: &[(u64, EvidenceJob)], store: &EvidenceStore) -> BatchRows {
+    let mut rows = BatchRows {
+        inserts: Vec::with_capacity(batch.len()),
+        promotions: Vec::new(),
+        failed: 0,
+    };
+    for (_, job) in batch {
+        let Ok(digest) = digest_pcm(&job.output_path) else {
+            rows.failed = rows.failed.saturating_add(1);
+            continue;
+        };
+        // 查询失败时按新行处理：多算一次指纹，由唯一约束兜底。
+        let exists = store
+            .contains(&job.identity, job.key_slot, &job.key_id, &digest.pcm_sha256)
+            .unwrap_or(false);
+        let snr = analyze(job.input_path.as_str(), job.output_path.as_str());
+        let mut row = NewAudioEvidence {
+            file_path: job.output_path.clone(),
+            tag: job.tag.clone(),
+            identity: job.identity.clone(),
+            version: job.version,
+            key_slot: job.key_slot,
+            timestamp_minutes: job.timestamp_minutes,
+            message_hex: job.message_hex.clone(),
+            sample_rate: digest.sample_rate,
+            channels: digest.channels,
+            sample_count: digest.sample_count,
+            pcm_sha256: digest.pcm_sha256.clone(),
+            key_id: job.key_id.clone(),
+            is_forced_embed: job.is_forced_embed,
+            snr_db: snr.snr_db,
+            snr_status: snr.status,
+            chromaprint: Vec::new(),
+            fp_config_id: 0,
+        };
+        if exists {
+            rows.promotions.push(row);
+            continue;
+        }
+        let Ok(proof) = digest.into_proof() else {
+            rows.failed = rows.failed.saturating_add(1);
+            continue;
+        };
+        row.chromaprint = proof.chromaprint;
+        row.fp_config_id = proof.fp_config_id;
+        rows.inserts.push(row);
+    }
+    rows
+}
+
+/// 对 journal 旁的锁文件加独占锁；锁随返回的句柄一直持有到队列 drop.
+///
+/// journal 本身会被压缩后 rename 替换，因此锁放在独立文件上。.
+fn lock_journal(path: &Path) -> Result<File> {
+    if let Some(parent) = path.parent() {
+        fs::create_dir_all(parent)?;
+    }
+    let lock = OpenOptions::new()
+        .create(true)
+        .truncate(false)
+        .write(true)
+        .open(path.with_extension(LOCK_EXTENSION))?;
+    match lock.try_lock() {
+        Ok(()) => Ok(lock),
+        Err(TryLockError::WouldBlock) => Err(Failure::Message(format!(
+            "evidence journal is in use by another process: {}",
+            path.display()
+        ))),
+        Err(TryLockError::Error(err)) => Err(err.into()),
+    }
+}
+
+/// Internal helper function.
+fn append_entries(journal: &mut File, entries: &[JournalEntry]) -> Result<()> {
+    let mut buf = Vec::new();
+    for entry in entries {
+        serde_json::to_writer(&mut buf, entry)?;
+        buf.push(b'\n');
+    }
+    journal.write_all(&buf)?;
+    journal.sync_data()?;
+    Ok(())
+}
+
+/// 读取 journal，返回未确认记录（按 seq 排序）与下一个 seq，并把 journal 压缩为仅含未确认记录.
+///
+/// 无法解析的行（崩溃时写了一半的尾行）被忽略。.
+fn replay_journal(path: &Path) -> Result<(VecDeque<(u64, EvidenceJob)>, u64)> {
+    if let Some(parent) = path.parent() {
+        fs::create_dir_all(parent)?;
+    }
+    let mut pending = BTreeMap::new();
+    let mut next_seq = 0_u64;
+    match File::open(path) {
+        Ok(file) => {
+            for line in BufReader::new(file).lines() {
+                let line = line?;
+                let Ok(entry) = serde_json::from_str::<JournalEntry>(&line) else {
+                    continue;
+                };
+                match entry {
+                    JournalEntry::Enqueue { seq, job } => {
+                        next_seq = next_seq.max(seq.saturating_add(1));
+                        pending.insert(seq, job);
+                    }
+                    JournalEntry::Done { seq } => {
+                        pending.remove(&seq);
+                    }
+                }
+            }
+        }
+        Err(err) if err.kind() == std::io::ErrorKind::NotFound => {}
+        Err(err) => return Err(err.into()),
+    }
+
+    let tmp = path.with_extension("jsonl.tmp");
+    {
+        let mut writer = BufWriter::new(File::create(&tmp)?);
+        for (seq, job) in &pending {
+            serde_json::to_writer(
+                &mut writer,
+                &JournalEntry::Enqueue {
+                    seq: *seq,
+                    job: job.clone(),
+                },
+            )?;
+            writer.write_all(b"\n")?;
+        }
+        let file = writer
+            .into_inner()
+            .map_err(|err| Failure::Io(err.into_error()))?;
+        file.sync_all()?;
+    }
+    fs::rename(&tmp, path)?;
+
+    Ok((pending.into_iter().collect(), next_seq))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::atomic::{AtomicU64, Ordering};
+    use std::time::{SystemTime, UNIX_EPOCH};
+
+    static NEXT_ID: AtomicU64 = AtomicU64::new(0);
+
+    fn temp_dir() -> PathBuf {
+        let nanos = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .map_or(0, |duration| duration.as_nanos());
+        let id = NEXT_ID.fetch_add(1, Ordering::Relaxed);
+        std::env::temp_dir().join(format!("awmkit-evidence-queue-{nanos}-{id}"))
+    }
+
+    fn sample_job(output: &str) -> EvidenceJob {
+        EvidenceJob {
+            input_path: "/tmp/in.wav".to_string(),
+            output_path: output.to_string(),
+            tag: "ABCDEFGH".to_string(),
+            identity: "TESTER".to_string(),
+            version: 2,
+            key_slot: 0,
+            timestamp_minutes: 1234,
+            message_hex: "00112233445566778899aabbccddeeff".to_string(),
+            key_id: "AAAAAAAAAA".to_string(),
+            is_forced_embed: false,
+        }
+    }
+
+    #[test]
+    fn replay_keeps_unacknowledged_jobs_and_skips_torn_tail() {
+        let dir = temp_dir();
+        let path = dir.join(JOURNAL_FILE_NAME);
+        assert!(fs::create_dir_all(&dir).is_ok());
+        let mut text = String::new();
+        for entry in [
+            JournalEntry::Enqueue {
+                seq: 0,
+                job: sample_job("/tmp/a.wav"),
+            },
+            JournalEntry::Enqueue {
+                seq: 1,
+                job: sample_job("/tmp/b.wav"),
+            },
+            JournalEntry::Done { seq: 0 },
+        ] {
+            let line = serde_json::to_string(&entry);
+            assert!(line.is_ok());
+            let Ok(line) = line else {
+                return;
+            };
+            text.push_str(&line);
+            text.push('\n');
+        }
+        text.push_str("{\"op\":\"enqueue\",\"seq\":2,\"jo");
+        assert!(fs::write(&path, text).is_ok());
+
+        let replayed = replay_journal(&path);
+        assert!(replayed.is_ok());
+        let Ok((pending, next_seq)) = replayed else {
+            return;
+        };
+        assert_eq!(next_seq, 2);
+        assert_eq!(pending.len(), 1);
+        assert_eq!(pending[0].0, 1);
+        assert_eq!(pending[0].1.output_path, "/tmp/b.wav");
+
+        // 压缩后再次重放结果不变。
+        let again = replay_journal(&path);
+        assert!(again.is_ok());
+        let Ok((pending_again, _)) = again else {
+            return;
+        };
+        assert_eq!(pending_again, pending);
+        let _ = fs::remove_dir_all(dir);
+    }
+
+    #[test]
+    fn finish_drains_queue_and_truncates_journal() {
+        let dir = temp_dir();
+        let path = dir.join(JOURNAL_FILE_NAME);
+        let db_path = dir.join("awmkit.db");
+        let queue = EvidenceQueue::start_with(
+            path.clone(),
+            Box::new(move || EvidenceStore::load_at(db_path.clone())),
+        );
+        assert!(queue.is_ok());
+        let Ok(queue) = queue else {
+            return;
+        };
+
+        // 输出文件不存在：proof 失败，记录被确认丢弃而不是无限重试。
+        let missing = dir.join("missing.wav").display().to_string();
+        assert!(queue.enqueue(sample_job(&missing)).is_ok());
+        assert!(queue.wait_idle(Some(Duration::from_secs(10))));
+
+        let stats = queue.finish();
+        assert_eq!(stats.pending, 0);
+        assert_eq!(stats.failed, 1);
+        assert_eq!(stats.recorded, 0);
+        assert_eq!(fs::metadata(&path).map(|meta| meta.len()).ok(), Some(0));
+        let _ = fs::remove_dir_all(dir);
+    }
+
+    #[test]
+    fn second_queue_on_same_journal_is_rejected_until_first_drops() {
+        let dir = temp_dir();
+        let path = dir.join(JOURNAL_FILE_NAME);
+        let opener = |dir: &Path| -> StoreOpener {
+            let db_path = dir.join("awmkit.db");
+            Box::new(move || EvidenceStore::load_at(db_path.clone()))
+        };
+        let first = EvidenceQueue::start_with(path.clone(), opener(&dir));
+        assert!(first.is_ok());
+        let Ok(first) = first else {
+            return;
+        };
+        assert!(first.enqueue(sample_job("/tmp/held.wav")).is_ok());
+
+        // 第二个句柄不得重放/压缩正在使用的 journal。
+        let second = EvidenceQueue::start_with(path.clone(), opener(&dir));
+        assert!(matches!(second, Err(Failure::Message(_))));
+        drop(first);
+
+        let third = EvidenceQueue::start_with(path, opener(&dir));
+        assert!(third.is_ok());
+        drop(third);
+        let _ = fs::remove_dir_all(dir);
+    }
+}
@@ -1,11 +1,24 @@
 use crate::app::error::{Failure, Result};
-use rusqlite::{params, Connection, OptionalExtension, Row};
+use rusqlite::{params, Connection, Row, Transaction, TransactionBehavior};
 use std::fs;
 use std::path::{Path, PathBuf};
 use std::time::{SystemTime, UNIX_EPOCH};
 
 /// Internal constant.
-const DEFAULT_CANDIDATE_LIMIT: usize = 200;
+pub(crate) const DEFAULT_CANDIDATE_LIMIT: usize = 200;
+/// 证据查询列；`?1` 为目标指纹配置，已迁移的旧行返回新配置指纹.
+const SELECT_FOR_CONFIG: &str = "SELECT
+        e.id, e.created_at, e.file_path, e.tag, e.identity, e.version, e.key_slot,
+        e.timestamp_minutes, e.message_hex, e.sample_rate, e.channels, e.sample_count,
+        e.pcm_sha256, e.key_id, e.is_forced_embed, e.snr_db, e.snr_status,
+        COALESCE(f.chromaprint_blob, e.chromaprint_blob),
+        COALESCE(f.fp_config_id, e.fp_config_id)
+     FROM audio_evidence e
+     LEFT JOIN audio_evidence_fingerprint f
+       ON f.evidence_id = e.id
+      AND f.fp_config_id = ?1
+      AND f.status = 'ok'
+      AND e.fp_config_id != ?1";
 
 #[derive(Debug, Clone)]
 pub struct NewAudioEvidence {
@@ -58,6 +71,39 @@ pub struct EvidenceStore {
     conn: Connection,
 }
 
+/// 待重新计算指纹的证据（指纹配置迁移用）.
+#[derive(Debug, Clone)]
+pub struct FingerprintSource {
+    pub id: i64,
+    pub file_path: String,
+    pub pcm_sha256: String,
+}
+
+/// 指纹迁移中单条证据的结果.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum FingerprintStatus {
+    /// 已按目标配置重新计算.
+    Migrated,
+    /// 原始文件不存在.
+    SourceMissing,
+    /// 原始文件内容与证据中的 PCM 哈希不一致.
+    SourceChanged,
+    /// 解码或指纹计算失败.
+    Failed,
+}
+
+impl FingerprintStatus {
+    /// Internal helper method.
+    const fn as_str(self) -> &'static str {
+        match self {
+            Self::Migrated => "ok",
+            Self::SourceMissing => "source_missing",
+            Self::SourceChanged => "source_changed",
+            Self::Failed => "failed",
+        }
+    }
+}
+
 /// Slot usage summary from evidence table.
 #[derive(Debug, Clone, Copy)]
 pub struct EvidenceSlotUsage {
@@ -67,6 +113,14 @@ pub struct EvidenceSlotUsage {
     pub last_created_at: Option<u64>,
 }
 
+/// 某个 `(key_slot, key_id)` 的证据用量（热表与冷归档合计）.
+#[derive(Debug, Clone)]
+pub struct EvidenceKeyUsage {
+    pub key_slot: u8,
+    pub key_id: String,
+    pub usage: EvidenceSlotUsage,
+}
+
 impl EvidenceStore {
     /// # Errors
     /// 当数据库路径解析、目录创建或 `SQLite` 打开失败时返回错误。.
@@ -77,11 +131,13 @@ impl EvidenceStore {
     }
 
     #[cfg(test)]
-    fn load_at(path: PathBuf) -> Result<Self> {
+    pub(crate) fn load_at(path: PathBuf) -> Result<Self> {
         let conn = open_db(&path)?;
         Ok(Self { path, conn })
     }
 
+    /// 唯一键已在热表或冷索引中时不写新行；热表已有时改为提升该行.
+    ///
     /// # Errors
     /// 当字段转换溢出或 `SQLite` 写入失败时返回错误。.
     pub fn insert(&self, input: &NewAudioEvidence) -> Result<bool> {
@@ -97,7 +153,12 @@ impl EvidenceStore {
                 message_hex, sample_rate, channels, sample_count, pcm_sha256, key_id, is_forced_embed,
                 snr_db, snr_status,
                 chromaprint_blob, fingerprint_len, fp_config_id
-             ) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14, ?15, ?16, ?17, ?18, ?19)",
+             )
+             SELECT ?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14, ?15, ?16, ?17, ?18, ?19
+             WHERE NOT EXISTS (
+                 SELECT 1 FROM audio_evidence_cold
+                 WHERE identity = ?4 AND key_slot = ?6 AND key_id = ?13 AND pcm_sha256 = ?12
+             )",
             params![
                 created_at,
                 input.file_path,
@@ -123,7 +184,38 @@ impl EvidenceStore {
         if changed > 0 {
             return Ok(true);
         }
+        self.promote(input)
+    }
 
+    /// 唯一键 `(identity, key_slot, key_id, pcm_sha256)` 是否已有证据行，热表与冷索引都算（走唯一索引）.
+    ///
+    /// # Errors
+    /// 当 `SQLite` 查询失败时返回错误。.
+    pub fn contains(
+        &self,
+        identity: &str,
+        key_slot: u8,
+        key_id: &str,
+        pcm_sha256: &str,
+    ) -> Result<bool> {
+        Ok(self.conn.query_row(
+            "SELECT EXISTS(
+                SELECT 1 FROM audio_evidence
+                WHERE identity = ?1 AND key_slot = ?2 AND key_id = ?3 AND pcm_sha256 = ?4
+             ) OR EXISTS(
+                SELECT 1 FROM audio_evidence_cold
+                WHERE identity = ?1 AND key_slot = ?2 AND key_id = ?3 AND pcm_sha256 = ?4
+             )",
+            params![identity, i64::from(key_slot), key_id, pcm_sha256],
+            |row| row.get(0),
+        )?)
+    }
+
+    /// 只提升已有行的强制嵌入标记与 SNR，不写入新行；`input` 的指纹字段不会被读取.
+    ///
+    /// # Errors
+    /// 当 `SQLite` 写入失败时返回错误。.
+    pub fn promote(&self, input: &NewAudioEvidence) -> Result<bool> {
         let promoted = self.conn.execute(
             "UPDATE audio_evidence
              SET is_forced_embed = CASE WHEN ?5 != 0 THEN 1 ELSE is_forced_embed END,
@@ -154,6 +246,40 @@ impl EvidenceStore {
         Ok(promoted > 0)
     }
 
+    /// 在单个事务内批量写入，返回新增或被提升的行数.
+    ///
+    /// # Errors
+    /// 当任一行写入失败或事务提交失败时返回错误（整批回滚）。.
+    pub fn insert_batch(&self, rows: &[NewAudioEvidence]) -> Result<usize> {
+        self.record_batch(rows, &[])
+    }
+
+    /// 在单个事务内写入新行（`inserts`）并提升已有行（`promotions`，不携带指纹），
+    /// 返回新增或被提升的行数.
+    ///
+    /// # Errors
+    /// 当任一行写入失败或事务提交失败时返回错误（整批回滚）。.
+    pub fn record_batch(
+        &self,
+        inserts: &[NewAudioEvidence],
+        promotions: &[NewAudioEvidence],
+    ) -> Result<usize> {
+        let tx = self.conn.unchecked_transaction()?;
+        let mut changed = 0_usize;
+        for row in inserts {
+            if self.insert(row)? {
+                changed = changed.saturating_add(1);
+            }
+        }
+        for row in promotions {
+            if self.promote(row)? {
+                changed = changed.saturating_add(1);
+            }
+        }
+        tx.commit()?;
+        Ok(changed)
+    }
+
     /// # Errors
     /// 当 `SQLite` 查询失败时返回错误。.
     pub fn list_candidates(&self, identity: &str, key_slot: u8) -> Result<Vec<AudioEvidence>> {
@@ -206,6 +332,204 @@ impl EvidenceStore {
         Ok(out)
     }
 
+    /// 与 `list_candidates` 相同，但旧配置的行若已迁移到 `fp_config_id`，返回迁移后的指纹.
+    ///
+    /// # Errors
+    /// 当 `SQLite` 查询失败或记录反序列化失败时返回错误。.
+    pub fn list_candidates_for_config(
+        &self,
+        identity: &str,
+        key_slot: u8,
+        fp_config_id: u8,
+    ) -> Result<Vec<AudioEvidence>> {
+        let limit_i64 = i64::try_from(DEFAULT_CANDIDATE_LIMIT)
+            .map_err(|_| Failure::Message("limit overflow".to_string()))?;
+        let mut stmt = self.conn.prepare(&format!(
+            "{SELECT_FOR_CONFIG}
+             WHERE e.identity = ?2
+               AND e.key_slot = ?3
+             ORDER BY e.created_at DESC
+             LIMIT ?4"
+        ))?;
+        let mut rows = stmt.query(params![
+            i64::from(fp_config_id),
+            identity,
+            i64::from(key_slot),
+            limit_i64
+        ])?;
+
+        let mut out = Vec::new();
+        while let Some(row) = rows.next()? {
+            out.push(parse_audio_evidence_row(row)?);
+        }
+        Ok(out)
+    }
+
+    /// 按 id 升序列出 `created_at` 早于 `cutoff` 的热表证据（冷归档用）.
+    pub(crate) fn list_created_before(
+        &self,
+        cutoff: u64,
+        fp_config_id: u8,
+        limit: usize,
+    ) -> Result<Vec<AudioEvidence>> {
+        let cutoff_i64 =
+            i64::try_from(cutoff).map_err(|_| Failure::Message("cutoff overflow".to_string()))?;
+        let limit_i64 =
+            i64::try_from(limit).map_err(|_| Failure::Message("limit overflow".to_string()))?;
+        let mut stmt = self.conn.prepare(&format!(
+            "{SELECT_FOR_CONFIG}
+             WHERE e.created_at < ?2
+             ORDER BY e.id
+             LIMIT ?3"
+        ))?;
+        let mut rows = stmt.query(params![i64::from(fp_config_id), cutoff_i64, limit_i64])?;
+
+        let mut out = Vec::new();
+        while let Some(row) = rows.next()? {
+            out.push(parse_audio_evidence_row(row)?);
+        }
+        Ok(out)
+    }
+
+    /// Internal helper method.
+    pub(crate) const fn conn(&self) -> &Connection {
+        &self.conn
+    }
+
+    /// 按 id 升序列出尚无 `fp_config_id` 指纹的证据（`retry_failed` 时包含此前失败的行）.
+    ///
+    /// 冷归档行同样列出，其文件路径从所在 member 读取；迁移结果与热表行一样写入
+    /// `audio_evidence_fingerprint`。.
+    ///
+    /// # Errors
+    /// 当 `limit` 溢出、`SQLite` 查询失败或归档文件读取失败时返回错误。.
+    pub fn list_fingerprint_pending(
+        &self,
+        fp_config_id: u8,
+        after_id: i64,
+        retry_failed: bool,
+        limit: usize,
+    ) -> Result<Vec<FingerprintSource>> {
+        let limit_i64 =
+            i64::try_from(limit).map_err(|_| Failure::Message("limit overflow".to_string()))?;
+        let mut stmt = self.conn.prepare(
+            "SELECT e.id AS id, e.file_path, e.pcm_sha256, NULL, NULL
+             FROM audio_evidence e
+             LEFT JOIN audio_evidence_fingerprint f
+               ON f.evidence_id = e.id AND f.fp_config_id = ?1
+             WHERE e.fp_config_id != ?1
+               AND e.id > ?2
+               AND (f.evidence_id IS NULL OR (?3 != 0 AND f.status != 'ok'))
+             UNION ALL
+             SELECT c.id, NULL, c.pcm_sha256, c.segment_offset, c.segment_len
+             FROM audio_evidence_cold c
+             LEFT JOIN audio_evidence_fingerprint f
+               ON f.evidence_id = c.id AND f.fp_config_id = ?1
+             WHERE c.fp_config_id != ?1
+               AND c.id > ?2
+               AND (f.evidence_id IS NULL OR (?3 != 0 AND f.status != 'ok'))
+             ORDER BY id
+             LIMIT ?4",
+        )?;
+        let rows = stmt.query_map(
+            params![
+                i64::from(fp_config_id),
+                after_id,
+                i64::from(retry_failed),
+                limit_i64
+            ],
+            |row| {
+                Ok((
+                    FingerprintSource {
+                        id: row.get(0)?,
+                        file_path: row.get::<_, Option<String>>(1)?.unwrap_or_default(),
+                        pcm_sha256: row.get(2)?,
+                    },
+                    row.get::<_, Option<i64>>(3)?
+                        .zip(row.get::<_, Option<i64>>(4)?),
+                ))
+            },
+        )?;
+        let mut out = Vec::new();
+        let mut cold = Vec::new();
+        for row in rows {
+            let (source, segment) = row?;
+            if let Some((offset, len)) = segment {
+                cold.push((source.id, offset, len));
+            }
+            out.push(source);
+        }
+        if !cold.is_empty() {
+            // 归档中找不到的行保留空路径，迁移时记为源文件缺失。
+            let paths = self.archived_file_paths(&cold)?;
+            for source in &mut out {
+                if let Some(path) = paths.get(&source.id) {
+                    source.file_path.clone_from(path);
+                }
+            }
+        }
+        Ok(out)
+    }
+
+    /// 统计尚无 `fp_config_id` 指纹的证据数（热表与冷归档合计）.
+    ///
+    /// # Errors
+    /// 当 `SQLite` 查询失败或计数值无效时返回错误。.
+    pub fn count_fingerprint_pending(&self, fp_config_id: u8, retry_failed: bool) -> Result<usize> {
+        let count: i64 = self.conn.query_row(
+            "SELECT
+                (SELECT COUNT(*)
+                 FROM audio_evidence e
+                 LEFT JOIN audio_evidence_fingerprint f
+                   ON f.evidence_id = e.id AND f.fp_config_id = ?1
+                 WHERE e.fp_config_id != ?1
+                   AND (f.evidence_id IS NULL OR (?2 != 0 AND f.status != 'ok')))
+              + (SELECT COUNT(*)
+                 FROM audio_evidence_cold c
+                 LEFT JOIN audio_evidence_fingerprint f
+                   ON f.evidence_id = c.id AND f.fp_config_id = ?1
+                 WHERE c.fp_config_id != ?1
+                   AND (f.evidence_id IS NULL OR (?2 != 0 AND f.status != 'ok')))",
+            params![i64::from(fp_config_id), i64::from(retry_failed)],
+            |row| row.get(0),
+        )?;
+        usize::try_from(count)
+            .map_err(|_| Failure::Message("count must be non-negative".to_string()))
+    }
+
+    /// 在单个事务内记录一批迁移结果；原行的旧配置指纹保持不变.
+    ///
+    /// # Errors
+    /// 当字段转换溢出或 `SQLite` 写入失败时返回错误（整批回滚）。.
+    pub fn record_fingerprints(
+        &self,
+        fp_config_id: u8,
+        results: &[(i64, FingerprintStatus, Option<Vec<u32>>)],
+    ) -> Result<()> {
+        let updated_at = now_ts()?;
+        let tx = self.conn.unchecked_transaction()?;
+        for (evidence_id, status, chromaprint) in results {
+            let blob = chromaprint.as_deref().map(encode_chromaprint_blob);
+            let fingerprint_len = i64::try_from(chromaprint.as_ref().map_or(0, Vec::len))
+                .map_err(|_| Failure::Message("fingerprint length overflow".to_string()))?;
+            self.conn.execute(
+                "INSERT OR REPLACE INTO audio_evidence_fingerprint (
+                    evidence_id, fp_config_id, status, chromaprint_blob, fingerprint_len, updated_at
+                 ) VALUES (?1, ?2, ?3, ?4, ?5, ?6)",
+                params![
+                    evidence_id,
+                    i64::from(fp_config_id),
+                    status.as_str(),
+                    blob,
+                    fingerprint_len,
+                    updated_at,
+                ],
+            )?;
+        }
+        tx.commit()?;
+        Ok(())
+    }
+
     /// # Errors
     /// 当 `SQLite` 查询失败或记录反序列化失败时返回错误。.
     pub fn get_by_id(&self, id: i64) -> Result<Option<AudioEvidence>> {
@@ -226,15 +550,28 @@ impl EvidenceStore {
         Ok(Some(parse_audio_evidence_row(row)?))
     }
 
+    /// 删除热表行或冷索引行（归档后 id 不变）.
+    ///
+    /// 冷归档文件只追加，被删行的压缩内容仍留在文件中，但不再被任何索引引用。.
+    ///
     /// # Errors
     /// 当 `SQLite` 删除失败时返回错误。.
     pub fn remove_by_id(&self, id: i64) -> Result<bool> {
-        let affected = self
-            .conn
-            .execute("DELETE FROM audio_evidence WHERE id = ?1", params![id])?;
-        Ok(affected > 0)
+        let tx = self.conn.unchecked_transaction()?;
+        let hot = tx.execute("DELETE FROM audio_evidence WHERE id = ?1", params![id])?;
+        let cold = tx.execute("DELETE FROM audio_evidence_cold WHERE id = ?1", params![id])?;
+        tx.execute(
+            "DELETE FROM audio_evidence_fingerprint WHERE evidence_id = ?1",
+            params![id],
+        )?;
+        tx.commit()?;
+        Ok(hot.saturating_add(cold) > 0)
     }
 
+    /// 按条件删除热表与冷索引中的行，返回删除总数.
+    ///
+    /// 冷归档文件只追加，被删行的压缩内容仍留在文件中，但不再被任何索引引用。.
+    ///
     /// # Errors
     /// 当 `SQLite` 删除失败时返回错误。.
     pub fn clear_filtered(
@@ -244,24 +581,40 @@ impl EvidenceStore {
         key_slot: Option<u8>,
     ) -> Result<usize> {
         let key_slot_i64 = key_slot.map(i64::from);
-        let affected = self.conn.execute(
+        let tx = self.conn.unchecked_transaction()?;
+        let hot = tx.execute(
             "DELETE FROM audio_evidence
              WHERE (?1 IS NULL OR identity = ?1)
                AND (?2 IS NULL OR tag = ?2)
                AND (?3 IS NULL OR key_slot = ?3)",
             params![identity, tag, key_slot_i64],
         )?;
-        Ok(affected)
+        let cold = tx.execute(
+            "DELETE FROM audio_evidence_cold
+             WHERE (?1 IS NULL OR identity = ?1)
+               AND (?2 IS NULL OR tag = ?2)
+               AND (?3 IS NULL OR key_slot = ?3)",
+            params![identity, tag, key_slot_i64],
+        )?;
+        tx.execute(
+            "DELETE FROM audio_evidence_fingerprint
+             WHERE evidence_id NOT IN (SELECT id FROM audio_evidence)
+               AND evidence_id NOT IN (SELECT id FROM audio_evidence_cold)",
+            [],
+        )?;
+        tx.commit()?;
+        Ok(hot.saturating_add(cold))
     }
 
     /// # Errors
     /// 当 `SQLite` 查询失败或计数值无效时返回错误。.
     pub fn count_all(&self) -> Result<usize> {
-        let mut stmt = self.conn.prepare("SELECT COUNT(*) FROM audio_evidence")?;
-        let count: i64 = stmt
-            .query_row([], |row| row.get(0))
-            .optional()?
-            .unwrap_or(0);
+        // 读物化计数，不对热表做全表 `COUNT(*)`。
+        let count: i64 = self.conn.query_row(
+            "SELECT COALESCE(SUM(hot_count), 0) FROM audio_evidence_usage",
+            [],
+            |row| row.get(0),
+        )?;
         let count = usize::try_from(count)
             .map_err(|_| Failure::Message("count must be non-negative".to_string()))?;
         Ok(count)
@@ -285,16 +638,7 @@ impl EvidenceStore {
 
     /// Internal helper method.
     fn count_by_slot_with_key_id(&self, key_slot: u8, key_id: Option<&str>) -> Result<usize> {
-        let mut stmt = self
-            .conn
-            .prepare("SELECT COUNT(*) FROM audio_evidence WHERE key_slot = ?1 AND (?2 IS NULL OR key_id = ?2)")?;
-        let count: i64 = stmt
-            .query_row(params![i64::from(key_slot), key_id], |row| row.get(0))
-            .optional()?
-            .unwrap_or(0);
-        let count = usize::try_from(count)
-            .map_err(|_| Failure::Message("count must be non-negative".to_string()))?;
-        Ok(count)
+        Ok(self.usage_by_slot_with_key_id(key_slot, key_id)?.count)
     }
 
     /// Usage stats for one key slot.
@@ -323,27 +667,40 @@ impl EvidenceStore {
         key_slot: u8,
         key_id: Option<&str>,
     ) -> Result<EvidenceSlotUsage> {
-        let mut stmt = self.conn.prepare(
-            "SELECT COUNT(*), MAX(created_at)
-             FROM audio_evidence
-             WHERE key_slot = ?1
-               AND (?2 IS NULL OR key_id = ?2)",
+        let (count_i64, last_i64): (i64, Option<i64>) = self.conn.query_row(
+            "SELECT COALESCE(SUM(hot_count + cold_count), 0), MAX(last_created_at)
+             FROM audio_evidence_usage
+             WHERE key_slot = ?1 AND (?2 IS NULL OR key_id = ?2)",
+            params![i64::from(key_slot), key_id],
+            |row| Ok((row.get(0)?, row.get(1)?)),
         )?;
-        let (count_i64, last_i64): (i64, Option<i64>) = stmt
-            .query_row(params![i64::from(key_slot), key_id], |row| {
-                Ok((row.get(0)?, row.get(1)?))
-            })
-            .optional()?
-            .unwrap_or((0, None));
-
-        let count = usize::try_from(count_i64)
-            .map_err(|_| Failure::Message("count must be non-negative".to_string()))?;
-        let last_created_at = last_i64.and_then(|value| u64::try_from(value).ok());
+        usage_from_counts(count_i64, last_i64)
+    }
 
-        Ok(EvidenceSlotUsage {
-            count,
-            last_created_at,
-        })
+    /// 一次查询读出全部 `(key_slot, key_id)` 的用量，按槽位升序.
+    ///
+    /// # Errors
+    /// 当 `SQLite` 查询失败或计数值无效时返回错误。.
+    pub fn usage_by_key(&self) -> Result<Vec<EvidenceKeyUsage>> {
+        let mut stmt = self.conn.prepare(
+            "SELECT key_slot, key_id, hot_count + cold_count, last_created_at
+             FROM audio_evidence_usage
+             ORDER BY key_slot, key_id",
+        )?;
+        let mut rows = stmt.query([])?;
+        let mut out = Vec::new();
+        while let Some(row) = rows.next()? {
+            let key_slot: i64 = row.get(0)?;
+            let Ok(key_slot) = u8::try_from(key_slot) else {
+                continue;
+            };
+            out.push(EvidenceKeyUsage {
+                key_slot,
+                key_id: row.get(1)?,
+                usage: usage_from_counts(row.get(2)?, row.get(3)?)?,
+            });
+        }
+        Ok(out)
     }
 
     pub fn path(&self) -> &Path {
@@ -424,7 +781,7 @@ pub fn decode_chromaprint_blob(blob: &[u8]) -> Result<Vec<u32>> {
 }
 
 /// Internal helper function.
-fn db_path() -> Result<PathBuf> {
+pub(crate) fn db_path() -> Result<PathBuf> {
     #[cfg(target_os = "windows")]
     {
         let base = std::env::var_os("LOCALAPPDATA")
@@ -480,11 +837,160 @@ fn open_db(path: &Path) -> Result<Connection> {
         CREATE INDEX IF NOT EXISTS idx_audio_evidence_identity_slot_created
         ON audio_evidence(identity, key_slot, created_at DESC);
         CREATE INDEX IF NOT EXISTS idx_audio_evidence_slot_key_created
-        ON audio_evidence(key_slot, key_id, created_at DESC);",
+        ON audio_evidence(key_slot, key_id, created_at DESC);
+        -- 指纹配置变更后的迁移结果；原行保留旧配置指纹，过渡期两者并存。
+        CREATE TABLE IF NOT EXISTS audio_evidence_fingerprint (
+            evidence_id INTEGER NOT NULL,
+            fp_config_id INTEGER NOT NULL,
+            status TEXT NOT NULL,
+            chromaprint_blob BLOB NULL,
+            fingerprint_len INTEGER NOT NULL DEFAULT 0,
+            updated_at INTEGER NOT NULL,
+            PRIMARY KEY(evidence_id, fp_config_id)
+        );
+        -- 冷归档索引：行内容在压缩归档文件中，这里只保留精确哈希与指纹定位信息。
+        CREATE TABLE IF NOT EXISTS audio_evidence_cold (
+            id INTEGER PRIMARY KEY,
+            created_at INTEGER NOT NULL,
+            tag TEXT NOT NULL,
+            identity TEXT NOT NULL,
+            key_slot INTEGER NOT NULL,
+            key_id TEXT NOT NULL,
+            pcm_sha256 TEXT NOT NULL,
+            fp_config_id INTEGER NOT NULL,
+            fingerprint_len INTEGER NOT NULL,
+            segment_offset INTEGER NOT NULL,
+            segment_len INTEGER NOT NULL,
+            UNIQUE(identity, key_slot, key_id, pcm_sha256)
+        );
+        CREATE INDEX IF NOT EXISTS idx_audio_evidence_cold_identity_slot
+        ON audio_evidence_cold(identity, key_slot, created_at DESC);
+        CREATE INDEX IF NOT EXISTS idx_audio_evidence_cold_slot_key_created
+        ON audio_evidence_cold(key_slot, key_id, created_at DESC);",
     )?;
+    ensure_usage_counters(&conn)?;
     Ok(conn)
 }
 
+/// 用量计数表与维护触发器；热表/冷归档每次插入、删除都同步更新 `(key_slot, key_id)` 计数.
+///
+/// 删除的恰是最新一行时，才借助 `(key_slot, key_id, created_at)` 索引重新取最大时间。.
+const USAGE_COUNTERS_DDL: &str = "
+    CREATE TABLE IF NOT EXISTS audio_evidence_usage (
+        key_slot INTEGER NOT NULL,
+        key_id TEXT NOT NULL,
+        hot_count INTEGER NOT NULL DEFAULT 0,
+        cold_count INTEGER NOT NULL DEFAULT 0,
+        last_created_at INTEGER NULL,
+        PRIMARY KEY(key_slot, key_id)
+    );
+    INSERT INTO audio_evidence_usage (key_slot, key_id, hot_count, cold_count, last_created_at)
+    SELECT key_slot, key_id, SUM(hot), SUM(cold), MAX(created_at)
+    FROM (
+        SELECT key_slot, key_id, 1 AS hot, 0 AS cold, created_at FROM audio_evidence
+        UNION ALL
+        SELECT key_slot, key_id, 0, 1, created_at FROM audio_evidence_cold
+    )
+    GROUP BY key_slot, key_id;
+    CREATE TRIGGER IF NOT EXISTS trg_audio_evidence_usage_insert
+    AFTER INSERT ON audio_evidence
+    BEGIN
+        INSERT INTO audio_evidence_usage (key_slot, key_id, hot_count, last_created_at)
+        VALUES (NEW.key_slot, NEW.key_id, 1, NEW.created_at)
+        ON CONFLICT(key_slot, key_id) DO UPDATE SET
+            hot_count = hot_count + 1,
+            last_created_at = MAX(COALESCE(last_created_at, 0), excluded.last_created_at);
+    END;
+    CREATE TRIGGER IF NOT EXISTS trg_audio_evidence_usage_delete
+    AFTER DELETE ON audio_evidence
+    BEGIN
+        UPDATE audio_evidence_usage
+        SET hot_count = hot_count - 1,
+            last_created_at = CASE
+                WHEN last_created_at > OLD.created_at THEN last_created_at
+                ELSE (
+                    SELECT MAX(latest) FROM (
+                        SELECT MAX(created_at) AS latest FROM audio_evidence
+                        WHERE key_slot = OLD.key_slot AND key_id = OLD.key_id
+                        UNION ALL
+                        SELECT MAX(created_at) FROM audio_evidence_cold
+                        WHERE key_slot = OLD.key_slot AND key_id = OLD.key_id
+                    )
+                )
+            END
+        WHERE key_slot = OLD.key_slot AND key_id = OLD.key_id;
+        DELETE FROM audio_evidence_usage
+        WHERE key_slot = OLD.key_slot AND key_id = OLD.key_id
+          AND hot_count <= 0 AND cold_count <= 0;
+    END;
+    CREATE TRIGGER IF NOT EXISTS trg_audio_evidence_cold_usage_insert
+    AFTER INSERT ON audio_evidence_cold
+    BEGIN
+        INSERT INTO audio_evidence_usage (key_slot, key_id, cold_count, last_created_at)
+        VALUES (NEW.key_slot, NEW.key_id, 1, NEW.created_at)
+        ON CONFLICT(key_slot, key_id) DO UPDATE SET
+            cold_count = cold_count + 1,
+            last_created_at = MAX(COALESCE(last_created_at, 0), excluded.last_created_at);
+    END;
+    CREATE TRIGGER IF NOT EXISTS trg_audio_evidence_cold_usage_delete
+    AFTER DELETE ON audio_evidence_cold
+    BEGIN
+        UPDATE audio_evidence_usage
+        SET cold_count = cold_count - 1,
+            last_created_at = CASE
+                WHEN last_created_at > OLD.created_at THEN last_created_at
+                ELSE (
+                    SELECT MAX(latest) FROM (
+                        SELECT MAX(created_at) AS latest FROM audio_evidence
+                        WHERE key_slot = OLD.key_slot AND key_id = OLD.key_id
+                        UNION ALL
+                        SELECT MAX(created_at) FROM audio_evidence_cold
+                        WHERE key_slot = OLD.key_slot AND key_id = OLD.key_id
+                    )
+                )
+            END
+        WHERE key_slot = OLD.key_slot AND key_id = OLD.key_id;
+        DELETE FROM audio_evidence_usage
+        WHERE key_slot = OLD.key_slot AND key_id = OLD.key_id
+          AND hot_count <= 0 AND cold_count <= 0;
+    END;";
+
+/// 首次打开旧库时建立用量计数表，并在同一写事务内按现有行回填.
+fn ensure_usage_counters(conn: &Connection) -> Result<()> {
+    if usage_counters_exist(conn)? {
+        return Ok(());
+    }
+    // IMMEDIATE：回填与建触发器之间不能有其他连接写入，否则计数会漏算。
+    let tx = Transaction::new_unchecked(conn, TransactionBehavior::Immediate)?;
+    if !usage_counters_exist(&tx)? {
+        tx.execute_batch(USAGE_COUNTERS_DDL)?;
+    }
+    tx.commit()?;
+    Ok(())
+}
+
+/// Internal helper function.
+fn usage_counters_exist(conn: &Connection) -> Result<bool> {
+    Ok(conn.query_row(
+        "SELECT EXISTS(
+            SELECT 1 FROM sqlite_master
+            WHERE type = 'trigger' AND name = 'trg_audio_evidence_cold_usage_delete'
+         )",
+        [],
+        |row| row.get(0),
+    )?)
+}
+
+/// Internal helper function.
+fn usage_from_counts(count: i64, last_created_at: Option<i64>) -> Result<EvidenceSlotUsage> {
+    let count = usize::try_from(count)
+        .map_err(|_| Failure::Message("count must be non-negative".to_string()))?;
+    Ok(EvidenceSlotUsage {
+        count,
+        last_created_at: last_created_at.and_then(|value| u64::try_from(value).ok()),
+    })
+}
+
 /// Internal helper function.
 fn now_ts() -> Result<u64> {
     let now = SystemTime::now()
@@ -691,4 +1197,136 @@ mod tests {
 
         let _ = fs::remove_file(db_path);
     }
+
+    #[test]
+    fn usage_counters_follow_inserts_deletes_and_backfill() {
+        let db_path = temp_db_path();
+        let store = ok_or_return!(EvidenceStore::load_at(db_path.clone()));
+
+        let first = sample_evidence("COUNT", 4, "u1");
+        let second = sample_evidence("COUNT", 4, "u2");
+        let mut other_key = sample_evidence("COUNT", 4, "u3");
+        other_key.key_id = "BBBBBBBBBB".to_string();
+        assert!(ok_or_return!(store.insert(&first)));
+        assert!(ok_or_return!(store.insert(&second)));
+        assert!(ok_or_return!(store.insert(&other_key)));
+        // 被忽略的重复插入不计数。
+        assert!(!ok_or_return!(store.insert(&first)));
+        assert_eq!(ok_or_return!(store.count_all()), 3);
+        assert_eq!(ok_or_return!(store.count_by_slot(4)), 3);
+        assert_eq!(
+            ok_or_return!(store.count_by_slot_and_key_id(4, "AAAAAAAAAA")),
+            2
+        );
+
+        let by_key = ok_or_return!(store.usage_by_key());
+        assert_eq!(by_key.len(), 2);
+        assert!(by_key.iter().all(|entry| entry.key_slot == 4));
+        assert!(by_key.iter().any(|entry| {
+            entry.key_id == "AAAAAAAAAA"
+                && entry.usage.count == 2
+                && entry.usage.last_created_at.is_some()
+        }));
+
+        let rows = ok_or_return!(store.list_candidates("COUNT", 4));
+        let other_ids: Vec<i64> = rows
+            .iter()
+            .filter(|row| row.key_id.as_deref() == Some("BBBBBBBBBB"))
+            .map(|row| row.id)
+            .collect();
+        for id in other_ids {
+            assert!(ok_or_return!(store.remove_by_id(id)));
+        }
+        assert_eq!(ok_or_return!(store.usage_by_key()).len(), 1);
+        assert_eq!(ok_or_return!(store.count_all()), 2);
+
+        // 旧库没有计数表：重新打开时按现有行回填。
+        assert!(store
+            .conn()
+            .execute_batch(
+                "DROP TRIGGER trg_audio_evidence_usage_insert;
+                 DROP TRIGGER trg_audio_evidence_usage_delete;
+                 DROP TRIGGER trg_audio_evidence_cold_usage_insert;
+                 DROP TRIGGER trg_audio_evidence_cold_usage_delete;
+                 DROP TABLE audio_evidence_usage;"
+            )
+            .is_ok());
+        drop(store);
+        let reopened = ok_or_return!(EvidenceStore::load_at(db_path.clone()));
+        let usage = ok_or_return!(reopened.usage_by_slot_and_key_id(4, "AAAAAAAAAA"));
+        assert_eq!(usage.count, 2);
+        assert!(usage.last_created_at.is_some());
+        assert!(ok_or_return!(reopened.usage_by_slot(5))
+            .last_created_at
+            .is_none());
+
+        let _ = fs::remove_file(db_path);
+    }
+
+    #[test]
+    fn promotion_without_fingerprint_keeps_existing_row() {
+        let db_path = temp_db_path();
+        let store = ok_or_return!(EvidenceStore::load_at(db_path.clone()));
+        let has_h1 = |key_id: &str| store.contains("HASHED", 2, key_id, "h1");
+        assert!(!ok_or_return!(has_h1("AAAAAAAAAA")));
+
+        let mut first = sample_evidence("HASHED", 2, "h1");
+        first.snr_db = None;
+        first.snr_status = "unavailable".to_string();
+        assert!(ok_or_return!(store.insert(&first)));
+        assert!(ok_or_return!(has_h1("AAAAAAAAAA")));
+        assert!(!ok_or_return!(has_h1("BBBBBBBBBB")));
+
+        // 已存在的行只提升，不携带指纹。
+        let mut repeat = sample_evidence("HASHED", 2, "h1");
+        repeat.chromaprint = Vec::new();
+        repeat.fp_config_id = 0;
+        let fresh = sample_evidence("HASHED", 2, "h2");
+        let changed = ok_or_return!(store.record_batch(&[fresh], &[repeat.clone()]));
+        assert_eq!(changed, 2);
+        assert!(!ok_or_return!(store.promote(&repeat)));
+
+        let rows = ok_or_return!(store.list_candidates("HASHED", 2));
+        assert_eq!(rows.len(), 2);
+        let promoted = rows.iter().find(|row| row.pcm_sha256 == "h1");
+        assert!(promoted.is_some_and(|row| {
+            row.snr_status == "ok" && row.chromaprint == vec![1, 2, 3, 4] && row.fp_config_id == 1
+        }));
+
+        let _ = fs::remove_file(db_path);
+    }
+
+    #[test]
+    fn migrated_fingerprint_is_preferred_for_new_config() {
+        let db_path = temp_db_path();
+        let store = ok_or_return!(EvidenceStore::load_at(db_path.clone()));
+        assert!(ok_or_return!(
+            store.insert(&sample_evidence("MIGRATE", 0, "m1"))
+        ));
+        assert!(ok_or_return!(
+            store.insert(&sample_evidence("MIGRATE", 0, "m2"))
+        ));
+        assert_eq!(ok_or_return!(store.count_fingerprint_pending(2, false)), 2);
+
+        let pending = ok_or_return!(store.list_fingerprint_pending(2, 0, false, 10));
+        assert_eq!(pending.len(), 2);
+        let results = vec![
+            (pending[0].id, FingerprintStatus::Migrated, Some(vec![9, 9])),
+            (pending[1].id, FingerprintStatus::SourceMissing, None),
+        ];
+        assert!(store.record_fingerprints(2, &results).is_ok());
+        assert_eq!(ok_or_return!(store.count_fingerprint_pending(2, false)), 0);
+        assert_eq!(ok_or_return!(store.count_fingerprint_pending(2, true)), 1);
+
+        let rows = ok_or_return!(store.list_candidates_for_config("MIGRATE", 0, 2));
+        let migrated = rows.iter().find(|row| row.id == pending[0].id);
+        assert!(migrated.is_some_and(|row| row.fp_config_id == 2 && row.chromaprint == [9, 9]));
+        let missing = rows.iter().find(|row| row.id == pending[1].id);
+        assert!(missing.is_some_and(|row| row.fp_config_id == 1));
+
+        // 旧配置查询仍看到原指纹。
+        let legacy = ok_or_return!(store.list_candidates("MIGRATE", 0));
+        assert!(legacy.iter().all(|row| row.fp_config_id == 1));
+        let _ = fs::remove_file(db_path);
+    }
 }
@@ -0,0 +1,195 @@
+//! 指纹配置迁移：按当前 chromaprint 配置重新计算旧证据的指纹.
+//!
+//! 证据行保留原配置的指纹，迁移结果写入 `audio_evidence_fingerprint`，过渡期两者并存，
+//! clone 检查通过 `list_candidates_for_config` / `list_cold_candidates` 优先取新配置指纹；
+//! 冷归档行同样参与迁移。每批结果在一个事务内落库并按 id 推进游标，中断后重新运行只处理
+//! 尚无结果的行（可续跑）。解码在 worker 池中并行，读取字节数受 I/O 预算节流。.
+
+use crate::app::audio_proof::build_proof;
+use crate::app::error::{Failure, Result};
+use crate::app::evidence_store::{EvidenceStore, FingerprintSource, FingerprintStatus};
+use crate::cancel::CancellationToken;
+use rayon::prelude::*;
+use rusty_chromaprint::Configuration;
+use std::path::Path;
+use std::sync::{Mutex, PoisonError};
+use std::time::{Duration, Instant};
+
+/// 每批从数据库取出并提交的行数.
+const BATCH_SIZE: usize = 64;
+/// 节流等待时检查取消的间隔.
+const THROTTLE_SLICE: Duration = Duration::from_millis(50);
+
+/// 迁移参数.
+#[derive(Debug, Clone, Copy, Default)]
+pub struct MigrationOptions {
+    /// worker 数；0 表示按可用并行度.
+    pub workers: usize,
+    /// 每秒最多读取的源文件字节数；`None` 表示不限速.
+    pub io_budget_bytes_per_sec: Option<u64>,
+    /// 是否重试此前失败/源文件缺失的行.
+    pub retry_failed: bool,
+}
+
+/// 迁移进度快照.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct MigrationProgress {
+    /// 目标指纹配置.
+    pub fp_config_id: u8,
+    /// 本次运行开始时待处理的行数.
+    pub total: usize,
+    /// 已处理行数.
+    pub processed: usize,
+    /// 已写入新配置指纹的行数.
+    pub migrated: usize,
+    /// 源文件缺失的行数.
+    pub source_missing: usize,
+    /// 源文件内容已变化（PCM 哈希不符）的行数.
+    pub source_changed: usize,
+    /// 解码或指纹计算失败的行数.
+    pub failed: usize,
+}
+
+/// Internal struct.
+struct IoBudget {
+    /// Internal field.
+    bytes_per_sec: u64,
+    /// Internal field.
+    started: Instant,
+    /// Internal field.
+    consumed: Mutex<u64>,
+}
+
+impl IoBudget {
+    /// 记入 `bytes` 并等待到预算允许的时刻；取消时提前返回.
+    fn acquire(&self, bytes: u64, cancel: &CancellationToken) {
+        let consumed = {
+            let mut consumed = self.consumed.lock().unwrap_or_else(PoisonError::into_inner);
+            *consumed = consumed.saturating_add(bytes);
+            *consumed
+        };
+        let due = Duration::from_millis(consumed.saturating_mul(1_000) / self.bytes_per_sec);
+        while !cancel.is_cancelled() {
+            let elapsed = self.started.elapsed();
+            if elapsed >= due {
+                break;
+            }
+            std::thread::sleep((due - elapsed).min(THROTTLE_SLICE));
+        }
+    }
+}
+
+/// 将所有旧配置证据迁移到当前指纹配置，返回最终进度.
+///
+/// 每提交一批调用一次 `on_progress`；`cancel` 触发后在当前批次落库后返回。.
+///
+/// # Errors
+/// 当 worker 池创建失败或 `SQLite` 读写失败时返回错误。.
+pub fn migrate_fingerprints(
+    store: &EvidenceStore,
+    options: MigrationOptions,
+    cancel: &CancellationToken,
+    mut on_progress: impl FnMut(&MigrationProgress),
+) -> Result<MigrationProgress> {
+    let fp_config_id = Configuration::default().id();
+    let mut progress = MigrationProgress {
+        fp_config_id,
+        total: store.count_fingerprint_pending(fp_config_id, options.retry_failed)?,
+        ..MigrationProgress::default()
+    };
+    on_progress(&progress);
+    if progress.total == 0 {
+        return Ok(progress);
+    }
+
+    let workers = if options.workers == 0 {
+        std::thread::available_parallelism().map_or(1, std::num::NonZero::get)
+    } else {
+        options.workers
+    };
+    let pool = rayon::ThreadPoolBuilder::new()
+        .num_threads(workers)
+        .build()
+        .map_err(|err| Failure::Message(format!("failed to build migration pool: {err}")))?;
+    let budget = options
+        .io_budget_bytes_per_sec
+        .filter(|&bytes| bytes > 0)
+        .map(|bytes_per_sec| IoBudget {
+            bytes_per_sec,
+            started: Instant::now(),
+            consumed: Mutex::new(0),
+        });
+
+    let mut cursor = 0_i64;
+    while !cancel.is_cancelled() {
+        let batch = store.list_fingerprint_pending(
+            fp_config_id,
+            cursor,
+            options.retry_failed,
+            BATCH_SIZE,
+        )?;
+        let Some(last) = batch.last() else {
+            break;
+        };
+        cursor = last.id;
+
+        let results: Vec<(i64, FingerprintStatus, Option<Vec<u32>>)> = pool.install(|| {
+            batch
+                .par_iter()
+                .filter(|_| !cancel.is_cancelled())
+                .map(|source| {
+                    let (status, chromaprint) =
+                        refingerprint(source, fp_config_id, budget.as_ref(), cancel);
+                    (source.id, status, chromaprint)
+                })
+                .collect()
+        });
+        // 被取消而跳过的行不落库，下次运行继续处理。
+        store.record_fingerprints(fp_config_id, &results)?;
+        tally(&mut progress, &results);
+        on_progress(&progress);
+    }
+    Ok(progress)
+}
+
+/// Internal helper function.
+fn tally(progress: &mut MigrationProgress, results: &[(i64, FingerprintStatus, Option<Vec<u32>>)]) {
+    for (_, status, _) in results {
+        progress.processed = progress.processed.saturating_add(1);
+        let counter = match status {
+            FingerprintStatus::Migrated => &mut progress.migrated,
+            FingerprintStatus::SourceMissing => &mut progress.source_missing,
+            FingerprintStatus::SourceChanged => &mut progress.source_changed,
+            FingerprintStatus::Failed => &mut progress.failed,
+        };
+        *counter = counter.saturating_add(1);
+    }
+}
+
+/// 重新计算单条证据的指纹；源文件内容必须与记录的 PCM 哈希一致.
+fn refingerprint(
+    source: &FingerprintSource,
+    fp_config_id: u8,
+    budget: Option<&IoBudget>,
+    cancel: &CancellationToken,
+) -> (FingerprintStatus, Option<Vec<u32>>) {
+    let path = Path::new(&source.file_path);
+    let Ok(meta) = std::fs::metadata(path) else {
+        return (FingerprintStatus::SourceMissing, None);
+    };
+    if !meta.is_file() {
+        return (FingerprintStatus::SourceMissing, None);
+    }
+    if let Some(budget) = budget {
+        budget.acquire(meta.len(), cancel);
+    }
+    match build_proof(path) {
+        Ok(proof) if proof.pcm_sha256 != source.pcm_sha256 => {
+            (FingerprintStatus::SourceChanged, None)
+        }
+        Ok(proof) if proof.fp_config_id == fp_config_id => {
+            (FingerprintStatus::Migrated, Some(proof.chromaprint))
+        }
+        Ok(_) | Err(_) => (FingerprintStatus::Failed, None),
+    }
+}
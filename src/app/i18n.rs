@@ -4,6 +4,9 @@ use i18n_embed::fluent::FluentLanguageLoader;
 use i18n_embed::{DesktopLanguageRequester, LanguageLoader};
 use rust_embed::RustEmbed;
 use std::str::FromStr;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::{Mutex, PoisonError};
+use std::time::{Duration, Instant};
 use unic_langid::LanguageIdentifier;
 
 #[derive(RustEmbed)]
@@ -18,6 +21,12 @@ static FALLBACK_LANG: std::sync::LazyLock<LanguageIdentifier> = std::sync::LazyL
 /// Internal item.
 static LOADER: std::sync::LazyLock<FluentLanguageLoader> =
     std::sync::LazyLock::new(|| FluentLanguageLoader::new("awmkit", FALLBACK_LANG.clone()));
+/// Internal item.
+static LOADED: AtomicBool = AtomicBool::new(false);
+/// 延迟加载请求：外层 `Some` 表示已登记，内层为语言标识（`None` 为系统语言）.
+static DEFERRED: Mutex<Option<Option<String>>> = Mutex::new(None);
+/// Internal item.
+static LOAD_MICROS: AtomicU64 = AtomicU64::new(0);
 
 #[derive(Clone, Copy)]
 pub struct LanguageInfo {
@@ -43,6 +52,7 @@ pub fn available_languages() -> &'static [LanguageInfo] {
 }
 
 pub fn current_language() -> Option<String> {
+    ensure_loaded();
     LOADER
         .current_languages()
         .first()
@@ -87,14 +97,65 @@ pub fn set_language(lang: Option<&str>) -> Result<()> {
             .load_fallback_language(&Localizations)
             .map_err(|err| Failure::Message(format!("i18n fallback failed: {err}")))?;
     }
+    LOADED.store(true, Ordering::Release);
+    Ok(())
+}
+
+/// 登记语言但推迟语言包解析，直到第一次 `tr`/`tr_args` 调用（CLI 冷启动用）.
+///
+/// 标识符在此立即校验；之后的加载失败回退到 en-US。.
+///
+/// # Errors
+/// 当语言标识符非法时返回错误。.
+pub fn defer_language(lang: Option<&str>) -> Result<()> {
+    if let Some(lang) = lang {
+        LanguageIdentifier::from_str(lang)
+            .map_err(|_| Failure::Message(format!("invalid language identifier: {lang}")))?;
+    }
+    let mut deferred = DEFERRED.lock().unwrap_or_else(PoisonError::into_inner);
+    *deferred = Some(lang.map(str::to_string));
+    LOADED.store(false, Ordering::Release);
     Ok(())
 }
 
+/// 最近一次延迟加载语言包的耗时；尚未发生延迟加载时返回 `None`.
+#[must_use]
+pub fn deferred_load_duration() -> Option<Duration> {
+    match LOAD_MICROS.load(Ordering::Relaxed) {
+        0 => None,
+        micros => Some(Duration::from_micros(micros)),
+    }
+}
+
+/// Internal helper function.
+fn ensure_loaded() {
+    if LOADED.load(Ordering::Acquire) {
+        return;
+    }
+    let mut deferred = DEFERRED.lock().unwrap_or_else(PoisonError::into_inner);
+    if LOADED.load(Ordering::Acquire) {
+        return;
+    }
+    let Some(lang) = deferred.take() else {
+        // 没有延迟请求：保持原行为（调用方自行 `set_language`），后续调用不再加锁。
+        LOADED.store(true, Ordering::Release);
+        return;
+    };
+    let started = Instant::now();
+    if set_language(lang.as_deref()).is_err() {
+        let _ = set_language(Some("en-US"));
+    }
+    let micros = u64::try_from(started.elapsed().as_micros()).unwrap_or(u64::MAX);
+    LOAD_MICROS.store(micros.max(1), Ordering::Relaxed);
+}
+
 pub fn tr(key: &str) -> String {
+    ensure_loaded();
     LOADER.get(key)
 }
 
 pub fn tr_args(key: &str, args: &FluentArgs) -> String {
+    ensure_loaded();
     LOADER.get_args_fluent(key, Some(args))
 }
 
@@ -117,4 +178,9 @@ mod tests {
         let value = tr("missing.key");
         assert!(value.contains("No localization for id"));
     }
+
+    #[test]
+    fn deferred_language_rejects_invalid_identifier() {
+        assert!(defer_language(Some("not a language!")).is_err());
+    }
 }
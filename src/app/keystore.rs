@@ -1,5 +1,7 @@
 use crate::app::error::{Failure, Result};
-use crate::app::settings_store::{validate_slot, SettingsStore, KEY_SLOT_MAX, KEY_SLOT_MIN};
+use crate::app::settings_store::{
+    cached_settings, update_settings, validate_slot, KEY_SLOT_MAX, KEY_SLOT_MIN,
+};
 use crate::app::{EvidenceSlotUsage, EvidenceStore};
 use keyring::Entry;
 use rand::rngs::OsRng;
@@ -69,7 +71,7 @@ impl KeyStore {
         {
             let store = Self {};
             // Ensure settings table exists and perform one-time legacy migration.
-            let _ = SettingsStore::load()?;
+            let _ = cached_settings()?;
             if test_file_backend_enabled() {
                 return Ok(store);
             }
@@ -81,7 +83,7 @@ impl KeyStore {
         {
             let dpapi_base_dir = dpapi_base_dir()?;
             let store = Self { dpapi_base_dir };
-            let _ = SettingsStore::load()?;
+            let _ = cached_settings()?;
             if test_file_backend_enabled() {
                 return Ok(store);
             }
@@ -93,16 +95,14 @@ impl KeyStore {
     /// # Errors
     /// 当配置存储读取失败时返回错误。.
     pub fn active_slot(&self) -> Result<u8> {
-        let settings = SettingsStore::load()?;
-        settings.active_key_slot()
+        Ok(cached_settings()?.active_key_slot)
     }
 
     /// # Errors
     /// 当槽位非法或配置写入失败时返回错误。.
     pub fn set_active_slot(&self, slot: u8) -> Result<()> {
         validate_slot(slot)?;
-        let settings = SettingsStore::load()?;
-        settings.set_active_key_slot(slot)
+        update_settings(|settings| settings.set_active_key_slot(slot))
     }
 
     #[must_use]
@@ -241,23 +241,30 @@ impl KeyStore {
     /// # Errors
     /// 当任一槽位的配置、证据统计或密钥读取失败时返回错误。.
     pub fn slot_summaries(&self) -> Result<Vec<KeySlotSummary>> {
-        let active_slot = self.active_slot()?;
-        let settings = SettingsStore::load()?;
-        let evidence_store = EvidenceStore::load()?;
+        let settings = cached_settings()?;
+        let active_slot = settings.active_key_slot;
+        // 全部槽位的用量一次读出（物化计数表），不再逐槽聚合。
+        let usage_by_key = EvidenceStore::load()?.usage_by_key()?;
         let mut summaries = Vec::with_capacity(usize::from(KEY_SLOT_MAX) + 1);
 
         for slot in KEY_SLOT_MIN..=KEY_SLOT_MAX {
             let key = self.load_slot(slot).ok();
             let key_id = key.as_ref().map(|bytes| key_id_from_key_material(bytes));
-            let label = settings.slot_label(slot)?;
-            let usage = if let Some(key_id) = key_id.as_deref() {
-                evidence_store.usage_by_slot_and_key_id(slot, key_id)?
-            } else {
-                EvidenceSlotUsage {
-                    count: 0,
-                    last_created_at: None,
-                }
-            };
+            let label = settings.slot_label(slot).map(str::to_string);
+            let usage = key_id
+                .as_deref()
+                .and_then(|key_id| {
+                    usage_by_key
+                        .iter()
+                        .find(|entry| entry.key_slot == slot && entry.key_id == key_id)
+                })
+                .map_or(
+                    EvidenceSlotUsage {
+                        count: 0,
+                        last_created_at: None,
+                    },
+                    |entry| entry.usage,
+                );
             let has_key = key.is_some();
 
             let status_text = if !has_key {
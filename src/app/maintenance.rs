@@ -1,4 +1,6 @@
 use crate::app::error::Result;
+use crate::app::evidence_archive::{apply_retention, ArchiveReport, RetentionPolicy};
+use crate::app::evidence_store::EvidenceStore;
 use crate::app::keystore::KeyStore;
 use crate::app::settings::Preferences;
 use crate::app::tag_store::TagStore;
@@ -28,3 +30,12 @@ pub fn reset_all() -> Result<()> {
     }
     Ok(())
 }
+
+/// 按保留策略把超过期限的证据从热表移入压缩冷归档.
+///
+/// # Errors
+/// 当证据库打开、归档文件写入或 `SQLite` 读写失败时返回错误。.
+pub fn archive_evidence(policy: RetentionPolicy) -> Result<ArchiveReport> {
+    let store = EvidenceStore::load()?;
+    apply_retention(&store, policy)
+}
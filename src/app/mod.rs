@@ -1,7 +1,10 @@
 pub mod audio_engine;
 pub mod audio_proof;
 pub mod error;
+pub mod evidence_archive;
+pub mod evidence_queue;
 pub mod evidence_store;
+pub mod fingerprint_migration;
 pub mod i18n;
 pub mod keystore;
 pub mod maintenance;
@@ -11,17 +14,32 @@ pub mod snr;
 pub mod tag_store;
 
 pub use audio_engine::{AudioEngine, Config, DetectOutcome};
-pub use audio_proof::{build_proof, AudioProof};
+pub use audio_proof::{
+    best_fingerprint_match, build_proof, digest_pcm, is_better_match, AudioProof, PcmDigest,
+};
 pub use error::{Failure, Result};
-pub use evidence_store::{AudioEvidence, EvidenceSlotUsage, EvidenceStore, NewAudioEvidence};
+pub use evidence_archive::{apply_retention, ArchiveReport, RetentionPolicy};
+pub use evidence_queue::{EvidenceJob, EvidenceQueue, QueueStats as EvidenceQueueStats};
+pub use evidence_store::{
+    AudioEvidence, EvidenceKeyUsage, EvidenceSlotUsage, EvidenceStore, FingerprintSource,
+    FingerprintStatus, NewAudioEvidence,
+};
+pub use fingerprint_migration::{
+    migrate_fingerprints, MigrationOptions as FingerprintMigrationOptions,
+    MigrationProgress as FingerprintMigrationProgress,
+};
 pub use i18n::{
-    available_languages, current_language, env_language, set_language, tr, tr_args, LanguageInfo,
+    available_languages, current_language, defer_language, deferred_load_duration, env_language,
+    set_language, tr, tr_args, LanguageInfo,
 };
 pub use keystore::{
     generate_key, key_id_from_key_material, KeyBackend, KeySlotSummary, KeyStore, KEY_LEN,
 };
-pub use maintenance::{clear_local_cache, reset_all};
+pub use maintenance::{archive_evidence, clear_local_cache, reset_all};
 pub use settings::Preferences;
-pub use settings_store::{is_valid_slot, validate_slot, SettingsStore, KEY_SLOT_MAX, KEY_SLOT_MIN};
+pub use settings_store::{
+    cached_settings, is_valid_slot, update_settings, validate_slot, SettingsSnapshot,
+    SettingsStore, KEY_SLOT_MAX, KEY_SLOT_MIN,
+};
 pub use snr::{analyze, Analysis, SNR_STATUS_ERROR, SNR_STATUS_OK, SNR_STATUS_UNAVAILABLE};
 pub use tag_store::{TagEntry, TagStore};
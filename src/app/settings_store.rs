@@ -2,6 +2,7 @@ use crate::app::error::{Failure, Result};
 use rusqlite::{params, Connection, OptionalExtension};
 use std::fs;
 use std::path::{Path, PathBuf};
+use std::sync::{Arc, Mutex, PoisonError};
 use std::time::{SystemTime, UNIX_EPOCH};
 
 /// Minimum valid key slot.
@@ -12,11 +13,16 @@ pub const KEY_SLOT_MAX: u8 = 31;
 const ACTIVE_KEY_SLOT_KEY: &str = "active_key_slot";
 /// Internal constant.
 const UI_LANGUAGE_KEY: &str = "ui_language";
+/// 设置修订号所在的 `app_settings` 行；只由 [`update_settings`] 递增.
+const SETTINGS_REVISION_KEY: &str = "settings_revision";
 /// Internal constant.
 const UI_LANG_ZH_CN: &str = "zh-CN";
 /// Internal constant.
 const UI_LANG_EN_US: &str = "en-US";
 
+/// 进程级共享连接与设置快照.
+static SHARED: Mutex<Option<SharedSettings>> = Mutex::new(None);
+
 /// App-level settings store backed by sqlite.
 pub struct SettingsStore {
     /// Internal field.
@@ -36,6 +42,24 @@ impl SettingsStore {
         Ok(Self { conn, path })
     }
 
+    #[cfg(test)]
+    pub(crate) fn load_at(path: PathBuf) -> Result<Self> {
+        let conn = open_db(&path)?;
+        Ok(Self { conn, path })
+    }
+
+    /// 一次读出全部设置.
+    ///
+    /// # Errors
+    /// 当读取 `SQLite` 配置失败时返回错误。.
+    pub fn snapshot(&self) -> Result<SettingsSnapshot> {
+        Ok(SettingsSnapshot {
+            active_key_slot: self.active_key_slot()?,
+            ui_language: self.ui_language()?,
+            slot_labels: self.list_slot_labels()?,
+        })
+    }
+
     /// Read active key slot. Missing/invalid value falls back to 0.
     ///
     /// # Errors
@@ -213,6 +237,149 @@ impl SettingsStore {
     pub fn path(&self) -> &Path {
         &self.path
     }
+
+    /// 设置修订号；共享库中证据、指纹等其他表的提交不改变它.
+    fn revision(&self) -> Result<i64> {
+        let value: Option<i64> = self
+            .conn
+            .query_row(
+                "SELECT CAST(value AS INTEGER) FROM app_settings WHERE key = ?1 LIMIT 1",
+                params![SETTINGS_REVISION_KEY],
+                |row| row.get(0),
+            )
+            .optional()?;
+        Ok(value.unwrap_or(0))
+    }
+
+    /// 递增设置修订号，通知其他连接与进程重新读取快照.
+    fn bump_revision(&self) -> Result<()> {
+        self.conn.execute(
+            "INSERT INTO app_settings (key, value, updated_at)
+             VALUES (?1, '1', ?2)
+             ON CONFLICT(key) DO UPDATE SET
+                value = CAST(value AS INTEGER) + 1,
+                updated_at = excluded.updated_at",
+            params![SETTINGS_REVISION_KEY, now_ts()?],
+        )?;
+        Ok(())
+    }
+}
+
+/// 某一时刻的全部设置.
+#[derive(Debug, Clone)]
+pub struct SettingsSnapshot {
+    pub active_key_slot: u8,
+    pub ui_language: Option<String>,
+    /// 非空槽位标签，按槽位升序.
+    pub slot_labels: Vec<(u8, String)>,
+}
+
+impl SettingsSnapshot {
+    /// 槽位标签（去除首尾空白）.
+    #[must_use]
+    pub fn slot_label(&self, slot: u8) -> Option<&str> {
+        self.slot_labels
+            .iter()
+            .find(|(labelled, _)| *labelled == slot)
+            .map(|(_, label)| label.trim())
+            .filter(|label| !label.is_empty())
+    }
+}
+
+/// Internal struct.
+struct SharedSettings {
+    /// Internal field.
+    store: SettingsStore,
+    /// 快照读取前的设置修订号.
+    revision: i64,
+    /// Internal field.
+    snapshot: Arc<SettingsSnapshot>,
+}
+
+impl SharedSettings {
+    /// Internal helper method.
+    fn open(store: SettingsStore) -> Result<Self> {
+        let revision = store.revision()?;
+        let snapshot = Arc::new(store.snapshot()?);
+        Ok(Self {
+            store,
+            revision,
+            snapshot,
+        })
+    }
+
+    /// 设置被其他连接修改过时重新读取快照.
+    fn sync(&mut self) -> Result<()> {
+        let revision = self.store.revision()?;
+        if revision != self.revision {
+            self.reload(revision)?;
+        }
+        Ok(())
+    }
+
+    /// Internal helper method.
+    fn reload(&mut self, revision: i64) -> Result<()> {
+        self.snapshot = Arc::new(self.store.snapshot()?);
+        self.revision = revision;
+        Ok(())
+    }
+}
+
+/// 进程级设置快照.
+///
+/// 首次调用打开共享连接；之后每次只比较一次设置修订号，其他连接或进程通过
+/// [`update_settings`] 修改过设置时才重新读取，共享库中证据等其他表的写入不会使快照失效，
+/// 批量循环与 FFI 轮询中的槽位/标签读取都落在内存里。.
+///
+/// # Errors
+/// 当数据库路径解析、`SQLite` 打开或读取失败时返回错误。.
+pub fn cached_settings() -> Result<Arc<SettingsSnapshot>> {
+    let mut guard = SHARED.lock().unwrap_or_else(PoisonError::into_inner);
+    let shared = shared_settings(&mut guard)?;
+    Ok(Arc::clone(&shared.snapshot))
+}
+
+/// 通过进程级共享连接写入设置、递增修订号并刷新快照.
+///
+/// 设置写入须经由此函数，其他进程的 [`cached_settings`] 才能看到变化.
+///
+/// # Errors
+/// 当共享连接不可用、`write` 失败或快照刷新失败时返回错误。.
+pub fn update_settings<T>(write: impl FnOnce(&SettingsStore) -> Result<T>) -> Result<T> {
+    let mut guard = SHARED.lock().unwrap_or_else(PoisonError::into_inner);
+    let shared = shared_settings(&mut guard)?;
+    let written = write(&shared.store);
+    // 失败的写入也可能部分生效，同样递增修订号并刷新。
+    let refreshed = shared
+        .store
+        .bump_revision()
+        .and_then(|()| shared.store.revision())
+        .and_then(|revision| shared.reload(revision));
+    if refreshed.is_err() {
+        *guard = None;
+    }
+    let value = written?;
+    refreshed?;
+    Ok(value)
+}
+
+/// 取得（必要时重新打开）共享连接，并与数据库同步.
+fn shared_settings(slot: &mut Option<SharedSettings>) -> Result<&mut SharedSettings> {
+    let path = db_path()?;
+    let stale = match slot.as_mut() {
+        // 数据目录（如 `HOME`）变化或连接失效时重新打开。
+        Some(shared) => shared.store.path != path || shared.sync().is_err(),
+        None => true,
+    };
+    if stale {
+        *slot = None;
+        *slot = Some(SharedSettings::open(SettingsStore {
+            conn: open_db(&path)?,
+            path,
+        })?);
+    }
+    slot.as_mut()
+        .ok_or_else(|| Failure::Message("settings cache unavailable".to_string()))
 }
 
 /// Internal helper function.
@@ -300,7 +467,55 @@ fn now_ts() -> Result<u64> {
 
 #[cfg(test)]
 mod tests {
-    use super::normalize_ui_language;
+    use super::{normalize_ui_language, SettingsStore, SharedSettings};
+    use std::path::PathBuf;
+
+    fn temp_db_path() -> PathBuf {
+        let nanos = std::time::SystemTime::now()
+            .duration_since(std::time::UNIX_EPOCH)
+            .map_or(0, |duration| duration.as_nanos());
+        std::env::temp_dir().join(format!("awmkit-settings-{}-{nanos}.db", std::process::id()))
+    }
+
+    #[test]
+    fn shared_snapshot_picks_up_external_writes() {
+        let path = temp_db_path();
+        let shared = SettingsStore::load_at(path.clone()).and_then(SharedSettings::open);
+        assert!(shared.is_ok());
+        let Ok(mut shared) = shared else {
+            return;
+        };
+        assert_eq!(shared.snapshot.active_key_slot, 0);
+
+        let external = SettingsStore::load_at(path.clone());
+        assert!(external.is_ok());
+        let Ok(external) = external else {
+            return;
+        };
+        assert!(external.set_active_key_slot(7).is_ok());
+        assert!(external.set_slot_label(7, "  studio  ").is_ok());
+        // 修订号未变时不重新读取。
+        assert!(shared.sync().is_ok());
+        assert_eq!(shared.snapshot.active_key_slot, 0);
+        assert!(external.bump_revision().is_ok());
+        assert!(shared.sync().is_ok());
+        assert_eq!(shared.snapshot.active_key_slot, 7);
+        assert_eq!(shared.snapshot.slot_label(7), Some("studio"));
+        assert_eq!(shared.snapshot.slot_label(3), None);
+
+        // 共享库中其他表的提交不使快照失效（同一个 Arc）。
+        let before = std::sync::Arc::clone(&shared.snapshot);
+        let unrelated = external
+            .conn
+            .execute_batch("CREATE TABLE other (id INTEGER); INSERT INTO other VALUES (1);");
+        assert!(unrelated.is_ok());
+        assert!(shared.sync().is_ok());
+        assert!(std::sync::Arc::ptr_eq(&before, &shared.snapshot));
+
+        drop(shared);
+        drop(external);
+        let _ = std::fs::remove_file(path);
+    }
 
     #[test]
     fn normalize_supported_ui_language() {
@@ -2,8 +2,9 @@
 //!
 //! 封装 audiowmark 命令行工具.
 
+use std::collections::BTreeMap;
 use std::path::{Path, PathBuf};
-use std::process::{Command, Output, Stdio};
+use std::process::{Child, Command, ExitStatus, Output, Stdio};
 use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::{Arc, Mutex, PoisonError, RwLock};
 use std::time::{Duration, Instant};
@@ -13,17 +14,21 @@ use std::{
     io::{BufReader, BufWriter, Read, Seek, SeekFrom, Write},
 };
 
+use crate::buffer_pool;
+use crate::cancel::CancellationToken;
 use crate::error::{Error, Result};
 #[cfg(any(feature = "ffmpeg-decode", feature = "multichannel"))]
 use crate::media;
 use crate::message::{self, MESSAGE_LEN};
 use crate::tag::Tag;
 
+#[cfg(feature = "multichannel")]
+use crate::media::wav_map::{InterleavedView, MappedWav};
 #[cfg(all(test, feature = "multichannel"))]
-use crate::multichannel::DEFAULT_LFE_MODE;
+use crate::multichannel::{build_smart_route_plan, DEFAULT_LFE_MODE};
 #[cfg(feature = "multichannel")]
 use crate::multichannel::{
-    build_smart_route_plan, effective_lfe_mode, AudioBuffer, ChannelLayout, RouteMode, RouteStep,
+    effective_lfe_mode, AudioBuffer, ChannelLayout, ChannelMirror, RouteMode, RoutePlan, RouteStep,
 };
 #[cfg(feature = "multichannel")]
 use rayon::prelude::*;
@@ -37,11 +42,15 @@ const DEFAULT_SEARCH_PATHS: &[&str] = &["audiowmark"];
 /// Windows 匿名管道内核缓冲区默认只有 4 KB，直接用 `io::copy` 的 8 KB 块写会频繁
 /// 触发系统调用切换。用 `BufWriter`/`BufReader` 在用户态积累更大的块，可显著减少
 /// Windows 上的上下文切换次数；在 macOS/Linux 上也能减少 syscall 开销。.
-const PIPE_BUF_SIZE: usize = 256 * 1024;
+pub(crate) const PIPE_BUF_SIZE: usize = 256 * 1024;
 /// audiowmark 0.6.x 候选分数阈值（低于此值通常为伪命中）.
 const MIN_PATTERN_SCORE: f32 = 1.0;
 /// 进度事件节流间隔（20Hz）.
 const PROGRESS_THROTTLE: Duration = Duration::from_millis(50);
+/// 已结束操作的进度槽位保留数量（运行中的槽位不计入）.
+const PROGRESS_FINISHED_RETAIN: usize = 16;
+/// 等待 audiowmark 子进程时轮询取消令牌的间隔.
+const CHILD_CANCEL_POLL: Duration = Duration::from_millis(20);
 
 /// 媒体解码能力摘要（用于 doctor/UI 状态）.
 #[derive(Debug, Clone, Copy)]
@@ -148,6 +157,47 @@ pub struct DetectResult {
     pub match_found: bool,
 }
 
+/// 嵌入后内存校验结果（`embed_multichannel_verified`）.
+#[cfg(feature = "multichannel")]
+#[derive(Debug, Clone)]
+pub struct EmbedVerification {
+    /// 参与校验的路由步骤名（立体声路径为 `stereo`）.
+    pub step: String,
+    /// 校验检测结果（`None` 表示未检出水印）.
+    pub result: Option<DetectResult>,
+    /// 检出的消息是否与嵌入消息一致.
+    pub passed: bool,
+}
+
+#[cfg(feature = "multichannel")]
+impl EmbedVerification {
+    /// Internal associated function.
+    pub(crate) fn new(
+        step: &str,
+        result: Option<DetectResult>,
+        message: &[u8; MESSAGE_LEN],
+    ) -> Self {
+        let passed = result
+            .as_ref()
+            .is_some_and(|detect| detect.raw_message == *message);
+        Self {
+            step: step.to_string(),
+            result,
+            passed,
+        }
+    }
+}
+
+/// 扇出嵌入的单个接收方（`embed_many`）.
+#[cfg(feature = "multichannel")]
+#[derive(Debug, Clone)]
+pub struct EmbedRecipient {
+    /// 嵌入该接收方的 16 字节消息.
+    pub message: [u8; MESSAGE_LEN],
+    /// 输出路径（WAV）.
+    pub output: PathBuf,
+}
+
 /// 多声道检测结果.
 #[cfg(feature = "multichannel")]
 #[derive(Debug, Clone)]
@@ -158,6 +208,90 @@ pub struct MultichannelDetectResult {
     pub best: Option<DetectResult>,
 }
 
+/// 多密钥检测中单个密钥的结果.
+#[cfg(feature = "multichannel")]
+#[derive(Debug, Clone)]
+pub struct KeyDetectResult {
+    /// 密钥文件.
+    pub key_file: PathBuf,
+    /// 该密钥在各路由步骤上的检测结果.
+    pub detect: MultichannelDetectResult,
+    /// 该密钥的结果是否已确定：所有路由步骤都已检测完毕，或该密钥完美命中（剩余步骤随之
+    /// 跳过）；因其他密钥完美命中而提前停止时为 `false`.
+    pub completed: bool,
+}
+
+/// 实时监测参数（[`Audio::monitor`]）.
+#[cfg(all(feature = "multichannel", feature = "ffmpeg-decode"))]
+#[derive(Debug, Clone, Copy)]
+pub struct MonitorConfig {
+    /// 检测窗口时长（秒），需容纳至少一个完整水印块.
+    pub window_secs: u32,
+    /// 相邻窗口终点的间隔（秒）.
+    pub hop_secs: u32,
+    /// 同时检测的窗口数上限.
+    pub workers: usize,
+}
+
+#[cfg(all(feature = "multichannel", feature = "ffmpeg-decode"))]
+impl Default for MonitorConfig {
+    fn default() -> Self {
+        Self {
+            window_secs: 180,
+            hop_secs: 30,
+            workers: std::thread::available_parallelism().map_or(1, std::num::NonZero::get),
+        }
+    }
+}
+
+/// 实时监测中一个窗口的命中.
+#[cfg(all(feature = "multichannel", feature = "ffmpeg-decode"))]
+#[derive(Debug, Clone)]
+pub struct MonitorHit {
+    /// 窗口起点（相对流开始，秒）.
+    pub window_start_secs: f64,
+    /// 窗口终点（相对流开始，秒）.
+    pub window_end_secs: f64,
+    /// 检测结果.
+    pub result: DetectResult,
+    /// 窗口凑齐到检测完成的耗时（毫秒）.
+    pub latency_ms: u64,
+}
+
+/// 实时监测结束时的统计.
+#[cfg(all(feature = "multichannel", feature = "ffmpeg-decode"))]
+#[derive(Debug, Clone, Default)]
+pub struct MonitorReport {
+    /// 已解码的音频时长（秒）.
+    pub audio_secs: f64,
+    /// 已检测的窗口数.
+    pub windows: u64,
+    /// 检测跟不上输入而跳过的窗口数.
+    pub windows_dropped: u64,
+    /// audiowmark 执行失败的窗口数（不计入 `windows`）.
+    pub windows_failed: u64,
+    /// 第一个失败窗口的错误信息.
+    pub first_error: Option<String>,
+    /// 命中窗口数.
+    pub hits: u64,
+    /// 窗口检测平均延迟（毫秒）.
+    pub latency_mean_ms: u64,
+    /// 窗口检测最大延迟（毫秒）.
+    pub latency_max_ms: u64,
+    /// 监测期间本进程与 audiowmark 子进程消耗的 CPU 时间（秒；平台不支持时为 `None`）.
+    pub cpu_secs: Option<f64>,
+}
+
+#[cfg(all(feature = "multichannel", feature = "ffmpeg-decode"))]
+impl MonitorReport {
+    /// 每小时音频流消耗的 CPU 秒数，用于估算监测主机容量.
+    #[must_use]
+    pub fn cpu_secs_per_stream_hour(&self) -> Option<f64> {
+        let cpu = self.cpu_secs?;
+        (self.audio_secs > 0.0).then(|| cpu * 3600.0 / self.audio_secs)
+    }
+}
+
 /// 进度所属操作类型.
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
 #[repr(u8)]
@@ -286,14 +420,22 @@ impl<'a> PhaseParams<'a> {
     }
 }
 
+/// 单个操作的进度槽位.
+struct ProgressSlot {
+    /// 该操作的最新快照.
+    snapshot: ProgressSnapshot,
+    /// 该操作上次推送回调的时间（节流按操作独立计算）.
+    last_emit: Option<Instant>,
+}
+
 /// Internal struct.
 struct ProgressTracker {
-    /// 最新快照（用于 polling）.
-    snapshot: RwLock<ProgressSnapshot>,
+    /// 按 op id 索引的进度槽位；并发操作各占一个槽位.
+    slots: Mutex<BTreeMap<u64, ProgressSlot>>,
+    /// 最近一次有进度变化的 op id（兼容单操作 polling）.
+    latest_op: AtomicU64,
     /// 回调（用于 push）.
     callback: RwLock<Option<ProgressCallback>>,
-    /// 节流时间戳.
-    last_emit: Mutex<Option<Instant>>,
     /// 递增操作 id.
     op_seq: AtomicU64,
 }
@@ -310,34 +452,55 @@ impl ProgressTracker {
     /// Internal associated function.
     fn new() -> Self {
         Self {
-            snapshot: RwLock::new(ProgressSnapshot::default()),
+            slots: Mutex::new(BTreeMap::new()),
+            latest_op: AtomicU64::new(0),
             callback: RwLock::new(None),
-            last_emit: Mutex::new(None),
             op_seq: AtomicU64::new(0),
         }
     }
 
     /// Internal helper method.
     fn set_callback(&self, callback: Option<ProgressCallback>) {
-        let mut guard = self.callback.write().unwrap_or_else(PoisonError::into_inner);
+        let mut guard = self
+            .callback
+            .write()
+            .unwrap_or_else(PoisonError::into_inner);
         *guard = callback;
     }
 
     /// Internal helper method.
     fn snapshot(&self) -> ProgressSnapshot {
-        self.snapshot
-            .read()
+        self.snapshot_for_op(self.latest_op.load(Ordering::Acquire))
+            .unwrap_or_default()
+    }
+
+    /// Internal helper method.
+    fn snapshot_for_op(&self, op_id: u64) -> Option<ProgressSnapshot> {
+        self.slots
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+            .get(&op_id)
+            .map(|slot| slot.snapshot.clone())
+    }
+
+    /// Internal helper method.
+    fn op_ids(&self) -> Vec<u64> {
+        self.slots
+            .lock()
             .unwrap_or_else(PoisonError::into_inner)
-            .clone()
+            .keys()
+            .copied()
+            .collect()
     }
 
     /// Internal helper method.
     fn clear(&self) {
-        {
-            let mut guard = self.snapshot.write().unwrap_or_else(PoisonError::into_inner);
-            *guard = ProgressSnapshot::default();
-        }
-        self.emit(true);
+        self.slots
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+            .clear();
+        self.latest_op.store(0, Ordering::Release);
+        self.dispatch(ProgressSnapshot::default());
     }
 
     /// Internal helper method.
@@ -346,102 +509,109 @@ impl ProgressTracker {
             .op_seq
             .fetch_add(1, Ordering::Relaxed)
             .saturating_add(1);
-        {
-            let mut snapshot = self.snapshot.write().unwrap_or_else(PoisonError::into_inner);
-            snapshot.operation = operation;
-            snapshot.phase = phase;
-            snapshot.state = ProgressState::Running;
-            snapshot.determinate = false;
-            snapshot.completed_units = 0;
-            snapshot.total_units = 0;
-            snapshot.step_index = 0;
-            snapshot.step_total = 0;
-            snapshot.op_id = op_id;
-            snapshot.phase_label.clear();
-            snapshot.phase_label.push_str(label);
-        }
-        self.emit(true);
+        let snapshot = ProgressSnapshot {
+            operation,
+            phase,
+            state: ProgressState::Running,
+            op_id,
+            phase_label: label.to_string(),
+            ..ProgressSnapshot::default()
+        };
+        self.slots
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+            .insert(
+                op_id,
+                ProgressSlot {
+                    snapshot: snapshot.clone(),
+                    last_emit: Some(Instant::now()),
+                },
+            );
+        self.latest_op.store(op_id, Ordering::Release);
+        self.dispatch(snapshot);
         op_id
     }
 
-    /// Internal helper method.
-    fn update_current<F>(&self, force: bool, mutator: F)
-    where
-        F: FnOnce(&mut ProgressSnapshot) -> bool,
-    {
-        let mut immediate = force;
-        {
-            let mut snapshot = self.snapshot.write().unwrap_or_else(PoisonError::into_inner);
-            if snapshot.state != ProgressState::Running || snapshot.op_id == 0 {
-                drop(snapshot);
-                return;
-            }
-            if mutator(&mut snapshot) {
-                immediate = true;
-            }
-        }
-        self.emit(immediate);
-    }
-
     /// Internal helper method.
     fn update_for_op<F>(&self, op_id: u64, force: bool, mutator: F)
     where
         F: FnOnce(&mut ProgressSnapshot) -> bool,
     {
-        let mut immediate = force;
-        {
-            let mut snapshot = self.snapshot.write().unwrap_or_else(PoisonError::into_inner);
-            if snapshot.op_id != op_id || snapshot.state != ProgressState::Running {
-                drop(snapshot);
+        let emitted = {
+            let mut slots = self.slots.lock().unwrap_or_else(PoisonError::into_inner);
+            let Some(slot) = slots.get_mut(&op_id) else {
+                return;
+            };
+            if slot.snapshot.state != ProgressState::Running {
                 return;
             }
-            if mutator(&mut snapshot) {
-                immediate = true;
-            }
+            let immediate = mutator(&mut slot.snapshot) || force;
+            Self::take_emit(slot, immediate)
+        };
+        self.latest_op.store(op_id, Ordering::Release);
+        if let Some(snapshot) = emitted {
+            self.dispatch(snapshot);
         }
-        self.emit(immediate);
     }
 
     /// Internal helper method.
     fn finish(&self, op_id: u64, ok: bool, label: &str) {
-        {
-            let mut snapshot = self.snapshot.write().unwrap_or_else(PoisonError::into_inner);
-            if snapshot.op_id != op_id {
+        let snapshot = {
+            let mut slots = self.slots.lock().unwrap_or_else(PoisonError::into_inner);
+            let Some(slot) = slots.get_mut(&op_id) else {
                 return;
-            }
-            snapshot.phase = ProgressPhase::Finalize;
-            snapshot.phase_label.clear();
-            snapshot.phase_label.push_str(label);
-            snapshot.state = if ok {
+            };
+            slot.snapshot.phase = ProgressPhase::Finalize;
+            slot.snapshot.phase_label.clear();
+            slot.snapshot.phase_label.push_str(label);
+            slot.snapshot.state = if ok {
                 ProgressState::Completed
             } else {
                 ProgressState::Failed
             };
-        }
-        self.emit(true);
+            let snapshot = slot.snapshot.clone();
+            Self::prune_finished(&mut slots);
+            snapshot
+        };
+        self.latest_op.store(op_id, Ordering::Release);
+        self.dispatch(snapshot);
     }
 
-    /// Internal helper method.
-    fn emit(&self, force: bool) {
+    /// 节流判定：需要推送时返回快照副本并刷新时间戳.
+    fn take_emit(slot: &mut ProgressSlot, force: bool) -> Option<ProgressSnapshot> {
+        if !force
+            && slot
+                .last_emit
+                .is_some_and(|last| last.elapsed() < PROGRESS_THROTTLE)
         {
-            let mut gate = self.last_emit.lock().unwrap_or_else(PoisonError::into_inner);
-            if !force {
-                if let Some(last) = *gate {
-                    if last.elapsed() < PROGRESS_THROTTLE {
-                        return;
-                    }
-                }
-            }
-            *gate = Some(Instant::now());
+            return None;
         }
+        slot.last_emit = Some(Instant::now());
+        Some(slot.snapshot.clone())
+    }
 
+    /// 仅保留最近 [`PROGRESS_FINISHED_RETAIN`] 个已结束槽位，运行中的槽位不受影响.
+    fn prune_finished(slots: &mut BTreeMap<u64, ProgressSlot>) {
+        let finished: Vec<u64> = slots
+            .iter()
+            .filter(|(_, slot)| slot.snapshot.state != ProgressState::Running)
+            .map(|(op_id, _)| *op_id)
+            .collect();
+        let excess = finished.len().saturating_sub(PROGRESS_FINISHED_RETAIN);
+        for op_id in finished.into_iter().take(excess) {
+            slots.remove(&op_id);
+        }
+    }
+
+    /// 在锁外调用回调，避免宿主回调重入时死锁.
+    fn dispatch(&self, snapshot: ProgressSnapshot) {
         let callback = self
             .callback
             .read()
             .unwrap_or_else(PoisonError::into_inner)
             .clone();
         if let Some(cb) = callback {
-            cb(self.snapshot());
+            cb(snapshot);
         }
     }
 }
@@ -457,6 +627,10 @@ pub struct Audio {
     key_file: Option<PathBuf>,
     /// 进度追踪器（callback + polling 共享源）.
     progress_tracker: Arc<ProgressTracker>,
+    /// 协作式取消令牌（克隆共享）.
+    cancel_token: CancellationToken,
+    /// 当前作用域绑定的操作 id（0 表示未绑定，仅在操作内部的作用域副本上非零）.
+    active_op: u64,
 }
 
 #[derive(Clone, Copy, Debug, PartialEq, Eq)]
@@ -535,25 +709,25 @@ struct PreparedInput {
 #[cfg(feature = "multichannel")]
 #[derive(Debug)]
 /// Internal struct.
-struct EmbedStepTaskResult {
+pub(crate) struct EmbedStepTaskResult {
     /// Internal field.
-    step_idx: usize,
+    pub(crate) step_idx: usize,
     /// Internal field.
-    step: RouteStep,
+    pub(crate) step: RouteStep,
     /// Internal field.
-    outcome: Result<AudioBuffer>,
+    pub(crate) outcome: Result<AudioBuffer>,
 }
 
 #[cfg(feature = "multichannel")]
 #[derive(Debug)]
 /// Internal struct.
-struct DetectStepTaskResult {
+pub(crate) struct DetectStepTaskResult {
     /// Internal field.
-    step_idx: usize,
+    pub(crate) step_idx: usize,
     /// Internal field.
-    step: RouteStep,
+    pub(crate) step: RouteStep,
     /// Internal field.
-    outcome: Option<DetectResult>,
+    pub(crate) outcome: Option<DetectResult>,
 }
 
 impl Audio {
@@ -572,6 +746,43 @@ impl Audio {
         Command::new(&self.binary_path)
     }
 
+    /// Internal helper method: stdin/stdout 均为 wav-pipe 的 `add` 命令.
+    pub(crate) fn add_wav_pipe_command(&self, message_hex: &str) -> Command {
+        let mut cmd = self.audiowmark_command();
+        cmd.arg("add")
+            .arg("--strength")
+            .arg(self.strength.to_string())
+            .arg("--input-format")
+            .arg("wav-pipe")
+            .arg("--output-format")
+            .arg("wav-pipe");
+
+        if let Some(ref key_file) = self.key_file {
+            cmd.arg("--key").arg(key_file);
+        }
+
+        cmd.arg("-").arg("-").arg(message_hex);
+        cmd
+    }
+
+    /// Internal helper method: 从 stdin 读取 WAV 的 `get` 命令.
+    pub(crate) fn get_wav_pipe_command(&self) -> Command {
+        self.get_wav_pipe_command_with_key(self.key_file.as_deref())
+    }
+
+    /// Internal helper method: 使用指定密钥（而非 `self.key_file`）的 `get` 管道命令.
+    pub(crate) fn get_wav_pipe_command_with_key(&self, key_file: Option<&Path>) -> Command {
+        let mut cmd = self.audiowmark_command();
+        cmd.arg("get");
+
+        if let Some(key_file) = key_file {
+            cmd.arg("--key").arg(key_file);
+        }
+
+        cmd.arg("-");
+        cmd
+    }
+
     /// 创建 Audio 实例，自动搜索 audiowmark.
     ///
     /// # Errors
@@ -588,6 +799,8 @@ impl Audio {
             strength: 10,
             key_file: None,
             progress_tracker: Arc::new(ProgressTracker::new()),
+            cancel_token: CancellationToken::new(),
+            active_op: 0,
         })
     }
 
@@ -605,6 +818,8 @@ impl Audio {
             strength: 10,
             key_file: None,
             progress_tracker: Arc::new(ProgressTracker::new()),
+            cancel_token: CancellationToken::new(),
+            active_op: 0,
         })
     }
 
@@ -622,6 +837,24 @@ impl Audio {
         self
     }
 
+    /// 绑定取消令牌；令牌取消后进行中的操作尽快返回 [`Error::Cancelled`].
+    #[must_use]
+    pub fn cancel_token(mut self, token: CancellationToken) -> Self {
+        self.cancel_token = token;
+        self
+    }
+
+    /// 换上新的未取消令牌，其余配置保持不变.
+    pub fn reset_cancellation(&mut self) {
+        self.cancel_token = CancellationToken::new();
+    }
+
+    /// 返回当前绑定的取消令牌.
+    #[must_use]
+    pub const fn cancellation(&self) -> &CancellationToken {
+        &self.cancel_token
+    }
+
     /// 返回 audiowmark 二进制路径.
     #[must_use]
     pub fn binary_path(&self) -> &Path {
@@ -640,6 +873,20 @@ impl Audio {
         self.progress_tracker.snapshot()
     }
 
+    /// 读取指定操作的进度快照；该操作未知或已被淘汰时返回 `None`.
+    ///
+    /// 同一实例可被多个线程共享并发执行 embed/detect，每个操作拥有独立的进度槽位。.
+    #[must_use]
+    pub fn progress_snapshot_for_op(&self, op_id: u64) -> Option<ProgressSnapshot> {
+        self.progress_tracker.snapshot_for_op(op_id)
+    }
+
+    /// 列出当前保留进度槽位的操作 id（升序；含运行中与最近结束的操作）.
+    #[must_use]
+    pub fn progress_op_ids(&self) -> Vec<u64> {
+        self.progress_tracker.op_ids()
+    }
+
     /// 清空进度状态（回到 idle）.
     pub fn clear_progress(&self) {
         self.progress_tracker.clear();
@@ -679,32 +926,22 @@ impl Audio {
 
     /// Internal helper method.
     fn progress_set_current_phase(&self, p: &PhaseParams<'_>) {
-        self.progress_tracker.update_current(false, |snapshot| {
-            let phase_changed = snapshot.phase != p.phase
-                || snapshot.phase_label != p.phase_label
-                || snapshot.determinate != p.determinate
-                || snapshot.step_index != p.step_index
-                || snapshot.step_total != p.step_total;
-            snapshot.phase = p.phase;
-            snapshot.phase_label.clear();
-            snapshot.phase_label.push_str(p.phase_label);
-            snapshot.determinate = p.determinate;
-            snapshot.completed_units = p.completed_units;
-            snapshot.total_units = p.total_units;
-            snapshot.step_index = p.step_index;
-            snapshot.step_total = p.step_total;
-            phase_changed
-        });
+        self.progress_set_phase_for_op(self.active_op, p);
     }
 
     /// Internal helper method.
-    fn progress_update_current_units(&self, completed_units: u64, total_units: Option<u64>) {
-        self.progress_tracker.update_current(false, |snapshot| {
-            snapshot.completed_units = completed_units;
-            snapshot.total_units = total_units.unwrap_or(0);
-            snapshot.determinate = total_units.is_some();
-            false
-        });
+    pub(crate) fn progress_update_current_units(
+        &self,
+        completed_units: u64,
+        total_units: Option<u64>,
+    ) {
+        self.progress_tracker
+            .update_for_op(self.active_op, false, |snapshot| {
+                snapshot.completed_units = completed_units;
+                snapshot.total_units = total_units.unwrap_or(0);
+                snapshot.determinate = total_units.is_some();
+                false
+            });
     }
 
     /// Internal helper method.
@@ -712,6 +949,14 @@ impl Audio {
         self.progress_tracker.finish(op_id, ok, label);
     }
 
+    /// 返回绑定到 `op_id` 的作用域副本；其内部的进度上报只写入该操作的槽位.
+    fn scoped_to_op(&self, op_id: u64) -> Self {
+        Self {
+            active_op: op_id,
+            ..self.clone()
+        }
+    }
+
     /// 嵌入水印消息到音频.
     ///
     /// # Arguments
@@ -728,27 +973,29 @@ impl Audio {
         message: &[u8; MESSAGE_LEN],
     ) -> Result<()> {
         let op_id = self.progress_begin_operation(ProgressOperation::Embed, "prepare_input");
+        let this = &self.scoped_to_op(op_id);
         let result = (|| {
+            this.cancel_token.check()?;
             let input = input.as_ref();
             let output = output.as_ref();
             validate_embed_output_path(output)?;
             #[cfg(feature = "multichannel")]
             if media::adm_bwav::probe_adm_bwf(input)?.is_some() {
-                self.progress_set_phase_for_op(
+                this.progress_set_phase_for_op(
                     op_id,
                     &PhaseParams::indeterminate(ProgressPhase::Core, "embed_adm"),
                 );
                 return media::adm_embed::embed_adm_multichannel(
-                    self, input, output, message, None,
+                    this, input, output, message, None,
                 );
             }
-            let prepared = prepare_input_for_audiowmark(input, "embed_input")?;
+            let prepared = prepare_input_for_audiowmark(input, "embed_input", &this.cancel_token)?;
             let hex = bytes_to_hex(message);
-            self.progress_set_phase_for_op(
+            this.progress_set_phase_for_op(
                 op_id,
                 &PhaseParams::indeterminate(ProgressPhase::Core, "embed_core"),
             );
-            run_audiowmark_add_prepared(self, &prepared.path, output, &hex)
+            run_audiowmark_add_prepared(this, &prepared.path, output, &hex)
         })();
         self.progress_finish_operation(op_id, result.is_ok(), "embed_done");
         result
@@ -783,13 +1030,15 @@ impl Audio {
     /// 当输入格式不支持、外部 `audiowmark` 执行失败或输出解析异常时返回错误。.
     pub fn detect<P: AsRef<Path>>(&self, input: P) -> Result<Option<DetectResult>> {
         let op_id = self.progress_begin_operation(ProgressOperation::Detect, "prepare_input");
+        let this = &self.scoped_to_op(op_id);
         let result = (|| {
+            this.cancel_token.check()?;
             let input = input.as_ref();
-            self.progress_set_phase_for_op(
+            this.progress_set_phase_for_op(
                 op_id,
                 &PhaseParams::indeterminate(ProgressPhase::Core, "detect_core"),
             );
-            let output = run_audiowmark_get_detect(self, input)?;
+            let output = run_audiowmark_get_detect(this, input)?;
             let stdout = String::from_utf8_lossy(&output.stdout);
             let stderr = String::from_utf8_lossy(&output.stderr);
             Ok(parse_detect_output(&stdout, &stderr))
@@ -850,8 +1099,10 @@ impl Audio {
         output: &Path,
         message: &[u8; MESSAGE_LEN],
         executable_steps: &[(usize, RouteStep)],
+        mirrors: &[ChannelMirror],
         step_total: u32,
-    ) -> Result<()> {
+        verify: bool,
+    ) -> Result<Option<EmbedVerification>> {
         self.progress_set_phase_for_op(
             op_id,
             &PhaseParams {
@@ -865,7 +1116,11 @@ impl Audio {
             },
         );
         let step_done = Arc::new(AtomicU64::new(0));
-        let parallelism = compute_route_parallelism(executable_steps.len());
+        let parallelism = if audio.num_channels() > LARGE_ROUTE_CHANNELS {
+            large_route_parallelism(executable_steps.len())
+        } else {
+            compute_route_parallelism(executable_steps.len())
+        };
         let mut step_results = with_route_thread_pool(parallelism, || {
             executable_steps
                 .par_iter()
@@ -900,16 +1155,47 @@ impl Audio {
                 })
                 .collect::<Vec<_>>()
         })?;
+        // 失败步骤会以"保持原样"降级合并；取消时必须在写出前中止，避免留下部分嵌入的输出。
+        self.cancel_token.check()?;
         self.progress_set_phase_for_op(
             op_id,
             &PhaseParams::indeterminate(ProgressPhase::Merge, "merge_route"),
         );
-        apply_embed_step_results(&mut audio, &mut step_results);
+        apply_embed_step_results(&mut audio, &mut step_results, mirrors);
+        for step_result in step_results {
+            if let Ok(processed) = step_result.outcome {
+                processed.recycle();
+            }
+        }
         self.progress_set_phase_for_op(
             op_id,
             &PhaseParams::indeterminate(ProgressPhase::Finalize, "write_output"),
         );
-        audio.to_wav(output)
+        let primary = if verify {
+            primary_route_step(executable_steps)
+        } else {
+            None
+        };
+        let Some(primary) = primary else {
+            let written = audio.to_wav(output);
+            audio.recycle();
+            return written.map(|()| None);
+        };
+        // 校验只跑主路由步骤，且直接取内存中已合并的缓冲区，与写盘并行。
+        let (written, verification) = std::thread::scope(|scope| {
+            let verifier = scope.spawn(|| -> Result<EmbedVerification> {
+                let stereo = build_stereo_for_route_step(&audio, primary)?;
+                let wav_bytes = stereo.to_wav_bytes();
+                stereo.recycle();
+                verify_embedded_wav_bytes(self, &primary.name, wav_bytes?, message)
+            });
+            (audio.to_wav(output), verifier.join())
+        });
+        audio.recycle();
+        written?;
+        let verification = verification
+            .map_err(|_| Error::AudiowmarkExec("verify thread panicked".to_string()))??;
+        Ok(Some(verification))
     }
 
     /// 多声道嵌入：将水印嵌入所有立体声对.
@@ -936,20 +1222,231 @@ impl Audio {
         message: &[u8; MESSAGE_LEN],
         layout: Option<ChannelLayout>,
     ) -> Result<()> {
+        self.embed_multichannel_impl(input.as_ref(), output.as_ref(), message, layout, false)
+            .map(|_| ())
+    }
+
+    /// 有界内存的流式多声道嵌入.
+    ///
+    /// 按块读取 WAV/RF64 输入，并发写入每个路由步骤的 audiowmark 管道，增量读取各步骤输出并
+    /// 在所有步骤都产出同一块后立即重交错写出；内存占用与时长无关，输出超过 4 GiB 时写为
+    /// RF64。非 PCM WAV、ADM/BWF 与单声道/立体声输入回退到 [`Self::embed_multichannel`]。.
+    ///
+    /// # Errors
+    /// 与 [`Self::embed_multichannel`] 相同；流式路径中任一路由步骤失败即返回错误，
+    /// 不做"保持原样"降级，并删除未完成的输出文件。.
+    #[cfg(feature = "multichannel")]
+    pub fn embed_multichannel_streaming<P: AsRef<Path>>(
+        &self,
+        input: P,
+        output: P,
+        message: &[u8; MESSAGE_LEN],
+        layout: Option<ChannelLayout>,
+    ) -> Result<()> {
+        let (input, output) = (input.as_ref(), output.as_ref());
         let op_id = self.progress_begin_operation(ProgressOperation::Embed, "prepare_input");
+        let this = &self.scoped_to_op(op_id);
         let result = (|| {
-            let input = input.as_ref();
-            let output = output.as_ref();
+            this.cancel_token.check()?;
             validate_embed_output_path(output)?;
+            if media::adm_bwav::probe_adm_bwf(input)?.is_some() {
+                return Ok(false);
+            }
+            this.progress_set_phase_for_op(
+                op_id,
+                &PhaseParams::indeterminate(ProgressPhase::RouteStep, "embed_route_stream"),
+            );
+            media::stream_embed::embed_wav_streaming(this, input, output, message, layout)
+        })();
+        self.progress_finish_operation(op_id, result.is_ok(), "embed_done");
+        if result? {
+            Ok(())
+        } else {
+            self.embed_multichannel(input, output, message, layout)
+        }
+    }
 
+    /// 时间分段并行嵌入（单声道/立体声长音频）.
+    ///
+    /// 输入按水印帧周期对齐切成约 `segment_secs` 秒的分段，各段带重叠区并行嵌入，再在接缝处
+    /// 交叉淡化、按样本精确拼接；吞吐随核心数增长。`verify` 时逐个接缝检测水印。多声道、
+    /// ADM/BWF 与无法解码到内存的输入回退到常规多声道嵌入路径。.
+    ///
+    /// # Errors
+    /// 当 `segment_secs` 小于 120 秒、输出不是 `.wav`、任一分段嵌入失败或操作被取消时返回错误。.
+    #[cfg(feature = "multichannel")]
+    pub fn embed_time_parallel<P: AsRef<Path>>(
+        &self,
+        input: P,
+        output: P,
+        message: &[u8; MESSAGE_LEN],
+        layout: Option<ChannelLayout>,
+        segment_secs: u32,
+        verify: bool,
+    ) -> Result<Option<EmbedVerification>> {
+        let (input, output) = (input.as_ref(), output.as_ref());
+        if segment_secs < media::segment_embed::MIN_SEGMENT_SECS {
+            return Err(Error::InvalidInput(format!(
+                "segment length must be at least {} seconds, got {segment_secs}",
+                media::segment_embed::MIN_SEGMENT_SECS
+            )));
+        }
+        let op_id = self.progress_begin_operation(ProgressOperation::Embed, "prepare_input");
+        let this = &self.scoped_to_op(op_id);
+        let result = (|| {
+            this.cancel_token.check()?;
+            validate_embed_output_path(output)?;
             if media::adm_bwav::probe_adm_bwf(input)?.is_some() {
-                self.progress_set_phase_for_op(
+                return this.embed_multichannel_impl(input, output, message, layout, verify);
+            }
+            let audio = match AudioBuffer::from_file(input) {
+                Ok(a) => a,
+                Err(Error::InvalidInput(_)) => {
+                    match decode_media_to_pcm_i32(input, &this.cancel_token)
+                        .and_then(decoded_pcm_into_multichannel)
+                    {
+                        Ok(a) => a,
+                        Err(Error::Cancelled) => return Err(Error::Cancelled),
+                        Err(_) => {
+                            return this
+                                .embed_multichannel_impl(input, output, message, layout, verify);
+                        }
+                    }
+                }
+                Err(e) => return Err(e),
+            };
+            if audio.num_channels() > 2 {
+                audio.recycle();
+                return this.embed_multichannel_impl(input, output, message, layout, verify);
+            }
+            this.progress_set_phase_for_op(
+                op_id,
+                &PhaseParams::indeterminate(ProgressPhase::RouteStep, "embed_segments"),
+            );
+            let embedded = media::segment_embed::embed_segmented(
+                this,
+                &audio,
+                output,
+                message,
+                segment_secs,
+                verify,
+            );
+            audio.recycle();
+            embedded
+        })();
+        self.progress_finish_operation(op_id, result.is_ok(), "embed_done");
+        result
+    }
+
+    /// 同一输入向多个接收方扇出嵌入.
+    ///
+    /// 输入只解码、路由规划并序列化一次，各路由步骤的 WAV 字节由所有接收方共享；每个
+    /// 接收方只需运行 audiowmark 并合并写出。最多 `workers` 个接收方并发处理，并受内存预算
+    /// 进一步限制（`AWMKIT_FANOUT_MEMORY_MB` 可覆盖默认预算）。ADM/BWF 与无法解码到内存的
+    /// 输入逐个回退到 [`Self::embed_multichannel`]。.
+    ///
+    /// 返回值与 `recipients` 一一对应；单个接收方失败不影响其他接收方。.
+    ///
+    /// # Errors
+    /// 当输入无法读取、布局与声道数不匹配、路由步骤准备失败或操作被取消时返回错误。.
+    #[cfg(feature = "multichannel")]
+    pub fn embed_many<P: AsRef<Path>>(
+        &self,
+        input: P,
+        recipients: &[EmbedRecipient],
+        layout: Option<ChannelLayout>,
+        workers: usize,
+    ) -> Result<Vec<Result<()>>> {
+        let input = input.as_ref();
+        let op_id = self.progress_begin_operation(ProgressOperation::Embed, "prepare_input");
+        let this = &self.scoped_to_op(op_id);
+        let result = (|| {
+            this.cancel_token.check()?;
+            let fallback = || -> Vec<Result<()>> {
+                recipients
+                    .iter()
+                    .map(|r| this.embed_multichannel(input, r.output.as_path(), &r.message, layout))
+                    .collect()
+            };
+            if media::adm_bwav::probe_adm_bwf(input)?.is_some() {
+                return Ok(fallback());
+            }
+            let audio = match AudioBuffer::from_file(input) {
+                Ok(a) => a,
+                Err(Error::InvalidInput(_)) => {
+                    match decode_media_to_pcm_i32(input, &this.cancel_token)
+                        .and_then(decoded_pcm_into_multichannel)
+                    {
+                        Ok(a) => a,
+                        Err(Error::Cancelled) => return Err(Error::Cancelled),
+                        Err(_) => return Ok(fallback()),
+                    }
+                }
+                Err(e) => return Err(e),
+            };
+            this.progress_set_phase_for_op(
+                op_id,
+                &PhaseParams::indeterminate(ProgressPhase::RouteStep, "embed_fanout"),
+            );
+            let embedded =
+                media::fanout_embed::embed_fanout(this, &audio, input, recipients, layout, workers);
+            audio.recycle();
+            embedded
+        })();
+        self.progress_finish_operation(op_id, result.is_ok(), "embed_done");
+        result
+    }
+
+    /// 多声道嵌入并在内存中校验结果（QA 门禁，无需再次解码输出）.
+    ///
+    /// 校验只检测主路由步骤（优先首个立体声对），直接使用已合并的内存缓冲区，并与输出
+    /// 写盘并行执行。立体声路径对 audiowmark 生成的 WAV 输出直接检测（无解码、无路由规划）。
+    /// ADM BWF 输入不支持内存校验，返回 `Ok(None)`。.
+    ///
+    /// # Errors
+    /// 与 [`Self::embed_multichannel`] 相同；校验阶段 audiowmark 执行失败时同样返回错误。.
+    #[cfg(feature = "multichannel")]
+    pub fn embed_multichannel_verified<P: AsRef<Path>>(
+        &self,
+        input: P,
+        output: P,
+        message: &[u8; MESSAGE_LEN],
+        layout: Option<ChannelLayout>,
+    ) -> Result<Option<EmbedVerification>> {
+        self.embed_multichannel_impl(input.as_ref(), output.as_ref(), message, layout, true)
+    }
+
+    /// Internal helper method.
+    #[cfg(feature = "multichannel")]
+    fn embed_multichannel_impl(
+        &self,
+        input: &Path,
+        output: &Path,
+        message: &[u8; MESSAGE_LEN],
+        layout: Option<ChannelLayout>,
+        verify: bool,
+    ) -> Result<Option<EmbedVerification>> {
+        let op_id = self.progress_begin_operation(ProgressOperation::Embed, "prepare_input");
+        let this = &self.scoped_to_op(op_id);
+        let result = (|| {
+            this.cancel_token.check()?;
+            validate_embed_output_path(output)?;
+
+            if media::adm_bwav::probe_adm_bwf(input)?.is_some() {
+                this.progress_set_phase_for_op(
                     op_id,
                     &PhaseParams::indeterminate(ProgressPhase::Core, "embed_adm"),
                 );
                 return media::adm_embed::embed_adm_multichannel(
-                    self, input, output, message, layout,
-                );
+                    this, input, output, message, layout,
+                )
+                .map(|()| None);
+            }
+
+            // 单声道/立体声 WAV 只需读头部即可交给 audiowmark，不反交错整段 PCM。
+            if map_wav_input(input).is_some_and(|mapped| mapped.layout().channels <= 2) {
+                this.embed(input, output, message)?;
+                return verify_embedded_output(this, output, message, verify);
             }
 
             let mut prepared_fallback: Option<PreparedInput> = None;
@@ -962,32 +1459,56 @@ impl Audio {
                 Ok(a) => a,
                 Err(Error::InvalidInput(_)) => {
                     // 内存管线：decode → AudioBuffer，跳过临时文件
-                    if let Ok(a) =
-                        decode_media_to_pcm_i32(input).and_then(decoded_pcm_into_multichannel)
+                    if let Ok(a) = decode_media_to_pcm_i32(input, &this.cancel_token)
+                        .and_then(decoded_pcm_into_multichannel)
                     {
                         // 单声道或立体声：字节管线直接完成，无需继续路由
                         if a.num_channels() <= 2 {
-                            self.progress_set_phase_for_op(
+                            this.progress_set_phase_for_op(
                                 op_id,
                                 &PhaseParams::indeterminate(ProgressPhase::Core, "embed_stereo_bytes"),
                             );
-                            let wav_bytes = a.to_wav_bytes()?;
+                            let wav_bytes = a.to_wav_bytes();
+                            a.recycle();
                             let out_bytes =
-                                run_audiowmark_add_bytes(self, wav_bytes, &bytes_to_hex(message))?;
-                            return AudioBuffer::from_wav_bytes(&out_bytes)?.to_wav(output);
+                                run_audiowmark_add_bytes(this, wav_bytes?, &bytes_to_hex(message))?;
+                            let out_audio = AudioBuffer::from_wav_bytes(&out_bytes)?;
+                            if !verify {
+                                buffer_pool::give_bytes(out_bytes);
+                                let written = out_audio.to_wav(output);
+                                out_audio.recycle();
+                                return written.map(|()| None);
+                            }
+                            let (written, verification) = std::thread::scope(|scope| {
+                                let verifier = scope.spawn(|| {
+                                    verify_embedded_wav_bytes(this, "stereo", out_bytes, message)
+                                });
+                                (out_audio.to_wav(output), verifier.join())
+                            });
+                            out_audio.recycle();
+                            written?;
+                            return verification
+                                .map_err(|_| {
+                                    Error::AudiowmarkExec("verify thread panicked".to_string())
+                                })?
+                                .map(Some);
                         }
                         a
                     } else {
                         // 兜底：传统临时文件路径
-                        let prepared =
-                            prepare_input_for_audiowmark(input, "embed_multichannel_input")?;
+                        let prepared = prepare_input_for_audiowmark(
+                            input,
+                            "embed_multichannel_input",
+                            &this.cancel_token,
+                        )?;
                         match AudioBuffer::from_file(&prepared.path) {
                             Ok(a) => {
                                 prepared_fallback = Some(prepared);
                                 a
                             }
                             Err(Error::InvalidInput(_)) => {
-                                return self.embed(prepared.path.as_path(), output, message);
+                                this.embed(prepared.path.as_path(), output, message)?;
+                                return verify_embedded_output(this, output, message, verify);
                             }
                             Err(e) => return Err(e),
                         }
@@ -1003,13 +1524,15 @@ impl Audio {
 
             // 单声道或立体声（来自 prepared_fallback 路径），直接使用普通方法
             if num_channels <= 2 {
-                return self.embed(stereo_input, output, message);
+                this.embed(stereo_input, output, message)?;
+                return verify_embedded_output(this, output, message, verify);
             }
 
             // 确定声道布局
             let layout = layout.unwrap_or_else(|| audio.layout());
             validate_layout_channels(layout, num_channels)?;
-            let route_plan = build_smart_route_plan(layout, num_channels, effective_lfe_mode());
+            let route_plan =
+                media::route_cluster::plan_routes(&audio, layout, effective_lfe_mode());
             log_route_warnings("embed", input, &route_plan.warnings);
 
             let executable_steps: Vec<(usize, RouteStep)> = route_plan
@@ -1020,7 +1543,16 @@ impl Audio {
                 .map(|(idx, step)| (idx, step.clone()))
                 .collect();
             let step_total = u32::try_from(executable_steps.len()).unwrap_or(u32::MAX);
-            self.embed_via_route_plan(op_id, audio, output, message, &executable_steps, step_total)
+            this.embed_via_route_plan(
+                op_id,
+                audio,
+                output,
+                message,
+                &executable_steps,
+                &route_plan.mirrors,
+                step_total,
+                verify,
+            )
         })();
         self.progress_finish_operation(op_id, result.is_ok(), "embed_done");
         result
@@ -1132,7 +1664,9 @@ impl Audio {
         layout: Option<ChannelLayout>,
     ) -> Result<MultichannelDetectResult> {
         let op_id = self.progress_begin_operation(ProgressOperation::Detect, "prepare_input");
+        let this = &self.scoped_to_op(op_id);
         let result = (|| {
+            this.cancel_token.check()?;
             let input = input.as_ref();
 
             // ADM/BWF 路径：直接从 data chunk 读 PCM，跳过 FFmpeg 解码，保留所有非音频 chunk 语义。
@@ -1144,7 +1678,7 @@ impl Audio {
             // Path B（无 axml 或标签无法识别，退回）：
             //   与旧行为相同，仅提取 Bed 声道按声道数量推断布局后检测。
             if let Some(ref index) = media::adm_bwav::probe_adm_bwf(input)? {
-                self.progress_set_phase_for_op(
+                this.progress_set_phase_for_op(
                     op_id,
                     &PhaseParams::indeterminate(ProgressPhase::Core, "detect_adm"),
                 );
@@ -1158,7 +1692,7 @@ impl Audio {
                     && speaker_labels.iter().all(|(_, l)| !l.starts_with('?'));
 
                 if has_valid_labels {
-                    return self.detect_adm_path_a(op_id, input, index, &full_audio, &speaker_labels);
+                    return this.detect_adm_path_a(op_id, input, index, &full_audio, &speaker_labels);
                 }
 
                 // ── Path B：退回路径（现有行为不变）──
@@ -1176,7 +1710,19 @@ impl Audio {
                 } else {
                     (full_audio, layout)
                 };
-                return detect_multichannel_from_audio(self, &bed_audio, None, input, bed_layout);
+                return detect_multichannel_from_audio(this, &bed_audio, None, input, bed_layout);
+            }
+
+            // 可内存映射的 WAV/RF64：立体声直接按路径检测；固定路由逐步骤只解出所需声道，
+            // 提前命中后其余声道不再反交错。需要按内容聚类的布局才整段加载。
+            if let Some(mapped) = map_wav_input(input) {
+                this.progress_set_phase_for_op(
+                    op_id,
+                    &PhaseParams::indeterminate(ProgressPhase::Core, "detect_core"),
+                );
+                if let Some(result) = detect_mapped_wav(this, &mapped, input, layout)? {
+                    return Ok(result);
+                }
             }
 
             // 加载多声道音频以检测声道数。
@@ -1187,19 +1733,38 @@ impl Audio {
                 match AudioBuffer::from_file(input) {
                     Ok(a) => (a, Some(input.to_path_buf())),
                     Err(Error::InvalidInput(_)) => {
+                        // 流式管线：解码帧直接送入各路由步骤的 audiowmark 管道，不物化整段 PCM
+                        #[cfg(feature = "ffmpeg-decode")]
+                        if matches!(effective_awmiomode(), AwmIoMode::Pipe) {
+                            this.progress_set_phase_for_op(
+                                op_id,
+                                &PhaseParams::indeterminate(
+                                    ProgressPhase::RouteStep,
+                                    "detect_route_stream",
+                                ),
+                            );
+                            if let Some(result) =
+                                media::stream_detect::detect_media_streaming(this, input, layout)?
+                            {
+                                return Ok(result);
+                            }
+                        }
                         // 内存管线：decode → AudioBuffer，跳过临时文件
-                        if let Ok(a) =
-                            decode_media_to_pcm_i32(input).and_then(decoded_pcm_into_multichannel)
+                        if let Ok(a) = decode_media_to_pcm_i32(input, &this.cancel_token)
+                            .and_then(decoded_pcm_into_multichannel)
                         {
                             (a, None)
                         } else {
                             // 兜底：传统临时文件路径
-                            let prepared =
-                                prepare_input_for_audiowmark(input, "detect_multichannel_input")?;
+                            let prepared = prepare_input_for_audiowmark(
+                                input,
+                                "detect_multichannel_input",
+                                &this.cancel_token,
+                            )?;
                             match AudioBuffer::from_file(&prepared.path) {
                                 Ok(a) => (a, Some(prepared.path)),
                                 Err(Error::InvalidInput(_)) => {
-                                    let result = self.detect(prepared.path.as_path())?;
+                                    let result = this.detect(prepared.path.as_path())?;
                                     return Ok(MultichannelDetectResult {
                                         pairs: vec![(0, "FL+FR".to_string(), result.clone())],
                                         best: result,
@@ -1212,11 +1777,11 @@ impl Audio {
                     Err(e) => return Err(e),
                 };
 
-            self.progress_set_phase_for_op(
+            this.progress_set_phase_for_op(
                 op_id,
                 &PhaseParams::indeterminate(ProgressPhase::Core, "detect_core"),
             );
-            detect_multichannel_from_audio(self, &audio, stereo_file.as_deref(), input, layout)
+            detect_multichannel_from_audio(this, &audio, stereo_file.as_deref(), input, layout)
         })();
         self.progress_finish_operation(op_id, result.is_ok(), "detect_done");
         result
@@ -1262,6 +1827,133 @@ impl Audio {
         }
     }
 
+    /// 多密钥检测：输入只解码一次，用 `key_files` 中的每个密钥并发检测.
+    ///
+    /// 每个（密钥, 路由步骤）组合运行一个 `audiowmark get --key` 子进程，共享同一份已序列化的
+    /// 步骤输入。任一组合完美命中（零比特错误）后其余子进程随即停止，未检测完的密钥
+    /// `completed` 为 `false`。ADM/BWF 输入、文件 I/O 模式或 audiowmark 不支持管道输入时，
+    /// 逐个密钥回退到 [`Self::detect_multichannel`]。.
+    ///
+    /// 返回值与 `key_files` 一一对应。.
+    ///
+    /// # Errors
+    /// 当输入无法读取、布局与声道数不匹配、audiowmark 执行失败或操作被取消时返回错误。.
+    #[cfg(feature = "multichannel")]
+    pub fn detect_with_keys<P: AsRef<Path>>(
+        &self,
+        input: P,
+        key_files: &[PathBuf],
+        layout: Option<ChannelLayout>,
+    ) -> Result<Vec<KeyDetectResult>> {
+        let input = input.as_ref();
+        let op_id = self.progress_begin_operation(ProgressOperation::Detect, "prepare_input");
+        let this = &self.scoped_to_op(op_id);
+        let result = (|| {
+            this.cancel_token.check()?;
+            if key_files.is_empty() {
+                return Ok(Vec::new());
+            }
+            if !matches!(effective_awmiomode(), AwmIoMode::Pipe)
+                || media::adm_bwav::probe_adm_bwf(input)?.is_some()
+            {
+                return this.detect_keys_sequential(input, key_files, layout);
+            }
+            let audio = match AudioBuffer::from_file(input) {
+                Ok(a) => a,
+                Err(Error::InvalidInput(_)) => {
+                    match decode_media_to_pcm_i32(input, &this.cancel_token)
+                        .and_then(decoded_pcm_into_multichannel)
+                    {
+                        Ok(a) => a,
+                        Err(Error::Cancelled) => return Err(Error::Cancelled),
+                        Err(_) => return this.detect_keys_sequential(input, key_files, layout),
+                    }
+                }
+                Err(e) => return Err(e),
+            };
+            this.progress_set_phase_for_op(
+                op_id,
+                &PhaseParams::indeterminate(ProgressPhase::RouteStep, "detect_keys"),
+            );
+            let detected =
+                media::multi_key_detect::detect_with_keys(this, &audio, input, key_files, layout);
+            audio.recycle();
+            match detected? {
+                Some(results) => Ok(results),
+                None => this.detect_keys_sequential(input, key_files, layout),
+            }
+        })();
+        self.progress_finish_operation(op_id, result.is_ok(), "detect_done");
+        result
+    }
+
+    /// 实时监测：持续解码直播流并以滑动窗口检测水印.
+    ///
+    /// `input` 可以是 `-`（标准输入）、FIFO 或仍在写入的采集文件。最近 `window_secs` 秒的
+    /// 音频保存在环形缓冲区中，每隔 `hop_secs` 秒把当前窗口交给至多 `workers` 个并发的
+    /// `audiowmark get` 检测；检测积压时新窗口被跳过并计入统计。每个命中窗口都会回调
+    /// `on_hit`。多声道输入只监测前两个声道。.
+    ///
+    /// 输入结束或操作被取消时返回统计结果；取消是结束监测的正常方式。.
+    ///
+    /// # Errors
+    /// 当参数无效、输入无法打开或解码失败，或 audiowmark 执行失败时返回错误。.
+    #[cfg(all(feature = "multichannel", feature = "ffmpeg-decode"))]
+    pub fn monitor<P, F>(&self, input: P, config: MonitorConfig, on_hit: F) -> Result<MonitorReport>
+    where
+        P: AsRef<Path>,
+        F: FnMut(&MonitorHit),
+    {
+        let op_id = self.progress_begin_operation(ProgressOperation::Detect, "prepare_input");
+        let this = &self.scoped_to_op(op_id);
+        this.progress_set_phase_for_op(
+            op_id,
+            &PhaseParams::indeterminate(ProgressPhase::Core, "detect_monitor"),
+        );
+        let result = media::live_monitor::monitor(this, input.as_ref(), config, on_hit);
+        self.progress_finish_operation(op_id, result.is_ok(), "detect_done");
+        result
+    }
+
+    /// Internal helper method: 逐个密钥检测，完美命中后停止.
+    #[cfg(feature = "multichannel")]
+    fn detect_keys_sequential(
+        &self,
+        input: &Path,
+        key_files: &[PathBuf],
+        layout: Option<ChannelLayout>,
+    ) -> Result<Vec<KeyDetectResult>> {
+        let mut results = Vec::with_capacity(key_files.len());
+        let mut stopped = false;
+        for key_file in key_files {
+            if stopped {
+                results.push(KeyDetectResult {
+                    key_file: key_file.clone(),
+                    detect: MultichannelDetectResult {
+                        pairs: Vec::new(),
+                        best: None,
+                    },
+                    completed: false,
+                });
+                continue;
+            }
+            let detect = self
+                .clone()
+                .key_file(key_file)
+                .detect_multichannel(input, layout)?;
+            stopped = detect
+                .best
+                .as_ref()
+                .is_some_and(|best| best.bit_errors == 0);
+            results.push(KeyDetectResult {
+                key_file: key_file.clone(),
+                detect,
+                completed: true,
+            });
+        }
+        Ok(results)
+    }
+
     /// 搜索 audiowmark 二进制
     #[cfg(not(feature = "bundled"))]
     fn find_binary() -> Option<PathBuf> {
@@ -1330,6 +2022,8 @@ impl Default for Audio {
             strength: 10,
             key_file: None,
             progress_tracker: Arc::new(ProgressTracker::new()),
+            cancel_token: CancellationToken::new(),
+            active_op: 0,
         })
     }
 }
@@ -1357,6 +2051,7 @@ fn copy_with_progress<R: Read, W: Write>(
     let mut copied = 0_u64;
     let mut buf = vec![0_u8; PIPE_BUF_SIZE];
     loop {
+        audio.cancel_token.check_io()?;
         let read = reader.read(&mut buf)?;
         if read == 0 {
             break;
@@ -1392,7 +2087,7 @@ fn run_audiowmark_add_prepared(
 
 /// Internal helper function.
 fn run_audiowmark_get_file_with_prepare(audio: &Audio, input: &Path) -> Result<Output> {
-    let prepared = prepare_input_for_audiowmark(input, "detect_input")?;
+    let prepared = prepare_input_for_audiowmark(input, "detect_input", &audio.cancel_token)?;
     run_audiowmark_get_file(audio, &prepared.path)
 }
 
@@ -1451,9 +2146,15 @@ fn run_audiowmark_add_file(
     }
 
     cmd.arg(prepared_input).arg(output).arg(message_hex);
-    let output = cmd
-        .output()
-        .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+    let output = match run_command_output(audio, &mut cmd) {
+        Ok(process_output) => process_output,
+        Err(Error::Cancelled) => {
+            // audiowmark 被中途 kill 时可能已写出半截文件。
+            let _ = fs::remove_file(output);
+            return Err(Error::Cancelled);
+        }
+        Err(err) => return Err(err),
+    };
     if !output.status.success() {
         let stderr = String::from_utf8_lossy(&output.stderr);
         return Err(Error::AudiowmarkExec(stderr.to_string()));
@@ -1472,26 +2173,35 @@ fn run_audiowmark_get_file(audio: &Audio, prepared_input: &Path) -> Result<Outpu
     }
 
     cmd.arg(prepared_input);
-    cmd.output()
-        .map_err(|e| Error::AudiowmarkExec(e.to_string()))
+    run_command_output(audio, &mut cmd)
 }
 
 /// Internal helper function.
-fn run_audiowmark_add_bytes(
+pub(crate) fn run_audiowmark_add_bytes(
     audio: &Audio,
     input_bytes: Vec<u8>,
     message_hex: &str,
+) -> Result<Vec<u8>> {
+    let output = run_audiowmark_add_shared_bytes(audio, &input_bytes, message_hex);
+    buffer_pool::give_bytes(input_bytes);
+    output
+}
+
+/// 不取得输入所有权的 `add`，供多个消息共享同一份 WAV 字节.
+pub(crate) fn run_audiowmark_add_shared_bytes(
+    audio: &Audio,
+    input_bytes: &[u8],
+    message_hex: &str,
 ) -> Result<Vec<u8>> {
     if matches!(effective_awmiomode(), AwmIoMode::File) {
         return run_audiowmark_add_bytes_file(audio, input_bytes, message_hex);
     }
-    match run_audiowmark_add_bytes_pipe(audio, &input_bytes, message_hex) {
-        Ok(output_bytes) => Ok(output_bytes),
+    match run_audiowmark_add_bytes_pipe(audio, input_bytes, message_hex) {
         Err(err) if should_fallback_pipe_error(&err) => {
             warn_pipe_fallback("add-bytes", "<memory-bytes>", &err);
             run_audiowmark_add_bytes_file(audio, input_bytes, message_hex)
         }
-        Err(err) => Err(err),
+        outcome => outcome,
     }
 }
 
@@ -1501,21 +2211,10 @@ fn run_audiowmark_add_bytes_pipe(
     input_bytes: &[u8],
     message_hex: &str,
 ) -> Result<Vec<u8>> {
-    let mut cmd = audio.audiowmark_command();
-    cmd.arg("add")
-        .arg("--strength")
-        .arg(audio.strength.to_string())
-        .arg("--input-format")
-        .arg("wav-pipe")
-        .arg("--output-format")
-        .arg("wav-pipe");
-
-    if let Some(ref key_file) = audio.key_file {
-        cmd.arg("--key").arg(key_file);
-    }
-
-    cmd.arg("-").arg("-").arg(message_hex);
-    let process_output = run_command_with_stdin(audio, &mut cmd, input_bytes)?;
+    let mut cmd = audio.add_wav_pipe_command(message_hex);
+    // wav-pipe 输出与输入大小相当，预留少量头部余量。
+    let process_output =
+        run_command_with_stdin(audio, &mut cmd, input_bytes, input_bytes.len() + 64)?;
     if !process_output.status.success() {
         let stderr = String::from_utf8_lossy(&process_output.stderr);
         return Err(Error::AudiowmarkExec(stderr.to_string()));
@@ -1531,12 +2230,15 @@ fn run_audiowmark_add_bytes_pipe(
 }
 
 /// Internal helper function.
-fn run_audiowmark_get_bytes(audio: &Audio, input_bytes: Vec<u8>) -> Result<Output> {
+pub(crate) fn run_audiowmark_get_bytes(audio: &Audio, input_bytes: Vec<u8>) -> Result<Output> {
     if matches!(effective_awmiomode(), AwmIoMode::File) {
         return run_audiowmark_get_bytes_file(audio, input_bytes);
     }
     match run_audiowmark_get_bytes_pipe(audio, &input_bytes) {
-        Ok(output) => Ok(output),
+        Ok(output) => {
+            buffer_pool::give_bytes(input_bytes);
+            Ok(output)
+        }
         Err(err) if should_fallback_pipe_error(&err) => {
             warn_pipe_fallback("get-bytes", "<memory-bytes>", &err);
             run_audiowmark_get_bytes_file(audio, input_bytes)
@@ -1547,15 +2249,8 @@ fn run_audiowmark_get_bytes(audio: &Audio, input_bytes: Vec<u8>) -> Result<Outpu
 
 /// Internal helper function.
 fn run_audiowmark_get_bytes_pipe(audio: &Audio, input_bytes: &[u8]) -> Result<Output> {
-    let mut cmd = audio.audiowmark_command();
-    cmd.arg("get");
-
-    if let Some(ref key_file) = audio.key_file {
-        cmd.arg("--key").arg(key_file);
-    }
-
-    cmd.arg("-");
-    let output = run_command_with_stdin(audio, &mut cmd, input_bytes)?;
+    let mut cmd = audio.get_wav_pipe_command();
+    let output = run_command_with_stdin(audio, &mut cmd, input_bytes, 0)?;
     if !output.status.success() {
         let stderr = String::from_utf8_lossy(&output.stderr);
         if is_pipe_compatibility_error(&stderr) {
@@ -1568,7 +2263,7 @@ fn run_audiowmark_get_bytes_pipe(audio: &Audio, input_bytes: &[u8]) -> Result<Ou
 /// Internal helper function.
 fn run_audiowmark_add_bytes_file(
     audio: &Audio,
-    input_bytes: Vec<u8>,
+    input_bytes: &[u8],
     message_hex: &str,
 ) -> Result<Vec<u8>> {
     let temp_dir = create_temp_dir("awmkit_add_bytes_file")?;
@@ -1590,7 +2285,8 @@ fn run_audiowmark_get_bytes_file(audio: &Audio, input_bytes: Vec<u8>) -> Result<
         path: temp_dir.clone(),
     };
     let input_path = temp_dir.join("input.wav");
-    fs::write(&input_path, input_bytes)?;
+    fs::write(&input_path, &input_bytes)?;
+    buffer_pool::give_bytes(input_bytes);
     run_audiowmark_get_file(audio, &input_path)
 }
 
@@ -1652,7 +2348,7 @@ fn run_audiowmark_get_pipe_decoded_streaming(audio: &Audio, input: &Path) -> Res
     let (status, stdin_result, stdout_result, stderr_result) = std::thread::scope(|scope| {
         let writer = scope.spawn(move || -> Result<()> {
             let mut stdin = BufWriter::with_capacity(PIPE_BUF_SIZE, stdin);
-            decode_media_to_wav_pipe(&input_path, &mut stdin)?;
+            decode_media_to_wav_pipe(&input_path, &mut stdin, &audio.cancel_token)?;
             stdin.flush()?;
             Ok(())
         });
@@ -1668,7 +2364,7 @@ fn run_audiowmark_get_pipe_decoded_streaming(audio: &Audio, input: &Path) -> Res
             stderr.read_to_end(&mut buf)?;
             Ok(buf)
         });
-        let status = child.wait();
+        let status = wait_child_cancellable(audio, &mut child);
         (
             status,
             writer.join(),
@@ -1677,6 +2373,7 @@ fn run_audiowmark_get_pipe_decoded_streaming(audio: &Audio, input: &Path) -> Res
         )
     });
 
+    audio.cancel_token.check()?;
     let status = status.map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
     stdin_result
         .map_err(|_| Error::AudiowmarkExec("stdin decode thread panicked".to_string()))??;
@@ -1768,43 +2465,123 @@ fn run_audiowmark_add_pipe_streaming(
             stderr.read_to_end(&mut buf)?;
             Ok(buf)
         });
-
-        let status = child.wait();
-        let stdin_result = stdin_writer.join();
-        let stdout_result = stdout_reader.join();
-        let stderr_result = stderr_reader.join();
-        (status, stdin_result, stdout_result, stderr_result)
+
+        let status = wait_child_cancellable(audio, &mut child);
+        let stdin_result = stdin_writer.join();
+        let stdout_result = stdout_reader.join();
+        let stderr_result = stderr_reader.join();
+        (status, stdin_result, stdout_result, stderr_result)
+    });
+
+    if audio.cancel_token.is_cancelled() {
+        let _ = fs::remove_file(output);
+        return Err(Error::Cancelled);
+    }
+    let status = status.map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+    let stdin_copied = stdin_result
+        .map_err(|_| Error::AudiowmarkExec("stdin streaming thread panicked".to_string()))?
+        .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+    let _ = stdin_copied;
+    let stdout_copied = stdout_result
+        .map_err(|_| Error::AudiowmarkExec("stdout streaming thread panicked".to_string()))?
+        .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+    if stdout_copied == 0 {
+        return Err(Error::AudiowmarkExec(
+            "pipe output is empty; expected WAV stream".to_string(),
+        ));
+    }
+    let stderr_bytes = stderr_result
+        .map_err(|_| Error::AudiowmarkExec("stderr streaming thread panicked".to_string()))?
+        .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+
+    if !status.success() {
+        let stderr_text = String::from_utf8_lossy(&stderr_bytes);
+        return Err(Error::AudiowmarkExec(stderr_text.to_string()));
+    }
+    validate_wav_output_file(output)?;
+
+    normalize_wav_pipe_file_in_place(output)?;
+    Ok(())
+}
+
+/// 等待子进程退出；期间轮询取消令牌，取消时立即 kill 并回收子进程。.
+///
+/// 轮询间隔从 1ms 指数退避到 [`CHILD_CANCEL_POLL`]，避免短命子进程被固定睡眠拖慢。.
+fn wait_child_cancellable(audio: &Audio, child: &mut Child) -> std::io::Result<ExitStatus> {
+    let mut backoff = Duration::from_millis(1);
+    loop {
+        if let Some(status) = child.try_wait()? {
+            return Ok(status);
+        }
+        if audio.cancel_token.is_cancelled() {
+            // kill 失败通常意味着子进程刚好已退出；随后的 wait 负责回收。
+            let _ = child.kill();
+            return child.wait();
+        }
+        std::thread::sleep(backoff);
+        backoff = backoff.saturating_mul(2).min(CHILD_CANCEL_POLL);
+    }
+}
+
+/// 执行命令并收集 stdout/stderr（可取消版 `Command::output`）。.
+fn run_command_output(audio: &Audio, cmd: &mut Command) -> Result<Output> {
+    cmd.stdin(Stdio::null())
+        .stdout(Stdio::piped())
+        .stderr(Stdio::piped());
+    let mut child = cmd
+        .spawn()
+        .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+    let stdout = child
+        .stdout
+        .take()
+        .ok_or_else(|| Error::AudiowmarkExec("failed to take stdout handle".to_string()))?;
+    let stderr = child
+        .stderr
+        .take()
+        .ok_or_else(|| Error::AudiowmarkExec("failed to take stderr handle".to_string()))?;
+
+    let (status, stdout_result, stderr_result) = std::thread::scope(|scope| {
+        let stdout_reader = scope.spawn(move || -> std::io::Result<Vec<u8>> {
+            let mut stdout = stdout;
+            let mut buf = Vec::new();
+            stdout.read_to_end(&mut buf)?;
+            Ok(buf)
+        });
+        let stderr_reader = scope.spawn(move || -> std::io::Result<Vec<u8>> {
+            let mut stderr = stderr;
+            let mut buf = Vec::new();
+            stderr.read_to_end(&mut buf)?;
+            Ok(buf)
+        });
+        let status = wait_child_cancellable(audio, &mut child);
+        (status, stdout_reader.join(), stderr_reader.join())
     });
 
+    audio.cancel_token.check()?;
     let status = status.map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
-    let stdin_copied = stdin_result
-        .map_err(|_| Error::AudiowmarkExec("stdin streaming thread panicked".to_string()))?
-        .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
-    let _ = stdin_copied;
-    let stdout_copied = stdout_result
-        .map_err(|_| Error::AudiowmarkExec("stdout streaming thread panicked".to_string()))?
+    let stdout = stdout_result
+        .map_err(|_| Error::AudiowmarkExec("stdout reader thread panicked".to_string()))?
         .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
-    if stdout_copied == 0 {
-        return Err(Error::AudiowmarkExec(
-            "pipe output is empty; expected WAV stream".to_string(),
-        ));
-    }
-    let stderr_bytes = stderr_result
-        .map_err(|_| Error::AudiowmarkExec("stderr streaming thread panicked".to_string()))?
+    let stderr = stderr_result
+        .map_err(|_| Error::AudiowmarkExec("stderr reader thread panicked".to_string()))?
         .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
 
-    if !status.success() {
-        let stderr_text = String::from_utf8_lossy(&stderr_bytes);
-        return Err(Error::AudiowmarkExec(stderr_text.to_string()));
-    }
-    validate_wav_output_file(output)?;
-
-    normalize_wav_pipe_file_in_place(output)?;
-    Ok(())
+    Ok(Output {
+        status,
+        stdout,
+        stderr,
+    })
 }
 
 /// Internal helper function.
-fn run_command_with_stdin(audio: &Audio, cmd: &mut Command, stdin_data: &[u8]) -> Result<Output> {
+///
+/// `stdout_capacity` 为预期 stdout 大小；非零时从缓冲池取 stdout 缓冲。.
+fn run_command_with_stdin(
+    audio: &Audio,
+    cmd: &mut Command,
+    stdin_data: &[u8],
+    stdout_capacity: usize,
+) -> Result<Output> {
     cmd.stdin(Stdio::piped())
         .stdout(Stdio::piped())
         .stderr(Stdio::piped());
@@ -1840,7 +2617,11 @@ fn run_command_with_stdin(audio: &Audio, cmd: &mut Command, stdin_data: &[u8]) -
         });
         let stdout_reader = scope.spawn(move || -> std::io::Result<Vec<u8>> {
             let mut stdout = BufReader::with_capacity(PIPE_BUF_SIZE, stdout);
-            let mut buf = Vec::new();
+            let mut buf = if stdout_capacity == 0 {
+                Vec::new()
+            } else {
+                buffer_pool::take_bytes(stdout_capacity)
+            };
             stdout.read_to_end(&mut buf)?;
             Ok(buf)
         });
@@ -1850,7 +2631,7 @@ fn run_command_with_stdin(audio: &Audio, cmd: &mut Command, stdin_data: &[u8]) -
             stderr.read_to_end(&mut buf)?;
             Ok(buf)
         });
-        let status = child.wait();
+        let status = wait_child_cancellable(audio, &mut child);
         (
             status,
             writer.join(),
@@ -1859,6 +2640,7 @@ fn run_command_with_stdin(audio: &Audio, cmd: &mut Command, stdin_data: &[u8]) -
         )
     });
 
+    audio.cancel_token.check()?;
     let status = status.map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
     stdin_result
         .map_err(|_| Error::AudiowmarkExec("stdin writer thread panicked".to_string()))?
@@ -1929,7 +2711,7 @@ fn run_command_with_stdin_from_file(
             stderr.read_to_end(&mut buf)?;
             Ok(buf)
         });
-        let status = child.wait();
+        let status = wait_child_cancellable(audio, &mut child);
         (
             status,
             writer.join(),
@@ -1938,6 +2720,7 @@ fn run_command_with_stdin_from_file(
         )
     });
 
+    audio.cancel_token.check()?;
     let status = status.map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
     stdin_result
         .map_err(|_| Error::AudiowmarkExec("stdin writer thread panicked".to_string()))?
@@ -2141,7 +2924,7 @@ const fn should_fallback_pipe_error(err: &Error) -> bool {
 }
 
 /// Internal helper function.
-fn is_pipe_compatibility_error(stderr: &str) -> bool {
+pub(crate) fn is_pipe_compatibility_error(stderr: &str) -> bool {
     let normalized = stderr.to_ascii_lowercase();
     normalized.contains("unsupported option")
         || normalized.contains("unrecognized option")
@@ -2160,7 +2943,10 @@ fn warn_pipe_fallback(operation: &str, source: impl std::fmt::Display, err: &Err
 
 #[cfg(feature = "multichannel")]
 /// Internal helper function.
-fn validate_layout_channels(layout: ChannelLayout, source_channels: usize) -> Result<()> {
+pub(crate) fn validate_layout_channels(
+    layout: ChannelLayout,
+    source_channels: usize,
+) -> Result<()> {
     let layout_channels = usize::from(layout.channels());
     if layout_channels != source_channels {
         return Err(Error::InvalidInput(format!(
@@ -2172,7 +2958,7 @@ fn validate_layout_channels(layout: ChannelLayout, source_channels: usize) -> Re
 
 #[cfg(feature = "multichannel")]
 /// Internal helper function.
-fn log_route_warnings(operation: &str, input: &Path, warnings: &[String]) {
+pub(crate) fn log_route_warnings(operation: &str, input: &Path, warnings: &[String]) {
     for warning in warnings {
         eprintln!(
             "Warning: smart route fallback ({operation}) for {}: {warning}",
@@ -2196,6 +2982,21 @@ fn compute_route_parallelism(step_count: usize) -> usize {
     1
 }
 
+/// 超过此声道数的路由方案由聚类规划生成，步骤默认铺满线程池.
+#[cfg(feature = "multichannel")]
+const LARGE_ROUTE_CHANNELS: usize = 16;
+
+#[cfg(feature = "multichannel")]
+/// 大声道数方案的并发度：每步都是整段音频的 audiowmark 运行，线程池开销可以摊薄.
+fn large_route_parallelism(step_count: usize) -> usize {
+    if step_count <= 1 {
+        return 1;
+    }
+    let forced = route_parallelism_override();
+    let available = std::thread::available_parallelism().map_or(1, std::num::NonZeroUsize::get);
+    step_count.min(forced.unwrap_or(available)).max(1)
+}
+
 #[cfg(feature = "multichannel")]
 /// Internal helper function.
 fn route_parallelism_override() -> Option<usize> {
@@ -2206,7 +3007,7 @@ fn route_parallelism_override() -> Option<usize> {
 
 #[cfg(feature = "multichannel")]
 /// Internal helper function.
-fn with_route_thread_pool<F, R>(parallelism: usize, f: F) -> Result<R>
+pub(crate) fn with_route_thread_pool<F, R>(parallelism: usize, f: F) -> Result<R>
 where
     F: FnOnce() -> R + Send,
     R: Send,
@@ -2232,10 +3033,15 @@ fn run_embed_step_task(
     step: &RouteStep,
     message: &[u8; MESSAGE_LEN],
 ) -> Result<AudioBuffer> {
+    audio_engine.cancel_token.check()?;
     let stereo = build_stereo_for_route_step(source_audio, step)?;
-    let input_bytes = stereo.to_wav_bytes()?;
-    let output_bytes = run_audiowmark_add_bytes(audio_engine, input_bytes, &bytes_to_hex(message))?;
-    AudioBuffer::from_wav_bytes(&output_bytes)
+    let input_bytes = stereo.to_wav_bytes();
+    stereo.recycle();
+    let output_bytes =
+        run_audiowmark_add_bytes(audio_engine, input_bytes?, &bytes_to_hex(message))?;
+    let processed = AudioBuffer::from_wav_bytes(&output_bytes);
+    buffer_pool::give_bytes(output_bytes);
+    processed
 }
 
 #[cfg(feature = "multichannel")]
@@ -2245,21 +3051,108 @@ fn run_detect_step_task(
     source_audio: &AudioBuffer,
     step: &RouteStep,
 ) -> Result<Option<DetectResult>> {
+    audio_engine.cancel_token.check()?;
     let stereo = build_stereo_for_route_step(source_audio, step)?;
-    let input_bytes = stereo.to_wav_bytes()?;
-    let output = run_audiowmark_get_bytes(audio_engine, input_bytes)?;
+    detect_route_step_input(audio_engine, stereo)
+}
+
+#[cfg(feature = "multichannel")]
+/// 与 [`run_detect_step_task`] 相同，但直接从映射的 WAV 只解出该步骤的声道.
+fn run_detect_step_task_from_view(
+    audio_engine: &Audio,
+    view: &InterleavedView<'_>,
+    step: &RouteStep,
+) -> Result<Option<DetectResult>> {
+    audio_engine.cancel_token.check()?;
+    let stereo = build_stereo_for_route_step_from_view(view, step)?;
+    detect_route_step_input(audio_engine, stereo)
+}
+
+#[cfg(feature = "multichannel")]
+/// Internal helper function.
+fn detect_route_step_input(
+    audio_engine: &Audio,
+    stereo: AudioBuffer,
+) -> Result<Option<DetectResult>> {
+    let input_bytes = stereo.to_wav_bytes();
+    stereo.recycle();
+    let output = run_audiowmark_get_bytes(audio_engine, input_bytes?)?;
     let stdout = String::from_utf8_lossy(&output.stdout);
     let stderr = String::from_utf8_lossy(&output.stderr);
     Ok(parse_detect_output(&stdout, &stderr))
 }
 
+#[cfg(feature = "multichannel")]
+/// 选择嵌入校验的主路由步骤：优先首个立体声对，其次首个可执行步骤.
+fn primary_route_step(steps: &[(usize, RouteStep)]) -> Option<&RouteStep> {
+    steps
+        .iter()
+        .find(|(_, step)| matches!(step.mode, RouteMode::Pair(..)))
+        .or_else(|| steps.first())
+        .map(|(_, step)| step)
+}
+
+#[cfg(feature = "multichannel")]
+/// Internal helper function.
+fn verify_embedded_wav_bytes(
+    audio_engine: &Audio,
+    step: &str,
+    wav_bytes: Vec<u8>,
+    message: &[u8; MESSAGE_LEN],
+) -> Result<EmbedVerification> {
+    audio_engine.cancel_token.check()?;
+    let output = run_audiowmark_get_bytes(audio_engine, wav_bytes)?;
+    let stdout = String::from_utf8_lossy(&output.stdout);
+    let stderr = String::from_utf8_lossy(&output.stderr);
+    Ok(EmbedVerification::new(
+        step,
+        parse_detect_output(&stdout, &stderr),
+        message,
+    ))
+}
+
+#[cfg(feature = "multichannel")]
+/// 立体声路径由 audiowmark 直接写出 WAV：对输出直接检测，跳过解码与路由规划.
+fn verify_embedded_output(
+    audio_engine: &Audio,
+    output: &Path,
+    message: &[u8; MESSAGE_LEN],
+    verify: bool,
+) -> Result<Option<EmbedVerification>> {
+    if !verify {
+        return Ok(None);
+    }
+    audio_engine.cancel_token.check()?;
+    let detect = run_audiowmark_get_file(audio_engine, output)?;
+    let stdout = String::from_utf8_lossy(&detect.stdout);
+    let stderr = String::from_utf8_lossy(&detect.stderr);
+    Ok(Some(EmbedVerification::new(
+        "stereo",
+        parse_detect_output(&stdout, &stderr),
+        message,
+    )))
+}
+
 #[cfg(feature = "multichannel")]
 /// Internal helper function.
-fn apply_embed_step_results(target: &mut AudioBuffer, step_results: &mut [EmbedStepTaskResult]) {
+pub(crate) fn apply_embed_step_results(
+    target: &mut AudioBuffer,
+    step_results: &mut [EmbedStepTaskResult],
+    mirrors: &[ChannelMirror],
+) {
     step_results.sort_by_key(|item| item.step_idx);
     for step_result in step_results {
         match &step_result.outcome {
             Ok(processed) => {
+                // 镜像声道需要源声道嵌入前的样本，必须先于源声道被替换。
+                if let Err(err) =
+                    apply_route_step_mirrors(target, &step_result.step, processed, mirrors)
+                {
+                    eprintln!(
+                        "Warning: Failed to mirror routed embed result for {}: {err}",
+                        step_result.step.name
+                    );
+                }
                 if let Err(err) = apply_processed_route_step(target, &step_result.step, processed) {
                     eprintln!(
                         "Warning: Failed to apply routed embed result for {}: {err}",
@@ -2279,7 +3172,7 @@ fn apply_embed_step_results(target: &mut AudioBuffer, step_results: &mut [EmbedS
 
 #[cfg(feature = "multichannel")]
 /// Internal helper function.
-fn finalize_detect_step_results(
+pub(crate) fn finalize_detect_step_results(
     mut step_results: Vec<DetectStepTaskResult>,
 ) -> MultichannelDetectResult {
     step_results.sort_by_key(|item| item.step_idx);
@@ -2371,71 +3264,134 @@ fn detect_multichannel_from_audio(
 
     let layout = layout.unwrap_or_else(|| audio.layout());
     validate_layout_channels(layout, num_channels)?;
-    let route_plan = build_smart_route_plan(layout, num_channels, effective_lfe_mode());
+    let route_plan = media::route_cluster::plan_routes(audio, layout, effective_lfe_mode());
     log_route_warnings("detect", input_for_log, &route_plan.warnings);
 
-    let detect_steps: Vec<(usize, RouteStep)> = route_plan
+    let detect_steps = owned_detectable_steps(&route_plan);
+    run_detect_route_steps(audio_engine, &detect_steps, |step| {
+        run_detect_step_task(audio_engine, audio, step)
+    })
+}
+
+#[cfg(feature = "multichannel")]
+/// 在内存映射的 WAV 上执行检测路由，逐步骤只解出所需声道.
+///
+/// 需要按内容聚类的大声道数布局返回 `Ok(None)`，由调用方整段加载后走
+/// [`detect_multichannel_from_audio`]。.
+fn detect_mapped_wav(
+    audio_engine: &Audio,
+    mapped: &MappedWav,
+    input: &Path,
+    layout: Option<ChannelLayout>,
+) -> Result<Option<MultichannelDetectResult>> {
+    let Some(view) = mapped.view() else {
+        return Ok(None);
+    };
+    let num_channels = view.layout().channels;
+    if num_channels <= 2 {
+        audio_engine.progress_set_current_phase(&PhaseParams::indeterminate(
+            ProgressPhase::Core,
+            "detect_stereo",
+        ));
+        let result = audio_engine.detect(input)?;
+        return Ok(Some(MultichannelDetectResult {
+            pairs: vec![(0, "FL+FR".to_string(), result.clone())],
+            best: result,
+        }));
+    }
+
+    let layout = layout.unwrap_or_else(|| {
+        ChannelLayout::from_channels(u16::try_from(num_channels).unwrap_or(u16::MAX))
+    });
+    validate_layout_channels(layout, num_channels)?;
+    let Some(route_plan) =
+        media::route_cluster::plan_fixed_routes(layout, num_channels, effective_lfe_mode())
+    else {
+        return Ok(None);
+    };
+    log_route_warnings("detect", input, &route_plan.warnings);
+
+    let detect_steps = owned_detectable_steps(&route_plan);
+    run_detect_route_steps(audio_engine, &detect_steps, |step| {
+        run_detect_step_task_from_view(audio_engine, &view, step)
+    })
+    .map(Some)
+}
+
+#[cfg(feature = "multichannel")]
+/// Internal helper function.
+fn owned_detectable_steps(route_plan: &RoutePlan) -> Vec<(usize, RouteStep)> {
+    route_plan
         .detectable_steps()
         .into_iter()
         .map(|(idx, step)| (idx, step.clone()))
-        .collect();
+        .collect()
+}
 
+#[cfg(feature = "multichannel")]
+/// 依次运行检测路由步骤（首个零误码步骤后提前结束）并汇总结果，同时上报步骤进度.
+fn run_detect_route_steps<F>(
+    audio_engine: &Audio,
+    detect_steps: &[(usize, RouteStep)],
+    mut run_step: F,
+) -> Result<MultichannelDetectResult>
+where
+    F: FnMut(&RouteStep) -> Result<Option<DetectResult>>,
+{
     let step_total_u64 = u64::try_from(detect_steps.len()).unwrap_or(u64::MAX);
     let step_total_u32 = u32::try_from(detect_steps.len()).unwrap_or(u32::MAX);
-    audio_engine.progress_set_current_phase(
-        &PhaseParams {
+    audio_engine.progress_set_current_phase(&PhaseParams {
+        phase: ProgressPhase::RouteStep,
+        phase_label: "detect_route_steps",
+        determinate: true,
+        completed_units: 0,
+        total_units: step_total_u64,
+        step_index: 0,
+        step_total: step_total_u32,
+    });
+    let mut done = 0_u64;
+    let step_results = collect_detect_step_results_with_early_exit(detect_steps, |step| {
+        let step_index = u32::try_from(done.saturating_add(1)).unwrap_or(u32::MAX);
+        audio_engine.progress_set_current_phase(&PhaseParams {
             phase: ProgressPhase::RouteStep,
-            phase_label: "detect_route_steps",
+            phase_label: step.name.as_str(),
             determinate: true,
-            completed_units: 0,
+            completed_units: done,
             total_units: step_total_u64,
-            step_index: 0,
+            step_index,
             step_total: step_total_u32,
-        },
-    );
-    let mut done = 0_u64;
-    let step_results = collect_detect_step_results_with_early_exit(&detect_steps, |step| {
-        let step_index = u32::try_from(done.saturating_add(1)).unwrap_or(u32::MAX);
-        audio_engine.progress_set_current_phase(
-            &PhaseParams {
-                phase: ProgressPhase::RouteStep,
-                phase_label: step.name.as_str(),
-                determinate: true,
-                completed_units: done,
-                total_units: step_total_u64,
-                step_index,
-                step_total: step_total_u32,
-            },
-        );
-        let outcome = run_detect_step_task(audio_engine, audio, step);
+        });
+        let outcome = run_step(step);
         done = done.saturating_add(1);
-        audio_engine.progress_set_current_phase(
-            &PhaseParams {
-                phase: ProgressPhase::RouteStep,
-                phase_label: step.name.as_str(),
-                determinate: true,
-                completed_units: done,
-                total_units: step_total_u64,
-                step_index,
-                step_total: step_total_u32,
-            },
-        );
+        audio_engine.progress_set_current_phase(&PhaseParams {
+            phase: ProgressPhase::RouteStep,
+            phase_label: step.name.as_str(),
+            determinate: true,
+            completed_units: done,
+            total_units: step_total_u64,
+            step_index,
+            step_total: step_total_u32,
+        });
         outcome
     })?;
 
-    audio_engine.progress_set_current_phase(
-        &PhaseParams::indeterminate(ProgressPhase::Merge, "detect_merge"),
-    );
+    audio_engine.progress_set_current_phase(&PhaseParams::indeterminate(
+        ProgressPhase::Merge,
+        "detect_merge",
+    ));
     Ok(finalize_detect_step_results(step_results))
 }
 
 #[cfg(feature = "multichannel")]
 /// Internal helper function.
-fn build_stereo_for_route_step(audio: &AudioBuffer, step: &RouteStep) -> Result<AudioBuffer> {
+pub(crate) fn build_stereo_for_route_step(
+    audio: &AudioBuffer,
+    step: &RouteStep,
+) -> Result<AudioBuffer> {
     match step.mode {
         RouteMode::Pair(left, right) => {
-            let left_samples = audio.channel_samples(left)?.to_vec();
-            let right_samples = audio.channel_samples(right)?.to_vec();
+            let left_samples = buffer_pool::copy_samples(audio.channel_samples(left)?);
+            let right_samples = buffer_pool::copy_samples(audio.channel_samples(right)?);
             AudioBuffer::new(
                 vec![left_samples, right_samples],
                 audio.sample_rate(),
@@ -2445,7 +3401,7 @@ fn build_stereo_for_route_step(audio: &AudioBuffer, step: &RouteStep) -> Result<
         RouteMode::Mono(channel) => {
             // 直接发 1 声道给 audiowmark；audiowmark 原生支持 mono，
             // 无需 L+L 复制（复制会引入人工相关性，降低水印质量）。
-            let mono = audio.channel_samples(channel)?.to_vec();
+            let mono = buffer_pool::copy_samples(audio.channel_samples(channel)?);
             AudioBuffer::new(vec![mono], audio.sample_rate(), audio.sample_format())
         }
         RouteMode::Skip { .. } => Err(Error::InvalidInput(
@@ -2454,6 +3410,30 @@ fn build_stereo_for_route_step(audio: &AudioBuffer, step: &RouteStep) -> Result<
     }
 }
 
+#[cfg(feature = "multichannel")]
+/// 与 [`build_stereo_for_route_step`] 相同，但只从交错视图解出该步骤的声道.
+fn build_stereo_for_route_step_from_view(
+    view: &InterleavedView<'_>,
+    step: &RouteStep,
+) -> Result<AudioBuffer> {
+    match step.mode {
+        RouteMode::Pair(left, right) => AudioBuffer::from_view_channels(view, &[left, right]),
+        RouteMode::Mono(channel) => AudioBuffer::from_view_channels(view, &[channel]),
+        RouteMode::Skip { .. } => Err(Error::InvalidInput(
+            "cannot build stereo input from skip route step".to_string(),
+        )),
+    }
+}
+
+#[cfg(feature = "multichannel")]
+/// `.wav` 输入可走内存映射快速路径时返回映射，供只需头部或部分声道的路径使用.
+fn map_wav_input(path: &Path) -> Option<MappedWav> {
+    if !matches!(extension_format_hint(path), Some(InputAudioFormat::Wav)) {
+        return None;
+    }
+    MappedWav::open(path)
+}
+
 #[cfg(feature = "multichannel")]
 /// Internal helper function.
 fn apply_processed_route_step(
@@ -2469,8 +3449,8 @@ fn apply_processed_route_step(
                     processed.num_channels()
                 )));
             }
-            let left = processed.channel_samples(0)?.to_vec();
-            let right = processed.channel_samples(1)?.to_vec();
+            let left = buffer_pool::copy_samples(processed.channel_samples(0)?);
+            let right = buffer_pool::copy_samples(processed.channel_samples(1)?);
             target.replace_channel_samples(left_index, left)?;
             target.replace_channel_samples(right_index, right)?;
             Ok(())
@@ -2482,15 +3462,60 @@ fn apply_processed_route_step(
                     "processed mono route output has no channels".to_string(),
                 ));
             }
-            let samples = processed.channel_samples(0)?.to_vec();
+            let samples = buffer_pool::copy_samples(processed.channel_samples(0)?);
             target.replace_channel_samples(channel, samples)
         }
         RouteMode::Skip { .. } => Ok(()),
     }
 }
 
+#[cfg(feature = "multichannel")]
+/// 将路由步骤中源声道的嵌入差值按增益叠加到其镜像声道.
+fn apply_route_step_mirrors(
+    target: &mut AudioBuffer,
+    step: &RouteStep,
+    processed: &AudioBuffer,
+    mirrors: &[ChannelMirror],
+) -> Result<()> {
+    use num_traits::ToPrimitive;
+
+    // (目标声道, 处理结果中的声道)
+    let routed = match step.mode {
+        RouteMode::Pair(left, right) => [Some((left, 0)), Some((right, 1))],
+        RouteMode::Mono(channel) => [Some((channel, 0)), None],
+        RouteMode::Skip { .. } => return Ok(()),
+    };
+    let (low, high) = match target.sample_format() {
+        crate::multichannel::SampleFormat::Int16 => (-32_768.0_f64, 32_767.0_f64),
+        crate::multichannel::SampleFormat::Int24 => (-8_388_608.0_f64, 8_388_607.0_f64),
+        crate::multichannel::SampleFormat::Int32 | crate::multichannel::SampleFormat::Float32 => {
+            (f64::from(i32::MIN), f64::from(i32::MAX))
+        }
+    };
+    for mirror in mirrors {
+        let Some((_, processed_index)) = routed
+            .into_iter()
+            .flatten()
+            .find(|(channel, _)| *channel == mirror.source)
+        else {
+            continue;
+        };
+        let embedded = processed.channel_samples(processed_index)?;
+        let original = target.channel_samples(mirror.source)?;
+        let gain = f64::from(mirror.gain);
+        let mut mirrored = buffer_pool::copy_samples(target.channel_samples(mirror.channel)?);
+        for ((sample, &after), &before) in mirrored.iter_mut().zip(embedded).zip(original) {
+            let delta = f64::from(after) - f64::from(before);
+            let value = (f64::from(*sample) + delta * gain).round().clamp(low, high);
+            *sample = value.to_i32().unwrap_or(*sample);
+        }
+        target.replace_channel_samples(mirror.channel, mirrored)?;
+    }
+    Ok(())
+}
+
 /// 解析 audiowmark get 输出.
-fn parse_detect_output(stdout: &str, stderr: &str) -> Option<DetectResult> {
+pub(crate) fn parse_detect_output(stdout: &str, stderr: &str) -> Option<DetectResult> {
     // 查找 pattern 行
     // 格式: "pattern  all 0101c1d05978131b57f7deb8e22a0b78"
     // 或:   "pattern   single 0101c1d05978131b57f7deb8e22a0b78 0"
@@ -2644,7 +3669,7 @@ fn classify_input_prepare_strategy(path: &Path) -> InputPrepareStrategy {
 }
 
 /// Internal helper function.
-fn validate_embed_output_path(path: &Path) -> Result<()> {
+pub(crate) fn validate_embed_output_path(path: &Path) -> Result<()> {
     let ext = path
         .extension()
         .and_then(|s| s.to_str())
@@ -2661,7 +3686,11 @@ fn validate_embed_output_path(path: &Path) -> Result<()> {
 }
 
 /// Internal helper function.
-fn prepare_input_for_audiowmark(input: &Path, purpose: &str) -> Result<PreparedInput> {
+fn prepare_input_for_audiowmark(
+    input: &Path,
+    purpose: &str,
+    cancel: &CancellationToken,
+) -> Result<PreparedInput> {
     match classify_input_prepare_strategy(input) {
         InputPrepareStrategy::Direct => Ok(PreparedInput {
             path: input.to_path_buf(),
@@ -2669,11 +3698,12 @@ fn prepare_input_for_audiowmark(input: &Path, purpose: &str) -> Result<PreparedI
         }),
         InputPrepareStrategy::DecodeToWav => {
             let temp_dir = create_temp_dir(purpose)?;
-            let temp_wav = temp_dir.join("input.wav");
-            decode_to_wav(input, &temp_wav)?;
+            let guard = TempDirGuard { path: temp_dir };
+            let temp_wav = guard.path.join("input.wav");
+            decode_to_wav(input, &temp_wav, cancel)?;
             Ok(PreparedInput {
                 path: temp_wav,
-                _guard: Some(TempDirGuard { path: temp_dir }),
+                _guard: Some(guard),
             })
         }
     }
@@ -2698,10 +3728,10 @@ fn create_temp_dir(prefix: &str) -> Result<PathBuf> {
 }
 
 /// Internal helper function.
-fn decode_to_wav(input: &Path, output_wav: &Path) -> Result<()> {
+fn decode_to_wav(input: &Path, output_wav: &Path, cancel: &CancellationToken) -> Result<()> {
     use hound::{SampleFormat as HoundSampleFormat, WavSpec, WavWriter};
 
-    let decoded = decode_media_to_pcm_i32(input)?;
+    let decoded = decode_media_to_pcm_i32(input, cancel)?;
     let spec = WavSpec {
         channels: decoded.channels,
         sample_rate: decoded.sample_rate,
@@ -2748,12 +3778,12 @@ pub(crate) struct DecodedPcm {
 
 #[cfg(feature = "ffmpeg-decode")]
 /// Internal helper function.
-fn decode_media_to_pcm_i32(input: &Path) -> Result<DecodedPcm> {
-    media::decode_media_to_pcm_i32(input)
+fn decode_media_to_pcm_i32(input: &Path, cancel: &CancellationToken) -> Result<DecodedPcm> {
+    media::decode_media_to_pcm_i32(input, cancel)
 }
 
 #[cfg(not(feature = "ffmpeg-decode"))]
-fn decode_media_to_pcm_i32(_input: &Path) -> Result<DecodedPcm> {
+fn decode_media_to_pcm_i32(_input: &Path, _cancel: &CancellationToken) -> Result<DecodedPcm> {
     Err(Error::FfmpegLibraryNotFound(
         "ffmpeg-decode feature is disabled".to_string(),
     ))
@@ -2761,8 +3791,12 @@ fn decode_media_to_pcm_i32(_input: &Path) -> Result<DecodedPcm> {
 
 #[cfg(feature = "ffmpeg-decode")]
 /// Internal helper function.
-fn decode_media_to_wav_pipe(input: &Path, writer: &mut dyn Write) -> Result<()> {
-    media::decode_media_to_wav_pipe(input, writer)
+fn decode_media_to_wav_pipe(
+    input: &Path,
+    writer: &mut dyn Write,
+    cancel: &CancellationToken,
+) -> Result<()> {
+    media::decode_media_to_wav_pipe(input, writer, cancel)
 }
 
 /// 当前构建可用的媒体能力摘要。.
@@ -2832,7 +3866,7 @@ fn clamp_sample_to_bits(sample: i32, bits_per_sample: u16) -> i32 {
 }
 
 /// 字节数组转 hex 字符串.
-fn bytes_to_hex(bytes: &[u8]) -> String {
+pub(crate) fn bytes_to_hex(bytes: &[u8]) -> String {
     const HEX: &[u8; 16] = b"0123456789abcdef";
     let mut out = String::with_capacity(bytes.len() * 2);
     for &byte in bytes {
@@ -3180,6 +4214,92 @@ mod tests {
         )));
     }
 
+    #[test]
+    fn test_cancelled_token_short_circuits_operations() {
+        let token = CancellationToken::new();
+        let audio = Audio::default().cancel_token(token.clone());
+        token.cancel();
+
+        assert!(!should_fallback_pipe_error(&Error::Cancelled));
+        assert!(matches!(
+            audio.detect("missing_input.wav"),
+            Err(Error::Cancelled)
+        ));
+
+        let mut src = std::io::Cursor::new(vec![0_u8; 16]);
+        let mut dst = Vec::new();
+        let copied = copy_with_progress(
+            &audio,
+            &mut src,
+            &mut dst,
+            ProgressPhase::Core,
+            "pipe_stdin",
+            Some(16),
+        );
+        assert!(copied.is_err());
+        assert!(dst.is_empty());
+    }
+
+    #[cfg(unix)]
+    #[test]
+    fn test_wait_child_cancellable_kills_running_child() {
+        let token = CancellationToken::new();
+        let audio = Audio::default().cancel_token(token.clone());
+        let child = Command::new("sleep").arg("30").spawn();
+        assert!(child.is_ok());
+        let Ok(mut child) = child else {
+            return;
+        };
+
+        token.cancel();
+        let started = Instant::now();
+        let status = wait_child_cancellable(&audio, &mut child);
+        assert!(status.is_ok());
+        let Ok(status) = status else {
+            return;
+        };
+        assert!(!status.success());
+        assert!(started.elapsed() < Duration::from_secs(5));
+    }
+
+    #[test]
+    fn test_progress_slots_are_independent_per_operation() {
+        let audio = Audio::default();
+        let embed_op = audio.progress_begin_operation(ProgressOperation::Embed, "embed");
+        let detect_op = audio.progress_begin_operation(ProgressOperation::Detect, "detect");
+        assert_ne!(embed_op, detect_op);
+
+        audio
+            .scoped_to_op(embed_op)
+            .progress_update_current_units(10, Some(100));
+        audio
+            .scoped_to_op(detect_op)
+            .progress_update_current_units(3, None);
+        audio.progress_finish_operation(detect_op, true, "done");
+
+        let embed = audio.progress_snapshot_for_op(embed_op);
+        let detect = audio.progress_snapshot_for_op(detect_op);
+        assert!(embed.is_some() && detect.is_some());
+        let (Some(embed), Some(detect)) = (embed, detect) else {
+            return;
+        };
+        assert_eq!(embed.state, ProgressState::Running);
+        assert_eq!(embed.completed_units, 10);
+        assert_eq!(embed.total_units, 100);
+        assert_eq!(detect.state, ProgressState::Completed);
+        assert_eq!(detect.completed_units, 3);
+        assert_eq!(audio.progress_op_ids(), vec![embed_op, detect_op]);
+
+        for _ in 0..PROGRESS_FINISHED_RETAIN + 4 {
+            let op_id = audio.progress_begin_operation(ProgressOperation::Detect, "detect");
+            audio.progress_finish_operation(op_id, true, "done");
+        }
+        let ids = audio.progress_op_ids();
+        assert_eq!(ids.len(), PROGRESS_FINISHED_RETAIN + 1);
+        assert!(ids.contains(&embed_op));
+        assert!(audio.progress_snapshot_for_op(detect_op).is_none());
+    }
+
     #[cfg(feature = "multichannel")]
     #[test]
     fn test_apply_processed_route_step_mono_only_updates_target_channel() {
@@ -3287,6 +4407,28 @@ mod tests {
         assert_eq!(detectable[2].1.name, "BL+BR");
     }
 
+    #[cfg(feature = "multichannel")]
+    #[test]
+    fn test_primary_route_step_prefers_first_pair() {
+        let plan = build_smart_route_plan(ChannelLayout::Surround51, 6, DEFAULT_LFE_MODE);
+        let mut steps: Vec<(usize, RouteStep)> = plan
+            .detectable_steps()
+            .into_iter()
+            .map(|(idx, step)| (idx, step.clone()))
+            .collect();
+        assert_eq!(
+            primary_route_step(&steps).map(|step| step.name.as_str()),
+            Some("FL+FR")
+        );
+
+        steps.retain(|(_, step)| matches!(step.mode, RouteMode::Mono(_)));
+        assert_eq!(
+            primary_route_step(&steps).map(|step| step.name.as_str()),
+            Some("FC(mono)")
+        );
+        assert!(primary_route_step(&[]).is_none());
+    }
+
     #[cfg(feature = "multichannel")]
     #[test]
     fn test_compute_route_parallelism_bounds() {
@@ -3339,7 +4481,7 @@ mod tests {
             },
         ];
 
-        apply_embed_step_results(&mut source, &mut step_results);
+        apply_embed_step_results(&mut source, &mut step_results, &[]);
         assert_eq!(step_results[0].step_idx, 0);
         assert_eq!(step_results[1].step_idx, 1);
 
@@ -3354,6 +4496,56 @@ mod tests {
         assert_eq!(ch3.unwrap_or(&[]), &[1000, 2000]);
     }
 
+    #[cfg(feature = "multichannel")]
+    #[test]
+    fn test_apply_embed_step_results_mirrors_source_delta() {
+        let source = AudioBuffer::new(
+            vec![vec![100, 200], vec![10, 20], vec![100, 200], vec![50, 100]],
+            48_000,
+            crate::multichannel::SampleFormat::Int16,
+        );
+        assert!(source.is_ok());
+        let Ok(mut source) = source else {
+            return;
+        };
+        let processed = AudioBuffer::new(
+            vec![vec![104, 190], vec![11, 21]],
+            48_000,
+            crate::multichannel::SampleFormat::Int16,
+        );
+        assert!(processed.is_ok());
+        let Ok(processed) = processed else {
+            return;
+        };
+        let mut step_results = vec![EmbedStepTaskResult {
+            step_idx: 0,
+            step: RouteStep {
+                name: "CH1+CH2".to_string(),
+                mode: RouteMode::Pair(0, 1),
+            },
+            outcome: Ok(processed),
+        }];
+        let mirrors = [
+            ChannelMirror {
+                channel: 2,
+                source: 0,
+                gain: 1.0,
+            },
+            ChannelMirror {
+                channel: 3,
+                source: 0,
+                gain: 0.5,
+            },
+        ];
+
+        apply_embed_step_results(&mut source, &mut step_results, &mirrors);
+        let ch2 = source.channel_samples(2);
+        let ch3 = source.channel_samples(3);
+        assert!(ch2.is_ok() && ch3.is_ok());
+        assert_eq!(ch2.unwrap_or(&[]), &[104, 190]);
+        assert_eq!(ch3.unwrap_or(&[]), &[52, 95]);
+    }
+
     #[cfg(feature = "multichannel")]
     #[test]
     fn test_finalize_detect_step_results_sorted_and_best() {
@@ -15,7 +15,7 @@ pub struct CmdArgs {
 
 /// Internal helper function.
 pub fn run(ctx: &Context, args: &CmdArgs) -> Result<()> {
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     let key = store.load()?;
     let bytes = hex::decode(&args.hex)?;
 
@@ -1,14 +1,19 @@
+use crate::discover::{self, DiscoverArgs, InputStream};
 use crate::error::{CliError, Result};
-use crate::util::{audio_from_context, ensure_file, expand_inputs, CliLayout};
+use crate::util::{audio_from_context, CliLayout};
 use crate::Context;
-use awmkit::app::{build_proof, i18n, EvidenceStore, Failure, KeyStore};
+use awmkit::app::{
+    best_fingerprint_match, build_proof, i18n, is_better_match, EvidenceStore, Failure, KeyStore,
+};
 use awmkit::ChannelLayout;
 use awmkit::Message;
 use clap::Args;
 use fluent_bundle::FluentArgs;
 use indicatif::{ProgressBar, ProgressStyle};
-use rusty_chromaprint::{match_fingerprints, Configuration};
+use rusty_chromaprint::Configuration;
 use serde::Serialize;
+use std::io::Write;
+use std::time::Instant;
 
 /// Internal constant.
 const CLONE_LIKELY_MAX_SCORE: f64 = 7.0;
@@ -21,14 +26,21 @@ const DETECT_PROGRESS_TEMPLATE: &str = "{prefix} [{bar:40}] {pos}/{len}";
 /// Internal struct.
 pub struct CmdArgs {
     /// JSON output.
-    #[arg(long)]
+    #[arg(long, conflicts_with = "watch")]
     pub json: bool,
 
+    /// Streaming JSON output: one compact object per line, flushed as each file completes.
+    #[arg(long, conflicts_with = "json")]
+    pub ndjson: bool,
+
     /// Channel layout (default: auto).
     #[arg(long, value_enum, default_value_t = CliLayout::Auto)]
     pub layout: CliLayout,
 
-    /// Input files (supports glob).
+    #[command(flatten)]
+    pub discover: DiscoverArgs,
+
+    /// Input files or directories (supports glob; directories are walked recursively).
     #[arg(value_name = "INPUT")]
     pub inputs: Vec<String>,
 }
@@ -92,17 +104,26 @@ struct DetectJson {
     fallback_reason: Option<String>,
 }
 
+#[derive(Serialize)]
+/// Internal struct.
+struct DetectNdjson<'a> {
+    /// Internal field.
+    index: u64,
+    /// Internal field.
+    elapsed_ms: u64,
+    /// Internal field.
+    #[serde(flatten)]
+    result: &'a DetectJson,
+}
+
 /// Internal helper function.
 pub fn run(ctx: &Context, args: &CmdArgs) -> Result<()> {
-    let inputs = expand_inputs(&args.inputs)?;
-    for input in &inputs {
-        ensure_file(input)?;
-    }
+    let mut inputs = discover::open(&args.inputs, &args.discover, &ctx.cancel, "detect")?;
 
-    let key_store = KeyStore::new()?;
+    let key_store = crate::startup::time("keystore", KeyStore::new)?;
     let audio = audio_from_context(ctx)?;
     let layout = args.layout.to_channel_layout();
-    let evidence_store = match EvidenceStore::load() {
+    let evidence_store = match crate::startup::time("evidence-store", EvidenceStore::load) {
         Ok(store) => Some(store),
         Err(err) => {
             let mut args_i18n = FluentArgs::new();
@@ -116,15 +137,24 @@ pub fn run(ctx: &Context, args: &CmdArgs) -> Result<()> {
     };
     log_parallelism(ctx);
 
-    if args.json {
-        run_json_mode(&inputs, &audio, &key_store, layout, evidence_store.as_ref())?;
-        return Ok(());
+    if args.json || args.ndjson {
+        if args.ndjson {
+            run_ndjson_mode(inputs, &audio, &key_store, layout, evidence_store.as_ref())?;
+        } else {
+            run_json_mode(inputs, &audio, &key_store, layout, evidence_store.as_ref())?;
+        }
+        return if ctx.cancel.is_cancelled() {
+            Err(CliError::Cancelled)
+        } else {
+            Ok(())
+        };
     }
 
-    let progress = build_progress(ctx, inputs.len())?;
+    let progress = build_progress(ctx)?;
+    inputs.attach_progress(progress.as_ref());
     let stats = run_text_mode(
         ctx,
-        &inputs,
+        inputs,
         &audio,
         &key_store,
         layout,
@@ -138,7 +168,11 @@ pub fn run(ctx: &Context, args: &CmdArgs) -> Result<()> {
 
     print_detect_summary(ctx, stats.ok, stats.miss, stats.invalid);
 
-    if stats.invalid > 0 {
+    if ctx.cancel.is_cancelled() {
+        Err(CliError::Cancelled)
+    } else if let Some(err) = stats.discovery_error {
+        Err(err)
+    } else if stats.invalid > 0 {
         Err(CliError::Message(i18n::tr("cli-detect-failed")))
     } else {
         Ok(())
@@ -153,6 +187,8 @@ struct DetectStats {
     miss: usize,
     /// Internal field.
     invalid: usize,
+    /// Internal field.
+    discovery_error: Option<CliError>,
 }
 
 /// Internal struct.
@@ -208,28 +244,79 @@ fn log_parallelism(ctx: &Context) {
 
 /// Internal helper function.
 fn run_json_mode(
-    inputs: &[std::path::PathBuf],
+    inputs: InputStream,
     audio: &awmkit::Audio,
     key_store: &KeyStore,
     layout: Option<ChannelLayout>,
     evidence_store: Option<&EvidenceStore>,
 ) -> Result<()> {
-    let results: Vec<DetectJson> = inputs
-        .iter()
-        .map(|input| detect_one_json(audio, key_store, input, layout, evidence_store))
-        .collect();
+    // 中断时只输出已完成的条目，被打断的那一项不写入结果。
+    let mut results: Vec<DetectJson> = Vec::new();
+    let mut discovery_error = None;
+    let ledger = inputs.ledger();
+    for input in inputs {
+        let input = match input {
+            Ok(input) => input,
+            Err(err) => {
+                discovery_error = Some(err);
+                break;
+            }
+        };
+        let json = detect_one_json(audio, key_store, &input, layout, evidence_store);
+        if audio.cancellation().is_cancelled() {
+            break;
+        }
+        if json.status != "error" {
+            ledger.commit(&input);
+        }
+        results.push(json);
+    }
     let output = serde_json::to_string_pretty(&results)?;
     println!("{output}");
+    discovery_error.map_or(Ok(()), Err)
+}
+
+/// 每个文件完成即写出一行紧凑 JSON 并刷新；`index` 为输入序号，`elapsed_ms` 为该文件耗时.
+fn run_ndjson_mode(
+    inputs: InputStream,
+    audio: &awmkit::Audio,
+    key_store: &KeyStore,
+    layout: Option<ChannelLayout>,
+    evidence_store: Option<&EvidenceStore>,
+) -> Result<()> {
+    let stdout = std::io::stdout();
+    let mut out = stdout.lock();
+    let ledger = inputs.ledger();
+    for (index, input) in (0_u64..).zip(inputs) {
+        let input = input?;
+        let started = Instant::now();
+        let json = detect_one_json(audio, key_store, &input, layout, evidence_store);
+        if audio.cancellation().is_cancelled() {
+            break;
+        }
+        let line = serde_json::to_string(&DetectNdjson {
+            index,
+            elapsed_ms: u64::try_from(started.elapsed().as_millis()).unwrap_or(u64::MAX),
+            result: &json,
+        })?;
+        writeln!(out, "{line}")?;
+        out.flush()?;
+        // 结果写出后才入账；检测出错的文件留待重启后重试。
+        if json.status != "error" {
+            ledger.commit(&input);
+        }
+    }
     Ok(())
 }
 
 /// Internal helper function.
-fn build_progress(ctx: &Context, len: usize) -> Result<Option<ProgressBar>> {
+fn build_progress(ctx: &Context) -> Result<Option<ProgressBar>> {
     if ctx.out.quiet() {
         return Ok(None);
     }
 
-    let bar = ProgressBar::new(len as u64);
+    // 长度随输入发现递增（运行中的总数）。
+    let bar = ProgressBar::new(0);
     bar.set_style(
         ProgressStyle::with_template(DETECT_PROGRESS_TEMPLATE)
             .map_err(|e| CliError::Message(e.to_string()))?
@@ -242,7 +329,7 @@ fn build_progress(ctx: &Context, len: usize) -> Result<Option<ProgressBar>> {
 /// Internal helper function.
 fn run_text_mode(
     ctx: &Context,
-    inputs: &[std::path::PathBuf],
+    inputs: InputStream,
     audio: &awmkit::Audio,
     key_store: &KeyStore,
     layout: Option<ChannelLayout>,
@@ -253,11 +340,28 @@ fn run_text_mode(
         ok: 0,
         miss: 0,
         invalid: 0,
+        discovery_error: None,
     };
 
+    let ledger = inputs.ledger();
     for input in inputs {
+        let input = match input {
+            Ok(input) => input,
+            Err(err) => {
+                stats.discovery_error = Some(err);
+                break;
+            }
+        };
+        let input = input.as_path();
         let execution = detect_one(audio, key_store, input, layout, evidence_store);
+        if audio.cancellation().is_cancelled() {
+            break;
+        }
         report_fallback_trace(ctx, progress, input, &execution);
+        // 检测出错（而非得出结论）的文件不入账，留待重启后重试。
+        if !matches!(execution.outcome, DetectOutcome::Error { .. }) {
+            ledger.commit(input);
+        }
 
         match execution.outcome {
             DetectOutcome::Found {
@@ -922,35 +1026,35 @@ const fn is_strict_adm_fallback_error(err: &awmkit::Error) -> bool {
 }
 
 /// Internal struct.
-struct DecodedSlotMessage {
+pub struct DecodedSlotMessage {
     /// Internal field.
-    message: awmkit::Decoded,
+    pub message: awmkit::Decoded,
     /// Internal field.
-    slot_hint: u8,
+    pub slot_hint: u8,
     /// Internal field.
-    slot_used: u8,
+    pub slot_used: u8,
     /// Internal field.
-    status: String,
+    pub status: String,
     /// Internal field.
-    scan_count: u32,
+    pub scan_count: u32,
 }
 
 /// Internal struct.
-struct InvalidSlotDecode {
+pub struct InvalidSlotDecode {
     /// Internal field.
-    slot_hint: u8,
+    pub slot_hint: u8,
     /// Internal field.
-    slot_used: Option<u8>,
+    pub slot_used: Option<u8>,
     /// Internal field.
-    status: String,
+    pub status: String,
     /// Internal field.
-    scan_count: u32,
+    pub scan_count: u32,
     /// Internal field.
-    error: String,
+    pub error: String,
 }
 
 /// Internal enum.
-enum SlotResolution {
+pub enum SlotResolution {
     /// Internal variant.
     Decoded(DecodedSlotMessage),
     /// Internal variant.
@@ -958,7 +1062,7 @@ enum SlotResolution {
 }
 
 /// Internal helper function.
-fn resolve_decode_slot(message: &[u8], key_store: &KeyStore) -> SlotResolution {
+pub fn resolve_decode_slot(message: &[u8], key_store: &KeyStore) -> SlotResolution {
     let slot_hint = match Message::peek_version_and_slot(message) {
         Ok((_, slot)) => slot,
         Err(err) => {
@@ -1061,15 +1165,16 @@ fn evaluate_clone_check(
         Err(err) => return CloneCheck::unavailable(format!("proof_error: {err}")),
     };
 
-    let candidates = match evidence_store.list_candidates(decoded.identity(), decoded.key_slot) {
+    // 已迁移到当前指纹配置的旧证据返回新指纹（`evidence migrate-fingerprints`）。
+    let candidates = match evidence_store.list_candidates_for_config(
+        decoded.identity(),
+        decoded.key_slot,
+        proof.fp_config_id,
+    ) {
         Ok(candidates) => candidates,
         Err(err) => return CloneCheck::unavailable(format!("query_error: {err}")),
     };
 
-    if candidates.is_empty() {
-        return CloneCheck::suspect(None, None, "no_evidence");
-    }
-
     if let Some(candidate) = candidates
         .iter()
         .find(|candidate| candidate.pcm_sha256 == proof.pcm_sha256)
@@ -1078,36 +1183,32 @@ fn evaluate_clone_check(
     }
 
     let config = Configuration::default();
-    let mut best_match: Option<(i64, f64, f32)> = None;
-
-    for candidate in &candidates {
-        if candidate.fp_config_id != config.id() {
-            continue;
-        }
-
-        let segments = match match_fingerprints(&proof.chromaprint, &candidate.chromaprint, &config)
-        {
-            Ok(segments) => segments,
-            Err(err) => return CloneCheck::unavailable(format!("match_error: {err}")),
-        };
-
-        for segment in segments {
-            let duration = segment.duration(&config);
-            let score = segment.score;
-            match best_match {
-                None => best_match = Some((candidate.id, score, duration)),
-                Some((_, best_score, best_duration))
-                    if duration > best_duration
-                        || ((duration - best_duration).abs() < f32::EPSILON
-                            && score < best_score) =>
-                {
-                    best_match = Some((candidate.id, score, duration));
+    let mut best_match = match best_fingerprint_match(&proof.chromaprint, &candidates, &config) {
+        Ok(best_match) => best_match,
+        Err(err) => return CloneCheck::unavailable(err.to_string()),
+    };
+    let mut has_evidence = !candidates.is_empty();
+
+    // 热表未命中时才查冷归档（`evidence archive`）。
+    if !best_match.is_some_and(|(_, score, duration)| is_likely(score, duration)) {
+        match consult_cold_tier(evidence_store, decoded, &proof, &config) {
+            Ok(ColdLookup::Exact(evidence_id)) => return CloneCheck::exact(evidence_id),
+            Ok(ColdLookup::Candidates { any, best }) => {
+                has_evidence |= any;
+                if let Some(cold_best) = best {
+                    if best_match.is_none_or(|best| is_better_match(cold_best, best)) {
+                        best_match = Some(cold_best);
+                    }
                 }
-                _ => {}
             }
+            Err(err) => return CloneCheck::unavailable(err),
         }
     }
 
+    if !has_evidence {
+        return CloneCheck::suspect(None, None, "no_evidence");
+    }
+
     if let Some((candidate_id, score, duration)) = best_match {
         if is_likely(score, duration) {
             CloneCheck::likely(candidate_id, score, duration)
@@ -1119,6 +1220,42 @@ fn evaluate_clone_check(
     }
 }
 
+/// Internal enum.
+enum ColdLookup {
+    /// Internal variant.
+    Exact(i64),
+    /// Internal variant.
+    Candidates {
+        /// Internal field.
+        any: bool,
+        /// Internal field.
+        best: Option<(i64, f64, f32)>,
+    },
+}
+
+/// 冷归档查询：先按 PCM 哈希查索引，再只解压候选所在的归档段做指纹比对.
+fn consult_cold_tier(
+    evidence_store: &EvidenceStore,
+    decoded: &awmkit::Decoded,
+    proof: &awmkit::app::AudioProof,
+    config: &Configuration,
+) -> std::result::Result<ColdLookup, String> {
+    if let Some(evidence_id) = evidence_store
+        .find_cold_exact(decoded.identity(), decoded.key_slot, &proof.pcm_sha256)
+        .map_err(|err| format!("query_error: {err}"))?
+    {
+        return Ok(ColdLookup::Exact(evidence_id));
+    }
+    let cold = evidence_store
+        .list_cold_candidates(decoded.identity(), decoded.key_slot, proof.fp_config_id)
+        .map_err(|err| format!("archive_error: {err}"))?;
+    Ok(ColdLookup::Candidates {
+        any: !cold.is_empty(),
+        best: best_fingerprint_match(&proof.chromaprint, &cold, config)
+            .map_err(|err| err.to_string())?,
+    })
+}
+
 /// Internal helper function.
 fn is_likely(score: f64, match_seconds: f32) -> bool {
     score <= CLONE_LIKELY_MAX_SCORE && match_seconds >= CLONE_LIKELY_MIN_SECONDS
@@ -1,17 +1,17 @@
+use crate::discover::{self, DiscoverArgs};
 use crate::error::{CliError, Result};
-use crate::util::{
-    audio_from_context, default_output_path, ensure_file, expand_inputs, parse_tag, CliLayout,
-};
+use crate::util::{audio_from_context, default_output_path, parse_tag, CliLayout};
 use crate::Context;
 use awmkit::app::{
-    analyze, build_proof, i18n, key_id_from_key_material, Analysis, EvidenceStore, KeyStore,
-    NewAudioEvidence, TagStore, SNR_STATUS_OK,
+    analyze, digest_pcm, i18n, key_id_from_key_material, Analysis, EvidenceJob, EvidenceQueue,
+    EvidenceStore, KeyStore, NewAudioEvidence, TagStore, SNR_STATUS_OK,
 };
-use awmkit::{Error as AwmError, Message};
+use awmkit::message::{current_utc_minutes, encode_batch, PreparedKey};
+use awmkit::{EmbedRecipient, EmbedVerification, Error as AwmError, Message};
 use clap::Args;
 use fluent_bundle::FluentArgs;
 use indicatif::{ProgressBar, ProgressStyle};
-use std::path::PathBuf;
+use std::path::{Path, PathBuf};
 
 /// Internal constant.
 const EMBED_PROGRESS_TEMPLATE: &str = "{prefix} [{bar:40}] {pos}/{len}";
@@ -20,8 +20,12 @@ const EMBED_PROGRESS_TEMPLATE: &str = "{prefix} [{bar:40}] {pos}/{len}";
 /// Internal struct.
 pub struct CmdArgs {
     /// Tag (1-7 identity or full 8-char tag).
-    #[arg(long)]
-    pub tag: String,
+    #[arg(
+        long,
+        required_unless_present = "recipients",
+        conflicts_with = "recipients"
+    )]
+    pub tag: Option<String>,
 
     /// Watermark strength (1-30).
     #[arg(long, default_value_t = 10)]
@@ -32,48 +36,73 @@ pub struct CmdArgs {
     pub layout: CliLayout,
 
     /// Output file path (single input only).
-    #[arg(long, value_name = "PATH")]
+    #[arg(long, value_name = "PATH", conflicts_with = "watch")]
     pub output: Option<PathBuf>,
 
-    /// Input files (supports glob).
+    /// Verify each output in memory right after embedding (QA gate).
+    #[arg(long)]
+    pub verify: bool,
+
+    /// Stream multichannel WAV through per-route-step pipes (bounded memory).
+    #[arg(long, conflicts_with = "verify")]
+    pub stream: bool,
+
+    /// Split long mono/stereo inputs into segments of about SECS seconds embedded in parallel.
+    #[arg(long, value_name = "SECS", conflicts_with = "stream")]
+    pub segment_secs: Option<u32>,
+
+    /// Record evidence in a journaled background queue instead of after each file.
+    #[arg(long)]
+    pub async_evidence: bool,
+
+    /// Embed one input for many recipients; FILE lists one `TAG OUTPUT` pair per line.
+    #[arg(
+        long,
+        value_name = "FILE",
+        conflicts_with_all = ["output", "verify", "stream", "segment_secs", "async_evidence", "watch"]
+    )]
+    pub recipients: Option<PathBuf>,
+
+    /// Maximum concurrent recipient embeds with `--recipients` (default: available cores).
+    #[arg(long, value_name = "N", requires = "recipients")]
+    pub workers: Option<usize>,
+
+    #[command(flatten)]
+    pub discover: DiscoverArgs,
+
+    /// Input files or directories (supports glob; directories are walked recursively).
     #[arg(value_name = "INPUT")]
     pub inputs: Vec<String>,
 }
 
 /// Internal helper function.
 pub fn run(ctx: &Context, args: &CmdArgs) -> Result<()> {
-    let inputs = expand_inputs(&args.inputs)?;
-    if args.output.is_some() && inputs.len() != 1 {
-        return Err(CliError::Message(i18n::tr("cli-embed-output_single")));
+    if let Some(list) = args.recipients.as_deref() {
+        return run_fanout(ctx, args, list);
     }
-
-    for input in &inputs {
-        ensure_file(input)?;
+    let mut inputs = discover::open(&args.inputs, &args.discover, &ctx.cancel, "embed")?;
+    if args.output.is_some() && inputs.lookahead(2)? != 1 {
+        return Err(CliError::Message(i18n::tr("cli-embed-output_single")));
     }
 
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     let active_slot = store.active_slot()?;
     let key = store.load_slot(active_slot)?;
-    let tag = parse_tag(&args.tag)?;
+    let tag = parse_tag(args.tag.as_deref().unwrap_or_default())?;
     let message = Message::encode_with_slot(awmkit::CURRENT_VERSION, &tag, &key, active_slot)?;
     let decoded_message = Message::decode(&message, &key)?;
-    let evidence_store = match EvidenceStore::load() {
-        Ok(store) => Some(store),
-        Err(err) => {
-            let mut args_i18n = FluentArgs::new();
-            args_i18n.set("error", err.to_string());
-            ctx.out.warn_diag(i18n::tr_args(
-                "cli-embed-evidence-store-unavailable-detail",
-                &args_i18n,
-            ));
-            None
-        }
+    let evidence_store = load_evidence_store(ctx);
+    let evidence_queue = if args.async_evidence && evidence_store.is_some() {
+        start_evidence_queue(ctx)
+    } else {
+        None
     };
 
     let audio = audio_from_context(ctx)?.strength(args.strength);
     let layout = args.layout.to_channel_layout();
 
-    let progress = build_progress(ctx, inputs.len())?;
+    let progress = build_progress(ctx)?;
+    inputs.attach_progress(progress.as_ref());
     let mut stats = EmbedStats::default();
     print_embed_intro(ctx);
     let shared = EmbedShared {
@@ -84,28 +113,225 @@ pub fn run(ctx: &Context, args: &CmdArgs) -> Result<()> {
         decoded_message: &decoded_message,
         key: &key,
         evidence_store: evidence_store.as_ref(),
+        evidence_queue: evidence_queue.as_ref(),
+        verify: args.verify,
+        stream: args.stream,
+        segment_secs: args.segment_secs,
         progress: progress.as_ref(),
     };
 
+    let mut discovery_error = None;
+    let ledger = inputs.ledger();
     for input in inputs {
+        // 中断后不再启动新文件；已完成文件的证据在各自处理结束时已落库。
+        if ctx.cancel.is_cancelled() {
+            break;
+        }
+        let input = match input {
+            Ok(input) => input,
+            Err(err) => {
+                discovery_error = Some(err);
+                break;
+            }
+        };
+        // 监视模式下输出与输入同目录，自己写出的结果不再作为输入。
+        if args.discover.watch && is_default_output(&input) {
+            continue;
+        }
         let output = resolve_output_path(args.output.as_ref(), &input)?;
-        process_embed_input(&shared, &input, &output, &mut stats);
+        if process_embed_input(&shared, &input, &output, &mut stats) {
+            ledger.commit(&input);
+        }
     }
 
     if let Some(bar) = progress {
         bar.finish_and_clear();
     }
+    if let Some(queue) = evidence_queue {
+        finish_evidence_queue(ctx, queue);
+    }
 
     print_embed_summary(ctx, &stats);
-    save_identity_mapping(ctx, &stats, &decoded_message, &tag);
+    if stats.success > 0 {
+        save_identity_mappings(ctx, &[(&decoded_message, &tag)]);
+    }
 
-    if stats.failed > 0 {
+    if ctx.cancel.is_cancelled() {
+        Err(CliError::Cancelled)
+    } else if let Some(err) = discovery_error {
+        Err(err)
+    } else if stats.failed > 0 {
         Err(CliError::Message(i18n::tr("cli-embed-failed")))
+    } else if stats.verify_failed > 0 {
+        Err(CliError::Message(i18n::tr("cli-embed-verify-failed")))
     } else {
         Ok(())
     }
 }
 
+/// 单输入多接收方扇出嵌入：输入只解码与规划一次，证据在结束时整批写入.
+fn run_fanout(ctx: &Context, args: &CmdArgs, list: &Path) -> Result<()> {
+    let mut inputs = discover::stream(&args.inputs, &args.discover)?;
+    let single_input = || CliError::Message(i18n::tr("cli-embed-recipients-single-input"));
+    if inputs.lookahead(2)? != 1 {
+        return Err(single_input());
+    }
+    let input = inputs.next().transpose()?.ok_or_else(single_input)?;
+    let recipients = read_recipient_list(list)?;
+
+    let store = crate::startup::time("keystore", KeyStore::new)?;
+    let active_slot = store.active_slot()?;
+    let key = store.load_slot(active_slot)?;
+    let tags: Vec<awmkit::Tag> = recipients.iter().map(|(tag, _)| tag.clone()).collect();
+    let messages = encode_batch(
+        awmkit::CURRENT_VERSION,
+        &tags,
+        &PreparedKey::new(&key)?,
+        current_utc_minutes(),
+        active_slot,
+    )?;
+    let decoded = messages
+        .iter()
+        .map(|message| Message::decode(message, &key))
+        .collect::<std::result::Result<Vec<_>, _>>()?;
+    let evidence_store = load_evidence_store(ctx);
+
+    let audio = audio_from_context(ctx)?.strength(args.strength);
+    let progress = build_progress(ctx)?;
+    if let Some(bar) = progress.as_ref() {
+        bar.set_length(u64::try_from(recipients.len()).unwrap_or(u64::MAX));
+    }
+    print_embed_intro(ctx);
+    let (Some(first_message), Some(first_decoded)) = (messages.first(), decoded.first()) else {
+        return Err(CliError::Message(i18n::tr("cli-embed-recipients-empty")));
+    };
+    let base = EmbedShared {
+        ctx,
+        audio: &audio,
+        layout: args.layout.to_channel_layout(),
+        message: first_message,
+        decoded_message: first_decoded,
+        key: &key,
+        evidence_store: evidence_store.as_ref(),
+        evidence_queue: None,
+        verify: false,
+        stream: false,
+        segment_secs: None,
+        progress: progress.as_ref(),
+    };
+
+    let mut stats = EmbedStats::default();
+    // 预检只对共享输入做一次；已含水印时所有接收方一并跳过。
+    if !handle_precheck(&base, &input, &mut stats) {
+        if let Some(bar) = progress {
+            bar.finish_and_clear();
+        }
+        print_embed_summary(ctx, &stats);
+        return if ctx.cancel.is_cancelled() {
+            Err(CliError::Cancelled)
+        } else if stats.failed > 0 {
+            Err(CliError::Message(i18n::tr("cli-embed-failed")))
+        } else {
+            Ok(())
+        };
+    }
+
+    let jobs: Vec<EmbedRecipient> = recipients
+        .iter()
+        .zip(&messages)
+        .map(|((_, output), message)| EmbedRecipient {
+            message: *message,
+            output: output.clone(),
+        })
+        .collect();
+    let workers = args
+        .workers
+        .unwrap_or_else(|| std::thread::available_parallelism().map_or(1, std::num::NonZero::get));
+    let outcomes = match audio.embed_many(&input, &jobs, base.layout, workers) {
+        Ok(outcomes) => outcomes,
+        Err(AwmError::Cancelled) => return Err(CliError::Cancelled),
+        Err(err) => return Err(err.into()),
+    };
+
+    // 每个接收方的 SNR 需要再解码一遍输入，扇出模式不计算。
+    let snr = Analysis::unavailable("fanout_batch");
+    let mut rows = Vec::new();
+    let mut mappings = Vec::new();
+    for (((job, decoded_message), (tag, _)), outcome) in
+        jobs.iter().zip(&decoded).zip(&recipients).zip(outcomes)
+    {
+        match outcome {
+            Ok(()) => {
+                stats.success = stats.success.saturating_add(1);
+                let shared = EmbedShared {
+                    message: &job.message,
+                    decoded_message,
+                    ..base
+                };
+                rows.extend(build_evidence(&shared, &input, &job.output, &snr));
+                mappings.push((decoded_message, tag));
+                report_embed_ok(ctx, &input, &job.output, &snr);
+            }
+            Err(AwmError::Cancelled) => continue,
+            Err(err) => {
+                stats.failed = stats.failed.saturating_add(1);
+                stats
+                    .failure_details
+                    .push(format!("{}: {err}", job.output.display()));
+                report_embed_error(ctx, base.progress, &job.output, &err.to_string());
+            }
+        }
+        if let Some(bar) = base.progress {
+            bar.inc(1);
+        }
+    }
+    persist_evidence_batch(ctx, evidence_store.as_ref(), rows);
+
+    if let Some(bar) = progress.as_ref() {
+        bar.finish_and_clear();
+    }
+    print_embed_summary(ctx, &stats);
+    save_identity_mappings(ctx, &mappings);
+
+    if ctx.cancel.is_cancelled() {
+        Err(CliError::Cancelled)
+    } else if stats.failed > 0 {
+        Err(CliError::Message(i18n::tr("cli-embed-failed")))
+    } else {
+        Ok(())
+    }
+}
+
+/// 读取接收方清单：每行 `TAG OUTPUT`，空行与 `#` 开头的注释行忽略.
+fn read_recipient_list(path: &Path) -> Result<Vec<(awmkit::Tag, PathBuf)>> {
+    let text = std::fs::read_to_string(path)?;
+    let mut recipients = Vec::new();
+    for (index, line) in text.lines().enumerate() {
+        let line = line.trim();
+        if line.is_empty() || line.starts_with('#') {
+            continue;
+        }
+        let parsed = line
+            .split_once(char::is_whitespace)
+            .map(|(tag, output)| (tag, output.trim()))
+            .filter(|(_, output)| !output.is_empty());
+        let Some((tag, output)) = parsed else {
+            let mut args = FluentArgs::new();
+            args.set("path", path.display().to_string());
+            args.set("line", (index + 1).to_string());
+            return Err(CliError::Message(i18n::tr_args(
+                "cli-embed-recipients-invalid-line",
+                &args,
+            )));
+        };
+        recipients.push((parse_tag(tag)?, PathBuf::from(output)));
+    }
+    if recipients.is_empty() {
+        return Err(CliError::Message(i18n::tr("cli-embed-recipients-empty")));
+    }
+    Ok(recipients)
+}
+
 #[derive(Default)]
 /// Internal struct.
 struct EmbedStats {
@@ -116,9 +342,12 @@ struct EmbedStats {
     /// Internal field.
     skipped: usize,
     /// Internal field.
+    verify_failed: usize,
+    /// Internal field.
     failure_details: Vec<String>,
 }
 
+#[derive(Clone, Copy)]
 /// Internal struct.
 struct EmbedShared<'a> {
     /// Internal field.
@@ -136,15 +365,40 @@ struct EmbedShared<'a> {
     /// Internal field.
     evidence_store: Option<&'a EvidenceStore>,
     /// Internal field.
+    evidence_queue: Option<&'a EvidenceQueue>,
+    /// Internal field.
+    verify: bool,
+    /// Internal field.
+    stream: bool,
+    /// Internal field.
+    segment_secs: Option<u32>,
+    /// Internal field.
     progress: Option<&'a ProgressBar>,
 }
 
 /// Internal helper function.
-fn build_progress(ctx: &Context, len: usize) -> Result<Option<ProgressBar>> {
+fn load_evidence_store(ctx: &Context) -> Option<EvidenceStore> {
+    match crate::startup::time("evidence-store", EvidenceStore::load) {
+        Ok(store) => Some(store),
+        Err(err) => {
+            let mut args = FluentArgs::new();
+            args.set("error", err.to_string());
+            ctx.out.warn_diag(i18n::tr_args(
+                "cli-embed-evidence-store-unavailable-detail",
+                &args,
+            ));
+            None
+        }
+    }
+}
+
+/// Internal helper function.
+fn build_progress(ctx: &Context) -> Result<Option<ProgressBar>> {
     if ctx.out.quiet() {
         return Ok(None);
     }
-    let bar = ProgressBar::new(len as u64);
+    // 长度随输入发现递增（运行中的总数）。
+    let bar = ProgressBar::new(0);
     bar.set_style(
         ProgressStyle::with_template(EMBED_PROGRESS_TEMPLATE)
             .map_err(|e| CliError::Message(e.to_string()))?
@@ -174,39 +428,87 @@ fn resolve_output_path(output_arg: Option<&PathBuf>, input: &std::path::Path) ->
     output_arg.map_or_else(|| default_output_path(input), |path| Ok(path.clone()))
 }
 
-/// Internal helper function.
+/// 是否为 [`default_output_path`] 生成的输出文件名（`<stem>_wm.wav`）.
+fn is_default_output(path: &Path) -> bool {
+    let is_wav = path
+        .extension()
+        .is_some_and(|ext| ext.eq_ignore_ascii_case("wav"));
+    is_wav
+        && path
+            .file_stem()
+            .and_then(|stem| stem.to_str())
+            .is_some_and(|stem| stem.ends_with("_wm"))
+}
+
+/// 处理单个输入；成功嵌入（开启校验时须校验通过）或因已含水印而跳过时返回 true.
 fn process_embed_input(
     shared: &EmbedShared<'_>,
     input: &std::path::Path,
     output: &std::path::Path,
     stats: &mut EmbedStats,
-) {
+) -> bool {
+    let skipped = stats.skipped;
     if !handle_precheck(shared, input, stats) {
-        return;
+        return stats.skipped > skipped;
     }
 
-    match shared
-        .audio
-        .embed_multichannel(input, output, shared.message, shared.layout)
-    {
-        Ok(()) => {
+    let embedded = if let Some(segment_secs) = shared.segment_secs {
+        shared.audio.embed_time_parallel(
+            input,
+            output,
+            shared.message,
+            shared.layout,
+            segment_secs,
+            shared.verify,
+        )
+    } else if shared.verify {
+        shared
+            .audio
+            .embed_multichannel_verified(input, output, shared.message, shared.layout)
+    } else if shared.stream {
+        shared
+            .audio
+            .embed_multichannel_streaming(input, output, shared.message, shared.layout)
+            .map(|()| None)
+    } else {
+        shared
+            .audio
+            .embed_multichannel(input, output, shared.message, shared.layout)
+            .map(|()| None)
+    };
+    let verify_failed = stats.verify_failed;
+    let done = match embedded {
+        Ok(verification) => {
             stats.success = stats.success.saturating_add(1);
-            let snr = analyze(input, output);
-            persist_evidence(shared, input, output, &snr);
+            if shared.verify {
+                report_verification(shared, output, verification.as_ref(), stats);
+            }
+            let snr = if enqueue_evidence(shared, input, output) {
+                Analysis::unavailable("evidence_async")
+            } else {
+                let snr = analyze(input, output);
+                persist_evidence(shared, input, output, &snr);
+                snr
+            };
             report_embed_ok(shared.ctx, input, output, &snr);
+            stats.verify_failed == verify_failed
         }
+        // 被中断的文件既不算失败也不推进进度；部分输出已由底层清理。
+        Err(AwmError::Cancelled) => return false,
         Err(err) => {
             stats.failed = stats.failed.saturating_add(1);
             stats
                 .failure_details
                 .push(format!("{}: {err}", input.display()));
             report_embed_error(shared.ctx, shared.progress, input, &err.to_string());
+            false
         }
-    }
+    };
 
     if let Some(bar) = shared.progress {
         bar.inc(1);
     }
+    done
 }
 
 /// Internal helper function.
@@ -231,6 +533,7 @@ fn handle_precheck(
                 return false;
             }
         }
+        Err(AwmError::Cancelled) => return false,
         Err(err) => {
             if matches!(err, AwmError::AdmUnsupported(_)) {
                 let mut args = FluentArgs::new();
@@ -262,51 +565,131 @@ fn handle_precheck(
 }
 
 /// Internal helper function.
-fn persist_evidence(
+fn report_verification(
     shared: &EmbedShared<'_>,
-    input: &std::path::Path,
     output: &std::path::Path,
-    snr: &Analysis,
+    verification: Option<&EmbedVerification>,
+    stats: &mut EmbedStats,
 ) {
-    let Some(evidence_store) = shared.evidence_store else {
+    let mut args = FluentArgs::new();
+    args.set("output", output.display().to_string());
+    let Some(verification) = verification else {
+        shared
+            .ctx
+            .out
+            .warn_diag(i18n::tr_args("cli-embed-verify-unavailable-detail", &args));
         return;
     };
+    args.set("step", verification.step.clone());
+    if verification.passed {
+        shared
+            .ctx
+            .out
+            .info_diag(i18n::tr_args("cli-embed-verify-ok-detail", &args));
+        return;
+    }
 
-    let proof = match build_proof(output) {
-        Ok(proof) => proof,
+    stats.verify_failed = stats.verify_failed.saturating_add(1);
+    let line = i18n::tr_args("cli-embed-verify-file-failed", &args);
+    if let Some(bar) = shared.progress {
+        bar.println(line);
+    } else if !shared.ctx.out.quiet() {
+        shared.ctx.out.warn_user(line);
+    }
+}
+
+/// Internal helper function.
+fn start_evidence_queue(ctx: &Context) -> Option<EvidenceQueue> {
+    match EvidenceQueue::start() {
+        Ok(queue) => Some(queue),
         Err(err) => {
             let mut args = FluentArgs::new();
-            args.set("input", input.display().to_string());
-            args.set("output", output.display().to_string());
             args.set("error", err.to_string());
-            shared.ctx.out.warn_diag(i18n::tr_args(
-                "cli-embed-evidence-proof-failed-detail",
+            ctx.out.warn_diag(i18n::tr_args(
+                "cli-embed-evidence-queue-unavailable-detail",
                 &args,
             ));
-            return;
+            None
         }
-    };
+    }
+}
 
-    let insert = NewAudioEvidence {
-        file_path: output.display().to_string(),
+/// 把证据记录交给后台队列；返回 false 时调用方应回退为同步记录.
+fn enqueue_evidence(
+    shared: &EmbedShared<'_>,
+    input: &std::path::Path,
+    output: &std::path::Path,
+) -> bool {
+    let Some(queue) = shared.evidence_queue else {
+        return false;
+    };
+    let job = EvidenceJob {
+        input_path: input.display().to_string(),
+        output_path: output.display().to_string(),
         tag: shared.decoded_message.tag.to_string(),
         identity: shared.decoded_message.identity().to_string(),
         version: shared.decoded_message.version,
         key_slot: shared.decoded_message.key_slot,
         timestamp_minutes: shared.decoded_message.timestamp_minutes,
         message_hex: hex::encode(shared.message),
-        sample_rate: proof.sample_rate,
-        channels: proof.channels,
-        sample_count: proof.sample_count,
-        pcm_sha256: proof.pcm_sha256,
         key_id: key_id_from_key_material(shared.key),
         is_forced_embed: false,
-        snr_db: snr.snr_db,
-        snr_status: snr.status.clone(),
-        chromaprint: proof.chromaprint,
-        fp_config_id: proof.fp_config_id,
     };
-    if let Err(err) = evidence_store.insert(&insert) {
+    match queue.enqueue(job) {
+        Ok(_) => true,
+        Err(err) => {
+            let mut args = FluentArgs::new();
+            args.set("input", input.display().to_string());
+            args.set("output", output.display().to_string());
+            args.set("error", err.to_string());
+            shared.ctx.out.warn_diag(i18n::tr_args(
+                "cli-embed-evidence-queue-enqueue-failed-detail",
+                &args,
+            ));
+            false
+        }
+    }
+}
+
+/// Internal helper function.
+fn finish_evidence_queue(ctx: &Context, queue: EvidenceQueue) {
+    // 中断时不等待：未处理的记录已在 journal 中，下次启动队列时重放。
+    let stats = if ctx.cancel.is_cancelled() {
+        let stats = queue.stats();
+        drop(queue);
+        stats
+    } else {
+        queue.finish()
+    };
+    let mut args = FluentArgs::new();
+    args.set("recorded", stats.recorded.to_string());
+    args.set("failed", stats.failed.to_string());
+    args.set("pending", stats.pending.to_string());
+    ctx.out.info_diag(i18n::tr_args(
+        "cli-embed-evidence-queue-summary-detail",
+        &args,
+    ));
+}
+
+/// Internal helper function.
+fn persist_evidence(
+    shared: &EmbedShared<'_>,
+    input: &std::path::Path,
+    output: &std::path::Path,
+    snr: &Analysis,
+) {
+    let Some(evidence_store) = shared.evidence_store else {
+        return;
+    };
+    let Some(evidence) = build_evidence(shared, input, output, snr) else {
+        return;
+    };
+    let written = if evidence.exists {
+        evidence_store.promote(&evidence.row)
+    } else {
+        evidence_store.insert(&evidence.row)
+    };
+    if let Err(err) = written {
         let mut args = FluentArgs::new();
         args.set("input", input.display().to_string());
         args.set("output", output.display().to_string());
@@ -318,6 +701,109 @@ fn persist_evidence(
     }
 }
 
+/// 在单个事务内写入扇出嵌入的全部证据.
+fn persist_evidence_batch(
+    ctx: &Context,
+    evidence_store: Option<&EvidenceStore>,
+    rows: Vec<EvidenceRow>,
+) {
+    let Some(evidence_store) = evidence_store else {
+        return;
+    };
+    if rows.is_empty() {
+        return;
+    }
+    let count = rows.len();
+    let (promotions, inserts): (Vec<_>, Vec<_>) = rows.into_iter().partition(|row| row.exists);
+    let inserts: Vec<NewAudioEvidence> = inserts.into_iter().map(|row| row.row).collect();
+    let promotions: Vec<NewAudioEvidence> = promotions.into_iter().map(|row| row.row).collect();
+    if let Err(err) = evidence_store.record_batch(&inserts, &promotions) {
+        let mut args = FluentArgs::new();
+        args.set("count", count.to_string());
+        args.set("error", err.to_string());
+        ctx.out.warn_diag(i18n::tr_args(
+            "cli-embed-evidence-batch-failed-detail",
+            &args,
+        ));
+    }
+}
+
+/// 待写入的证据行.
+struct EvidenceRow {
+    /// Internal field.
+    row: NewAudioEvidence,
+    /// 唯一键已有记录：只需提升，`row` 未计算指纹.
+    exists: bool,
+}
+
+/// 构造一条证据记录；无证据库或解码/指纹计算失败时返回 `None`.
+///
+/// 先只算 PCM 哈希查唯一键，已有记录时跳过指纹计算。.
+fn build_evidence(
+    shared: &EmbedShared<'_>,
+    input: &std::path::Path,
+    output: &std::path::Path,
+    snr: &Analysis,
+) -> Option<EvidenceRow> {
+    let evidence_store = shared.evidence_store?;
+    let warn_proof_failed = |err: &dyn std::fmt::Display| {
+        let mut args = FluentArgs::new();
+        args.set("input", input.display().to_string());
+        args.set("output", output.display().to_string());
+        args.set("error", err.to_string());
+        shared.ctx.out.warn_diag(i18n::tr_args(
+            "cli-embed-evidence-proof-failed-detail",
+            &args,
+        ));
+    };
+    let digest = match digest_pcm(output) {
+        Ok(digest) => digest,
+        Err(err) => {
+            warn_proof_failed(&err);
+            return None;
+        }
+    };
+
+    let identity = shared.decoded_message.identity().to_string();
+    let key_id = key_id_from_key_material(shared.key);
+    let key_slot = shared.decoded_message.key_slot;
+    // 查询失败时按新行处理，由唯一约束兜底。
+    let exists = evidence_store
+        .contains(&identity, key_slot, &key_id, &digest.pcm_sha256)
+        .unwrap_or(false);
+    let mut row = NewAudioEvidence {
+        file_path: output.display().to_string(),
+        tag: shared.decoded_message.tag.to_string(),
+        identity,
+        version: shared.decoded_message.version,
+        key_slot,
+        timestamp_minutes: shared.decoded_message.timestamp_minutes,
+        message_hex: hex::encode(shared.message),
+        sample_rate: digest.sample_rate,
+        channels: digest.channels,
+        sample_count: digest.sample_count,
+        pcm_sha256: digest.pcm_sha256.clone(),
+        key_id,
+        is_forced_embed: false,
+        snr_db: snr.snr_db,
+        snr_status: snr.status.clone(),
+        chromaprint: Vec::new(),
+        fp_config_id: 0,
+    };
+    if !exists {
+        let proof = match digest.into_proof() {
+            Ok(proof) => proof,
+            Err(err) => {
+                warn_proof_failed(&err);
+                return None;
+            }
+        };
+        row.chromaprint = proof.chromaprint;
+        row.fp_config_id = proof.fp_config_id;
+    }
+    Some(EvidenceRow { row, exists })
+}
+
 /// Internal helper function.
 fn report_embed_ok(
     ctx: &Context,
@@ -413,32 +899,33 @@ fn print_embed_summary(ctx: &Context, stats: &EmbedStats) {
 }
 
 /// Internal helper function.
-fn save_identity_mapping(
-    ctx: &Context,
-    stats: &EmbedStats,
-    decoded_message: &awmkit::Decoded,
-    tag: &awmkit::Tag,
-) {
-    if stats.success == 0 {
+fn save_identity_mappings(ctx: &Context, mappings: &[(&awmkit::Decoded, &awmkit::Tag)]) {
+    if mappings.is_empty() {
         return;
     }
-    match TagStore::load() {
-        Ok(mut store) => match store.save_if_absent(decoded_message.identity(), tag) {
-            Ok(inserted) if inserted && !ctx.out.quiet() => {
-                let mut args = FluentArgs::new();
-                args.set("identity", decoded_message.identity().to_string());
-                args.set("tag", decoded_message.tag.to_string());
-                ctx.out
-                    .info_user(i18n::tr_args("cli-embed-mapping-autosaved", &args));
-            }
-            Ok(_) => {}
-            Err(err) => {
-                let mut args = FluentArgs::new();
-                args.set("error", err.to_string());
-                ctx.out
-                    .warn_diag(i18n::tr_args("cli-embed-mapping-save-failed-detail", &args));
+    match crate::startup::time("tag-store", TagStore::load) {
+        Ok(mut store) => {
+            for (decoded_message, tag) in mappings {
+                match store.save_if_absent(decoded_message.identity(), tag) {
+                    Ok(inserted) if inserted && !ctx.out.quiet() => {
+                        let mut args = FluentArgs::new();
+                        args.set("identity", decoded_message.identity().to_string());
+                        args.set("tag", decoded_message.tag.to_string());
+                        ctx.out
+                            .info_user(i18n::tr_args("cli-embed-mapping-autosaved", &args));
+                    }
+                    Ok(_) => {}
+                    Err(err) => {
+                        let mut args = FluentArgs::new();
+                        args.set("error", err.to_string());
+                        ctx.out.warn_diag(i18n::tr_args(
+                            "cli-embed-mapping-save-failed-detail",
+                            &args,
+                        ));
+                    }
+                }
             }
-        },
+        }
         Err(err) => {
             let mut args = FluentArgs::new();
             args.set("error", err.to_string());
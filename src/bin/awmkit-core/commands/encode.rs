@@ -23,7 +23,7 @@ pub struct CmdArgs {
 
 /// Internal helper function.
 pub fn run(ctx: &Context, args: &CmdArgs) -> Result<()> {
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     let slot = store.active_slot()?;
     let key = store.load_slot(slot)?;
     let tag = parse_tag(&args.tag)?;
@@ -1,10 +1,17 @@
 use crate::error::{CliError, Result};
 use crate::Context;
-use awmkit::app::{i18n, AudioEvidence, EvidenceStore};
+use awmkit::app::{
+    apply_retention, i18n, migrate_fingerprints, AudioEvidence, EvidenceStore,
+    FingerprintMigrationOptions, RetentionPolicy,
+};
 use clap::{Args, Subcommand};
 use fluent_bundle::FluentArgs;
+use indicatif::{ProgressBar, ProgressStyle};
 use serde::Serialize;
 
+/// Internal constant.
+const MIGRATE_PROGRESS_TEMPLATE: &str = "{prefix} [{bar:40}] {pos}/{len}";
+
 #[derive(Subcommand)]
 /// Internal enum.
 pub enum Command {
@@ -19,6 +26,12 @@ pub enum Command {
 
     /// Clear evidence records by filters.
     Clear(ClearArgs),
+
+    /// Re-fingerprint evidence recorded under an older fingerprint config (resumable).
+    MigrateFingerprints(MigrateArgs),
+
+    /// Move evidence older than N days into the compressed cold archive.
+    Archive(ArchiveArgs),
 }
 
 #[derive(Args)]
@@ -87,6 +100,30 @@ pub struct ClearArgs {
     pub yes: bool,
 }
 
+#[derive(Args)]
+/// Internal struct.
+pub struct MigrateArgs {
+    /// Worker threads (0 = available parallelism).
+    #[arg(long, value_name = "N", default_value_t = 0)]
+    pub jobs: usize,
+
+    /// Max source bytes read per second, in MiB (0 = unlimited).
+    #[arg(long, value_name = "MIB", default_value_t = 0)]
+    pub io_budget: u64,
+
+    /// Retry rows that previously failed or had a missing source file.
+    #[arg(long)]
+    pub retry_failed: bool,
+}
+
+#[derive(Args)]
+/// Internal struct.
+pub struct ArchiveArgs {
+    /// Keep rows newer than this many days in the hot table.
+    #[arg(long, value_name = "DAYS")]
+    pub older_than_days: u32,
+}
+
 #[derive(Serialize)]
 /// Internal struct.
 struct EvidenceJson {
@@ -133,12 +170,14 @@ pub fn run(ctx: &Context, command: Command) -> Result<()> {
         Command::Show(args) => show(ctx, &args),
         Command::Remove(args) => remove(ctx, &args),
         Command::Clear(args) => clear(ctx, &args),
+        Command::MigrateFingerprints(args) => migrate(ctx, &args),
+        Command::Archive(args) => archive(ctx, &args),
     }
 }
 
 /// Internal helper function.
 fn list(ctx: &Context, args: &ListArgs) -> Result<()> {
-    let store = EvidenceStore::load()?;
+    let store = crate::startup::time("evidence-store", EvidenceStore::load)?;
     let items = store.list_filtered(
         args.identity.as_deref(),
         args.tag.as_deref(),
@@ -184,7 +223,7 @@ fn list(ctx: &Context, args: &ListArgs) -> Result<()> {
 
 /// Internal helper function.
 fn show(ctx: &Context, args: &ShowArgs) -> Result<()> {
-    let store = EvidenceStore::load()?;
+    let store = crate::startup::time("evidence-store", EvidenceStore::load)?;
     let Some(item) = store.get_by_id(args.id)? else {
         let mut fmt = FluentArgs::new();
         fmt.set("id", args.id.to_string());
@@ -292,7 +331,7 @@ fn show(ctx: &Context, args: &ShowArgs) -> Result<()> {
 fn remove(ctx: &Context, args: &RemoveArgs) -> Result<()> {
     ensure_yes(args.yes, "remove")?;
 
-    let store = EvidenceStore::load()?;
+    let store = crate::startup::time("evidence-store", EvidenceStore::load)?;
     if !store.remove_by_id(args.id)? {
         let mut fmt = FluentArgs::new();
         fmt.set("id", args.id.to_string());
@@ -316,7 +355,7 @@ fn clear(ctx: &Context, args: &ClearArgs) -> Result<()> {
         return Err(CliError::Message(i18n::tr("cli-evidence-clear-refuse-all")));
     }
 
-    let store = EvidenceStore::load()?;
+    let store = crate::startup::time("evidence-store", EvidenceStore::load)?;
     let removed =
         store.clear_filtered(args.identity.as_deref(), args.tag.as_deref(), args.key_slot)?;
 
@@ -337,6 +376,80 @@ fn clear(ctx: &Context, args: &ClearArgs) -> Result<()> {
     Ok(())
 }
 
+/// Internal helper function.
+fn migrate(ctx: &Context, args: &MigrateArgs) -> Result<()> {
+    let store = crate::startup::time("evidence-store", EvidenceStore::load)?;
+    let options = FingerprintMigrationOptions {
+        workers: args.jobs,
+        io_budget_bytes_per_sec: (args.io_budget > 0)
+            .then(|| args.io_budget.saturating_mul(1024 * 1024)),
+        retry_failed: args.retry_failed,
+    };
+
+    let bar = if ctx.out.quiet() {
+        None
+    } else {
+        let bar = ProgressBar::new(0);
+        bar.set_style(
+            ProgressStyle::with_template(MIGRATE_PROGRESS_TEMPLATE)
+                .map_err(|e| CliError::Message(e.to_string()))?
+                .progress_chars("=>-"),
+        );
+        bar.set_prefix("migrate");
+        Some(bar)
+    };
+    let progress = migrate_fingerprints(&store, options, &ctx.cancel, |progress| {
+        if let Some(bar) = &bar {
+            bar.set_length(progress.total as u64);
+            bar.set_position(progress.processed as u64);
+        }
+    })?;
+    if let Some(bar) = bar {
+        bar.finish_and_clear();
+    }
+
+    let mut fmt = FluentArgs::new();
+    fmt.set("config", progress.fp_config_id.to_string());
+    if progress.total == 0 {
+        ctx.out
+            .info_user(i18n::tr_args("cli-evidence-migrate-none", &fmt));
+        return Ok(());
+    }
+    fmt.set("processed", progress.processed.to_string());
+    fmt.set("total", progress.total.to_string());
+    fmt.set("migrated", progress.migrated.to_string());
+    fmt.set("missing", progress.source_missing.to_string());
+    fmt.set("changed", progress.source_changed.to_string());
+    fmt.set("failed", progress.failed.to_string());
+    ctx.out
+        .info_user(i18n::tr_args("cli-evidence-migrate-done", &fmt));
+
+    if ctx.cancel.is_cancelled() {
+        Err(CliError::Cancelled)
+    } else {
+        Ok(())
+    }
+}
+
+/// Internal helper function.
+fn archive(ctx: &Context, args: &ArchiveArgs) -> Result<()> {
+    let store = crate::startup::time("evidence-store", EvidenceStore::load)?;
+    let report = apply_retention(
+        &store,
+        RetentionPolicy {
+            hot_days: args.older_than_days,
+        },
+    )?;
+    let mut fmt = FluentArgs::new();
+    fmt.set("archived", report.archived.to_string());
+    fmt.set("segments", report.segments.to_string());
+    fmt.set("bytes", report.bytes_written.to_string());
+    fmt.set("cold", store.count_cold()?.to_string());
+    ctx.out
+        .info_user(i18n::tr_args("cli-evidence-archived", &fmt));
+    Ok(())
+}
+
 /// Internal helper function.
 fn ensure_yes(yes: bool, action: &str) -> Result<()> {
     if yes {
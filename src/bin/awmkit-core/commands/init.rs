@@ -6,7 +6,7 @@ use fluent_bundle::FluentArgs;
 
 /// Internal helper function.
 pub fn run(ctx: &Context) -> Result<()> {
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     let slot = store.active_slot()?;
     if store.exists_slot(slot) {
         return Err(CliError::Message(i18n::tr("cli-error-key_exists")));
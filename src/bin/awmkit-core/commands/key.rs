@@ -2,7 +2,8 @@ use crate::error::{CliError, Result};
 use crate::Context;
 use crate::KeyCommand;
 use awmkit::app::{
-    generate_key, i18n, EvidenceStore, Failure, KeyStore, SettingsStore, KEY_LEN, KEY_SLOT_MAX,
+    cached_settings, generate_key, i18n, update_settings, EvidenceStore, Failure, KeyStore,
+    KEY_LEN, KEY_SLOT_MAX,
 };
 use clap::{Args, Subcommand};
 use fluent_bundle::FluentArgs;
@@ -186,7 +187,7 @@ pub fn run(ctx: &Context, command: KeyCommand) -> Result<()> {
 
 /// Internal helper function.
 fn show(ctx: &Context, args: &ShowArgs) -> Result<()> {
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     let active_slot = store.active_slot()?;
     let slot = args.slot.unwrap_or(active_slot);
     let loaded = store.load_slot_with_backend(slot);
@@ -264,7 +265,7 @@ fn import(ctx: &Context, args: &ImportArgs) -> Result<()> {
         });
     }
 
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     let slot = resolve_slot(&store, args.slot)?;
     reject_slot_conflicts(&store, slot, Some(&bytes))?;
     store.save_slot(slot, &bytes)?;
@@ -278,7 +279,7 @@ fn import(ctx: &Context, args: &ImportArgs) -> Result<()> {
 
 /// Internal helper function.
 fn export(ctx: &Context, args: &ExportArgs) -> Result<()> {
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     let slot = resolve_slot(&store, args.slot)?;
     let key = store.load_slot(slot)?;
 
@@ -306,7 +307,7 @@ fn export(ctx: &Context, args: &ExportArgs) -> Result<()> {
 
 /// Internal helper function.
 fn rotate(ctx: &Context, args: &RotateArgs) -> Result<()> {
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     let slot = resolve_slot(&store, args.slot)?;
     let key = generate_key();
     reject_slot_conflicts(&store, slot, Some(&key))?;
@@ -324,10 +325,10 @@ fn delete(ctx: &Context, args: &DeleteArgs) -> Result<()> {
     if !args.yes {
         return Err(CliError::Message(i18n::tr("cli-key-delete-requires-yes")));
     }
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     let active_slot = store.active_slot()?;
     let slot = resolve_slot(&store, args.slot)?;
-    let evidence_store = EvidenceStore::load()?;
+    let evidence_store = crate::startup::time("evidence-store", EvidenceStore::load)?;
     let evidence_count = evidence_store.count_by_slot(slot)?;
     if evidence_count > 0 && !args.force {
         let mut fmt = FluentArgs::new();
@@ -373,8 +374,7 @@ fn slot(ctx: &Context, command: SlotCommand) -> Result<()> {
 
 /// Internal helper function.
 fn slot_current(ctx: &Context) -> Result<()> {
-    let store = SettingsStore::load()?;
-    let slot = store.active_key_slot()?;
+    let slot = cached_settings()?.active_key_slot;
     let mut args = FluentArgs::new();
     args.set("slot", slot.to_string());
     ctx.out
@@ -384,8 +384,7 @@ fn slot_current(ctx: &Context) -> Result<()> {
 
 /// Internal helper function.
 fn slot_use(ctx: &Context, args: &SlotUseArgs) -> Result<()> {
-    let store = SettingsStore::load()?;
-    store.set_active_key_slot(args.slot)?;
+    update_settings(|store| store.set_active_key_slot(args.slot))?;
     let mut fmt = FluentArgs::new();
     fmt.set("slot", args.slot.to_string());
     ctx.out.info_user(i18n::tr_args("cli-key-slot-set", &fmt));
@@ -394,10 +393,11 @@ fn slot_use(ctx: &Context, args: &SlotUseArgs) -> Result<()> {
 
 /// Internal helper function.
 fn slot_list(ctx: &Context, args: &SlotListArgs) -> Result<()> {
-    let store = KeyStore::new()?;
-    let settings = SettingsStore::load()?;
-    let evidence_store = EvidenceStore::load()?;
-    let active = settings.active_key_slot()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
+    let settings = cached_settings()?;
+    let evidence_store = crate::startup::time("evidence-store", EvidenceStore::load)?;
+    let active = settings.active_key_slot;
+    let usage_by_key = evidence_store.usage_by_key()?;
 
     let mut summaries = Vec::new();
     for slot in 0..=KEY_SLOT_MAX {
@@ -412,8 +412,12 @@ fn slot_list(ctx: &Context, args: &SlotListArgs) -> Result<()> {
             }
             Err(_) => (false, None, None),
         };
-        let label = settings.slot_label(slot)?;
-        let usage = evidence_store.usage_by_slot(slot)?;
+        let label = settings.slot_label(slot).map(str::to_string);
+        let slot_usage = usage_by_key.iter().filter(|entry| entry.key_slot == slot);
+        let evidence_count = slot_usage.clone().map(|entry| entry.usage.count).sum();
+        let last_used_at = slot_usage
+            .filter_map(|entry| entry.usage.last_created_at)
+            .max();
         summaries.push(SlotSummary {
             slot,
             active: slot == active,
@@ -421,8 +425,8 @@ fn slot_list(ctx: &Context, args: &SlotListArgs) -> Result<()> {
             label,
             fingerprint8,
             backend,
-            evidence_count: usage.count,
-            last_used_at: usage.last_created_at,
+            evidence_count,
+            last_used_at,
         });
     }
 
@@ -468,8 +472,7 @@ fn slot_list(ctx: &Context, args: &SlotListArgs) -> Result<()> {
 
 /// Internal helper function.
 fn slot_label_set(ctx: &Context, args: &SlotLabelSetArgs) -> Result<()> {
-    let store = SettingsStore::load()?;
-    store.set_slot_label(args.slot, &args.label)?;
+    update_settings(|store| store.set_slot_label(args.slot, &args.label))?;
     let mut fmt = FluentArgs::new();
     fmt.set("slot", args.slot.to_string());
     fmt.set("label", args.label.as_str());
@@ -480,8 +483,7 @@ fn slot_label_set(ctx: &Context, args: &SlotLabelSetArgs) -> Result<()> {
 
 /// Internal helper function.
 fn slot_label_clear(ctx: &Context, args: &SlotLabelClearArgs) -> Result<()> {
-    let store = SettingsStore::load()?;
-    store.clear_slot_label(args.slot)?;
+    update_settings(|store| store.clear_slot_label(args.slot))?;
     let mut fmt = FluentArgs::new();
     fmt.set("slot", args.slot.to_string());
     ctx.out
@@ -491,7 +493,7 @@ fn slot_label_clear(ctx: &Context, args: &SlotLabelClearArgs) -> Result<()> {
 
 /// Internal helper function.
 pub fn generate_for_active_slot() -> Result<u8> {
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     let slot = store.active_slot()?;
     reject_slot_conflicts(&store, slot, None)?;
     let key = generate_key();
@@ -515,7 +517,7 @@ fn reject_slot_conflicts(store: &KeyStore, slot: u8, candidate_key: Option<&[u8]
         )));
     }
 
-    let evidence_store = EvidenceStore::load()?;
+    let evidence_store = crate::startup::time("evidence-store", EvidenceStore::load)?;
     let usage = evidence_store.count_by_slot(slot)?;
     if usage > 0 {
         let mut args = FluentArgs::new();
@@ -13,6 +13,8 @@ pub mod init;
 /// Internal module.
 pub mod key;
 /// Internal module.
+pub mod monitor;
+/// Internal module.
 pub mod status;
 /// Internal module.
 pub mod tag;
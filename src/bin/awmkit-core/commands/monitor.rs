@@ -0,0 +1,185 @@
+use crate::commands::detect::{resolve_decode_slot, SlotResolution};
+use crate::error::Result;
+use crate::util::audio_from_context;
+use crate::Context;
+use awmkit::app::{i18n, KeyStore};
+use awmkit::{MonitorConfig, MonitorHit, MonitorReport};
+use clap::Args;
+use fluent_bundle::FluentArgs;
+use serde::Serialize;
+use std::io::Write;
+use std::path::PathBuf;
+
+#[derive(Args)]
+/// Internal struct.
+pub struct CmdArgs {
+    /// Detection window length in seconds (must hold a full watermark block).
+    #[arg(long, value_name = "SECS", default_value_t = 180)]
+    pub window_secs: u32,
+
+    /// Seconds between consecutive windows.
+    #[arg(long, value_name = "SECS", default_value_t = 30)]
+    pub hop_secs: u32,
+
+    /// Maximum windows detected concurrently (default: available cores).
+    #[arg(long, value_name = "N")]
+    pub workers: Option<usize>,
+
+    /// Live input: `-` for stdin, a FIFO, or a capture file that is still being written.
+    #[arg(value_name = "INPUT")]
+    pub input: PathBuf,
+}
+
+#[derive(Serialize)]
+/// 命中行；`status` 为 `ok`（消息已通过校验）或 `invalid`.
+struct HitJson {
+    /// Internal field.
+    event: &'static str,
+    /// Internal field.
+    window_start_secs: f64,
+    /// Internal field.
+    window_end_secs: f64,
+    /// Internal field.
+    latency_ms: u64,
+    /// Internal field.
+    status: &'static str,
+    /// Internal field.
+    tag: Option<String>,
+    /// Internal field.
+    identity: Option<String>,
+    /// Internal field.
+    key_slot: Option<u8>,
+    /// Internal field.
+    timestamp_utc: Option<u64>,
+    /// Internal field.
+    pattern: String,
+    /// Internal field.
+    bit_errors: u32,
+    /// Internal field.
+    detect_score: Option<f32>,
+    /// Internal field.
+    error: Option<String>,
+}
+
+#[derive(Serialize)]
+/// 结束时的统计行.
+struct SummaryJson {
+    /// Internal field.
+    event: &'static str,
+    /// Internal field.
+    audio_secs: f64,
+    /// Internal field.
+    windows: u64,
+    /// Internal field.
+    windows_dropped: u64,
+    /// Internal field.
+    windows_failed: u64,
+    /// Internal field.
+    first_error: Option<String>,
+    /// Internal field.
+    hits: u64,
+    /// Internal field.
+    latency_mean_ms: u64,
+    /// Internal field.
+    latency_max_ms: u64,
+    /// Internal field.
+    cpu_secs: Option<f64>,
+    /// Internal field.
+    cpu_secs_per_stream_hour: Option<f64>,
+}
+
+/// 持续监测直播输入，命中与结束统计以 NDJSON 写到 stdout.
+pub fn run(ctx: &Context, args: &CmdArgs) -> Result<()> {
+    let key_store = crate::startup::time("keystore", KeyStore::new)?;
+    let audio = audio_from_context(ctx)?;
+    let defaults = MonitorConfig::default();
+    let config = MonitorConfig {
+        window_secs: args.window_secs,
+        hop_secs: args.hop_secs,
+        workers: args.workers.unwrap_or(defaults.workers),
+    };
+
+    let stdout = std::io::stdout();
+    let mut out = stdout.lock();
+    let mut write_error = None;
+    let report = audio.monitor(&args.input, config, |hit| {
+        if write_error.is_some() {
+            return;
+        }
+        let written = serde_json::to_string(&hit_json(hit, &key_store))
+            .map_err(std::io::Error::from)
+            .and_then(|line| {
+                writeln!(out, "{line}")?;
+                out.flush()
+            });
+        if let Err(err) = written {
+            write_error = Some(err);
+            // 下游已关闭（如管道被关闭）：停止监测。
+            ctx.cancel.cancel();
+        }
+    })?;
+    if let Some(err) = write_error {
+        return Err(err.into());
+    }
+    let line = serde_json::to_string(&summary_json(&report))?;
+    writeln!(out, "{line}")?;
+    out.flush()?;
+
+    if ctx.out.verbose() {
+        let mut args_i18n = FluentArgs::new();
+        args_i18n.set("windows", report.windows.to_string());
+        args_i18n.set("dropped", report.windows_dropped.to_string());
+        args_i18n.set("failed", report.windows_failed.to_string());
+        args_i18n.set("latency", report.latency_mean_ms.to_string());
+        ctx.out
+            .info_diag(i18n::tr_args("cli-monitor-summary-detail", &args_i18n));
+    }
+    Ok(())
+}
+
+/// Internal helper function.
+fn hit_json(hit: &MonitorHit, key_store: &KeyStore) -> HitJson {
+    let mut json = HitJson {
+        event: "hit",
+        window_start_secs: hit.window_start_secs,
+        window_end_secs: hit.window_end_secs,
+        latency_ms: hit.latency_ms,
+        status: "invalid",
+        tag: None,
+        identity: None,
+        key_slot: None,
+        timestamp_utc: None,
+        pattern: hit.result.pattern.clone(),
+        bit_errors: hit.result.bit_errors,
+        detect_score: hit.result.detect_score,
+        error: None,
+    };
+    match resolve_decode_slot(&hit.result.raw_message, key_store) {
+        SlotResolution::Decoded(decoded) => {
+            json.status = "ok";
+            json.tag = Some(decoded.message.tag.to_string());
+            json.identity = Some(decoded.message.identity().to_string());
+            json.key_slot = Some(decoded.message.key_slot);
+            json.timestamp_utc = Some(decoded.message.timestamp_utc);
+        }
+        SlotResolution::Invalid(invalid) => json.error = Some(invalid.error),
+    }
+    json
+}
+
+/// Internal helper function.
+fn summary_json(report: &MonitorReport) -> SummaryJson {
+    SummaryJson {
+        event: "summary",
+        audio_secs: report.audio_secs,
+        windows: report.windows,
+        windows_dropped: report.windows_dropped,
+        windows_failed: report.windows_failed,
+        first_error: report.first_error.clone(),
+        hits: report.hits,
+        latency_mean_ms: report.latency_mean_ms,
+        latency_max_ms: report.latency_max_ms,
+        cpu_secs: report.cpu_secs,
+        cpu_secs_per_stream_hour: report.cpu_secs_per_stream_hour(),
+    }
+}
@@ -16,7 +16,7 @@ pub struct CmdArgs {
 /// Internal helper function.
 pub fn run(ctx: &Context, args: &CmdArgs) -> Result<()> {
     print_version(ctx);
-    let store = KeyStore::new()?;
+    let store = crate::startup::time("keystore", KeyStore::new)?;
     print_active_slot(ctx, store.active_slot()?);
     print_key_status(ctx, &store)?;
 
@@ -154,7 +154,7 @@ fn print_audio_capabilities(ctx: &Context, audio: &awmkit::Audio) {
 
 /// Internal helper function.
 fn print_db_status(ctx: &Context) {
-    match TagStore::load() {
+    match crate::startup::time("tag-store", TagStore::load) {
         Ok(tags) => {
             let mut args = FluentArgs::new();
             args.set("count", tags.list().len().to_string());
@@ -169,7 +169,7 @@ fn print_db_status(ctx: &Context) {
         }
     }
 
-    match EvidenceStore::load() {
+    match crate::startup::time("evidence-store", EvidenceStore::load) {
         Ok(evidence_store) => match evidence_store.count_all() {
             Ok(count) => {
                 let mut args = FluentArgs::new();
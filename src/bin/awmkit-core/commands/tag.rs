@@ -96,7 +96,7 @@ fn save(ctx: &Context, args: &SaveArgs) -> Result<()> {
         None => TagStore::suggest(&args.username)?,
     };
 
-    let mut store = TagStore::load()?;
+    let mut store = crate::startup::time("tag-store", TagStore::load)?;
     store.save(&args.username, &tag, args.force)?;
     let mut args_i18n = FluentArgs::new();
     args_i18n.set("username", args.username.as_str());
@@ -108,7 +108,7 @@ fn save(ctx: &Context, args: &SaveArgs) -> Result<()> {
 
 /// Internal helper function.
 fn list(ctx: &Context, args: &ListArgs) -> Result<()> {
-    let store = TagStore::load()?;
+    let store = crate::startup::time("tag-store", TagStore::load)?;
 
     if args.json {
         let output = TagStoreOutput {
@@ -135,7 +135,7 @@ fn list(ctx: &Context, args: &ListArgs) -> Result<()> {
 
 /// Internal helper function.
 fn remove(ctx: &Context, args: &RemoveArgs) -> Result<()> {
-    let mut store = TagStore::load()?;
+    let mut store = crate::startup::time("tag-store", TagStore::load)?;
     store.remove(&args.username)?;
     let mut args_i18n = FluentArgs::new();
     args_i18n.set("username", args.username.as_str());
@@ -146,7 +146,7 @@ fn remove(ctx: &Context, args: &RemoveArgs) -> Result<()> {
 
 /// Internal helper function.
 fn clear(ctx: &Context) -> Result<()> {
-    let mut store = TagStore::load()?;
+    let mut store = crate::startup::time("tag-store", TagStore::load)?;
     store.clear()?;
     ctx.out.info_user(i18n::tr("cli-tag-cleared"));
     Ok(())
@@ -0,0 +1,545 @@
+//! 流式输入发现：glob 与目录树在后台线程中遍历，经有界通道边发现边交给批处理.
+//!
+//! 目录由多个 worker 并行遍历；扩展名过滤不触发 `stat`，只有设置了大小/修改时间过滤时
+//! 才读取元数据。消费端丢弃 [`InputStream`] 后发送失败，遍历线程随之退出。`--watch`
+//! 时改由 [`watch`] 常驻监视目录，产出同样的输入流。.
+
+mod watch;
+
+use crate::error::{CliError, Result};
+use awmkit::app::i18n;
+use awmkit::CancellationToken;
+use clap::Args;
+use glob::glob;
+use indicatif::ProgressBar;
+use std::collections::VecDeque;
+use std::fs;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::mpsc::{sync_channel, Receiver, SyncSender};
+use std::sync::{Arc, Condvar, Mutex, PoisonError};
+use std::time::{Duration, SystemTime};
+
+/// 发现结果通道容量（背压：处理跟不上时遍历暂停）.
+const CHANNEL_BOUND: usize = 1024;
+/// 目录遍历 worker 上限.
+const MAX_WALK_WORKERS: usize = 8;
+/// 目录遍历时未指定 `--ext` 的默认扩展名（与 audiowmark 输入探测一致）.
+const DEFAULT_AUDIO_EXTENSIONS: &[&str] = &[
+    "wav", "flac", "mp3", "ogg", "opus", "m4a", "alac", "mp4", "mov", "mkv", "mka", "ts", "m2ts",
+    "m2t",
+];
+
+#[derive(Args, Clone, Debug, Default)]
+/// Internal struct.
+pub struct DiscoverArgs {
+    /// Extensions to include from directories and globs (comma separated; default for
+    /// directories: supported audio formats).
+    #[arg(long, value_name = "EXTS", value_delimiter = ',')]
+    pub ext: Vec<String>,
+
+    /// Skip discovered files smaller than this many bytes.
+    #[arg(long, value_name = "BYTES")]
+    pub min_size: Option<u64>,
+
+    /// Skip discovered files larger than this many bytes.
+    #[arg(long, value_name = "BYTES")]
+    pub max_size: Option<u64>,
+
+    /// Only include discovered files modified within this window (e.g. 90s, 30m, 12h, 7d).
+    #[arg(long, value_name = "DURATION", value_parser = parse_age)]
+    pub modified_within: Option<Duration>,
+
+    /// Keep running and process files as they land in the input directories.
+    #[arg(long)]
+    pub watch: bool,
+
+    /// With --watch, wait until size and mtime are unchanged for this long (default: 2s).
+    #[arg(long, value_name = "DURATION", value_parser = parse_age, requires = "watch")]
+    pub settle: Option<Duration>,
+
+    /// With --watch, ledger of processed files (default: next to the evidence database).
+    #[arg(long, value_name = "FILE", requires = "watch")]
+    pub watch_state: Option<PathBuf>,
+}
+
+/// Internal helper function.
+fn parse_age(value: &str) -> std::result::Result<Duration, String> {
+    let value = value.trim();
+    let split = value
+        .find(|c: char| !c.is_ascii_digit())
+        .unwrap_or(value.len());
+    let (digits, unit) = value.split_at(split);
+    let amount: u64 = digits
+        .parse()
+        .map_err(|_| format!("invalid duration: {value}"))?;
+    let scale = match unit {
+        "" | "s" => 1,
+        "m" => 60,
+        "h" => 3_600,
+        "d" => 86_400,
+        _ => return Err(format!("invalid duration unit: {value} (use s, m, h or d)")),
+    };
+    Ok(Duration::from_secs(amount.saturating_mul(scale)))
+}
+
+/// Internal struct.
+#[derive(Clone)]
+struct Filters {
+    /// Internal field.
+    ext: Vec<String>,
+    /// Internal field.
+    min_size: Option<u64>,
+    /// Internal field.
+    max_size: Option<u64>,
+    /// Internal field.
+    modified_after: Option<SystemTime>,
+}
+
+impl Filters {
+    /// Internal associated function.
+    fn from_args(args: &DiscoverArgs) -> Self {
+        Self {
+            ext: args
+                .ext
+                .iter()
+                .map(|ext| ext.trim().trim_start_matches('.').to_ascii_lowercase())
+                .filter(|ext| !ext.is_empty())
+                .collect(),
+            min_size: args.min_size,
+            max_size: args.max_size,
+            modified_after: args
+                .modified_within
+                .and_then(|age| SystemTime::now().checked_sub(age)),
+        }
+    }
+
+    /// Internal helper method.
+    fn ext_matches(&self, path: &Path, walking: bool) -> bool {
+        let Some(ext) = path
+            .extension()
+            .and_then(|ext| ext.to_str())
+            .map(str::to_ascii_lowercase)
+        else {
+            return self.ext.is_empty() && !walking;
+        };
+        if self.ext.is_empty() {
+            return !walking || DEFAULT_AUDIO_EXTENSIONS.contains(&ext.as_str());
+        }
+        self.ext.iter().any(|wanted| *wanted == ext)
+    }
+
+    /// Internal helper method.
+    const fn needs_metadata(&self) -> bool {
+        self.min_size.is_some() || self.max_size.is_some() || self.modified_after.is_some()
+    }
+
+    /// Internal helper method.
+    fn metadata_matches(&self, meta: &fs::Metadata) -> bool {
+        let size = meta.len();
+        if self.min_size.is_some_and(|min| size < min)
+            || self.max_size.is_some_and(|max| size > max)
+        {
+            return false;
+        }
+        match self.modified_after {
+            Some(after) => meta.modified().is_ok_and(|modified| modified >= after),
+            None => true,
+        }
+    }
+
+    /// 对已知是普通文件的路径应用过滤；需要元数据时才 `stat`.
+    fn accepts_file(&self, path: &Path, walking: bool) -> bool {
+        if !self.ext_matches(path, walking) {
+            return false;
+        }
+        if !self.needs_metadata() {
+            return true;
+        }
+        fs::metadata(path).is_ok_and(|meta| self.metadata_matches(&meta))
+    }
+}
+
+/// 流式输入迭代器；`discovered()` 为目前已发现的文件数（运行中的总数）.
+pub struct InputStream {
+    /// Internal field.
+    rx: Receiver<Result<PathBuf>>,
+    /// Internal field.
+    ahead: VecDeque<PathBuf>,
+    /// Internal field.
+    progress: Option<ProgressBar>,
+    /// Internal field.
+    discovered: Arc<AtomicU64>,
+    /// Internal field.
+    stop: Arc<AtomicBool>,
+    /// 监视模式的处理完成账本.
+    ledger: Ledger,
+}
+
+/// 监视模式的处理完成账本句柄；一次性发现时为空操作.
+///
+/// 消费端在文件处理成功后立即调用 [`Ledger::commit`]；失败或被中断的文件不入账，重启后重试。.
+#[derive(Clone, Default)]
+pub struct Ledger {
+    /// Internal field.
+    log: Option<Arc<Mutex<watch::StateLog>>>,
+}
+
+impl Ledger {
+    /// 把 `path` 以当前指纹记为已处理完成.
+    pub fn commit(&self, path: &Path) {
+        if let Some(log) = &self.log {
+            log.lock()
+                .unwrap_or_else(PoisonError::into_inner)
+                .commit(path);
+        }
+    }
+}
+
+impl InputStream {
+    /// 已发现（已入队）的文件数.
+    pub fn discovered(&self) -> u64 {
+        self.discovered.load(Ordering::Relaxed)
+    }
+
+    /// 处理完成账本句柄；在消费流之前取出，供逐个文件成功后入账.
+    pub fn ledger(&self) -> Ledger {
+        self.ledger.clone()
+    }
+
+    /// 绑定进度条：每取出一个条目就把长度更新为当前运行总数.
+    pub fn attach_progress(&mut self, bar: Option<&ProgressBar>) {
+        self.progress = bar.cloned();
+    }
+
+    /// 预读至多 `limit` 个文件并保留在流中，返回预读到的数量（用于单输入校验）.
+    ///
+    /// # Errors
+    /// 当发现过程中出现错误（如 glob 无匹配）时返回错误。.
+    pub fn lookahead(&mut self, limit: usize) -> Result<usize> {
+        while self.ahead.len() < limit {
+            match self.rx.recv() {
+                Ok(item) => self.ahead.push_back(item?),
+                Err(_) => break,
+            }
+        }
+        Ok(self.ahead.len())
+    }
+}
+
+impl Iterator for InputStream {
+    type Item = Result<PathBuf>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let item = match self.ahead.pop_front() {
+            Some(path) => Ok(path),
+            None => self.rx.recv().ok()?,
+        };
+        if let Some(bar) = &self.progress {
+            bar.set_length(self.discovered().max(bar.position().saturating_add(1)));
+        }
+        Some(item)
+    }
+}
+
+impl Drop for InputStream {
+    fn drop(&mut self) {
+        self.stop.store(true, Ordering::Relaxed);
+    }
+}
+
+/// Internal struct.
+struct Feed {
+    /// Internal field.
+    tx: SyncSender<Result<PathBuf>>,
+    /// Internal field.
+    discovered: Arc<AtomicU64>,
+    /// Internal field.
+    stop: Arc<AtomicBool>,
+}
+
+impl Feed {
+    /// 发送一个结果；消费端已退出时返回 false.
+    fn send(&self, item: Result<PathBuf>) -> bool {
+        if self.stop.load(Ordering::Relaxed) {
+            return false;
+        }
+        // 先计数再发送，保证消费端看到的运行总数不小于已收到的条目数。
+        if item.is_ok() {
+            self.discovered.fetch_add(1, Ordering::Relaxed);
+        }
+        if self.tx.send(item).is_err() {
+            self.stop.store(true, Ordering::Relaxed);
+            return false;
+        }
+        true
+    }
+
+    /// Internal helper method.
+    fn stopped(&self) -> bool {
+        self.stop.load(Ordering::Relaxed)
+    }
+}
+
+/// 启动输入发现.
+///
+/// 显式文件参数立即校验（缺失时直接返回错误）；glob 与目录在后台线程中流式展开。.
+///
+/// # Errors
+/// 当没有任何输入参数，或显式指定的文件不存在时返回错误。.
+pub fn stream(values: &[String], args: &DiscoverArgs) -> Result<InputStream> {
+    if values.is_empty() {
+        return Err(CliError::Message(i18n::tr("cli-util-no_input_files")));
+    }
+    for value in values {
+        if !is_glob_pattern(value) {
+            let path = Path::new(value);
+            if !path.is_file() && !path.is_dir() {
+                return Err(CliError::InputNotFound(value.clone()));
+            }
+        }
+    }
+
+    let (tx, rx) = sync_channel(CHANNEL_BOUND);
+    let discovered = Arc::new(AtomicU64::new(0));
+    let stop = Arc::new(AtomicBool::new(false));
+    let feed = Feed {
+        tx,
+        discovered: Arc::clone(&discovered),
+        stop: Arc::clone(&stop),
+    };
+    let filters = Filters::from_args(args);
+    let values = values.to_vec();
+    std::thread::Builder::new()
+        .name("awmkit-discover".to_string())
+        .spawn(move || feed_inputs(&values, &filters, &feed))?;
+
+    Ok(InputStream {
+        rx,
+        ahead: VecDeque::new(),
+        progress: None,
+        discovered,
+        stop,
+        ledger: Ledger::default(),
+    })
+}
+
+/// 按 `--watch` 选择一次性发现或常驻监视；`command` 区分各命令的监视账本.
+///
+/// # Errors
+/// 与 [`stream`] / [`watch::watch`] 相同。.
+pub fn open(
+    values: &[String],
+    args: &DiscoverArgs,
+    cancel: &CancellationToken,
+    command: &str,
+) -> Result<InputStream> {
+    if args.watch {
+        watch::watch(values, args, cancel, command)
+    } else {
+        stream(values, args)
+    }
+}
+
+/// Internal helper function.
+fn feed_inputs(values: &[String], filters: &Filters, feed: &Feed) {
+    for value in values {
+        if feed.stopped() {
+            return;
+        }
+        if is_glob_pattern(value) {
+            if !feed_glob(value, filters, feed) {
+                return;
+            }
+            continue;
+        }
+        let path = PathBuf::from(value);
+        if path.is_dir() {
+            walk_dir(path, filters, feed);
+        } else if !feed.send(Ok(path)) {
+            return;
+        }
+    }
+    if feed.discovered.load(Ordering::Relaxed) == 0 {
+        let _ = feed.send(Err(CliError::Message(i18n::tr("cli-util-no_input_files"))));
+    }
+}
+
+/// 展开单个 glob；出错时发送错误并返回 false.
+fn feed_glob(pattern: &str, filters: &Filters, feed: &Feed) -> bool {
+    let entries = match glob(pattern) {
+        Ok(entries) => entries,
+        Err(err) => {
+            let _ = feed.send(Err(CliError::InvalidGlob(err.to_string())));
+            return false;
+        }
+    };
+    let mut matched = false;
+    for entry in entries {
+        if feed.stopped() {
+            return false;
+        }
+        let path = match entry {
+            Ok(path) => path,
+            Err(err) => {
+                let _ = feed.send(Err(CliError::Glob(err.to_string())));
+                return false;
+            }
+        };
+        matched = true;
+        if path.is_dir() {
+            walk_dir(path, filters, feed);
+        } else if filters.accepts_file(&path, false) && !feed.send(Ok(path)) {
+            return false;
+        }
+    }
+    if !matched {
+        let _ = feed.send(Err(CliError::InputNotFound(pattern.to_string())));
+        return false;
+    }
+    true
+}
+
+/// Internal struct.
+struct WalkState {
+    /// Internal field.
+    dirs: Vec<PathBuf>,
+    /// Internal field.
+    active: usize,
+}
+
+/// 并行遍历目录树（不跟随目录符号链接，避免环）；阻塞直到遍历完成.
+fn walk_dir(root: PathBuf, filters: &Filters, feed: &Feed) {
+    let state = Mutex::new(WalkState {
+        dirs: vec![root],
+        active: 0,
+    });
+    let cv = Condvar::new();
+    let workers = std::thread::available_parallelism()
+        .map_or(1, std::num::NonZero::get)
+        .clamp(1, MAX_WALK_WORKERS);
+    std::thread::scope(|scope| {
+        for _ in 0..workers {
+            scope.spawn(|| walk_worker(&state, &cv, filters, feed));
+        }
+    });
+}
+
+/// Internal helper function.
+fn walk_worker(state: &Mutex<WalkState>, cv: &Condvar, filters: &Filters, feed: &Feed) {
+    loop {
+        let dir = {
+            let mut guard = state.lock().unwrap_or_else(PoisonError::into_inner);
+            loop {
+                if feed.stopped() {
+                    cv.notify_all();
+                    return;
+                }
+                if let Some(dir) = guard.dirs.pop() {
+                    guard.active = guard.active.saturating_add(1);
+                    break dir;
+                }
+                if guard.active == 0 {
+                    cv.notify_all();
+                    return;
+                }
+                guard = cv.wait(guard).unwrap_or_else(PoisonError::into_inner);
+            }
+        };
+
+        let subdirs = scan_dir(&dir, filters, feed);
+
+        let mut guard = state.lock().unwrap_or_else(PoisonError::into_inner);
+        guard.active = guard.active.saturating_sub(1);
+        if !subdirs.is_empty() {
+            guard.dirs.extend(subdirs);
+        }
+        cv.notify_all();
+    }
+}
+
+/// 扫描单个目录：文件经过滤后发送，返回子目录；不可读的目录被跳过.
+fn scan_dir(dir: &Path, filters: &Filters, feed: &Feed) -> Vec<PathBuf> {
+    let mut subdirs = Vec::new();
+    let Ok(entries) = fs::read_dir(dir) else {
+        return subdirs;
+    };
+    for entry in entries.flatten() {
+        if feed.stopped() {
+            break;
+        }
+        let Ok(file_type) = entry.file_type() else {
+            continue;
+        };
+        let path = entry.path();
+        if file_type.is_dir() {
+            subdirs.push(path);
+            continue;
+        }
+        // 文件符号链接跟随到目标；指向目录的符号链接跳过。
+        if file_type.is_symlink() && !path.is_file() {
+            continue;
+        }
+        if filters.accepts_file(&path, true) && !feed.send(Ok(path)) {
+            break;
+        }
+    }
+    subdirs
+}
+
+/// Internal helper function.
+fn is_glob_pattern(value: &str) -> bool {
+    value.contains('*') || value.contains('?') || value.contains('[')
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn parse_age_units() {
+        assert_eq!(parse_age("90"), Ok(Duration::from_secs(90)));
+        assert_eq!(parse_age("30m"), Ok(Duration::from_secs(1_800)));
+        assert_eq!(parse_age("2d"), Ok(Duration::from_secs(172_800)));
+        assert!(parse_age("5w").is_err());
+        assert!(parse_age("h").is_err());
+    }
+
+    #[test]
+    fn walk_streams_filtered_files() {
+        let root = std::env::temp_dir().join(format!(
+            "awmkit-discover-{}-{}",
+            std::process::id(),
+            SystemTime::now()
+                .duration_since(SystemTime::UNIX_EPOCH)
+                .map_or(0, |d| d.as_nanos())
+        ));
+        let nested = root.join("a").join("b");
+        assert!(fs::create_dir_all(&nested).is_ok());
+        for (path, len) in [
+            (root.join("one.wav"), 8_usize),
+            (root.join("a").join("two.FLAC"), 64),
+            (nested.join("three.wav"), 64),
+            (nested.join("notes.txt"), 64),
+        ] {
+            assert!(fs::write(path, vec![0_u8; len]).is_ok());
+        }
+
+        let args = DiscoverArgs {
+            min_size: Some(16),
+            ..DiscoverArgs::default()
+        };
+        let stream = stream(&[root.display().to_string()], &args);
+        assert!(stream.is_ok());
+        let Ok(stream) = stream else {
+            return;
+        };
+        let mut found: Vec<String> = stream
+            .filter_map(std::result::Result::ok)
+            .filter_map(|path| path.file_name().map(|n| n.to_string_lossy().into_owned()))
+            .collect();
+        found.sort();
+        assert_eq!(found, vec!["three.wav".to_string(), "two.FLAC".to_string()]);
+        let _ = fs::remove_dir_all(root);
+    }
+}
@@ -0,0 +1,528 @@
+//! 监视模式：常驻监视投递目录，文件落地并稳定后送入与批处理相同的输入流.
+//!
+//! Linux 上用 inotify 接收目录事件（新建子目录自动加入监视，事件队列溢出时整体重扫），
+//! 其他平台按固定间隔重扫。候选文件的大小与修改时间在 `--settle` 窗口内保持不变才会
+//! 入队；消费端成功处理一个条目后立即把它写入状态账本，重启后指纹未变的文件不再处理，
+//! 失败或被中断的文件不入账，重启后重试。.
+
+use super::{DiscoverArgs, Feed, Filters, InputStream, Ledger};
+use crate::error::{CliError, Result};
+use awmkit::app::{evidence_queue, i18n};
+use awmkit::CancellationToken;
+use fluent_bundle::FluentArgs;
+use std::collections::{HashMap, VecDeque};
+use std::fs::{self, File, OpenOptions};
+use std::io::{BufRead, BufReader, Write};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, AtomicU64};
+use std::sync::mpsc::sync_channel;
+use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant, SystemTime};
+
+/// 监视模式的入队上限：处理跟不上时监视线程暂停入队，事件留在内核队列中.
+const WATCH_QUEUE_BOUND: usize = 64;
+/// 稳定性检查与取消检查的间隔.
+const TICK: Duration = Duration::from_millis(250);
+/// 无 inotify 时的重扫间隔.
+const RESCAN_INTERVAL: Duration = Duration::from_secs(2);
+/// 默认稳定窗口.
+pub const DEFAULT_SETTLE: Duration = Duration::from_secs(2);
+
+/// 文件指纹：大小与修改时间（纳秒）.
+type Fingerprint = (u64, u128);
+
+/// 处理完成账本：每行 `大小\t修改时间纳秒\t路径`，只追加.
+pub struct StateLog {
+    /// Internal field.
+    file: File,
+}
+
+impl StateLog {
+    /// 记录 `path` 当前指纹；文件已消失时不记录.
+    pub fn commit(&mut self, path: &Path) {
+        let (Some(fp), Some(text)) = (fingerprint(path), path.to_str()) else {
+            return;
+        };
+        if text.contains(['\n', '\t']) {
+            return;
+        }
+        // 账本写入失败只影响重启后的去重，不中断监视。
+        let _ = writeln!(self.file, "{}\t{}\t{text}", fp.0, fp.1);
+    }
+}
+
+/// 启动监视模式输入流；流只在 `cancel` 取消后结束.
+///
+/// # Errors
+/// 当输入不是目录、状态账本无法打开或监视线程无法启动时返回错误。.
+pub fn watch(
+    values: &[String],
+    args: &DiscoverArgs,
+    cancel: &CancellationToken,
+    command: &str,
+) -> Result<InputStream> {
+    if values.is_empty() {
+        return Err(CliError::Message(i18n::tr("cli-util-no_input_files")));
+    }
+    let mut roots = Vec::with_capacity(values.len());
+    for value in values {
+        let root = Path::new(value);
+        if !root.is_dir() {
+            let mut args_i18n = FluentArgs::new();
+            args_i18n.set("path", value.as_str());
+            return Err(CliError::Message(i18n::tr_args(
+                "cli-util-watch_not_directory",
+                &args_i18n,
+            )));
+        }
+        roots.push(fs::canonicalize(root)?);
+    }
+    let state_path = match &args.watch_state {
+        Some(path) => path.clone(),
+        None => evidence_queue::journal_path()?.with_file_name(format!("watch-{command}.tsv")),
+    };
+    let done = load_state(&state_path);
+    if let Some(parent) = state_path.parent() {
+        fs::create_dir_all(parent)?;
+    }
+    let log = StateLog {
+        file: OpenOptions::new()
+            .create(true)
+            .append(true)
+            .open(&state_path)?,
+    };
+
+    let (tx, rx) = sync_channel(WATCH_QUEUE_BOUND);
+    let discovered = Arc::new(AtomicU64::new(0));
+    let stop = Arc::new(AtomicBool::new(false));
+    let feed = Feed {
+        tx,
+        discovered: Arc::clone(&discovered),
+        stop: Arc::clone(&stop),
+    };
+    let mut watcher = Watcher {
+        filters: Filters::from_args(args),
+        settle: args.settle.unwrap_or(DEFAULT_SETTLE),
+        done,
+        pending: HashMap::new(),
+    };
+    let cancel = cancel.clone();
+    std::thread::Builder::new()
+        .name("awmkit-watch".to_string())
+        .spawn(move || watcher.run(&roots, &feed, &cancel))?;
+
+    Ok(InputStream {
+        rx,
+        ahead: VecDeque::new(),
+        progress: None,
+        discovered,
+        stop,
+        ledger: Ledger {
+            log: Some(Arc::new(Mutex::new(log))),
+        },
+    })
+}
+
+/// 读取状态账本；同一路径以最后一行为准，无法解析的行跳过.
+fn load_state(path: &Path) -> HashMap<PathBuf, Fingerprint> {
+    let mut done = HashMap::new();
+    let Ok(file) = File::open(path) else {
+        return done;
+    };
+    for line in BufReader::new(file).lines() {
+        let Ok(line) = line else {
+            break;
+        };
+        let mut fields = line.splitn(3, '\t');
+        let (Some(len), Some(mtime), Some(file)) = (fields.next(), fields.next(), fields.next())
+        else {
+            continue;
+        };
+        if let (Ok(len), Ok(mtime)) = (len.parse(), mtime.parse()) {
+            done.insert(PathBuf::from(file), (len, mtime));
+        }
+    }
+    done
+}
+
+/// Internal helper function.
+fn fingerprint(path: &Path) -> Option<Fingerprint> {
+    let meta = fs::metadata(path).ok()?;
+    if !meta.is_file() {
+        return None;
+    }
+    let mtime = meta
+        .modified()
+        .ok()?
+        .duration_since(SystemTime::UNIX_EPOCH)
+        .map_or(0, |age| age.as_nanos());
+    Some((meta.len(), mtime))
+}
+
+/// 等待稳定的候选文件.
+struct Candidate {
+    /// Internal field.
+    fp: Fingerprint,
+    /// 指纹最近一次变化的时间.
+    since: Instant,
+}
+
+/// 监视线程状态.
+struct Watcher {
+    /// Internal field.
+    filters: Filters,
+    /// Internal field.
+    settle: Duration,
+    /// 已入队（或已在账本中）的文件及其指纹.
+    done: HashMap<PathBuf, Fingerprint>,
+    /// Internal field.
+    pending: HashMap<PathBuf, Candidate>,
+}
+
+impl Watcher {
+    /// 记录一个可能需要处理的文件.
+    fn observe(&mut self, path: PathBuf) {
+        if !self.filters.accepts_file(&path, true) {
+            return;
+        }
+        let Some(fp) = fingerprint(&path) else {
+            self.pending.remove(&path);
+            return;
+        };
+        if self.done.get(&path) == Some(&fp) {
+            self.pending.remove(&path);
+            return;
+        }
+        match self.pending.get_mut(&path) {
+            Some(candidate) if candidate.fp == fp => {}
+            Some(candidate) => {
+                candidate.fp = fp;
+                candidate.since = Instant::now();
+            }
+            None => {
+                self.pending.insert(
+                    path,
+                    Candidate {
+                        fp,
+                        since: Instant::now(),
+                    },
+                );
+            }
+        }
+    }
+
+    /// 扫描 `root` 下所有文件，返回遇到的目录（含 `root`）.
+    fn scan(&mut self, root: &Path) -> Vec<PathBuf> {
+        let mut dirs = vec![root.to_path_buf()];
+        let mut next = 0;
+        while let Some(dir) = dirs.get(next).cloned() {
+            next += 1;
+            let Ok(entries) = fs::read_dir(&dir) else {
+                continue;
+            };
+            for entry in entries.flatten() {
+                let Ok(file_type) = entry.file_type() else {
+                    continue;
+                };
+                if file_type.is_dir() {
+                    dirs.push(entry.path());
+                } else {
+                    self.observe(entry.path());
+                }
+            }
+        }
+        dirs
+    }
+
+    /// 复查候选文件，把已稳定的送入输入流；消费端已退出时返回 false.
+    fn flush_settled(&mut self, feed: &Feed) -> bool {
+        let now = Instant::now();
+        let paths: Vec<PathBuf> = self.pending.keys().cloned().collect();
+        for path in paths {
+            self.observe(path.clone());
+            let Some(candidate) = self.pending.get(&path) else {
+                continue;
+            };
+            if now.saturating_duration_since(candidate.since) < self.settle {
+                continue;
+            }
+            let fp = candidate.fp;
+            self.pending.remove(&path);
+            self.done.insert(path.clone(), fp);
+            if !feed.send(Ok(path)) {
+                return false;
+            }
+        }
+        true
+    }
+
+    /// Internal helper method.
+    #[cfg(target_os = "linux")]
+    fn run(&mut self, roots: &[PathBuf], feed: &Feed, cancel: &CancellationToken) {
+        let Some(mut inotify) = inotify::Inotify::new() else {
+            self.run_polling(roots, feed, cancel);
+            return;
+        };
+        for root in roots {
+            for dir in self.scan(root) {
+                inotify.add_dir(dir);
+            }
+        }
+        while !cancel.is_cancelled() && !feed.stopped() {
+            let events = inotify.wait(TICK);
+            for event in events {
+                match event {
+                    inotify::Event::File(path) => self.observe(path),
+                    inotify::Event::Dir(dir) => {
+                        for sub in self.scan(&dir) {
+                            inotify.add_dir(sub);
+                        }
+                    }
+                    inotify::Event::Overflow => {
+                        for root in roots {
+                            for dir in self.scan(root) {
+                                inotify.add_dir(dir);
+                            }
+                        }
+                    }
+                }
+            }
+            if !self.flush_settled(feed) {
+                return;
+            }
+        }
+    }
+
+    /// Internal helper method.
+    #[cfg(not(target_os = "linux"))]
+    fn run(&mut self, roots: &[PathBuf], feed: &Feed, cancel: &CancellationToken) {
+        self.run_polling(roots, feed, cancel);
+    }
+
+    /// 定时重扫（无 inotify 时）.
+    fn run_polling(&mut self, roots: &[PathBuf], feed: &Feed, cancel: &CancellationToken) {
+        let mut last_scan: Option<Instant> = None;
+        while !cancel.is_cancelled() && !feed.stopped() {
+            if last_scan.is_none_or(|at| at.elapsed() >= RESCAN_INTERVAL) {
+                for root in roots {
+                    self.scan(root);
+                }
+                last_scan = Some(Instant::now());
+            }
+            if !self.flush_settled(feed) {
+                return;
+            }
+            std::thread::sleep(TICK);
+        }
+    }
+}
+
+#[cfg(target_os = "linux")]
+/// 最小 inotify 封装：只监视目录，事件折算为候选文件、新目录或溢出.
+mod inotify {
+    use std::collections::HashMap;
+    use std::ffi::{CString, OsStr};
+    use std::os::unix::ffi::OsStrExt;
+    use std::path::PathBuf;
+    use std::time::Duration;
+
+    /// 监视的事件：写入关闭、移入、新建、修改.
+    const WATCH_MASK: u32 = libc::IN_CLOSE_WRITE
+        | libc::IN_MOVED_TO
+        | libc::IN_CREATE
+        | libc::IN_MODIFY
+        | libc::IN_ONLYDIR;
+    /// `inotify_event` 固定头长度（wd, mask, cookie, len）.
+    const EVENT_HEADER: usize = 16;
+
+    /// Internal enum.
+    pub enum Event {
+        /// 目录中的文件有变化.
+        File(PathBuf),
+        /// 新建或移入的子目录.
+        Dir(PathBuf),
+        /// 内核事件队列溢出，需要整体重扫.
+        Overflow,
+    }
+
+    /// Internal struct.
+    pub struct Inotify {
+        /// Internal field.
+        fd: libc::c_int,
+        /// Internal field.
+        dirs: HashMap<libc::c_int, PathBuf>,
+    }
+
+    impl Inotify {
+        /// 创建非阻塞 inotify 实例；内核不支持时返回 `None`.
+        #[allow(unsafe_code)]
+        pub fn new() -> Option<Self> {
+            // SAFETY: `inotify_init1` takes only flag constants and returns a new fd or -1.
+            let fd = unsafe { libc::inotify_init1(libc::IN_NONBLOCK | libc::IN_CLOEXEC) };
+            (fd >= 0).then(|| Self {
+                fd,
+                dirs: HashMap::new(),
+            })
+        }
+
+        /// 监视目录；重复添加只刷新映射，失败（如目录已删除）时忽略.
+        #[allow(unsafe_code)]
+        pub fn add_dir(&mut self, dir: PathBuf) {
+            let Ok(c_path) = CString::new(dir.as_os_str().as_bytes()) else {
+                return;
+            };
+            // SAFETY: `c_path` is a valid NUL-terminated string that outlives the call.
+            let wd = unsafe { libc::inotify_add_watch(self.fd, c_path.as_ptr(), WATCH_MASK) };
+            if wd >= 0 {
+                self.dirs.insert(wd, dir);
+            }
+        }
+
+        /// 等待至多 `timeout`，读出当前所有事件.
+        #[allow(unsafe_code)]
+        pub fn wait(&mut self, timeout: Duration) -> Vec<Event> {
+            let mut pollfd = libc::pollfd {
+                fd: self.fd,
+                events: libc::POLLIN,
+                revents: 0,
+            };
+            let timeout_ms = libc::c_int::try_from(timeout.as_millis()).unwrap_or(libc::c_int::MAX);
+            // SAFETY: `pollfd` is a valid, exclusively borrowed single-element array.
+            if unsafe { libc::poll(&mut pollfd, 1, timeout_ms) } <= 0 {
+                return Vec::new();
+            }
+            let mut events = Vec::new();
+            let mut buf = [0_u8; 64 * 1024];
+            loop {
+                // SAFETY: `buf` is valid for writes of `buf.len()` bytes for the whole call.
+                let read = unsafe { libc::read(self.fd, buf.as_mut_ptr().cast(), buf.len()) };
+                let Ok(read) = usize::try_from(read) else {
+                    break;
+                };
+                if read == 0 {
+                    break;
+                }
+                self.parse(buf.get(..read).unwrap_or_default(), &mut events);
+            }
+            events
+        }
+
+        /// 解析一段 `inotify_event` 记录.
+        fn parse(&mut self, mut bytes: &[u8], events: &mut Vec<Event>) {
+            while bytes.len() >= EVENT_HEADER {
+                let field = |at: usize| {
+                    bytes
+                        .get(at..at + 4)
+                        .and_then(|raw| raw.try_into().ok())
+                        .map_or(0, u32::from_ne_bytes)
+                };
+                let wd = libc::c_int::from_ne_bytes(field(0).to_ne_bytes());
+                let mask = field(4);
+                let name_len = usize::try_from(field(12)).unwrap_or(usize::MAX);
+                let Some(name) = bytes.get(EVENT_HEADER..EVENT_HEADER.saturating_add(name_len))
+                else {
+                    return;
+                };
+                bytes = bytes.get(EVENT_HEADER + name_len..).unwrap_or_default();
+
+                if mask & libc::IN_Q_OVERFLOW != 0 {
+                    events.push(Event::Overflow);
+                    continue;
+                }
+                if mask & libc::IN_IGNORED != 0 {
+                    self.dirs.remove(&wd);
+                    continue;
+                }
+                let name = name.split(|byte| *byte == 0).next().unwrap_or_default();
+                let Some(dir) = self.dirs.get(&wd) else {
+                    continue;
+                };
+                if name.is_empty() {
+                    continue;
+                }
+                let path = dir.join(OsStr::from_bytes(name));
+                if mask & libc::IN_ISDIR != 0 {
+                    events.push(Event::Dir(path));
+                } else {
+                    events.push(Event::File(path));
+                }
+            }
+        }
+    }
+
+    impl Drop for Inotify {
+        #[allow(unsafe_code)]
+        fn drop(&mut self) {
+            // SAFETY: `fd` was returned by `inotify_init1` and is closed exactly once.
+            unsafe {
+                libc::close(self.fd);
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn state_log_round_trips_and_settle_waits_for_stability() {
+        let root = std::env::temp_dir().join(format!(
+            "awmkit-watch-{}-{}",
+            std::process::id(),
+            SystemTime::now()
+                .duration_since(SystemTime::UNIX_EPOCH)
+                .map_or(0, |d| d.as_nanos())
+        ));
+        assert!(fs::create_dir_all(&root).is_ok());
+        let audio = root.join("drop.wav");
+        assert!(fs::write(&audio, vec![0_u8; 32]).is_ok());
+        let state_path = root.join("state.tsv");
+        let opened = OpenOptions::new()
+            .create(true)
+            .append(true)
+            .open(&state_path);
+        assert!(opened.is_ok());
+        let Ok(file) = opened else {
+            return;
+        };
+        let ledger = Ledger {
+            log: Some(Arc::new(Mutex::new(StateLog { file }))),
+        };
+        ledger.commit(&audio);
+        ledger.commit(&root.join("missing.wav"));
+        let done = load_state(&state_path);
+        assert_eq!(done.len(), 1);
+        assert_eq!(done.get(&audio).copied(), fingerprint(&audio));
+
+        let (tx, rx) = sync_channel(4);
+        let feed = Feed {
+            tx,
+            discovered: Arc::new(AtomicU64::new(0)),
+            stop: Arc::new(AtomicBool::new(false)),
+        };
+        let mut watcher = Watcher {
+            filters: Filters::from_args(&DiscoverArgs::default()),
+            settle: Duration::ZERO,
+            done,
+            pending: HashMap::new(),
+        };
+        let fresh = root.join("fresh.flac");
+        assert!(fs::write(&fresh, vec![1_u8; 8]).is_ok());
+        assert!(fs::write(root.join("notes.txt"), b"x").is_ok());
+        watcher.scan(&root);
+        // 账本中指纹未变的文件与非音频文件都不入队。
+        assert_eq!(watcher.pending.len(), 1);
+        assert!(watcher.flush_settled(&feed));
+        assert!(matches!(rx.try_recv(), Ok(Ok(ref path)) if *path == fresh));
+        assert!(rx.try_recv().is_err());
+
+        watcher.settle = Duration::from_secs(3_600);
+        assert!(fs::write(&audio, vec![0_u8; 64]).is_ok());
+        watcher.observe(audio.clone());
+        assert!(watcher.flush_settled(&feed));
+        assert!(rx.try_recv().is_err());
+        assert!(watcher.pending.contains_key(&audio));
+        let _ = fs::remove_dir_all(root);
+    }
+}
@@ -62,6 +62,10 @@ pub enum CliError {
     /// Internal variant.
     Config(String),
 
+    #[error("operation cancelled")]
+    /// Internal variant.
+    Cancelled,
+
     #[error(transparent)]
     /// Internal variant.
     Io(#[from] std::io::Error),
@@ -107,6 +111,15 @@ impl From<awmkit::app::Failure> for CliError {
 }
 
 impl CliError {
+    /// Internal helper method.
+    pub const fn exit_code(&self) -> i32 {
+        match self {
+            // 与 shell 约定一致：128 + SIGINT。
+            Self::Cancelled | Self::Awmkit(awmkit::Error::Cancelled) => 130,
+            _ => 1,
+        }
+    }
+
     /// Internal helper method.
     pub fn render_user_message(&self) -> RenderedCliError {
         let with_detail = |user: String, detail: String| RenderedCliError {
@@ -178,6 +191,10 @@ impl CliError {
             }
             Self::Database(err) => with_detail(i18n::tr("cli-error-database"), err.clone()),
             Self::Config(err) => with_detail(i18n::tr("cli-error-config"), err.clone()),
+            Self::Cancelled | Self::Awmkit(awmkit::Error::Cancelled) => RenderedCliError {
+                user: i18n::tr("cli-error-cancelled"),
+                detail: None,
+            },
             Self::Io(err) => with_detail(i18n::tr("cli-error-io"), err.to_string()),
             Self::Hex(err) => with_detail(i18n::tr("cli-error-hex"), err.to_string()),
             Self::Awmkit(err) => with_detail(i18n::tr("cli-error-audio"), err.to_string()),
@@ -2,8 +2,9 @@
 
 #[cfg(feature = "full-cli")]
 fn main() {
+    startup::mark_process_start();
     let verbose_requested = cli_arg_has_verbose();
-    preload_i18n_for_parser_errors();
+    defer_i18n_for_parser_errors();
     if let Err(err) = run() {
         let rendered = err.render_user_message();
         eprintln!("{}", rendered.user);
@@ -12,7 +13,7 @@ fn main() {
                 eprintln!("DETAIL: {detail}");
             }
         }
-        std::process::exit(1);
+        std::process::exit(err.exit_code());
     }
 }
 
@@ -29,17 +30,28 @@ fn main() {
 mod commands;
 #[cfg(feature = "full-cli")]
 /// Internal module.
+mod discover;
+#[cfg(feature = "full-cli")]
+/// Internal module.
 mod error;
 #[cfg(feature = "full-cli")]
 /// Internal module.
 mod output;
 #[cfg(feature = "full-cli")]
 /// Internal module.
+mod shutdown;
+#[cfg(feature = "full-cli")]
+/// Internal module.
+mod startup;
+#[cfg(feature = "full-cli")]
+/// Internal module.
 mod util;
 
 #[cfg(feature = "full-cli")]
 use awmkit::app::{i18n, Preferences};
 #[cfg(feature = "full-cli")]
+use awmkit::CancellationToken;
+#[cfg(feature = "full-cli")]
 use clap::{Parser, Subcommand};
 #[cfg(feature = "full-cli")]
 use error::{CliError, Result};
@@ -74,6 +86,10 @@ struct Cli {
     #[arg(long, global = true, value_name = "LANG")]
     lang: Option<String>,
 
+    /// Print per-subsystem initialisation time to stderr when the command finishes.
+    #[arg(long, global = true)]
+    startup_trace: bool,
+
     #[command(subcommand)]
     /// Internal field.
     command: Commands,
@@ -112,6 +128,9 @@ enum Commands {
     /// 从音频文件检测水印。
     Detect(commands::detect::CmdArgs),
 
+    /// 持续监测直播流中的水印（滑动窗口，NDJSON 输出）。
+    Monitor(commands::monitor::CmdArgs),
+
     /// 证据记录查询与管理。
     Evidence {
         #[command(subcommand)]
@@ -157,21 +176,29 @@ struct Context {
     out: Output,
     /// Internal field.
     audiowmark: Option<PathBuf>,
+    /// Internal field.
+    cancel: CancellationToken,
 }
 
 #[cfg(feature = "full-cli")]
 /// Internal helper function.
 fn run() -> Result<()> {
     let cli = Cli::parse();
+    if cli.startup_trace {
+        startup::enable();
+    }
 
-    let settings = Preferences::load().unwrap_or_default();
+    // 语言包在第一次输出文案时才解析；偏好文件只在命令行与环境都未指定语言时读取。
     let env_lang = i18n::env_language();
-    let lang = cli
-        .lang
-        .as_deref()
-        .or(env_lang.as_deref())
-        .or(settings.language.as_deref());
-    i18n::set_language(lang).map_err(CliError::from)?;
+    let lang = match cli.lang.clone().or(env_lang) {
+        Some(lang) => Some(lang),
+        None => {
+            startup::time("preferences", Preferences::load)
+                .unwrap_or_default()
+                .language
+        }
+    };
+    i18n::defer_language(lang.as_deref()).map_err(CliError::from)?;
 
     if cli.quiet && cli.verbose {
         return Err(CliError::Message(i18n::tr(
@@ -182,9 +209,11 @@ fn run() -> Result<()> {
     let ctx = Context {
         out: Output::new(cli.quiet, cli.verbose),
         audiowmark: cli.audiowmark,
+        cancel: CancellationToken::new(),
     };
+    startup::time("signal-handler", || shutdown::install(&ctx.cancel));
 
-    match cli.command {
+    let result = match cli.command {
         Commands::Init => commands::init::run(&ctx),
         Commands::Tag { command } => commands::tag::run(&ctx, command),
         Commands::Key { command } => commands::key::run(&ctx, command),
@@ -192,9 +221,13 @@ fn run() -> Result<()> {
         Commands::Decode(args) => commands::decode::run(&ctx, &args),
         Commands::Embed(args) => commands::embed::run(&ctx, &args),
         Commands::Detect(args) => commands::detect::run(&ctx, &args),
+        Commands::Monitor(args) => commands::monitor::run(&ctx, &args),
         Commands::Evidence { command } => commands::evidence::run(&ctx, command),
         Commands::Status(args) => commands::status::run(&ctx, &args),
-    }
+    };
+    util::finish_buffer_pool(&ctx);
+    startup::report();
+    result
 }
 
 #[cfg(feature = "full-cli")]
@@ -205,7 +238,9 @@ fn cli_arg_has_verbose() -> bool {
 }
 
 #[cfg(feature = "full-cli")]
-fn preload_i18n_for_parser_errors() {
+fn defer_i18n_for_parser_errors() {
     let env_lang = i18n::env_language();
-    let _ = i18n::set_language(env_lang.as_deref());
+    if i18n::defer_language(env_lang.as_deref()).is_err() {
+        let _ = i18n::defer_language(None);
+    }
 }
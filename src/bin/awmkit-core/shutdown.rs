@@ -0,0 +1,46 @@
+//! Ctrl-C / SIGTERM 处理：转换为协作式取消，让批处理有机会清理子进程与临时文件.
+
+use awmkit::CancellationToken;
+use std::sync::OnceLock;
+
+/// Internal item.
+static SHUTDOWN_TOKEN: OnceLock<CancellationToken> = OnceLock::new();
+
+/// 安装进程级中断处理；第一次中断取消 `token`，第二次中断立即退出。.
+pub fn install(token: &CancellationToken) {
+    if SHUTDOWN_TOKEN.set(token.clone()).is_err() {
+        return;
+    }
+    install_platform_handler();
+}
+
+#[cfg(unix)]
+#[allow(unsafe_code)]
+/// Internal helper function.
+fn install_platform_handler() {
+    // SAFETY: the handler only performs atomic loads/stores and `_exit`, all of which are
+    // async-signal-safe; `signal` is called with valid constants.
+    unsafe {
+        libc::signal(libc::SIGINT, on_signal as libc::sighandler_t);
+        libc::signal(libc::SIGTERM, on_signal as libc::sighandler_t);
+    }
+}
+
+#[cfg(not(unix))]
+/// Internal helper function.
+const fn install_platform_handler() {}
+
+#[cfg(unix)]
+#[allow(unsafe_code)]
+/// Internal helper function.
+extern "C" fn on_signal(_signum: libc::c_int) {
+    let Some(token) = SHUTDOWN_TOKEN.get() else {
+        return;
+    };
+    if token.is_cancelled() {
+        // 用户再次中断：放弃优雅清理。
+        // SAFETY: `_exit` is async-signal-safe and never returns.
+        unsafe { libc::_exit(130) };
+    }
+    token.cancel();
+}
@@ -0,0 +1,73 @@
+//! `--startup-trace`：记录各子系统首次初始化耗时，命令结束时输出到 stderr.
+//!
+//! 报告本身不经过 i18n，避免为了打印耗时而触发语言包加载。.
+
+use awmkit::app::i18n;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Mutex, OnceLock, PoisonError};
+use std::time::{Duration, Instant};
+
+/// Internal item.
+static ENABLED: AtomicBool = AtomicBool::new(false);
+/// Internal item.
+static PROCESS_START: OnceLock<Instant> = OnceLock::new();
+/// Internal item.
+static ENTRIES: Mutex<Vec<(&'static str, Duration)>> = Mutex::new(Vec::new());
+
+/// 记录进程起点（`main` 第一行调用）.
+pub fn mark_process_start() {
+    let _ = PROCESS_START.set(Instant::now());
+}
+
+/// 启用追踪，并把参数解析耗时计为第一项.
+pub fn enable() {
+    ENABLED.store(true, Ordering::Relaxed);
+    if let Some(start) = PROCESS_START.get() {
+        record("cli-parse", start.elapsed());
+    }
+}
+
+/// Internal helper function.
+fn record(name: &'static str, elapsed: Duration) {
+    ENTRIES
+        .lock()
+        .unwrap_or_else(PoisonError::into_inner)
+        .push((name, elapsed));
+}
+
+/// 执行 `init` 并在追踪启用时记录耗时.
+pub fn time<T>(name: &'static str, init: impl FnOnce() -> T) -> T {
+    if !ENABLED.load(Ordering::Relaxed) {
+        return init();
+    }
+    let started = Instant::now();
+    let value = init();
+    record(name, started.elapsed());
+    value
+}
+
+/// 输出追踪报告（未启用时无操作）.
+pub fn report() {
+    if !ENABLED.load(Ordering::Relaxed) {
+        return;
+    }
+    if let Some(elapsed) = i18n::deferred_load_duration() {
+        record("i18n", elapsed);
+    }
+    let entries = ENTRIES.lock().unwrap_or_else(PoisonError::into_inner);
+    for (name, elapsed) in entries.iter() {
+        eprintln!("startup-trace: {name:<16} {:>9.3} ms", millis(*elapsed));
+    }
+    if let Some(start) = PROCESS_START.get() {
+        eprintln!(
+            "startup-trace: {:<16} {:>9.3} ms",
+            "total",
+            millis(start.elapsed())
+        );
+    }
+}
+
+/// Internal helper function.
+fn millis(elapsed: Duration) -> f64 {
+    elapsed.as_secs_f64() * 1_000.0
+}
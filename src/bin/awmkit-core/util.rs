@@ -4,7 +4,7 @@ use awmkit::app::{i18n, AudioEngine, Config};
 use awmkit::ChannelLayout;
 use awmkit::Tag;
 use clap::ValueEnum;
-use glob::glob;
+use fluent_bundle::FluentArgs;
 use std::path::{Path, PathBuf};
 
 #[derive(Debug, Clone, Copy, PartialEq, Eq, ValueEnum)]
@@ -50,54 +50,19 @@ pub fn parse_tag(input: &str) -> Result<Tag> {
     }
 }
 
-/// Internal helper function.
-pub fn expand_inputs(values: &[String]) -> Result<Vec<PathBuf>> {
-    let mut out = Vec::new();
-    for value in values {
-        if is_glob_pattern(value) {
-            let mut matched = false;
-            let entries = glob(value).map_err(|e| CliError::InvalidGlob(e.to_string()))?;
-            for entry in entries {
-                let path = entry.map_err(|e| CliError::Glob(e.to_string()))?;
-                matched = true;
-                out.push(path);
-            }
-            if !matched {
-                return Err(CliError::InputNotFound(value.clone()));
-            }
-        } else {
-            out.push(PathBuf::from(value));
-        }
-    }
-
-    if out.is_empty() {
-        return Err(CliError::Message(i18n::tr("cli-util-no_input_files")));
-    }
-
-    Ok(out)
-}
-
-/// Internal helper function.
-pub fn ensure_file(path: &Path) -> Result<()> {
-    if path.is_file() {
-        Ok(())
-    } else {
-        Err(CliError::InputNotFound(path.display().to_string()))
-    }
-}
-
 /// Internal helper function.
 pub fn audio_from_context(ctx: &Context) -> Result<awmkit::Audio> {
     let config = Config {
         audiowmark_override: ctx.audiowmark.clone(),
     };
-    let engine = AudioEngine::new(&config).map_err(|err| match err {
+    let engine = crate::startup::time("audio-engine", || AudioEngine::new(&config));
+    let engine = engine.map_err(|err| match err {
         awmkit::app::Failure::Awmkit(awmkit::Error::AudiowmarkNotFound) => {
             CliError::AudiowmarkNotFound
         }
         other => CliError::from(other),
     })?;
-    Ok(engine.audio().clone())
+    Ok(engine.audio().clone().cancel_token(ctx.cancel.clone()))
 }
 
 /// Internal helper function.
@@ -105,7 +70,19 @@ pub fn default_output_path(input: &Path) -> Result<PathBuf> {
     awmkit::app::audio_engine::default_output_path(input).map_err(CliError::from)
 }
 
-/// Internal helper function.
-fn is_glob_pattern(value: &str) -> bool {
-    value.contains('*') || value.contains('?') || value.contains('[')
+/// 命令结束时输出缓冲池计数（`--verbose`），并释放池中保留的内存.
+pub fn finish_buffer_pool(ctx: &Context) {
+    let stats = awmkit::buffer_pool::stats();
+    if ctx.out.verbose() && stats.hits.saturating_add(stats.misses) > 0 {
+        let mut args = FluentArgs::new();
+        args.set("hits", stats.hits.to_string());
+        args.set("misses", stats.misses.to_string());
+        args.set(
+            "retained",
+            (stats.retained_bytes / (1024 * 1024)).to_string(),
+        );
+        ctx.out
+            .info_diag(i18n::tr_args("cli-buffer-pool-summary-detail", &args));
+    }
+    awmkit::buffer_pool::clear();
 }
@@ -0,0 +1,286 @@
+//! 按容量分级的缓冲区复用池.
+//!
+//! 路由步骤与批处理中每个文件都会反复申请同量级的 WAV 字节缓冲与声道样本缓冲。
+//! 池按容量向下取整到 2 的幂分级保存归还的 `Vec`，取用时在同级中找容量足够的缓冲或从
+//! 更高一级弹出，未命中时按实际需求分配；稳态批处理因此几乎不再分配。全局保留总量有上限（默认 128 MiB，可用环境变量
+//! `AWMKIT_BUFFER_POOL_MB` 或 [`set_retained_limit`] 调整，0 表示不复用），超出时直接释放；
+//! 批处理结束后调用 [`clear`] 归还全部内存。.
+
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+use std::sync::{Mutex, PoisonError};
+
+/// 最小入池容量级别（元素数 `2^12`），更小的缓冲不值得复用.
+const MIN_CLASS: u32 = 12;
+/// 级别总数（最大 `2^(CLASS_COUNT-1)` 个元素）.
+const CLASS_COUNT: usize = 31;
+/// 每个级别最多保留的缓冲数.
+const MAX_PER_CLASS: usize = 16;
+/// 默认全池保留上限（MiB）.
+const DEFAULT_RETAINED_MB: usize = 128;
+/// 尚未从环境变量读取上限的哨兵值.
+const LIMIT_UNSET: usize = usize::MAX;
+
+/// Internal item.
+static BYTES: Pool<u8> = Pool::new();
+/// Internal item.
+static SAMPLES: Pool<i32> = Pool::new();
+/// Internal item.
+static HITS: AtomicU64 = AtomicU64::new(0);
+/// Internal item.
+static MISSES: AtomicU64 = AtomicU64::new(0);
+/// Internal item.
+static RECYCLED: AtomicU64 = AtomicU64::new(0);
+/// Internal item.
+static DISCARDED: AtomicU64 = AtomicU64::new(0);
+/// Internal item.
+static RETAINED_BYTES: AtomicUsize = AtomicUsize::new(0);
+/// Internal item.
+static RETAINED_LIMIT: AtomicUsize = AtomicUsize::new(LIMIT_UNSET);
+
+/// 缓冲池计数快照.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct Stats {
+    /// 从池中取到缓冲的次数.
+    pub hits: u64,
+    /// 池中无可用缓冲而新分配的次数.
+    pub misses: u64,
+    /// 归还并入池的次数.
+    pub recycled: u64,
+    /// 因过小、过大或超出保留上限而直接释放的次数.
+    pub discarded: u64,
+    /// 当前池中保留的字节数.
+    pub retained_bytes: usize,
+    /// 池保留字节上限.
+    pub retained_limit: usize,
+}
+
+/// 读取缓冲池计数.
+#[must_use]
+pub fn stats() -> Stats {
+    Stats {
+        hits: HITS.load(Ordering::Relaxed),
+        misses: MISSES.load(Ordering::Relaxed),
+        recycled: RECYCLED.load(Ordering::Relaxed),
+        discarded: DISCARDED.load(Ordering::Relaxed),
+        retained_bytes: RETAINED_BYTES.load(Ordering::Relaxed),
+        retained_limit: retained_limit(),
+    }
+}
+
+/// 释放池中全部缓冲（计数保留）.
+pub fn clear() {
+    BYTES.trim(0);
+    SAMPLES.trim(0);
+}
+
+/// 当前保留上限（字节）；首次调用时读取 `AWMKIT_BUFFER_POOL_MB`.
+#[must_use]
+pub fn retained_limit() -> usize {
+    let limit = RETAINED_LIMIT.load(Ordering::Relaxed);
+    if limit != LIMIT_UNSET {
+        return limit;
+    }
+    let from_env = std::env::var("AWMKIT_BUFFER_POOL_MB")
+        .ok()
+        .and_then(|raw| raw.trim().parse::<usize>().ok())
+        .unwrap_or(DEFAULT_RETAINED_MB)
+        .saturating_mul(1024 * 1024)
+        .min(LIMIT_UNSET - 1);
+    // 与并发的 `set_retained_limit` 竞争时以显式设置为准。
+    match RETAINED_LIMIT.compare_exchange(
+        LIMIT_UNSET,
+        from_env,
+        Ordering::Relaxed,
+        Ordering::Relaxed,
+    ) {
+        Ok(_) => from_env,
+        Err(current) => current,
+    }
+}
+
+/// 设置保留上限（字节，0 表示不复用），并立即释放超出新上限的缓冲.
+pub fn set_retained_limit(bytes: usize) {
+    let limit = bytes.min(LIMIT_UNSET - 1);
+    RETAINED_LIMIT.store(limit, Ordering::Relaxed);
+    BYTES.trim(limit);
+    SAMPLES.trim(limit);
+}
+
+/// 取一个容量不小于 `min_len` 的空字节缓冲.
+pub(crate) fn take_bytes(min_len: usize) -> Vec<u8> {
+    BYTES.take(min_len)
+}
+
+/// 归还字节缓冲.
+pub(crate) fn give_bytes(buf: Vec<u8>) {
+    BYTES.give(buf);
+}
+
+/// 取一个容量不小于 `min_len` 的空样本缓冲.
+pub(crate) fn take_samples(min_len: usize) -> Vec<i32> {
+    SAMPLES.take(min_len)
+}
+
+/// 取一个池化缓冲并复制 `samples`.
+pub(crate) fn copy_samples(samples: &[i32]) -> Vec<i32> {
+    let mut buf = SAMPLES.take(samples.len());
+    buf.extend_from_slice(samples);
+    buf
+}
+
+/// 归还样本缓冲.
+pub(crate) fn give_samples(buf: Vec<i32>) {
+    SAMPLES.give(buf);
+}
+
+/// Internal struct.
+struct Pool<T> {
+    /// Internal field.
+    classes: Mutex<[Vec<Vec<T>>; CLASS_COUNT]>,
+}
+
+impl<T> Pool<T> {
+    /// Internal helper method.
+    const fn new() -> Self {
+        Self {
+            classes: Mutex::new([const { Vec::new() }; CLASS_COUNT]),
+        }
+    }
+
+    /// Internal helper method.
+    fn take(&self, min_len: usize) -> Vec<T> {
+        let wanted = min_len.max(1 << MIN_CLASS);
+        // 归还按容量向下取整入级：先在 `wanted` 向下取整的级别里找容量足够的缓冲，
+        // 再从向上取整的级别弹出（该级别内任一缓冲容量都 >= wanted）。
+        let floor = usize::BITS - 1 - wanted.leading_zeros();
+        let ceil = floor + u32::from(!wanted.is_power_of_two());
+        let Some(floor_index) = usize::try_from(floor).ok().filter(|&idx| idx < CLASS_COUNT) else {
+            MISSES.fetch_add(1, Ordering::Relaxed);
+            return Vec::with_capacity(min_len);
+        };
+        let pooled = {
+            let mut classes = self.classes.lock().unwrap_or_else(PoisonError::into_inner);
+            let same = &mut classes[floor_index];
+            match same.iter().rposition(|buf| buf.capacity() >= wanted) {
+                Some(pos) => Some(same.swap_remove(pos)),
+                None if ceil != floor => usize::try_from(ceil)
+                    .ok()
+                    .and_then(|idx| classes.get_mut(idx))
+                    .and_then(Vec::pop),
+                None => None,
+            }
+        };
+        if let Some(buf) = pooled {
+            RETAINED_BYTES.fetch_sub(byte_size(&buf), Ordering::Relaxed);
+            HITS.fetch_add(1, Ordering::Relaxed);
+            return buf;
+        }
+        MISSES.fetch_add(1, Ordering::Relaxed);
+        // 按实际需求分配，不向上取整到 2 的幂：避免大缓冲近一倍的空闲容量。
+        Vec::with_capacity(wanted)
+    }
+
+    /// Internal helper method.
+    fn give(&self, mut buf: Vec<T>) {
+        let capacity = buf.capacity();
+        if capacity < (1 << MIN_CLASS) {
+            DISCARDED.fetch_add(1, Ordering::Relaxed);
+            return;
+        }
+        // 归还级别向下取整。
+        let class = usize::BITS - 1 - capacity.leading_zeros();
+        let Some(index) = usize::try_from(class).ok().filter(|&idx| idx < CLASS_COUNT) else {
+            DISCARDED.fetch_add(1, Ordering::Relaxed);
+            return;
+        };
+        buf.clear();
+        let size = byte_size(&buf);
+        let limit = retained_limit();
+        let mut classes = self.classes.lock().unwrap_or_else(PoisonError::into_inner);
+        let retained = RETAINED_BYTES.load(Ordering::Relaxed);
+        if classes[index].len() >= MAX_PER_CLASS || retained.saturating_add(size) > limit {
+            DISCARDED.fetch_add(1, Ordering::Relaxed);
+            return;
+        }
+        RETAINED_BYTES.fetch_add(size, Ordering::Relaxed);
+        RECYCLED.fetch_add(1, Ordering::Relaxed);
+        classes[index].push(buf);
+    }
+
+    /// 从最大级别开始释放缓冲，直到全池保留量不超过 `limit`.
+    fn trim(&self, limit: usize) {
+        let mut classes = self.classes.lock().unwrap_or_else(PoisonError::into_inner);
+        for class in classes.iter_mut().rev() {
+            while RETAINED_BYTES.load(Ordering::Relaxed) > limit {
+                let Some(buf) = class.pop() else {
+                    break;
+                };
+                RETAINED_BYTES.fetch_sub(byte_size(&buf), Ordering::Relaxed);
+            }
+        }
+    }
+}
+
+/// Internal helper function.
+const fn byte_size<T>(buf: &Vec<T>) -> usize {
+    buf.capacity().saturating_mul(std::mem::size_of::<T>())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn recycled_buffer_is_reused_for_same_class() {
+        let mut buf = take_samples(10_000);
+        assert!(buf.capacity() >= 10_000);
+        buf.resize(10_000, 7);
+        let ptr = buf.as_ptr();
+        give_samples(buf);
+
+        // 其他测试可能并发使用全局池，只在取回同一块内存时断言其状态。
+        let again = take_samples(9_000);
+        assert!(again.capacity() >= 9_000);
+        if again.as_ptr() == ptr {
+            assert!(again.is_empty());
+        }
+        give_samples(again);
+        assert!(stats().hits >= 1);
+    }
+
+    #[test]
+    fn small_buffers_are_not_pooled() {
+        let before = stats().discarded;
+        give_bytes(Vec::with_capacity(16));
+        assert!(stats().discarded > before);
+    }
+
+    #[test]
+    fn trim_releases_pooled_buffers() {
+        let pool: Pool<u16> = Pool::new();
+        pool.give(Vec::with_capacity(1 << 13));
+        pool.give(Vec::with_capacity(1 << 20));
+        pool.trim(0);
+        let classes = pool.classes.lock().unwrap_or_else(PoisonError::into_inner);
+        assert!(classes.iter().all(Vec::is_empty));
+    }
+
+    #[test]
+    fn miss_allocates_requested_size_and_same_size_hits() {
+        let pool: Pool<u16> = Pool::new();
+        let len = 3_000_000;
+        let buf = pool.take(len);
+        assert!(buf.capacity() >= len && buf.capacity() < (1 << 22));
+        let ptr = buf.as_ptr();
+        pool.give(buf);
+
+        // 同级中容量不足的缓冲不会被取出。
+        pool.give(Vec::with_capacity((1 << 21) + 1));
+        let again = pool.take(len);
+        assert_eq!(again.as_ptr(), ptr);
+        let larger = pool.take(len + 1);
+        assert!(larger.as_ptr() != ptr);
+        pool.give(again);
+        pool.trim(0);
+    }
+}
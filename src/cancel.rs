@@ -0,0 +1,121 @@
+//! 协作式取消令牌.
+//!
+//! 长耗时操作（解码、管道拷贝、路由步骤调度、audiowmark 子进程等待）在安全点轮询令牌，
+//! 一旦取消立即终止子进程并返回 [`Error::Cancelled`]，由各自的临时目录守卫负责清理。.
+
+use std::fmt;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::Arc;
+
+use crate::error::{Error, Result};
+
+/// 可克隆的取消令牌；所有克隆共享同一取消状态。.
+#[derive(Debug, Clone, Default)]
+pub struct CancellationToken {
+    /// Internal field.
+    cancelled: Arc<AtomicBool>,
+}
+
+impl CancellationToken {
+    /// 创建未取消的令牌。.
+    #[must_use]
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// 请求取消（幂等，可跨线程/信号处理上下文调用）。.
+    pub fn cancel(&self) {
+        self.cancelled.store(true, Ordering::SeqCst);
+    }
+
+    /// 是否已请求取消。.
+    #[must_use]
+    pub fn is_cancelled(&self) -> bool {
+        self.cancelled.load(Ordering::SeqCst)
+    }
+
+    /// 已取消时返回 [`Error::Cancelled`]，供循环安全点使用。.
+    ///
+    /// # Errors
+    /// 当令牌已被取消时返回错误。.
+    pub fn check(&self) -> Result<()> {
+        if self.is_cancelled() {
+            return Err(Error::Cancelled);
+        }
+        Ok(())
+    }
+
+    /// 已取消时返回携带 [`CancelledIo`] 标记的 I/O 错误，供 `Read`/`Write` 路径使用.
+    ///
+    /// 错误类型不是 `Interrupted`：`read_exact`、`write_all`、`io::copy` 等会自动重试
+    /// `Interrupted`，取消后会一直空转。转换为 [`Error`] 时还原为 [`Error::Cancelled`]。.
+    pub(crate) fn check_io(&self) -> std::io::Result<()> {
+        if self.is_cancelled() {
+            return Err(std::io::Error::other(CancelledIo));
+        }
+        Ok(())
+    }
+}
+
+/// I/O 路径上的取消标记.
+#[derive(Debug)]
+pub(crate) struct CancelledIo;
+
+impl fmt::Display for CancelledIo {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.write_str("operation cancelled")
+    }
+}
+
+impl std::error::Error for CancelledIo {}
+
+/// `err` 是否由 [`CancellationToken::check_io`] 产生.
+pub(crate) fn is_cancelled_io(err: &std::io::Error) -> bool {
+    err.get_ref().is_some_and(|inner| inner.is::<CancelledIo>())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn clones_share_cancel_state() {
+        let token = CancellationToken::new();
+        let clone = token.clone();
+        assert!(!clone.is_cancelled());
+        assert!(token.check().is_ok());
+
+        token.cancel();
+        assert!(clone.is_cancelled());
+        assert!(matches!(clone.check(), Err(Error::Cancelled)));
+        assert!(clone.check_io().is_err());
+    }
+
+    #[test]
+    fn cancelled_io_is_not_retried_and_maps_back() {
+        /// 每次读取都检查令牌的读取器.
+        struct Guarded(CancellationToken);
+        impl std::io::Read for Guarded {
+            fn read(&mut self, _buf: &mut [u8]) -> std::io::Result<usize> {
+                self.0.check_io()?;
+                Ok(0)
+            }
+        }
+
+        let token = CancellationToken::new();
+        token.cancel();
+        // `io::copy` 会重试 `Interrupted`；取消错误必须直接返回。
+        let copied = std::io::copy(&mut Guarded(token.clone()), &mut std::io::sink());
+        assert!(copied.is_err());
+        let Err(err) = copied else {
+            return;
+        };
+        assert_ne!(err.kind(), std::io::ErrorKind::Interrupted);
+        assert!(is_cancelled_io(&err));
+        assert!(matches!(Error::from(err), Error::Cancelled));
+        assert!(matches!(
+            Error::from(std::io::Error::other("disk full")),
+            Error::Io(_)
+        ));
+    }
+}
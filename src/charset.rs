@@ -8,15 +8,38 @@ pub const CHARSET: &[u8; 32] = b"ABCDEFGHJKMNPQRSTUVWXYZ23456789_";
 /// 校验位计算用素数.
 pub const PRIMES: [u32; 7] = [3, 5, 7, 11, 13, 17, 19];
 
+/// [`CHAR_INDEX`] 中表示非法字符的标记位；合法索引都小于 32.
+pub const INVALID_INDEX: u8 = 0x80;
+
+/// 编译期生成的字节 → 索引查找表（大小写不敏感），非法字节为 [`INVALID_INDEX`].
+pub const CHAR_INDEX: [u8; 256] = build_char_index();
+
+/// Internal helper function.
+const fn build_char_index() -> [u8; 256] {
+    let mut table = [INVALID_INDEX; 256];
+    let mut i = 0;
+    while i < CHARSET.len() {
+        let c = CHARSET[i];
+        // i < 32，截断安全。
+        #[allow(clippy::cast_possible_truncation)]
+        let index = i as u8;
+        table[c as usize] = index;
+        table[c.to_ascii_lowercase() as usize] = index;
+        i += 1;
+    }
+    table
+}
+
 /// 字符转索引 (0-31)，无效字符返回 None.
 #[inline]
 #[must_use]
-pub fn char_to_index(c: u8) -> Option<u8> {
-    let c = c.to_ascii_uppercase();
-    CHARSET
-        .iter()
-        .position(|&x| x == c)
-        .and_then(|i| u8::try_from(i).ok())
+pub const fn char_to_index(c: u8) -> Option<u8> {
+    let index = CHAR_INDEX[c as usize];
+    if index & INVALID_INDEX == 0 {
+        Some(index)
+    } else {
+        None
+    }
 }
 
 /// 索引转字符.
@@ -29,8 +52,8 @@ pub fn index_to_char(i: u8) -> Option<u8> {
 /// 验证字符是否在字符集内.
 #[inline]
 #[must_use]
-pub fn is_valid_char(c: u8) -> bool {
-    char_to_index(c).is_some()
+pub const fn is_valid_char(c: u8) -> bool {
+    CHAR_INDEX[c as usize] & INVALID_INDEX == 0
 }
 
 #[cfg(test)]
@@ -67,6 +90,16 @@ mod tests {
         assert_eq!(char_to_index(b'z'), char_to_index(b'Z'));
     }
 
+    #[test]
+    fn test_lookup_table_matches_charset_scan() {
+        for c in 0..=u8::MAX {
+            let upper = c.to_ascii_uppercase();
+            let scanned = CHARSET.iter().position(|&x| x == upper);
+            assert_eq!(char_to_index(c).map(usize::from), scanned);
+            assert_eq!(is_valid_char(c), scanned.is_some());
+        }
+    }
+
     #[test]
     fn test_round_trip() {
         for i in 0..32u8 {
@@ -58,8 +58,23 @@ pub enum Error {
     #[error("Invalid output format: {0}")]
     InvalidOutputFormat(String),
 
+    #[error("Operation cancelled")]
+    Cancelled,
+
     #[error("IO error: {0}")]
-    Io(#[from] std::io::Error),
+    Io(#[source] std::io::Error),
+}
+
+/// I/O 错误转换：[`crate::cancel::CancellationToken::check_io`] 产生的取消标记还原为
+/// [`Error::Cancelled`]，其余保持为 [`Error::Io`].
+impl From<std::io::Error> for Error {
+    fn from(err: std::io::Error) -> Self {
+        if crate::cancel::is_cancelled_io(&err) {
+            Self::Cancelled
+        } else {
+            Self::Io(err)
+        }
+    }
 }
 
 pub type Result<T> = std::result::Result<T, Error>;
@@ -14,15 +14,18 @@ use crate::tag::Tag;
 
 #[cfg(feature = "app")]
 use crate::app::{
-    analyze, build_proof, key_id_from_key_material, EvidenceStore, KeySlotSummary,
-    NewAudioEvidence, SettingsStore, TagStore,
+    analyze, best_fingerprint_match, build_proof, cached_settings, digest_pcm, is_better_match,
+    key_id_from_key_material, update_settings, EvidenceJob, EvidenceQueue, EvidenceStore,
+    KeySlotSummary, NewAudioEvidence, TagStore,
 };
 #[cfg(feature = "app")]
-use rusty_chromaprint::{match_fingerprints, Configuration};
+use rusty_chromaprint::Configuration;
 #[cfg(feature = "app")]
 use serde::Serialize;
 #[cfg(feature = "app")]
 use std::panic::{catch_unwind, AssertUnwindSafe};
+#[cfg(feature = "app")]
+use std::sync::{Mutex, PoisonError};
 
 /// FFI 错误码.
 #[repr(i32)]
@@ -42,6 +45,7 @@ pub enum AWMError {
     AdmUnsupported = -12,
     AdmPreserveFailed = -13,
     AdmPcmFormatUnsupported = -14,
+    Cancelled = -15,
 }
 
 /// 解码结果结构体.
@@ -195,6 +199,66 @@ pub unsafe extern "C" fn awm_tag_identity(tag: *const c_char, out: *mut c_char)
     })
 }
 
+/// 批量验证定长 8 字节 Tag（查表，无逐项分配）.
+///
+/// # Safety
+/// - `tags` 必须指向 `count * 8` 字节（Tag 首尾相接，无 NUL 分隔）
+/// - `out_valid` 必须指向至少 `count` 个 `bool` 的缓冲区
+#[no_mangle]
+pub unsafe extern "C" fn awm_tag_verify_batch(
+    tags: *const c_char,
+    count: usize,
+    out_valid: *mut bool,
+) -> i32 {
+    if tags.is_null() || out_valid.is_null() {
+        return AWMError::NullPointer as i32;
+    }
+
+    let raw = slice::from_raw_parts(tags.cast::<[u8; 8]>(), count);
+    let out = slice::from_raw_parts_mut(out_valid, count);
+    for (slot, tag) in out.iter_mut().zip(raw) {
+        *slot = crate::tag::normalize_raw(tag).is_some();
+    }
+    AWMError::Success as i32
+}
+
+/// 批量提取定长 8 字节 Tag 的身份部分.
+///
+/// # Safety
+/// - `tags` 必须指向 `count * 8` 字节（Tag 首尾相接，无 NUL 分隔）
+/// - `out` 必须指向至少 `count * 8` 字节；每项 8 字节，写入以 NUL 结尾的身份（非法项为空串）
+/// - `out_valid` 必须指向至少 `count` 个 `bool` 的缓冲区
+#[no_mangle]
+pub unsafe extern "C" fn awm_tag_identity_batch(
+    tags: *const c_char,
+    count: usize,
+    out: *mut c_char,
+    out_valid: *mut bool,
+) -> i32 {
+    if tags.is_null() || out.is_null() || out_valid.is_null() {
+        return AWMError::NullPointer as i32;
+    }
+
+    let raw = slice::from_raw_parts(tags.cast::<[u8; 8]>(), count);
+    let identities = slice::from_raw_parts_mut(out.cast::<[u8; 8]>(), count);
+    let valid = slice::from_raw_parts_mut(out_valid, count);
+    for ((tag, identity), ok) in raw.iter().zip(identities.iter_mut()).zip(valid.iter_mut()) {
+        *identity = [0; 8];
+        let Some(chars) = crate::tag::normalize_raw(tag) else {
+            *ok = false;
+            continue;
+        };
+        // 身份为前 7 字符去掉尾部 `_` 补齐。
+        let len = chars[..7]
+            .iter()
+            .rposition(|&c| c != b'_')
+            .map_or(0, |i| i + 1);
+        identity[..len].copy_from_slice(&chars[..len]);
+        *ok = true;
+    }
+    AWMError::Success as i32
+}
+
 /// 编码消息.
 ///
 /// # Safety
@@ -383,6 +447,91 @@ pub unsafe extern "C" fn awm_message_verify(
     message::verify(data_slice, key_slice)
 }
 
+/// 批量编码消息（当前时间戳 + 指定槽位，共用预置密钥）.
+///
+/// # Safety
+/// - `tags` 必须指向 `count` 个有效的 8 字符 C 字符串指针
+/// - `key` 必须指向 `key_len` 字节的有效内存
+/// - `out` 必须指向至少 `count * 16` 字节的缓冲区
+#[no_mangle]
+pub unsafe extern "C" fn awm_message_encode_batch(
+    version: u8,
+    tags: *const *const c_char,
+    count: usize,
+    key: *const u8,
+    key_len: usize,
+    key_slot: u8,
+    out: *mut u8,
+) -> i32 {
+    if tags.is_null() || key.is_null() || out.is_null() {
+        return AWMError::NullPointer as i32;
+    }
+
+    let mut parsed = Vec::with_capacity(count);
+    for &tag in slice::from_raw_parts(tags, count) {
+        if tag.is_null() {
+            return AWMError::NullPointer as i32;
+        }
+        let Ok(tag_str) = CStr::from_ptr(tag).to_str() else {
+            return AWMError::InvalidUtf8 as i32;
+        };
+        let Ok(tag_obj) = Tag::parse(tag_str) else {
+            return AWMError::InvalidTag as i32;
+        };
+        parsed.push(tag_obj);
+    }
+
+    let key_slice = slice::from_raw_parts(key, key_len);
+    let Ok(prepared) = message::PreparedKey::new(key_slice) else {
+        return AWMError::InvalidTag as i32;
+    };
+
+    message::encode_batch(
+        version,
+        &parsed,
+        &prepared,
+        message::current_utc_minutes(),
+        key_slot,
+    )
+    .map_or(AWMError::InvalidTag as i32, |messages| {
+        ptr::copy_nonoverlapping(
+            messages.as_ptr().cast::<u8>(),
+            out,
+            messages.len() * MESSAGE_LEN,
+        );
+        AWMError::Success as i32
+    })
+}
+
+/// 批量验证消息 HMAC（共用预置密钥）.
+///
+/// # Safety
+/// - `data` 必须指向 `count * 16` 字节
+/// - `key` 必须指向 `key_len` 字节
+/// - `out_valid` 必须指向至少 `count` 个 `bool` 的缓冲区
+#[no_mangle]
+pub unsafe extern "C" fn awm_message_verify_batch(
+    data: *const u8,
+    count: usize,
+    key: *const u8,
+    key_len: usize,
+    out_valid: *mut bool,
+) -> i32 {
+    if data.is_null() || key.is_null() || out_valid.is_null() {
+        return AWMError::NullPointer as i32;
+    }
+
+    let messages = slice::from_raw_parts(data.cast::<[u8; MESSAGE_LEN]>(), count);
+    let key_slice = slice::from_raw_parts(key, key_len);
+    let Ok(prepared) = message::PreparedKey::new(key_slice) else {
+        return AWMError::InvalidTag as i32;
+    };
+
+    let results = message::verify_batch(messages, &prepared);
+    ptr::copy_nonoverlapping(results.as_ptr(), out_valid, results.len());
+    AWMError::Success as i32
+}
+
 /// 获取当前版本号.
 #[no_mangle]
 pub const extern "C" fn awm_current_version() -> u8 {
@@ -788,6 +937,63 @@ pub unsafe extern "C" fn awm_audio_progress_get(
     AWMError::Success as i32
 }
 
+/// 拉取指定操作的进度快照（polling）.
+///
+/// 同一句柄可在多个线程上并发执行 embed/detect，每个操作拥有独立的进度槽位；
+/// `op_id` 未知或已被淘汰时写入 idle 快照（`op_id = 0`）并返回成功。.
+///
+/// # Safety
+/// - `handle` 与 `result` 必须是有效指针
+#[no_mangle]
+pub unsafe extern "C" fn awm_audio_progress_get_op(
+    handle: *const AWMAudioHandle,
+    op_id: u64,
+    result: *mut AWMProgressSnapshot,
+) -> i32 {
+    if handle.is_null() || result.is_null() {
+        return AWMError::NullPointer as i32;
+    }
+    let snapshot = (*handle)
+        .inner
+        .progress_snapshot_for_op(op_id)
+        .unwrap_or_default();
+    fill_progress_snapshot(&mut *result, &snapshot);
+    AWMError::Success as i32
+}
+
+/// 列出当前保留进度槽位的操作 id（升序）.
+///
+/// Two-step usage:
+/// 1) call with `out_ids=nullptr, out_len=0` to get required count
+/// 2) allocate buffer and call again
+///
+/// # Safety
+/// - `handle` 与 `out_required_len` 必须是有效指针
+/// - `out_ids` 为 NULL 时 `out_len` 必须为 0，否则须指向至少 `out_len` 个元素
+#[no_mangle]
+pub unsafe extern "C" fn awm_audio_progress_list_ops(
+    handle: *const AWMAudioHandle,
+    out_ids: *mut u64,
+    out_len: usize,
+    out_required_len: *mut usize,
+) -> i32 {
+    if handle.is_null() || out_required_len.is_null() {
+        return AWMError::NullPointer as i32;
+    }
+    let ids = (*handle).inner.progress_op_ids();
+    *out_required_len = ids.len();
+
+    if out_ids.is_null() || out_len == 0 {
+        return AWMError::Success as i32;
+    }
+    if out_len < ids.len() {
+        return AWMError::InvalidMessageLength as i32;
+    }
+
+    ptr::copy_nonoverlapping(ids.as_ptr(), out_ids, ids.len());
+    AWMError::Success as i32
+}
+
 /// 清空进度状态（回到 idle）.
 ///
 /// # Safety
@@ -800,6 +1006,83 @@ pub unsafe extern "C" fn awm_audio_progress_clear(handle: *mut AWMAudioHandle) {
     (*handle).inner.clear_progress();
 }
 
+/// 取消该句柄上所有进行中的操作（子进程被 kill，临时文件被清理）.
+///
+/// 取消状态会持续到调用 `awm_audio_cancel_reset` 为止，期间新操作立即返回 `Cancelled`。.
+///
+/// # Safety
+/// - `handle` 必须是有效句柄
+#[no_mangle]
+pub unsafe extern "C" fn awm_audio_cancel(handle: *const AWMAudioHandle) {
+    if handle.is_null() {
+        return;
+    }
+    (*handle).inner.cancellation().cancel();
+}
+
+/// 为句柄换上新的未取消令牌，使后续操作可以继续执行.
+///
+/// # Safety
+/// - `handle` 必须是有效句柄，且调用期间无其他线程在该句柄上执行操作
+#[no_mangle]
+pub unsafe extern "C" fn awm_audio_cancel_reset(handle: *mut AWMAudioHandle) {
+    if handle.is_null() {
+        return;
+    }
+    (*handle).inner.reset_cancellation();
+}
+
+/// 进程级缓冲复用池计数.
+#[repr(C)]
+#[derive(Default)]
+pub struct AWMBufferPoolStats {
+    /// 从池中取到缓冲的次数.
+    pub hits: u64,
+    /// 池中无可用缓冲而新分配的次数.
+    pub misses: u64,
+    /// 归还并入池的次数.
+    pub recycled: u64,
+    /// 归还时直接释放的次数.
+    pub discarded: u64,
+    /// 当前池中保留的字节数.
+    pub retained_bytes: u64,
+    /// 池保留字节上限.
+    pub retained_limit: u64,
+}
+
+/// 读取缓冲复用池计数.
+///
+/// # Safety
+/// - `result` 必须是有效指针
+#[no_mangle]
+pub unsafe extern "C" fn awm_buffer_pool_stats(result: *mut AWMBufferPoolStats) -> i32 {
+    if result.is_null() {
+        return AWMError::NullPointer as i32;
+    }
+    let stats = crate::buffer_pool::stats();
+    *result = AWMBufferPoolStats {
+        hits: stats.hits,
+        misses: stats.misses,
+        recycled: stats.recycled,
+        discarded: stats.discarded,
+        retained_bytes: u64::try_from(stats.retained_bytes).unwrap_or(u64::MAX),
+        retained_limit: u64::try_from(stats.retained_limit).unwrap_or(u64::MAX),
+    };
+    AWMError::Success as i32
+}
+
+/// 释放缓冲复用池中保留的全部内存；宿主在一批文件处理完后调用.
+#[no_mangle]
+pub extern "C" fn awm_buffer_pool_clear() {
+    crate::buffer_pool::clear();
+}
+
+/// 设置缓冲复用池保留上限（字节，0 表示不复用），超出部分立即释放.
+#[no_mangle]
+pub extern "C" fn awm_buffer_pool_set_limit(bytes: u64) {
+    crate::buffer_pool::set_retained_limit(usize::try_from(bytes).unwrap_or(usize::MAX));
+}
+
 /// 嵌入水印到音频.
 ///
 /// # Safety
@@ -835,6 +1118,7 @@ pub unsafe extern "C" fn awm_audio_embed(
         Err(crate::Error::AdmUnsupported(_)) => AWMError::AdmUnsupported as i32,
         Err(crate::Error::AdmPreserveFailed(_)) => AWMError::AdmPreserveFailed as i32,
         Err(crate::Error::AdmPcmFormatUnsupported(_)) => AWMError::AdmPcmFormatUnsupported as i32,
+        Err(crate::Error::Cancelled) => AWMError::Cancelled as i32,
         Err(crate::Error::AudiowmarkExec(_) | _) => AWMError::AudiowmarkExec as i32,
     }
 }
@@ -882,6 +1166,7 @@ pub unsafe extern "C" fn awm_audio_detect(
             AWMError::NoWatermarkFound as i32
         }
         Err(crate::Error::AudiowmarkNotFound) => AWMError::AudiowmarkNotFound as i32,
+        Err(crate::Error::Cancelled) => AWMError::Cancelled as i32,
         Err(crate::Error::AudiowmarkExec(_) | _) => AWMError::AudiowmarkExec as i32,
     }
 }
@@ -915,16 +1200,11 @@ fn evaluate_clone_check(
         .map_err(|_| "proof_panic".to_string())?
         .map_err(|e| format!("proof_error: {e}"))?;
 
+    // 已迁移到当前指纹配置的旧证据返回新指纹，未迁移的仍在匹配时按配置跳过。
     let candidates = evidence_store
-        .list_candidates(identity, key_slot)
+        .list_candidates_for_config(identity, key_slot, proof.fp_config_id)
         .map_err(|e| format!("query_error: {e}"))?;
 
-    if candidates.is_empty() {
-        output.kind = AWMCloneCheckKind::Suspect;
-        copy_str_to_c_buf(&mut output.reason, "no_evidence");
-        return Ok(output);
-    }
-
     if let Some(candidate) = candidates
         .iter()
         .find(|candidate| candidate.pcm_sha256 == proof.pcm_sha256)
@@ -936,33 +1216,40 @@ fn evaluate_clone_check(
     }
 
     let config = Configuration::default();
-    let mut best_match: Option<(i64, f64, f32)> = None;
-
-    for candidate in &candidates {
-        if candidate.fp_config_id != config.id() {
-            continue;
+    let mut best_match = best_fingerprint_match(&proof.chromaprint, &candidates, &config)
+        .map_err(|e| e.to_string())?;
+    let mut has_evidence = !candidates.is_empty();
+
+    // 热表未命中时才查冷归档：先按哈希查索引，再解压候选 member 做指纹比对。
+    if !best_match.is_some_and(|(_, score, duration)| is_likely(score, duration)) {
+        if let Some(evidence_id) = evidence_store
+            .find_cold_exact(identity, key_slot, &proof.pcm_sha256)
+            .map_err(|e| format!("query_error: {e}"))?
+        {
+            output.kind = AWMCloneCheckKind::Exact;
+            output.has_evidence_id = true;
+            output.evidence_id = evidence_id;
+            return Ok(output);
         }
-
-        let segments = match_fingerprints(&proof.chromaprint, &candidate.chromaprint, &config)
-            .map_err(|e| format!("match_error: {e}"))?;
-
-        for segment in segments {
-            let duration = segment.duration(&config);
-            let score = segment.score;
-            match best_match {
-                None => best_match = Some((candidate.id, score, duration)),
-                Some((_, best_score, best_duration))
-                    if duration > best_duration
-                        || ((duration - best_duration).abs() < f32::EPSILON
-                            && score < best_score) =>
-                {
-                    best_match = Some((candidate.id, score, duration));
-                }
-                _ => {}
+        let cold = evidence_store
+            .list_cold_candidates(identity, key_slot, proof.fp_config_id)
+            .map_err(|e| format!("archive_error: {e}"))?;
+        has_evidence |= !cold.is_empty();
+        if let Some(cold_best) =
+            best_fingerprint_match(&proof.chromaprint, &cold, &config).map_err(|e| e.to_string())?
+        {
+            if best_match.is_none_or(|best| is_better_match(cold_best, best)) {
+                best_match = Some(cold_best);
             }
         }
     }
 
+    if !has_evidence {
+        output.kind = AWMCloneCheckKind::Suspect;
+        copy_str_to_c_buf(&mut output.reason, "no_evidence");
+        return Ok(output);
+    }
+
     if let Some((candidate_id, score, duration)) = best_match {
         output.has_score = true;
         output.score = score;
@@ -1196,14 +1483,15 @@ unsafe fn record_evidence_file_impl(
             Err(_) => return AWMError::InvalidTag as i32,
         };
 
-        let Ok(Ok(proof)) = catch_unwind(AssertUnwindSafe(|| build_proof(file_path_str))) else {
+        let Ok(Ok(digest)) = catch_unwind(AssertUnwindSafe(|| digest_pcm(file_path_str))) else {
             return AWMError::AudiowmarkExec as i32;
         };
         let Ok(store) = EvidenceStore::load() else {
             return AWMError::AudiowmarkExec as i32;
         };
+        let key_id = key_id_from_key_material(key_slice);
 
-        let row = NewAudioEvidence {
+        let mut row = NewAudioEvidence {
             file_path: file_path_str.to_string(),
             tag: decoded.tag.to_string(),
             identity: decoded.identity().to_string(),
@@ -1211,19 +1499,34 @@ unsafe fn record_evidence_file_impl(
             key_slot: decoded.key_slot,
             timestamp_minutes: decoded.timestamp_minutes,
             message_hex: hex::encode(raw),
-            sample_rate: proof.sample_rate,
-            channels: proof.channels,
-            sample_count: proof.sample_count,
-            pcm_sha256: proof.pcm_sha256,
-            key_id: key_id_from_key_material(key_slice),
+            sample_rate: digest.sample_rate,
+            channels: digest.channels,
+            sample_count: digest.sample_count,
+            pcm_sha256: digest.pcm_sha256.clone(),
+            key_id,
             is_forced_embed: false,
             snr_db,
             snr_status: snr_status.to_string(),
-            chromaprint: proof.chromaprint,
-            fp_config_id: proof.fp_config_id,
+            chromaprint: Vec::new(),
+            fp_config_id: 0,
         };
 
-        match store.insert(&row) {
+        // 唯一键已存在时只提升，跳过指纹计算。
+        let Ok(exists) = store.contains(&row.identity, row.key_slot, &row.key_id, &row.pcm_sha256)
+        else {
+            return AWMError::AudiowmarkExec as i32;
+        };
+        let written = if exists {
+            store.promote(&row)
+        } else {
+            let Ok(Ok(proof)) = catch_unwind(AssertUnwindSafe(|| digest.into_proof())) else {
+                return AWMError::AudiowmarkExec as i32;
+            };
+            row.chromaprint = proof.chromaprint;
+            row.fp_config_id = proof.fp_config_id;
+            store.insert(&row)
+        };
+        match written {
             Ok(_) => AWMError::Success as i32,
             Err(_) => AWMError::AudiowmarkExec as i32,
         }
@@ -1241,6 +1544,204 @@ unsafe fn record_evidence_file_impl(
     }
 }
 
+// ============================================================================
+// Background Evidence Queue (requires "app" feature)
+// ============================================================================
+
+#[cfg(feature = "app")]
+/// 进程级后台证据队列（首次使用时启动并重放 journal）.
+static EVIDENCE_QUEUE: Mutex<Option<EvidenceQueue>> = Mutex::new(None);
+#[cfg(feature = "app")]
+/// 等待队列清空时单次持锁的最长时间.
+const EVIDENCE_QUEUE_WAIT_SLICE: std::time::Duration = std::time::Duration::from_millis(50);
+
+/// 后台证据队列计数.
+#[repr(C)]
+#[derive(Default)]
+pub struct AWMEvidenceQueueStats {
+    /// 尚未写库的记录数.
+    pub pending: u64,
+    /// 本进程内已写库的记录数.
+    pub recorded: u64,
+    /// 本进程内因指纹计算失败而丢弃的记录数.
+    pub failed: u64,
+}
+
+#[cfg(feature = "app")]
+/// Internal helper function.
+fn with_evidence_queue<T>(f: impl FnOnce(&EvidenceQueue) -> T) -> Result<T, i32> {
+    let mut guard = EVIDENCE_QUEUE
+        .lock()
+        .unwrap_or_else(PoisonError::into_inner);
+    if guard.is_none() {
+        let queue = EvidenceQueue::start().map_err(|_| AWMError::AudiowmarkExec as i32)?;
+        *guard = Some(queue);
+    }
+    guard.as_ref().map(f).ok_or(AWMError::AudiowmarkExec as i32)
+}
+
+/// 启动后台证据队列并重放上次未完成的记录（幂等）.
+#[no_mangle]
+pub extern "C" fn awm_evidence_queue_start() -> i32 {
+    #[cfg(feature = "app")]
+    {
+        match with_evidence_queue(|_| ()) {
+            Ok(()) => AWMError::Success as i32,
+            Err(code) => code,
+        }
+    }
+
+    #[cfg(not(feature = "app"))]
+    {
+        AWMError::AudiowmarkExec as i32
+    }
+}
+
+/// 将嵌入结果交给后台证据队列；记录写入 journal 后立即返回，指纹/SNR/写库在后台完成.
+///
+/// # Safety
+/// - `input_path` 与 `output_path` 必须是有效的 C 字符串
+/// - `raw_message` 必须指向 16 字节
+/// - `key` 必须指向 `key_len` 字节
+#[no_mangle]
+pub unsafe extern "C" fn awm_evidence_enqueue_embed_file(
+    input_path: *const c_char,
+    output_path: *const c_char,
+    raw_message: *const u8,
+    key: *const u8,
+    key_len: usize,
+) -> i32 {
+    if input_path.is_null() || output_path.is_null() || raw_message.is_null() || key.is_null() {
+        return AWMError::NullPointer as i32;
+    }
+
+    let Ok(input_path_str) = CStr::from_ptr(input_path).to_str() else {
+        return AWMError::InvalidUtf8 as i32;
+    };
+    let Ok(output_path_str) = CStr::from_ptr(output_path).to_str() else {
+        return AWMError::InvalidUtf8 as i32;
+    };
+    let Ok(raw) = <[u8; 16]>::try_from(slice::from_raw_parts(raw_message, 16)) else {
+        return AWMError::InvalidMessageLength as i32;
+    };
+    let key_slice = slice::from_raw_parts(key, key_len);
+
+    #[cfg(feature = "app")]
+    {
+        let decoded = match message::decode(&raw, key_slice) {
+            Ok(decoded) => decoded,
+            Err(crate::Error::HmacMismatch) => return AWMError::HmacMismatch as i32,
+            Err(crate::Error::ChecksumMismatch { .. }) => return AWMError::ChecksumMismatch as i32,
+            Err(_) => return AWMError::InvalidTag as i32,
+        };
+        let job = EvidenceJob {
+            input_path: input_path_str.to_string(),
+            output_path: output_path_str.to_string(),
+            tag: decoded.tag.to_string(),
+            identity: decoded.identity().to_string(),
+            version: decoded.version,
+            key_slot: decoded.key_slot,
+            timestamp_minutes: decoded.timestamp_minutes,
+            message_hex: hex::encode(raw),
+            key_id: key_id_from_key_material(key_slice),
+            is_forced_embed: false,
+        };
+        match with_evidence_queue(|queue| queue.enqueue(job)) {
+            Ok(Ok(_)) => AWMError::Success as i32,
+            Ok(Err(_)) => AWMError::AudiowmarkExec as i32,
+            Err(code) => code,
+        }
+    }
+
+    #[cfg(not(feature = "app"))]
+    {
+        let _ = (input_path_str, output_path_str, raw, key_slice);
+        AWMError::AudiowmarkExec as i32
+    }
+}
+
+/// 读取后台证据队列计数；队列未启动时返回全 0.
+///
+/// # Safety
+/// - `result` 必须是有效指针
+#[no_mangle]
+pub unsafe extern "C" fn awm_evidence_queue_stats(result: *mut AWMEvidenceQueueStats) -> i32 {
+    if result.is_null() {
+        return AWMError::NullPointer as i32;
+    }
+    *result = AWMEvidenceQueueStats::default();
+
+    #[cfg(feature = "app")]
+    {
+        let guard = EVIDENCE_QUEUE
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner);
+        if let Some(stats) = guard.as_ref().map(EvidenceQueue::stats) {
+            (*result).pending = u64::try_from(stats.pending).unwrap_or(u64::MAX);
+            (*result).recorded = u64::try_from(stats.recorded).unwrap_or(u64::MAX);
+            (*result).failed = u64::try_from(stats.failed).unwrap_or(u64::MAX);
+        }
+    }
+    AWMError::Success as i32
+}
+
+/// 等待后台证据队列清空，最多 `timeout_ms` 毫秒；队列未启动或已清空时立即返回 true.
+#[no_mangle]
+pub extern "C" fn awm_evidence_queue_wait_idle(timeout_ms: u32) -> bool {
+    #[cfg(feature = "app")]
+    {
+        // 分片等待，避免长时间持有全局锁阻塞其他线程入队。
+        let deadline =
+            std::time::Instant::now() + std::time::Duration::from_millis(u64::from(timeout_ms));
+        loop {
+            let slice = EVIDENCE_QUEUE_WAIT_SLICE
+                .min(deadline.saturating_duration_since(std::time::Instant::now()));
+            let idle = EVIDENCE_QUEUE
+                .lock()
+                .unwrap_or_else(PoisonError::into_inner)
+                .as_ref()
+                .is_none_or(|queue| queue.wait_idle(Some(slice)));
+            if idle {
+                return true;
+            }
+            if std::time::Instant::now() >= deadline {
+                return false;
+            }
+        }
+    }
+
+    #[cfg(not(feature = "app"))]
+    {
+        let _ = timeout_ms;
+        true
+    }
+}
+
+/// 停止后台证据队列.
+///
+/// - `drain = true`：处理完剩余记录后停止（阻塞）
+/// - `drain = false`：当前批次结束后停止，剩余记录保留在 journal，下次启动时重放
+#[no_mangle]
+pub extern "C" fn awm_evidence_queue_stop(drain: bool) {
+    #[cfg(feature = "app")]
+    {
+        let queue = EVIDENCE_QUEUE
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+            .take();
+        if let Some(queue) = queue {
+            if drain {
+                let _ = queue.finish();
+            }
+        }
+    }
+
+    #[cfg(not(feature = "app"))]
+    {
+        let _ = drain;
+    }
+}
+
 // ============================================================================
 // Database Operations (requires "app" feature)
 // ============================================================================
@@ -1351,13 +1852,10 @@ pub unsafe extern "C" fn awm_ui_language_get(
 ) -> i32 {
     #[cfg(feature = "app")]
     {
-        let Ok(settings) = SettingsStore::load() else {
+        let Ok(settings) = cached_settings() else {
             return AWMError::AudiowmarkExec as i32;
         };
-        let Ok(value) = settings.ui_language() else {
-            return AWMError::AudiowmarkExec as i32;
-        };
-        let text = value.unwrap_or_default();
+        let text = settings.ui_language.clone().unwrap_or_default();
         write_string_with_required(&text, out, out_len, out_required_len)
     }
 
@@ -1397,7 +1895,7 @@ pub unsafe extern "C" fn awm_ui_language_set(lang_or_null: *const c_char) -> i32
             }
         };
 
-        match SettingsStore::load().and_then(|settings| settings.set_ui_language(normalized)) {
+        match update_settings(|settings| settings.set_ui_language(normalized)) {
             Ok(()) => AWMError::Success as i32,
             Err(_) => AWMError::AudiowmarkExec as i32,
         }
@@ -2014,9 +2512,7 @@ pub unsafe extern "C" fn awm_key_slot_label_set(slot: u8, label: *const c_char)
         if label_str.trim().is_empty() {
             return AWMError::InvalidTag as i32;
         }
-        match crate::app::SettingsStore::load()
-            .and_then(|settings| settings.set_slot_label(slot, label_str))
-        {
+        match update_settings(|settings| settings.set_slot_label(slot, label_str)) {
             Ok(()) => AWMError::Success as i32,
             Err(_) => AWMError::AudiowmarkExec as i32,
         }
@@ -2033,8 +2529,7 @@ pub unsafe extern "C" fn awm_key_slot_label_set(slot: u8, label: *const c_char)
 pub extern "C" fn awm_key_slot_label_clear(slot: u8) -> i32 {
     #[cfg(feature = "app")]
     {
-        match crate::app::SettingsStore::load().and_then(|settings| settings.clear_slot_label(slot))
-        {
+        match update_settings(|settings| settings.clear_slot_label(slot)) {
             Ok(()) => AWMError::Success as i32,
             Err(_) => AWMError::AudiowmarkExec as i32,
         }
@@ -2344,6 +2839,7 @@ pub unsafe extern "C" fn awm_audio_embed_multichannel(
         Err(crate::Error::AdmUnsupported(_)) => AWMError::AdmUnsupported as i32,
         Err(crate::Error::AdmPreserveFailed(_)) => AWMError::AdmPreserveFailed as i32,
         Err(crate::Error::AdmPcmFormatUnsupported(_)) => AWMError::AdmPcmFormatUnsupported as i32,
+        Err(crate::Error::Cancelled) => AWMError::Cancelled as i32,
         Err(crate::Error::AudiowmarkExec(_) | _) => AWMError::AudiowmarkExec as i32,
     }
 }
@@ -2424,6 +2920,7 @@ pub unsafe extern "C" fn awm_audio_detect_multichannel(
             }
         }
         Err(crate::Error::AudiowmarkNotFound) => AWMError::AudiowmarkNotFound as i32,
+        Err(crate::Error::Cancelled) => AWMError::Cancelled as i32,
         Err(crate::Error::AudiowmarkExec(_) | _) => AWMError::AudiowmarkExec as i32,
     }
 }
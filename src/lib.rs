@@ -36,9 +36,11 @@
 #![deny(clippy::module_name_repetitions)]
 
 pub mod audio;
+pub mod buffer_pool;
 /// Internal module.
 #[cfg(any(feature = "bundled", feature = "app"))]
 pub(crate) mod bundled;
+pub mod cancel;
 pub mod charset;
 pub mod error;
 pub(crate) mod media;
@@ -58,6 +60,8 @@ pub mod launcher;
 
 // Re-exports
 pub use audio::{Audio, DetectResult};
+pub use buffer_pool::Stats as BufferPoolStats;
+pub use cancel::CancellationToken;
 pub use error::{Error, Result};
 pub use message::{Decoded, CURRENT_VERSION, MESSAGE_LEN};
 pub use tag::Tag;
@@ -66,7 +70,10 @@ pub use tag::Tag;
 pub use multichannel::{AudioBuffer, ChannelLayout, SampleFormat};
 
 #[cfg(feature = "multichannel")]
-pub use audio::MultichannelDetectResult;
+pub use audio::{EmbedRecipient, EmbedVerification, KeyDetectResult, MultichannelDetectResult};
+
+#[cfg(all(feature = "multichannel", feature = "ffmpeg-decode"))]
+pub use audio::{MonitorConfig, MonitorHit, MonitorReport};
 
 /// 消息操作的便捷入口.
 pub struct Message;
@@ -100,6 +100,8 @@ pub fn embed_adm_multichannel(
         )?;
         // Step 2：嵌入 Object 声道（每个真单声道，静默跳过）
         embed_object_channels_into_audio(audio_engine, &mut audio, message, &obj_indices)?;
+        // 取消时部分步骤会以"声道不变"降级，必须在写出前中止，避免留下半嵌入输出。
+        audio_engine.cancellation().check()?;
         Ok(audio)
     })
 }
@@ -260,6 +262,7 @@ fn embed_bed_by_speaker_labels(
     let mut result = source_audio.clone();
 
     for step in &plan.steps {
+        audio_engine.cancellation().check()?;
         match &step.mode {
             RouteMode::Skip { .. } => {
                 // 跳过，原样保留
@@ -345,6 +348,7 @@ fn embed_object_channels_into_audio(
     let sf = audio.sample_format();
 
     for &obj_idx in obj_indices {
+        audio_engine.cancellation().check()?;
         if obj_idx >= total_ch {
             eprintln!("[awmkit] ADM: Object ch{obj_idx} out of range (total={total_ch}), skipping");
             continue;
@@ -353,6 +353,7 @@ pub fn build_route_plan_from_labels(
         layout,
         channels,
         steps,
+        mirrors: Vec::new(),
         warnings,
     }
 }
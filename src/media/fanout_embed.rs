@@ -0,0 +1,281 @@
+//! 同一母版向多个接收方的扇出嵌入.
+//!
+//! 分发同一母版时逐个嵌入会为每个接收方重复解码、路由规划与 WAV 序列化。这里只在开始时
+//! 准备一次各路由步骤的 WAV 字节，所有接收方共享同一份只读输入；每个接收方只剩
+//! audiowmark 嵌入本身与合并写出。并发接收方数同时受调用方的工作线程数与内存预算限制。.
+
+use std::path::Path;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use rayon::prelude::*;
+
+use crate::audio::{
+    apply_embed_step_results, build_stereo_for_route_step, bytes_to_hex, log_route_warnings,
+    run_audiowmark_add_shared_bytes, validate_embed_output_path, validate_layout_channels,
+    with_route_thread_pool, Audio, EmbedRecipient, EmbedStepTaskResult,
+};
+use crate::buffer_pool;
+use crate::error::Result;
+use crate::media::route_cluster;
+use crate::multichannel::{
+    effective_lfe_mode, AudioBuffer, ChannelLayout, ChannelMirror, RouteMode, RouteStep,
+};
+
+/// 默认内存预算（MiB），限制同时在途的接收方数量.
+const DEFAULT_MEMORY_BUDGET_MB: usize = 2048;
+
+/// 预先序列化、由所有接收方共享的嵌入输入.
+enum FanoutSource {
+    /// 单声道/立体声：整段输入直接送入 audiowmark.
+    Whole(Vec<u8>),
+    /// 多声道：每个可执行路由步骤一份 WAV 字节，以及合并时要同步的镜像声道.
+    Routed(Vec<PreparedStep>, Vec<ChannelMirror>),
+}
+
+/// 已序列化的路由步骤输入.
+struct PreparedStep {
+    /// 步骤在路由方案中的序号.
+    index: usize,
+    /// 路由步骤.
+    step: RouteStep,
+    /// 步骤输入的 WAV 字节.
+    wav: Vec<u8>,
+}
+
+impl FanoutSource {
+    /// 规划路由并序列化各步骤输入.
+    fn prepare(audio: &AudioBuffer, input: &Path, layout: Option<ChannelLayout>) -> Result<Self> {
+        let num_channels = audio.num_channels();
+        if num_channels <= 2 {
+            return Ok(Self::Whole(audio.to_wav_bytes()?));
+        }
+        let layout = layout.unwrap_or_else(|| audio.layout());
+        validate_layout_channels(layout, num_channels)?;
+        let plan = route_cluster::plan_routes(audio, layout, effective_lfe_mode());
+        log_route_warnings("embed", input, &plan.warnings);
+        let mut steps = Vec::with_capacity(plan.steps.len());
+        for (index, step) in plan.steps.into_iter().enumerate() {
+            if matches!(step.mode, RouteMode::Skip { .. }) {
+                continue;
+            }
+            let wav = build_stereo_for_route_step(audio, &step).and_then(|stereo| {
+                let wav = stereo.to_wav_bytes();
+                stereo.recycle();
+                wav
+            });
+            match wav {
+                Ok(wav) => steps.push(PreparedStep { index, step, wav }),
+                Err(err) => {
+                    Self::Routed(steps, plan.mirrors).recycle();
+                    return Err(err);
+                }
+            }
+        }
+        Ok(Self::Routed(steps, plan.mirrors))
+    }
+
+    /// 共享字节总量.
+    fn byte_len(&self) -> usize {
+        match self {
+            Self::Whole(wav) => wav.len(),
+            Self::Routed(steps, _) => steps.iter().map(|s| s.wav.len()).sum(),
+        }
+    }
+
+    /// 归还共享字节.
+    fn recycle(self) {
+        match self {
+            Self::Whole(wav) => buffer_pool::give_bytes(wav),
+            Self::Routed(steps, _) => {
+                for step in steps {
+                    buffer_pool::give_bytes(step.wav);
+                }
+            }
+        }
+    }
+}
+
+/// 以共享输入为每个接收方嵌入并写出；结果与 `recipients` 一一对应.
+///
+/// # Errors
+/// 当布局与声道数不匹配、路由步骤准备失败或线程池创建失败时返回错误。.
+pub fn embed_fanout(
+    audio_engine: &Audio,
+    audio: &AudioBuffer,
+    input: &Path,
+    recipients: &[EmbedRecipient],
+    layout: Option<ChannelLayout>,
+    workers: usize,
+) -> Result<Vec<Result<()>>> {
+    if recipients.is_empty() {
+        return Ok(Vec::new());
+    }
+    audio_engine.cancellation().check()?;
+    let source = FanoutSource::prepare(audio, input, layout)?;
+    // 每个在途接收方约持有一份合并缓冲与一份 audiowmark 输出。
+    let per_recipient = audio
+        .num_samples()
+        .saturating_mul(audio.num_channels())
+        .saturating_mul(std::mem::size_of::<i32>())
+        .saturating_add(source.byte_len());
+    let parallelism = fanout_parallelism(workers, recipients.len(), per_recipient, memory_budget());
+
+    let total_units = u64::try_from(recipients.len()).unwrap_or(u64::MAX);
+    audio_engine.progress_update_current_units(0, Some(total_units));
+    let done = AtomicU64::new(0);
+    let run = |recipient: &EmbedRecipient| {
+        let outcome = embed_recipient(audio_engine, audio, &source, recipient);
+        let completed = done.fetch_add(1, Ordering::Relaxed) + 1;
+        audio_engine.progress_update_current_units(completed, Some(total_units));
+        outcome
+    };
+    // 单线程时不进入 rayon，避免全局线程池绕过内存预算。
+    let results = if parallelism <= 1 {
+        Ok(recipients.iter().map(run).collect())
+    } else {
+        with_route_thread_pool(parallelism, || recipients.par_iter().map(run).collect())
+    };
+    source.recycle();
+    results
+}
+
+/// 按工作线程数、接收方数与内存预算计算并发度.
+fn fanout_parallelism(
+    workers: usize,
+    recipients: usize,
+    per_recipient: usize,
+    budget: usize,
+) -> usize {
+    let by_memory = budget / per_recipient.max(1);
+    workers.min(recipients).min(by_memory).max(1)
+}
+
+/// Internal helper function.
+fn memory_budget() -> usize {
+    let mb = std::env::var("AWMKIT_FANOUT_MEMORY_MB")
+        .ok()
+        .and_then(|raw| raw.trim().parse::<usize>().ok())
+        .filter(|&mb| mb > 0)
+        .unwrap_or(DEFAULT_MEMORY_BUDGET_MB);
+    mb.saturating_mul(1024 * 1024)
+}
+
+/// 为单个接收方嵌入并写出.
+fn embed_recipient(
+    audio_engine: &Audio,
+    audio: &AudioBuffer,
+    source: &FanoutSource,
+    recipient: &EmbedRecipient,
+) -> Result<()> {
+    audio_engine.cancellation().check()?;
+    validate_embed_output_path(&recipient.output)?;
+    let hex = bytes_to_hex(&recipient.message);
+    let merged = match source {
+        FanoutSource::Whole(wav) => embed_shared(audio_engine, wav, &hex)?,
+        FanoutSource::Routed(steps, mirrors) => {
+            let mut step_results: Vec<EmbedStepTaskResult> = steps
+                .iter()
+                .map(|prepared| EmbedStepTaskResult {
+                    step_idx: prepared.index,
+                    step: prepared.step.clone(),
+                    outcome: embed_shared(audio_engine, &prepared.wav, &hex),
+                })
+                .collect();
+            let mut target = copy_buffer(audio)?;
+            // 失败步骤与常规多声道嵌入一样以"保持原样"降级合并。
+            apply_embed_step_results(&mut target, &mut step_results, mirrors);
+            for step_result in step_results {
+                if let Ok(processed) = step_result.outcome {
+                    processed.recycle();
+                }
+            }
+            target
+        }
+    };
+    // 取消时不写出，避免留下部分嵌入的输出。
+    if let Err(err) = audio_engine.cancellation().check() {
+        merged.recycle();
+        return Err(err);
+    }
+    let written = merged.to_wav(&recipient.output);
+    merged.recycle();
+    written
+}
+
+/// 对共享的 WAV 字节运行一次 `add` 并解析输出.
+fn embed_shared(audio_engine: &Audio, wav: &[u8], message_hex: &str) -> Result<AudioBuffer> {
+    audio_engine.cancellation().check()?;
+    let output_bytes = run_audiowmark_add_shared_bytes(audio_engine, wav, message_hex)?;
+    let processed = AudioBuffer::from_wav_bytes(&output_bytes);
+    buffer_pool::give_bytes(output_bytes);
+    processed
+}
+
+/// 复制 `audio` 到池化缓冲，作为接收方的合并目标.
+fn copy_buffer(audio: &AudioBuffer) -> Result<AudioBuffer> {
+    let channels = (0..audio.num_channels())
+        .map(|channel| {
+            audio
+                .channel_samples(channel)
+                .map(buffer_pool::copy_samples)
+        })
+        .collect::<Result<Vec<_>>>()?;
+    AudioBuffer::new(channels, audio.sample_rate(), audio.sample_format())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::multichannel::SampleFormat;
+
+    #[test]
+    fn parallelism_respects_workers_recipients_and_budget() {
+        assert_eq!(fanout_parallelism(8, 100, 100, 10_000), 8);
+        assert_eq!(fanout_parallelism(8, 3, 100, 10_000), 3);
+        assert_eq!(fanout_parallelism(8, 100, 4_000, 10_000), 2);
+        // 单个接收方已超出预算时仍串行推进。
+        assert_eq!(fanout_parallelism(8, 100, 50_000, 10_000), 1);
+        assert_eq!(fanout_parallelism(0, 100, 0, 10_000), 1);
+    }
+
+    #[test]
+    fn surround_source_prepares_one_input_per_route_step() {
+        let channels: Vec<Vec<i32>> = (0..6).map(|ch| vec![ch * 100; 256]).collect();
+        let built = AudioBuffer::new(channels, 48_000, SampleFormat::Int16);
+        assert!(built.is_ok());
+        let Ok(audio) = built else {
+            return;
+        };
+        let source = FanoutSource::prepare(&audio, Path::new("in.wav"), None);
+        assert!(source.is_ok());
+        let Ok(source) = source else {
+            return;
+        };
+        assert!(matches!(source, FanoutSource::Routed(..)));
+        if let FanoutSource::Routed(steps, _) = &source {
+            assert!(!steps.is_empty());
+            for prepared in steps {
+                assert!(!matches!(prepared.step.mode, RouteMode::Skip { .. }));
+                let decoded = AudioBuffer::from_wav_bytes(&prepared.wav);
+                assert!(decoded.is_ok_and(|stereo| stereo.num_samples() == 256));
+            }
+        }
+        assert!(source.byte_len() > 0);
+        source.recycle();
+
+        let copy = copy_buffer(&audio);
+        assert!(copy.is_ok_and(|copy| copy.channel_samples(5).ok() == Some(&[500; 256][..])));
+
+        let stereo = AudioBuffer::new(
+            vec![vec![1; 256], vec![2; 256]],
+            48_000,
+            SampleFormat::Int16,
+        );
+        assert!(stereo.is_ok());
+        let Ok(stereo) = stereo else {
+            return;
+        };
+        let source = FanoutSource::prepare(&stereo, Path::new("in.wav"), None);
+        assert!(matches!(source, Ok(FanoutSource::Whole(_))));
+    }
+}
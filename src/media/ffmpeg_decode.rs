@@ -8,6 +8,7 @@ use std::sync::OnceLock;
 use ffmpeg_next as ffmpeg;
 
 use crate::audio::{ContainerCapabilities, DecodedPcm, MediaCapabilities};
+use crate::cancel::CancellationToken;
 use crate::error::{Error, Result};
 
 /// Internal item.
@@ -33,13 +34,15 @@ struct DecodeContext {
     output_rate: u32,
     /// Internal field.
     resampler: ffmpeg::software::resampling::Context,
+    /// 实时输入的中断回调令牌；须晚于 `input_ctx` 释放.
+    _interrupt: Option<Box<CancellationToken>>,
 }
 
 /// Internal helper function.
-pub fn decode_media_to_pcm_i32(input: &Path) -> Result<DecodedPcm> {
+pub fn decode_media_to_pcm_i32(input: &Path, cancel: &CancellationToken) -> Result<DecodedPcm> {
     let mut context = open_decode_context(input)?;
     let mut samples = Vec::<i32>::new();
-    let copied = decode_with_sink(&mut context, |bytes| {
+    let copied = decode_with_sink(&mut context, cancel, |bytes| {
         append_packed_i16_bytes(bytes, &mut samples);
         Ok(())
     })?;
@@ -59,10 +62,14 @@ pub fn decode_media_to_pcm_i32(input: &Path) -> Result<DecodedPcm> {
 }
 
 /// Internal helper function.
-pub fn decode_media_to_wav_pipe(input: &Path, writer: &mut dyn Write) -> Result<()> {
+pub fn decode_media_to_wav_pipe(
+    input: &Path,
+    writer: &mut dyn Write,
+    cancel: &CancellationToken,
+) -> Result<()> {
     let mut context = open_decode_context(input)?;
     write_wav_pipe_header(writer, context.sample_rate, context.channels)?;
-    let copied = decode_with_sink(&mut context, |bytes| {
+    let copied = decode_with_sink(&mut context, cancel, |bytes| {
         writer.write_all(bytes)?;
         Ok(())
     })?;
@@ -77,6 +84,59 @@ pub fn decode_media_to_wav_pipe(input: &Path, writer: &mut dyn Write) -> Result<
     Ok(())
 }
 
+/// 逐帧解码的媒体音频流，不物化整段 PCM.
+pub struct MediaStream {
+    /// Internal field.
+    context: DecodeContext,
+}
+
+impl MediaStream {
+    /// 打开 `input` 的最佳音频轨并准备解码.
+    ///
+    /// # Errors
+    /// 当 `FFmpeg` 不可用、容器无法打开或找不到可解码音轨时返回错误。.
+    pub fn open(input: &Path) -> Result<Self> {
+        Ok(Self {
+            context: open_decode_context(input)?,
+        })
+    }
+
+    /// 打开实时输入：`-` 为标准输入，FIFO 按流读取，普通文件视为仍在增长的采集文件.
+    ///
+    /// 阻塞中的读取（等待管道数据或文件追加）在 `cancel` 被取消后立即中断.
+    ///
+    /// # Errors
+    /// 当 `FFmpeg` 不可用、输入无法打开、找不到可解码音轨或操作被取消时返回错误。.
+    pub fn open_live(input: &Path, cancel: &CancellationToken) -> Result<Self> {
+        Ok(Self {
+            context: open_live_decode_context(input, cancel)?,
+        })
+    }
+
+    /// 采样率.
+    #[must_use]
+    pub const fn sample_rate(&self) -> u32 {
+        self.context.sample_rate
+    }
+
+    /// 声道数.
+    #[must_use]
+    pub const fn channels(&self) -> u16 {
+        self.context.channels
+    }
+
+    /// 逐帧解码，`sink` 收到本机字节序的交错 packed i16 帧；返回解码字节数.
+    ///
+    /// # Errors
+    /// 当解码失败、操作被取消或 `sink` 返回错误时返回错误。.
+    pub fn decode<F>(mut self, cancel: &CancellationToken, sink: F) -> Result<usize>
+    where
+        F: FnMut(&[u8]) -> Result<()>,
+    {
+        decode_with_sink(&mut self.context, cancel, sink)
+    }
+}
+
 /// Internal helper function.
 pub fn media_capabilities() -> MediaCapabilities {
     if ensure_ffmpeg_initialized().is_err() {
@@ -104,6 +164,97 @@ fn open_decode_context(input: &Path) -> Result<DecodeContext> {
 
     let input_ctx =
         ffmpeg::format::input(input).map_err(|err| map_open_error(input, &err.to_string()))?;
+    decode_context_from_input(input_ctx)
+}
+
+/// 打开持续增长的输入：`-` 读取标准输入，普通文件读到末尾后继续等待新数据.
+fn open_live_decode_context(input: &Path, cancel: &CancellationToken) -> Result<DecodeContext> {
+    ensure_ffmpeg_initialized()?;
+
+    let mut options = ffmpeg::Dictionary::new();
+    let url = if input == Path::new("-") {
+        Path::new("pipe:0")
+    } else {
+        if input.is_file() {
+            // file 协议的 follow 选项：到达 EOF 后轮询等待追加写入（采集文件）。
+            options.set("follow", "1");
+        }
+        input
+    };
+    let token = Box::new(cancel.clone());
+    let input_ctx = open_input_interruptible(input, url, options, &token)?;
+    let context = decode_context_from_input(input_ctx)?;
+    Ok(DecodeContext {
+        _interrupt: Some(token),
+        ..context
+    })
+}
+
+/// 以轮询 `token` 的中断回调打开输入；`token` 须比返回的上下文活得久.
+#[allow(unsafe_code)]
+fn open_input_interruptible(
+    input: &Path,
+    url: &Path,
+    options: ffmpeg::Dictionary,
+    token: &CancellationToken,
+) -> Result<ffmpeg::format::context::Input> {
+    let c_url = url
+        .to_str()
+        .and_then(|url| CString::new(url).ok())
+        .ok_or_else(|| Error::InvalidInput(format!("invalid input path: {}", input.display())))?;
+    // SAFETY: avformat_alloc_context 返回新分配的上下文或空指针，空指针在下方检查。
+    let mut ps = unsafe { ffmpeg::ffi::avformat_alloc_context() };
+    if ps.is_null() {
+        return Err(Error::FfmpegDecodeFailed(
+            "failed to allocate format context".to_string(),
+        ));
+    }
+    // SAFETY: ps 非空且尚未打开；opaque 指向调用方持有的令牌，回调只做只读访问。
+    unsafe {
+        (*ps).interrupt_callback = ffmpeg::ffi::AVIOInterruptCB {
+            callback: Some(interrupt_on_cancel),
+            opaque: std::ptr::from_ref(token).cast_mut().cast(),
+        };
+    }
+    // SAFETY: 字典所有权交给 FFmpeg，调用后由 Dictionary::own 收回。
+    let mut opts = unsafe { options.disown() };
+    // SAFETY: ps 与 c_url 在调用期间有效；失败时 avformat_open_input 会释放 ps 并置空。
+    let opened = unsafe {
+        ffmpeg::ffi::avformat_open_input(&mut ps, c_url.as_ptr(), std::ptr::null_mut(), &mut opts)
+    };
+    // SAFETY: opts 是 avformat_open_input 回写的剩余选项字典（可能为空），交回所有权释放。
+    drop(unsafe { ffmpeg::Dictionary::own(opts) });
+    if opened < 0 {
+        return Err(map_open_error(
+            input,
+            &ffmpeg::Error::from(opened).to_string(),
+        ));
+    }
+    // SAFETY: ps 已成功打开。
+    let probed = unsafe { ffmpeg::ffi::avformat_find_stream_info(ps, std::ptr::null_mut()) };
+    if probed < 0 {
+        // SAFETY: ps 已成功打开且之后不再使用。
+        unsafe { ffmpeg::ffi::avformat_close_input(&mut ps) };
+        return Err(map_open_error(
+            input,
+            &ffmpeg::Error::from(probed).to_string(),
+        ));
+    }
+    // SAFETY: ps 已打开并完成探测，所有权转交给 Input。
+    Ok(unsafe { ffmpeg::format::context::Input::wrap(ps) })
+}
+
+/// `FFmpeg` 阻塞 I/O 的中断回调：令牌已取消时返回非零.
+#[allow(unsafe_code)]
+unsafe extern "C" fn interrupt_on_cancel(opaque: *mut std::ffi::c_void) -> std::ffi::c_int {
+    // SAFETY: opaque 由 open_input_interruptible 设置为 DecodeContext 持有的令牌，
+    // 令牌在 input_ctx 关闭之后才释放。
+    let token = unsafe { &*opaque.cast::<CancellationToken>() };
+    std::ffi::c_int::from(token.is_cancelled())
+}
+
+/// Internal helper function.
+fn decode_context_from_input(input_ctx: ffmpeg::format::context::Input) -> Result<DecodeContext> {
     let stream = input_ctx
         .streams()
         .best(ffmpeg::media::Type::Audio)
@@ -151,11 +302,16 @@ fn open_decode_context(input: &Path) -> Result<DecodeContext> {
         output_layout,
         output_rate,
         resampler,
+        _interrupt: None,
     })
 }
 
 /// Internal helper function.
-fn decode_with_sink<F>(context: &mut DecodeContext, mut sink: F) -> Result<usize>
+fn decode_with_sink<F>(
+    context: &mut DecodeContext,
+    cancel: &CancellationToken,
+    mut sink: F,
+) -> Result<usize>
 where
     F: FnMut(&[u8]) -> Result<()>,
 {
@@ -170,10 +326,21 @@ where
         let output_rate = context.output_rate;
         let stream_index = context.stream_index;
 
-        for (packet_stream, packet) in input_ctx.packets() {
-            if packet_stream.index() != stream_index {
+        loop {
+            let mut packet = ffmpeg::Packet::empty();
+            match packet.read(input_ctx) {
+                Ok(()) => {}
+                Err(ffmpeg::Error::Eof) => break,
+                // 与 `packets()` 一致跳过损坏的包；中断回调触发的读取失败在此处结束。
+                Err(_) => {
+                    cancel.check()?;
+                    continue;
+                }
+            }
+            if packet.stream() != stream_index {
                 continue;
             }
+            cancel.check()?;
 
             decoder.send_packet(&packet).map_err(|err| {
                 Error::FfmpegDecodeFailed(format!("decoder send packet failed: {err}"))
@@ -0,0 +1,460 @@
+//! 直播流的滑动窗口检测.
+//!
+//! 解码线程把 `FFmpeg` 逐帧输出写入只保存最近一个窗口的环形缓冲区；每凑齐一个 hop 就把
+//! 当前窗口序列化为 WAV，经有界队列交给工作线程运行 `audiowmark get`。队列已满说明
+//! 检测跟不上输入，此时跳过该窗口而不是阻塞解码（直播源不会等待）。命中结果回到解码
+//! 线程后再回调调用方，因此回调不需要 `Send`。.
+
+use std::path::Path;
+use std::sync::mpsc::{self, Receiver, TrySendError};
+use std::sync::{Mutex, PoisonError};
+use std::time::{Duration, Instant};
+
+use crate::audio::{
+    parse_detect_output, run_audiowmark_get_bytes, Audio, DetectResult, MonitorConfig, MonitorHit,
+    MonitorReport,
+};
+use crate::buffer_pool;
+use crate::error::{Error, Result};
+use crate::media::MediaStream;
+use crate::multichannel::{push_wav_header, SampleFormat};
+
+/// 解码输出的样本字节宽度（packed i16）.
+const SAMPLE_BYTES: usize = 2;
+/// 单个窗口的最长时长（秒），限制环形缓冲区内存.
+const MAX_WINDOW_SECS: u32 = 3600;
+
+/// 待检测的窗口.
+struct WindowJob {
+    /// 窗口终点（样本帧）.
+    end_frame: u64,
+    /// 窗口帧数.
+    frames: u64,
+    /// 窗口 WAV 字节.
+    wav: Vec<u8>,
+    /// 窗口凑齐的时刻.
+    ready_at: Instant,
+}
+
+/// 工作线程返回的窗口结果.
+struct WindowOutcome {
+    /// Internal field.
+    end_frame: u64,
+    /// Internal field.
+    frames: u64,
+    /// Internal field.
+    latency: Duration,
+    /// Internal field.
+    result: Result<Option<DetectResult>>,
+}
+
+/// 只保存最近 `capacity` 帧的交错 i16 环形缓冲区.
+struct Ring {
+    /// Internal field.
+    samples: Vec<i16>,
+    /// 每帧样本数.
+    channels: usize,
+    /// 下一次写入的样本位置.
+    head: usize,
+    /// 已写入的样本数（不超过容量）.
+    filled: usize,
+}
+
+impl Ring {
+    /// Internal associated function.
+    fn new(frames: usize, channels: usize) -> Self {
+        Self {
+            samples: vec![0; frames.saturating_mul(channels)],
+            channels,
+            head: 0,
+            filled: 0,
+        }
+    }
+
+    /// 写入一个样本；缓冲区满时覆盖最旧的样本.
+    fn push(&mut self, sample: i16) {
+        let Some(slot) = self.samples.get_mut(self.head) else {
+            return;
+        };
+        *slot = sample;
+        self.head = (self.head + 1) % self.samples.len();
+        self.filled = (self.filled + 1).min(self.samples.len());
+    }
+
+    /// 当前保存的帧数.
+    const fn frames(&self) -> usize {
+        self.filled / self.channels
+    }
+
+    /// 按时间顺序把当前内容序列化为 16 位 WAV.
+    fn to_wav(&self, sample_rate: u32) -> Result<Vec<u8>> {
+        let mut wav = buffer_pool::take_bytes(44 + self.filled * SAMPLE_BYTES);
+        push_wav_header(
+            &mut wav,
+            self.channels,
+            sample_rate,
+            SampleFormat::Int16,
+            self.frames(),
+        )?;
+        let (older, newer) = if self.filled < self.samples.len() {
+            (&self.samples[..self.filled], &[][..])
+        } else {
+            (&self.samples[self.head..], &self.samples[..self.head])
+        };
+        for sample in older.iter().chain(newer) {
+            wav.extend_from_slice(&sample.to_le_bytes());
+        }
+        Ok(wav)
+    }
+}
+
+/// 监测 `input` 直到输入结束或操作被取消.
+///
+/// 单个窗口的 audiowmark 执行失败只计入 [`MonitorReport::windows_failed`]，监测继续.
+///
+/// # Errors
+/// 当参数无效、输入无法打开或解码失败时返回错误。.
+pub fn monitor<F>(
+    audio_engine: &Audio,
+    input: &Path,
+    config: MonitorConfig,
+    mut on_hit: F,
+) -> Result<MonitorReport>
+where
+    F: FnMut(&MonitorHit),
+{
+    if config.window_secs == 0 || config.window_secs > MAX_WINDOW_SECS || config.hop_secs == 0 {
+        return Err(Error::InvalidInput(format!(
+            "monitor window must be 1-{MAX_WINDOW_SECS}s and hop at least 1s"
+        )));
+    }
+    let stream = MediaStream::open_live(input, audio_engine.cancellation())?;
+    let num_channels = usize::from(stream.channels());
+    let sample_rate = stream.sample_rate();
+    // 多声道只取前两个声道（通常为 FL/FR）；单声道整路送检。
+    let picked: Vec<usize> = (0..num_channels.min(2)).collect();
+    let window_frames = u64::from(config.window_secs) * u64::from(sample_rate);
+    let hop_frames = u64::from(config.hop_secs) * u64::from(sample_rate);
+    let mut ring = Ring::new(
+        usize::try_from(window_frames).unwrap_or(usize::MAX),
+        picked.len(),
+    );
+
+    let cpu_start = process_cpu_time();
+    let workers = config.workers.max(1);
+    let (job_tx, job_rx) = mpsc::sync_channel::<WindowJob>(workers);
+    let job_rx = Mutex::new(job_rx);
+    let (outcome_tx, outcome_rx) = mpsc::channel::<WindowOutcome>();
+    let mut tally = Tally::new(sample_rate);
+
+    let (decoded, total_frames) = std::thread::scope(|scope| {
+        for _ in 0..workers {
+            let outcome_tx = outcome_tx.clone();
+            let job_rx = &job_rx;
+            scope.spawn(move || detect_windows(audio_engine, job_rx, &outcome_tx));
+        }
+        drop(outcome_tx);
+
+        let mut total_frames = 0_u64;
+        let mut next_end = window_frames;
+        let mut last_end = None;
+        let frame_bytes = num_channels * SAMPLE_BYTES;
+        let decoded = stream.decode(audio_engine.cancellation(), |bytes| {
+            for frame in bytes.chunks_exact(frame_bytes) {
+                for &channel in &picked {
+                    let offset = channel * SAMPLE_BYTES;
+                    ring.push(i16::from_ne_bytes([frame[offset], frame[offset + 1]]));
+                }
+            }
+            total_frames =
+                total_frames.saturating_add(u64::try_from(bytes.len() / frame_bytes).unwrap_or(0));
+            audio_engine.progress_update_current_units(total_frames, None);
+            if total_frames >= next_end {
+                next_end = total_frames.saturating_add(hop_frames);
+                last_end = Some(total_frames);
+                let job = window_job(&ring, total_frames, sample_rate)?;
+                match job_tx.try_send(job) {
+                    Ok(()) => {}
+                    Err(TrySendError::Full(job) | TrySendError::Disconnected(job)) => {
+                        buffer_pool::give_bytes(job.wav);
+                        let dropped = &mut tally.report.windows_dropped;
+                        *dropped = dropped.saturating_add(1);
+                    }
+                }
+            }
+            tally.drain(outcome_rx.try_iter(), &mut on_hit);
+            Ok(())
+        });
+        // 输入结束：尾部不足一个 hop 的音频（或整段短于窗口的输入）补检一次。
+        if decoded.is_ok() && total_frames > 0 && last_end != Some(total_frames) {
+            if let Ok(job) = window_job(&ring, total_frames, sample_rate) {
+                if let Err(mpsc::SendError(job)) = job_tx.send(job) {
+                    buffer_pool::give_bytes(job.wav);
+                }
+            }
+        }
+        drop(job_tx);
+        tally.drain(outcome_rx.iter(), &mut on_hit);
+        (decoded, total_frames)
+    });
+
+    match decoded {
+        Ok(_) | Err(Error::Cancelled) => {}
+        Err(err) => return Err(err),
+    }
+    let mut report = tally.report;
+    report.audio_secs = frames_to_secs(total_frames, sample_rate);
+    report.cpu_secs = process_cpu_time()
+        .zip(cpu_start)
+        .map(|(end, start)| end.saturating_sub(start).as_secs_f64());
+    Ok(report)
+}
+
+/// Internal helper function.
+fn window_job(ring: &Ring, end_frame: u64, sample_rate: u32) -> Result<WindowJob> {
+    Ok(WindowJob {
+        end_frame,
+        frames: u64::try_from(ring.frames()).unwrap_or(u64::MAX),
+        wav: ring.to_wav(sample_rate)?,
+        ready_at: Instant::now(),
+    })
+}
+
+/// 工作线程：逐个取出窗口运行 `audiowmark get`.
+fn detect_windows(
+    audio_engine: &Audio,
+    jobs: &Mutex<Receiver<WindowJob>>,
+    outcomes: &mpsc::Sender<WindowOutcome>,
+) {
+    loop {
+        let job = {
+            let rx = jobs.lock().unwrap_or_else(PoisonError::into_inner);
+            rx.recv()
+        };
+        let Ok(job) = job else {
+            return;
+        };
+        let result = run_audiowmark_get_bytes(audio_engine, job.wav).map(|output| {
+            parse_detect_output(
+                &String::from_utf8_lossy(&output.stdout),
+                &String::from_utf8_lossy(&output.stderr),
+            )
+        });
+        let outcome = WindowOutcome {
+            end_frame: job.end_frame,
+            frames: job.frames,
+            latency: job.ready_at.elapsed(),
+            result,
+        };
+        if outcomes.send(outcome).is_err() {
+            return;
+        }
+    }
+}
+
+/// 累计窗口结果并生成统计.
+struct Tally {
+    /// Internal field.
+    sample_rate: u32,
+    /// Internal field.
+    report: MonitorReport,
+    /// Internal field.
+    latency_total_ms: u64,
+}
+
+impl Tally {
+    /// Internal associated function.
+    fn new(sample_rate: u32) -> Self {
+        Self {
+            sample_rate,
+            report: MonitorReport::default(),
+            latency_total_ms: 0,
+        }
+    }
+
+    /// 处理已返回的窗口结果；取消导致的失败忽略，其他 audiowmark 错误计数后继续.
+    fn drain<I, F>(&mut self, outcomes: I, on_hit: &mut F)
+    where
+        I: Iterator<Item = WindowOutcome>,
+        F: FnMut(&MonitorHit),
+    {
+        for outcome in outcomes {
+            let detected = match outcome.result {
+                Ok(detected) => detected,
+                Err(Error::Cancelled) => continue,
+                Err(err) => {
+                    let report = &mut self.report;
+                    report.windows_failed = report.windows_failed.saturating_add(1);
+                    report.first_error.get_or_insert_with(|| err.to_string());
+                    continue;
+                }
+            };
+            let latency_ms = u64::try_from(outcome.latency.as_millis()).unwrap_or(u64::MAX);
+            let report = &mut self.report;
+            report.windows = report.windows.saturating_add(1);
+            self.latency_total_ms = self.latency_total_ms.saturating_add(latency_ms);
+            report.latency_max_ms = report.latency_max_ms.max(latency_ms);
+            report.latency_mean_ms = self.latency_total_ms / report.windows;
+            if let Some(result) = detected {
+                report.hits = report.hits.saturating_add(1);
+                let start = outcome.end_frame.saturating_sub(outcome.frames);
+                on_hit(&MonitorHit {
+                    window_start_secs: frames_to_secs(start, self.sample_rate),
+                    window_end_secs: frames_to_secs(outcome.end_frame, self.sample_rate),
+                    result,
+                    latency_ms,
+                });
+            }
+        }
+    }
+}
+
+/// Internal helper function.
+fn frames_to_secs(frames: u64, sample_rate: u32) -> f64 {
+    let rate = u64::from(sample_rate.max(1));
+    let fraction = Duration::from_nanos((frames % rate).saturating_mul(1_000_000_000) / rate);
+    (Duration::from_secs(frames / rate) + fraction).as_secs_f64()
+}
+
+/// 本进程与已回收子进程的累计 CPU 时间（用户态 + 内核态）.
+#[cfg(unix)]
+#[allow(unsafe_code)]
+fn process_cpu_time() -> Option<Duration> {
+    let mut total = Duration::ZERO;
+    for who in [libc::RUSAGE_SELF, libc::RUSAGE_CHILDREN] {
+        // SAFETY: `rusage` is plain old data, so an all-zero value is valid, and `getrusage`
+        // only writes into the exclusively borrowed struct.
+        let mut usage: libc::rusage = unsafe { std::mem::zeroed() };
+        // SAFETY: `who` is a valid constant and `usage` outlives the call.
+        if unsafe { libc::getrusage(who, &mut usage) } != 0 {
+            return None;
+        }
+        for time in [usage.ru_utime, usage.ru_stime] {
+            total += Duration::from_secs(u64::try_from(time.tv_sec).unwrap_or(0))
+                + Duration::from_micros(u64::try_from(time.tv_usec).unwrap_or(0));
+        }
+    }
+    Some(total)
+}
+
+/// Internal helper function.
+#[cfg(not(unix))]
+const fn process_cpu_time() -> Option<Duration> {
+    None
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::multichannel::AudioBuffer;
+
+    #[test]
+    fn ring_keeps_latest_frames_in_order() {
+        let mut ring = Ring::new(3, 2);
+        for sample in 1..=4_i16 {
+            ring.push(sample);
+            ring.push(-sample);
+        }
+        assert_eq!(ring.frames(), 3);
+        let wav = ring.to_wav(44_100);
+        assert!(wav.is_ok());
+        let Ok(wav) = wav else {
+            return;
+        };
+        let decoded = AudioBuffer::from_wav_bytes(&wav);
+        assert!(decoded.is_ok());
+        let Ok(decoded) = decoded else {
+            return;
+        };
+        assert_eq!(decoded.channel_samples(0).ok(), Some(&[2, 3, 4][..]));
+        assert_eq!(decoded.channel_samples(1).ok(), Some(&[-2, -3, -4][..]));
+    }
+
+    #[test]
+    fn tally_reports_hits_with_window_times() {
+        let mut tally = Tally::new(100);
+        tally.report.windows_dropped = 2;
+        let hit = DetectResult {
+            raw_message: [1; crate::message::MESSAGE_LEN],
+            pattern: "all".to_string(),
+            detect_score: None,
+            bit_errors: 0,
+            match_found: true,
+        };
+        let outcomes = vec![
+            WindowOutcome {
+                end_frame: 1_000,
+                frames: 600,
+                latency: Duration::from_millis(40),
+                result: Ok(Some(hit)),
+            },
+            WindowOutcome {
+                end_frame: 1_300,
+                frames: 600,
+                latency: Duration::from_millis(20),
+                result: Ok(None),
+            },
+            WindowOutcome {
+                end_frame: 1_600,
+                frames: 600,
+                latency: Duration::ZERO,
+                result: Err(Error::Cancelled),
+            },
+        ];
+        let mut hits = Vec::new();
+        tally.drain(outcomes.into_iter(), &mut |hit: &MonitorHit| {
+            hits.push((hit.window_start_secs, hit.window_end_secs, hit.latency_ms));
+        });
+        assert_eq!(hits, vec![(4.0, 10.0, 40)]);
+        assert_eq!(tally.report.windows, 2);
+        assert_eq!(tally.report.hits, 1);
+        assert_eq!(tally.report.windows_dropped, 2);
+        assert_eq!(tally.report.latency_mean_ms, 30);
+        assert_eq!(tally.report.latency_max_ms, 40);
+        assert_eq!(tally.report.windows_failed, 0);
+    }
+
+    #[test]
+    fn tally_counts_failed_windows_and_keeps_going() {
+        let mut tally = Tally::new(100);
+        let hit = DetectResult {
+            raw_message: [1; crate::message::MESSAGE_LEN],
+            pattern: "all".to_string(),
+            detect_score: None,
+            bit_errors: 0,
+            match_found: true,
+        };
+        let outcomes = vec![
+            WindowOutcome {
+                end_frame: 600,
+                frames: 600,
+                latency: Duration::ZERO,
+                result: Err(Error::AudiowmarkExec("first".to_string())),
+            },
+            WindowOutcome {
+                end_frame: 900,
+                frames: 600,
+                latency: Duration::ZERO,
+                result: Err(Error::AudiowmarkExec("second".to_string())),
+            },
+            WindowOutcome {
+                end_frame: 1_200,
+                frames: 600,
+                latency: Duration::from_millis(10),
+                result: Ok(Some(hit)),
+            },
+        ];
+        let mut hits = Vec::new();
+        tally.drain(outcomes.into_iter(), &mut |hit: &MonitorHit| {
+            hits.push(hit.window_end_secs);
+        });
+        assert_eq!(hits, vec![12.0]);
+        assert_eq!(tally.report.windows, 1);
+        assert_eq!(tally.report.windows_failed, 2);
+        assert!(tally
+            .report
+            .first_error
+            .as_deref()
+            .is_some_and(|err| err.contains("first")));
+    }
+}
@@ -6,9 +6,27 @@ pub mod adm_bwav;
 pub mod adm_embed;
 #[cfg(feature = "multichannel")]
 pub mod adm_routing;
+#[cfg(feature = "multichannel")]
+pub mod fanout_embed;
+#[cfg(all(feature = "multichannel", feature = "ffmpeg-decode"))]
+pub mod live_monitor;
+#[cfg(feature = "multichannel")]
+pub mod multi_key_detect;
+#[cfg(feature = "multichannel")]
+pub mod route_cluster;
+#[cfg(feature = "multichannel")]
+pub mod segment_embed;
+#[cfg(all(feature = "multichannel", feature = "ffmpeg-decode"))]
+pub mod stream_detect;
+#[cfg(feature = "multichannel")]
+pub mod stream_embed;
+#[cfg(feature = "multichannel")]
+pub mod wav_map;
 
 #[cfg(feature = "ffmpeg-decode")]
 mod ffmpeg_decode;
 
 #[cfg(feature = "ffmpeg-decode")]
-pub use ffmpeg_decode::{decode_media_to_pcm_i32, decode_media_to_wav_pipe, media_capabilities};
+pub use ffmpeg_decode::{
+    decode_media_to_pcm_i32, decode_media_to_wav_pipe, media_capabilities, MediaStream,
+};
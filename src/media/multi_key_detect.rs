@@ -0,0 +1,402 @@
+//! 单次解码的多密钥检测.
+//!
+//! 输入只解码一次，按路由步骤序列化的 WAV 字节由所有密钥共享；每个（密钥, 步骤）组合
+//! 对应一个并发运行的 `audiowmark get --key K -` 子进程。任一子进程报告零比特错误的
+//! pattern 后，尚未完成的子进程随即停止，未启动的组合不再启动。.
+
+use std::io::{BufRead, BufReader, Read, Write};
+use std::path::{Path, PathBuf};
+use std::process::{Child, ExitStatus, Stdio};
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
+use std::time::Duration;
+
+use crate::audio::{
+    build_stereo_for_route_step, finalize_detect_step_results, is_pipe_compatibility_error,
+    log_route_warnings, parse_detect_output, validate_layout_channels, Audio, DetectStepTaskResult,
+    KeyDetectResult,
+};
+use crate::buffer_pool;
+use crate::error::{Error, Result};
+use crate::media::route_cluster;
+use crate::multichannel::{effective_lfe_mode, AudioBuffer, ChannelLayout, RouteMode, RouteStep};
+
+/// 轮询子进程与停止标志的最长间隔.
+const STOP_POLL: Duration = Duration::from_millis(20);
+
+/// 由所有密钥共享的单个路由步骤输入.
+struct SharedStep {
+    /// 步骤在路由方案中的序号.
+    index: usize,
+    /// 路由步骤.
+    step: RouteStep,
+    /// 步骤输入的 WAV 字节.
+    wav: Vec<u8>,
+}
+
+/// 单个（密钥, 步骤）子进程的输出.
+struct JobOutput {
+    /// Internal field.
+    stdout: String,
+    /// Internal field.
+    stderr: String,
+    /// Internal field.
+    success: bool,
+}
+
+/// 用 `key_files` 中的每个密钥检测已解码的 `audio`.
+///
+/// audiowmark 不支持管道输入时返回 `Ok(None)`，由调用方逐个密钥回退。.
+///
+/// # Errors
+/// 当布局与声道数不匹配、步骤输入序列化失败、audiowmark 启动失败或操作被取消时返回错误。.
+pub fn detect_with_keys(
+    audio_engine: &Audio,
+    audio: &AudioBuffer,
+    input: &Path,
+    key_files: &[PathBuf],
+    layout: Option<ChannelLayout>,
+) -> Result<Option<Vec<KeyDetectResult>>> {
+    let steps = prepare_steps(audio, input, layout)?;
+    let jobs: Vec<(usize, usize)> = (0..key_files.len())
+        .flat_map(|key| (0..steps.len()).map(move |step| (key, step)))
+        .collect();
+    let total_units = u64::try_from(jobs.len()).unwrap_or(u64::MAX);
+    audio_engine.progress_update_current_units(0, Some(total_units));
+
+    let next = AtomicUsize::new(0);
+    let done = AtomicU64::new(0);
+    let stop = AtomicBool::new(false);
+    let workers = std::thread::available_parallelism()
+        .map_or(1, std::num::NonZero::get)
+        .min(jobs.len())
+        .max(1);
+    let run_worker = || -> Result<Vec<(usize, JobOutput)>> {
+        let mut finished = Vec::new();
+        loop {
+            let job_index = next.fetch_add(1, Ordering::Relaxed);
+            let Some(&(key, step)) = jobs.get(job_index) else {
+                return Ok(finished);
+            };
+            if stop.load(Ordering::Relaxed) {
+                return Ok(finished);
+            }
+            let output = run_job(audio_engine, &key_files[key], &steps[step].wav, &stop);
+            // 任一组合失败时停止其余子进程，错误随后整体返回。
+            let output = output.inspect_err(|_| stop.store(true, Ordering::Relaxed))?;
+            let completed = done.fetch_add(1, Ordering::Relaxed) + 1;
+            audio_engine.progress_update_current_units(completed, Some(total_units));
+            if let Some(output) = output {
+                finished.push((job_index, output));
+            }
+        }
+    };
+    let worker_results: Vec<Result<Vec<(usize, JobOutput)>>> = std::thread::scope(|scope| {
+        let handles: Vec<_> = (0..workers).map(|_| scope.spawn(run_worker)).collect();
+        handles
+            .into_iter()
+            .map(|handle| {
+                handle.join().unwrap_or_else(|_| {
+                    Err(Error::AudiowmarkExec("detect worker panicked".to_string()))
+                })
+            })
+            .collect()
+    });
+
+    let mut outputs: Vec<Option<JobOutput>> = jobs.iter().map(|_| None).collect();
+    let mut first_error = None;
+    for worker in worker_results {
+        match worker {
+            Ok(finished) => {
+                for (job_index, output) in finished {
+                    outputs[job_index] = Some(output);
+                }
+            }
+            Err(err) => {
+                first_error.get_or_insert(err);
+            }
+        }
+    }
+    let stopped_early = stop.load(Ordering::Relaxed);
+    let results = match first_error {
+        Some(err) => Err(err),
+        None => Ok(collect_results(
+            key_files,
+            &steps,
+            &jobs,
+            outputs,
+            stopped_early,
+        )),
+    };
+    for shared in steps {
+        buffer_pool::give_bytes(shared.wav);
+    }
+    results
+}
+
+/// 规划路由并序列化各步骤输入；单声道/立体声输入整路作为一个步骤.
+fn prepare_steps(
+    audio: &AudioBuffer,
+    input: &Path,
+    layout: Option<ChannelLayout>,
+) -> Result<Vec<SharedStep>> {
+    let num_channels = audio.num_channels();
+    if num_channels <= 2 {
+        return Ok(vec![SharedStep {
+            index: 0,
+            step: RouteStep {
+                name: "FL+FR".to_string(),
+                mode: if num_channels == 2 {
+                    RouteMode::Pair(0, 1)
+                } else {
+                    RouteMode::Mono(0)
+                },
+            },
+            wav: audio.to_wav_bytes()?,
+        }]);
+    }
+    let layout = layout.unwrap_or_else(|| audio.layout());
+    validate_layout_channels(layout, num_channels)?;
+    let plan = route_cluster::plan_routes(audio, layout, effective_lfe_mode());
+    log_route_warnings("detect-keys", input, &plan.warnings);
+    let mut steps = Vec::new();
+    for (index, step) in plan.detectable_steps() {
+        let wav = build_stereo_for_route_step(audio, step).and_then(|stereo| {
+            let wav = stereo.to_wav_bytes();
+            stereo.recycle();
+            wav
+        });
+        match wav {
+            Ok(wav) => steps.push(SharedStep {
+                index,
+                step: step.clone(),
+                wav,
+            }),
+            Err(err) => {
+                for shared in steps {
+                    buffer_pool::give_bytes(shared.wav);
+                }
+                return Err(err);
+            }
+        }
+    }
+    Ok(steps)
+}
+
+/// 运行一个 `get --key` 子进程；被停止时返回 `Ok(None)`.
+fn run_job(
+    audio_engine: &Audio,
+    key_file: &Path,
+    wav: &[u8],
+    stop: &AtomicBool,
+) -> Result<Option<JobOutput>> {
+    audio_engine.cancellation().check()?;
+    let mut child = audio_engine
+        .get_wav_pipe_command_with_key(Some(key_file))
+        .stdin(Stdio::piped())
+        .stdout(Stdio::piped())
+        .stderr(Stdio::piped())
+        .spawn()
+        .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+    let handles = (child.stdin.take(), child.stdout.take(), child.stderr.take());
+    let (Some(mut stdin), Some(stdout), Some(mut stderr)) = handles else {
+        let _ = child.kill();
+        let _ = child.wait();
+        return Err(Error::AudiowmarkExec(
+            "failed to take audiowmark pipe handles".to_string(),
+        ));
+    };
+    let perfect = AtomicBool::new(false);
+    let (status, stopped, stdout, stderr) = std::thread::scope(|scope| {
+        // 子进程被停止或提前退出时写入失败是预期的，结果以 stdout/stderr 为准。
+        scope.spawn(move || {
+            let _ = stdin.write_all(wav);
+        });
+        let reader = scope.spawn(|| collect_stdout(BufReader::new(stdout), &perfect));
+        let stderr_reader = scope.spawn(move || {
+            let mut buf = String::new();
+            let _ = stderr.read_to_string(&mut buf);
+            buf
+        });
+        let (status, stopped) = wait_or_stop(audio_engine, &mut child, stop, &perfect);
+        (
+            status,
+            stopped,
+            reader.join().unwrap_or_default(),
+            stderr_reader.join().unwrap_or_default(),
+        )
+    });
+    audio_engine.cancellation().check()?;
+    if stopped {
+        return Ok(None);
+    }
+    let status = status.map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+    Ok(Some(JobOutput {
+        stdout,
+        stderr,
+        success: status.success(),
+    }))
+}
+
+/// 等待子进程退出；其他子进程已完美命中或操作被取消时停止它。返回 `(状态, 是否被停止)`.
+///
+/// 本子进程自己报告零比特错误时置位全局 `stop`，但仍等待其正常退出。.
+fn wait_or_stop(
+    audio_engine: &Audio,
+    child: &mut Child,
+    stop: &AtomicBool,
+    perfect: &AtomicBool,
+) -> (std::io::Result<ExitStatus>, bool) {
+    let mut backoff = Duration::from_millis(1);
+    loop {
+        match child.try_wait() {
+            Ok(Some(status)) => return (Ok(status), false),
+            Ok(None) => {}
+            Err(err) => return (Err(err), false),
+        }
+        if perfect.load(Ordering::Relaxed) {
+            stop.store(true, Ordering::Relaxed);
+        } else if stop.load(Ordering::Relaxed) || audio_engine.cancellation().is_cancelled() {
+            // kill 失败通常意味着子进程刚好已退出；随后的 wait 负责回收。
+            let _ = child.kill();
+            return (child.wait(), true);
+        }
+        std::thread::sleep(backoff);
+        backoff = backoff.saturating_mul(2).min(STOP_POLL);
+    }
+}
+
+/// 按密钥汇总各步骤输出；发现管道兼容性错误时返回 `None`.
+fn collect_results(
+    key_files: &[PathBuf],
+    steps: &[SharedStep],
+    jobs: &[(usize, usize)],
+    outputs: Vec<Option<JobOutput>>,
+    stopped_early: bool,
+) -> Option<Vec<KeyDetectResult>> {
+    let mut per_key: Vec<(Vec<DetectStepTaskResult>, bool)> =
+        key_files.iter().map(|_| (Vec::new(), true)).collect();
+    for (&(key, step), output) in jobs.iter().zip(outputs) {
+        let Some(output) = output else {
+            per_key[key].1 = false;
+            continue;
+        };
+        if !output.success && is_pipe_compatibility_error(&output.stderr) {
+            return None;
+        }
+        let outcome = parse_detect_output(&output.stdout, &output.stderr);
+        // 提前停止时只保留命中的步骤，与逐步检测的提前退出语义一致
+        if stopped_early && !outcome.as_ref().is_some_and(|r| r.bit_errors == 0) {
+            per_key[key].1 = false;
+        }
+        per_key[key].0.push(DetectStepTaskResult {
+            step_idx: steps[step].index,
+            step: steps[step].step.clone(),
+            outcome,
+        });
+    }
+    Some(
+        key_files
+            .iter()
+            .zip(per_key)
+            .map(|(key_file, (step_results, completed))| {
+                // 完美命中的密钥结果已确定，其余步骤被跳过也算检测完毕
+                let hit = step_results.iter().any(|result| {
+                    result
+                        .outcome
+                        .as_ref()
+                        .is_some_and(|outcome| outcome.bit_errors == 0)
+                });
+                KeyDetectResult {
+                    key_file: key_file.clone(),
+                    detect: finalize_detect_step_results(step_results),
+                    completed: completed || hit,
+                }
+            })
+            .collect(),
+    )
+}
+
+/// 读线程：逐行收集 stdout，出现零比特错误的 pattern 行时置位 `perfect`.
+pub(crate) fn collect_stdout<R: BufRead>(stdout: R, perfect: &AtomicBool) -> String {
+    let mut collected = String::new();
+    for line in stdout.lines() {
+        let Ok(line) = line else {
+            break;
+        };
+        if parse_detect_output(&line, "").is_some_and(|result| result.bit_errors == 0) {
+            perfect.store(true, Ordering::Relaxed);
+        }
+        collected.push_str(&line);
+        collected.push('\n');
+    }
+    collected
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn job(stdout: &str) -> Option<JobOutput> {
+        Some(JobOutput {
+            stdout: stdout.to_string(),
+            stderr: String::new(),
+            success: true,
+        })
+    }
+
+    #[test]
+    fn results_are_grouped_per_key_with_completion() {
+        let steps: Vec<SharedStep> = (0..2)
+            .map(|index| SharedStep {
+                index,
+                step: RouteStep {
+                    name: format!("step{index}"),
+                    mode: RouteMode::Mono(index),
+                },
+                wav: Vec::new(),
+            })
+            .collect();
+        let keys = vec![PathBuf::from("a.key"), PathBuf::from("b.key")];
+        let jobs = vec![(0, 0), (0, 1), (1, 0), (1, 1)];
+        let outputs = vec![
+            job("pattern  all 0101c1d05978131b57f7deb8e22a0b78 4\n"),
+            job(""),
+            job("pattern  all 0101c1d05978131b57f7deb8e22a0b78 0\n"),
+            None,
+        ];
+        let collected = collect_results(&keys, &steps, &jobs, outputs, true);
+        assert!(matches!(collected, Some(ref results) if results.len() == 2));
+        let Some(results) = collected else {
+            return;
+        };
+        assert!(!results[0].completed);
+        assert_eq!(results[0].detect.pairs.len(), 2);
+        assert_eq!(results[1].key_file, PathBuf::from("b.key"));
+        // 命中的密钥即使跳过了剩余步骤也算完成
+        assert!(results[1].completed);
+        assert_eq!(
+            results[1].detect.best.as_ref().map(|best| best.bit_errors),
+            Some(0)
+        );
+    }
+
+    #[test]
+    fn pipe_compatibility_error_requests_fallback() {
+        let steps = vec![SharedStep {
+            index: 0,
+            step: RouteStep {
+                name: "FL+FR".to_string(),
+                mode: RouteMode::Pair(0, 1),
+            },
+            wav: Vec::new(),
+        }];
+        let outputs = vec![Some(JobOutput {
+            stdout: String::new(),
+            stderr: "audiowmark: unsupported option --input-format".to_string(),
+            success: false,
+        })];
+        let collected =
+            collect_results(&[PathBuf::from("a.key")], &steps, &[(0, 0)], outputs, false);
+        assert!(collected.is_none());
+    }
+}
@@ -0,0 +1,439 @@
+//! 大声道数（非 ADM）文件的聚类路由规划.
+//!
+//! 16 声道以上的自定义布局没有固定路由表，顺序配对会让每两条声道各跑一次 audiowmark。
+//! 这里先在抽样样本上做一次相关性分析：静默声道直接跳过；与更响声道高度相关的声道
+//! 作为镜像，合并时叠加源声道的嵌入差值而不单独嵌入；其余声道按相关性两两聚类并按
+//! 能量排序。默认每个聚类都会嵌入；只有显式设置 `AWMKIT_ROUTE_STEP_BUDGET` 时才按能量
+//! 保留前若干步骤，跳过的声道不含水印，并在路由警告中逐一列出。.
+
+use crate::media::adm_routing::is_silent;
+use crate::multichannel::{
+    build_smart_route_plan, has_fixed_routing, mono_step, pair_step, skip_step, AudioBuffer,
+    ChannelLayout, ChannelMirror, LfeMode, RoutePlan, RouteStep,
+};
+
+/// 启用聚类规划的最小声道数.
+const MIN_CLUSTER_CHANNELS: usize = 16;
+/// 相关性分析时每声道最多抽取的帧数.
+const ANALYSIS_FRAMES: usize = 16_384;
+/// 视为镜像声道的最小相关系数.
+const MIRROR_MIN_CORRELATION: f64 = 0.98;
+/// 按相关性聚为一对的最小相关系数；低于此值时按能量相邻配对.
+const CLUSTER_MIN_CORRELATION: f64 = 0.5;
+/// 步骤预算环境变量.
+const STEP_BUDGET_ENV: &str = "AWMKIT_ROUTE_STEP_BUDGET";
+
+/// 为已加载的音频规划路由：固定布局沿用 [`build_smart_route_plan`]，大声道数的
+/// 自定义布局按内容聚类.
+#[must_use]
+pub(crate) fn plan_routes(
+    audio: &AudioBuffer,
+    layout: ChannelLayout,
+    lfe_mode: LfeMode,
+) -> RoutePlan {
+    plan_fixed_routes(layout, audio.num_channels(), lfe_mode)
+        .unwrap_or_else(|| cluster_route_plan(audio, layout, lfe_mode, step_budget()))
+}
+
+/// 不看样本即可确定的路由方案：声道数低于聚类门槛或布局有固定路由表时返回
+/// [`build_smart_route_plan`] 的结果，需要按内容聚类时返回 `None`.
+#[must_use]
+pub(crate) fn plan_fixed_routes(
+    layout: ChannelLayout,
+    channels: usize,
+    lfe_mode: LfeMode,
+) -> Option<RoutePlan> {
+    (channels < MIN_CLUSTER_CHANNELS || has_fixed_routing(layout, channels))
+        .then(|| build_smart_route_plan(layout, channels, lfe_mode))
+}
+
+/// 运行时步骤预算：默认不限，见 [`parse_step_budget`].
+fn step_budget() -> usize {
+    parse_step_budget(std::env::var(STEP_BUDGET_ENV).ok().as_deref())
+}
+
+/// 解析 `AWMKIT_ROUTE_STEP_BUDGET`；未设置、为 `0` 或无法解析时不限.
+fn parse_step_budget(raw: Option<&str>) -> usize {
+    match raw.and_then(|raw| raw.trim().parse::<usize>().ok()) {
+        Some(0) | None => usize::MAX,
+        Some(budget) => budget,
+    }
+}
+
+/// 单个声道的抽样分析结果.
+struct ChannelProfile {
+    /// 声道序号.
+    channel: usize,
+    /// 去均值后的抽样样本.
+    samples: Vec<f64>,
+    /// 抽样样本能量.
+    energy: f64,
+}
+
+impl ChannelProfile {
+    /// 等间隔抽取至多 [`ANALYSIS_FRAMES`] 帧并去均值.
+    fn new(channel: usize, samples: &[i32]) -> Self {
+        let stride = (samples.len() / ANALYSIS_FRAMES).max(1);
+        let mut picked: Vec<f64> = samples
+            .iter()
+            .step_by(stride)
+            .take(ANALYSIS_FRAMES)
+            .map(|&sample| f64::from(sample))
+            .collect();
+        let count = f64::from(u32::try_from(picked.len().max(1)).unwrap_or(u32::MAX));
+        let mean = picked.iter().sum::<f64>() / count;
+        for sample in &mut picked {
+            *sample -= mean;
+        }
+        let energy = dot(&picked, &picked);
+        Self {
+            channel,
+            samples: picked,
+            energy,
+        }
+    }
+
+    /// 与另一声道的 (相关系数, 内积).
+    fn correlation(&self, other: &Self) -> (f64, f64) {
+        let product = dot(&self.samples, &other.samples);
+        let denom = (self.energy * other.energy).sqrt();
+        if denom > 0.0 {
+            (product / denom, product)
+        } else {
+            (0.0, product)
+        }
+    }
+}
+
+/// Internal helper function.
+fn dot(a: &[f64], b: &[f64]) -> f64 {
+    a.iter().zip(b).map(|(x, y)| x * y).sum()
+}
+
+/// 一个路由步骤承载的声道（`active` 下标）.
+enum Cluster {
+    /// Internal variant.
+    Pair(usize, usize),
+    /// Internal variant.
+    Mono(usize),
+}
+
+/// 按内容聚类生成路由方案.
+fn cluster_route_plan(
+    audio: &AudioBuffer,
+    layout: ChannelLayout,
+    lfe_mode: LfeMode,
+    budget: usize,
+) -> RoutePlan {
+    let channels = audio.num_channels();
+    let format = audio.sample_format();
+    let mut silent = Vec::new();
+    let mut active = Vec::new();
+    for channel in 0..channels {
+        let Ok(samples) = audio.channel_samples(channel) else {
+            continue;
+        };
+        if is_silent(samples, format) {
+            silent.push(channel);
+        } else {
+            active.push(ChannelProfile::new(channel, samples));
+        }
+    }
+    if active.is_empty() {
+        return build_smart_route_plan(layout, channels, lfe_mode);
+    }
+    // 响度优先：镜像源与保留的步骤都从能量最高的声道开始挑选。
+    active.sort_by(|a, b| {
+        b.energy
+            .total_cmp(&a.energy)
+            .then(a.channel.cmp(&b.channel))
+    });
+
+    let mut leaders: Vec<usize> = Vec::new();
+    let mut mirrors = Vec::new();
+    for (idx, profile) in active.iter().enumerate() {
+        let source = leaders
+            .iter()
+            .map(|&leader| (leader, active[leader].correlation(profile)))
+            .filter(|(_, (corr, _))| *corr >= MIRROR_MIN_CORRELATION)
+            .max_by(|a, b| (a.1).0.total_cmp(&(b.1).0));
+        match source {
+            Some((leader, (_, product))) => mirrors.push(ChannelMirror {
+                channel: profile.channel,
+                source: active[leader].channel,
+                gain: mirror_gain(product, active[leader].energy),
+            }),
+            None => leaders.push(idx),
+        }
+    }
+
+    let clusters = pair_leaders(&active, &leaders);
+    let mut steps = Vec::with_capacity(channels);
+    let mut over_budget = 0usize;
+    let mut unmarked = Vec::new();
+    for (rank, cluster) in clusters.iter().enumerate() {
+        if rank < budget {
+            steps.push(cluster_step(&active, cluster));
+            continue;
+        }
+        over_budget = over_budget.saturating_add(1);
+        let members = match *cluster {
+            Cluster::Pair(a, b) => vec![active[a].channel, active[b].channel],
+            Cluster::Mono(a) => vec![active[a].channel],
+        };
+        for channel in members {
+            steps.push(skip_step(channel, &channel_name(channel), "over_budget"));
+            unmarked.push(channel);
+        }
+    }
+    for mirror in &mirrors {
+        let name = channel_name(mirror.channel);
+        steps.push(skip_step(mirror.channel, &name, "mirrored"));
+    }
+    for &channel in &silent {
+        steps.push(skip_step(channel, &channel_name(channel), "silent"));
+    }
+
+    let mut warnings = vec![format!(
+        "clustered routing is used for layout {:?} ({} channels): {} steps, {} silent, {} mirrored, {} over budget",
+        layout,
+        channels,
+        clusters.len().min(budget),
+        silent.len(),
+        mirrors.len(),
+        over_budget
+    )];
+    if !unmarked.is_empty() {
+        unmarked.sort_unstable();
+        let names: Vec<String> = unmarked
+            .iter()
+            .map(|&channel| channel_name(channel))
+            .collect();
+        warnings.push(format!(
+            "{STEP_BUDGET_ENV}={budget} skipped {over_budget} step(s); {} channel(s) carry NO watermark: {}",
+            names.len(),
+            names.join(", ")
+        ));
+    }
+    RoutePlan {
+        layout,
+        channels,
+        steps,
+        warnings,
+        mirrors,
+    }
+}
+
+/// 先按相关性从高到低贪心配对代表声道，其余按能量相邻配对；结果按能量从高到低排序.
+fn pair_leaders(active: &[ChannelProfile], leaders: &[usize]) -> Vec<Cluster> {
+    let mut candidates = Vec::new();
+    for (pos, &a) in leaders.iter().enumerate() {
+        for &b in &leaders[pos + 1..] {
+            let (corr, _) = active[a].correlation(&active[b]);
+            if corr >= CLUSTER_MIN_CORRELATION {
+                candidates.push((corr, a, b));
+            }
+        }
+    }
+    candidates.sort_by(|x, y| y.0.total_cmp(&x.0).then(x.1.cmp(&y.1)).then(x.2.cmp(&y.2)));
+
+    let mut used = vec![false; active.len()];
+    let mut clusters = Vec::with_capacity(leaders.len().div_ceil(2));
+    for (_, a, b) in candidates {
+        if !used[a] && !used[b] {
+            used[a] = true;
+            used[b] = true;
+            clusters.push(Cluster::Pair(a, b));
+        }
+    }
+    // `leaders` 已按能量降序：剩余声道与能量相近者配对，预算裁掉的总是最弱的一组。
+    let mut pending = None;
+    for &leader in leaders.iter().filter(|&&leader| !used[leader]) {
+        match pending.take() {
+            Some(previous) => clusters.push(Cluster::Pair(previous, leader)),
+            None => pending = Some(leader),
+        }
+    }
+    if let Some(last) = pending {
+        clusters.push(Cluster::Mono(last));
+    }
+    let energy = |cluster: &Cluster| match *cluster {
+        Cluster::Pair(a, b) => active[a].energy + active[b].energy,
+        Cluster::Mono(a) => active[a].energy,
+    };
+    clusters.sort_by(|x, y| energy(y).total_cmp(&energy(x)));
+    clusters
+}
+
+/// Internal helper function.
+fn cluster_step(active: &[ChannelProfile], cluster: &Cluster) -> RouteStep {
+    match *cluster {
+        Cluster::Pair(a, b) => {
+            let (left, right) = if active[a].channel < active[b].channel {
+                (active[a].channel, active[b].channel)
+            } else {
+                (active[b].channel, active[a].channel)
+            };
+            pair_step(
+                left,
+                right,
+                &format!("{}+{}", channel_name(left), channel_name(right)),
+            )
+        }
+        Cluster::Mono(a) => {
+            let channel = active[a].channel;
+            mono_step(channel, &format!("{}(mono)", channel_name(channel)))
+        }
+    }
+}
+
+/// Internal helper function.
+fn channel_name(channel: usize) -> String {
+    format!("CH{}", channel + 1)
+}
+
+/// 镜像声道在源声道上的投影系数.
+#[allow(clippy::cast_possible_truncation)]
+fn mirror_gain(product: f64, source_energy: f64) -> f32 {
+    if source_energy > 0.0 {
+        (product / source_energy) as f32
+    } else {
+        0.0
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::multichannel::{RouteMode, SampleFormat, DEFAULT_LFE_MODE};
+
+    /// 确定性伪随机噪声.
+    fn noise(seed: u32, len: usize, amplitude: i32) -> Vec<i32> {
+        let mut state = seed.wrapping_mul(2_654_435_761).max(1);
+        (0..len)
+            .map(|_| {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                let unit = i32::try_from(state % 2001).unwrap_or(0) - 1000;
+                unit * amplitude / 1000
+            })
+            .collect()
+    }
+
+    #[test]
+    fn large_layout_skips_silent_and_mirrors_duplicates() {
+        let mut channels: Vec<Vec<i32>> = (0..24)
+            .map(|ch| noise(ch + 1, 4096, 1_000 + i32::try_from(ch).unwrap_or(0) * 100))
+            .collect();
+        channels[5] = vec![0; 4096];
+        channels[9] = channels[2].clone();
+        let built = AudioBuffer::new(channels, 48_000, SampleFormat::Int16);
+        assert!(built.is_ok());
+        let Ok(audio) = built else {
+            return;
+        };
+        let plan = cluster_route_plan(&audio, ChannelLayout::Custom(24), DEFAULT_LFE_MODE, 64);
+        assert_eq!(plan.warnings.len(), 1);
+        assert!(plan.steps.contains(&skip_step(5, "CH6", "silent")));
+        assert_eq!(plan.mirrors.len(), 1);
+        assert_eq!(plan.mirrors[0].channel.min(plan.mirrors[0].source), 2);
+        assert_eq!(plan.mirrors[0].channel.max(plan.mirrors[0].source), 9);
+        assert!((plan.mirrors[0].gain - 1.0).abs() < 1e-3);
+        // 22 条有效代表声道 → 11 个立体声步骤，每条声道恰好出现一次。
+        assert_eq!(plan.detectable_steps().len(), 11);
+        let mut seen = vec![0u8; 24];
+        for step in &plan.steps {
+            match step.mode {
+                RouteMode::Pair(a, b) => {
+                    seen[a] += 1;
+                    seen[b] += 1;
+                }
+                RouteMode::Mono(a) | RouteMode::Skip { channel: a, .. } => seen[a] += 1,
+            }
+        }
+        assert!(seen.iter().all(|&count| count == 1));
+    }
+
+    #[test]
+    fn budget_keeps_loudest_steps() {
+        let channels: Vec<Vec<i32>> = (0..32)
+            .map(|ch| noise(ch + 7, 2048, 200 + i32::try_from(ch).unwrap_or(0) * 300))
+            .collect();
+        let built = AudioBuffer::new(channels, 48_000, SampleFormat::Int16);
+        assert!(built.is_ok());
+        let Ok(audio) = built else {
+            return;
+        };
+        let plan = cluster_route_plan(&audio, ChannelLayout::Custom(32), DEFAULT_LFE_MODE, 4);
+        let kept = plan.detectable_steps();
+        assert_eq!(kept.len(), 4);
+        let over_budget = plan
+            .steps
+            .iter()
+            .filter(|step| {
+                matches!(
+                    step.mode,
+                    RouteMode::Skip {
+                        reason: "over_budget",
+                        ..
+                    }
+                )
+            })
+            .count();
+        assert_eq!(over_budget, 24);
+        assert_eq!(plan.warnings.len(), 2);
+        assert!(plan.warnings[1].contains("24 channel(s) carry NO watermark"));
+        // 最响的声道（CH32）必须在保留的步骤里。
+        assert!(kept.iter().any(|(_, step)| match step.mode {
+            RouteMode::Pair(a, b) => a == 31 || b == 31,
+            RouteMode::Mono(a) => a == 31,
+            RouteMode::Skip { .. } => false,
+        }));
+    }
+
+    #[test]
+    fn step_budget_is_unlimited_unless_set() {
+        assert_eq!(parse_step_budget(None), usize::MAX);
+        assert_eq!(parse_step_budget(Some("0")), usize::MAX);
+        assert_eq!(parse_step_budget(Some("junk")), usize::MAX);
+        assert_eq!(parse_step_budget(Some(" 12 ")), 12);
+    }
+
+    #[test]
+    fn fixed_and_small_layouts_keep_static_plan() {
+        let channels: Vec<Vec<i32>> = (0..16).map(|ch| noise(ch + 3, 512, 1_000)).collect();
+        let built = AudioBuffer::new(channels, 48_000, SampleFormat::Int16);
+        assert!(built.is_ok());
+        let Ok(audio) = built else {
+            return;
+        };
+        assert_eq!(
+            plan_routes(&audio, ChannelLayout::Surround916, DEFAULT_LFE_MODE),
+            build_smart_route_plan(ChannelLayout::Surround916, 16, DEFAULT_LFE_MODE)
+        );
+        assert_eq!(
+            plan_fixed_routes(ChannelLayout::Surround916, 16, DEFAULT_LFE_MODE),
+            Some(build_smart_route_plan(
+                ChannelLayout::Surround916,
+                16,
+                DEFAULT_LFE_MODE
+            ))
+        );
+        assert!(plan_fixed_routes(ChannelLayout::Custom(18), 18, DEFAULT_LFE_MODE).is_none());
+    }
+
+    #[test]
+    fn all_silent_falls_back_to_sequential_pairs() {
+        let built = AudioBuffer::new(vec![vec![0; 64]; 18], 48_000, SampleFormat::Int24);
+        assert!(built.is_ok());
+        let Ok(audio) = built else {
+            return;
+        };
+        let plan = cluster_route_plan(&audio, ChannelLayout::Custom(18), DEFAULT_LFE_MODE, 16);
+        assert_eq!(
+            plan,
+            build_smart_route_plan(ChannelLayout::Custom(18), 18, DEFAULT_LFE_MODE)
+        );
+    }
+}
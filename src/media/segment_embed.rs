@@ -0,0 +1,430 @@
+//! 长音频的时间分段并行嵌入.
+//!
+//! 单个 `audiowmark add` 进程只能占满一个核心。这里把输入按水印帧周期对齐切段，每段向
+//! 两侧各延伸一段重叠区后并行嵌入，再在接缝处线性交叉淡化、按样本精确拼回原长度。各段
+//! 的水印都从段首重新开始重复，接缝附近最多损失一个水印块；可选的接缝校验对每个接缝
+//! 单独检测一个只容纳跨接缝水印块的窗口（不足两个块长），接缝损坏时校验必然失败。.
+
+use std::ops::Range;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use rayon::prelude::*;
+
+use crate::audio::{
+    bytes_to_hex, parse_detect_output, run_audiowmark_add_bytes, run_audiowmark_get_bytes,
+    with_route_thread_pool, Audio, DetectResult, EmbedVerification,
+};
+use crate::buffer_pool;
+use crate::cancel::CancellationToken;
+use crate::error::{Error, Result};
+use crate::message::MESSAGE_LEN;
+use crate::multichannel::AudioBuffer;
+
+/// audiowmark 内部处理采样率.
+const WATERMARK_RATE: u64 = 44_100;
+/// audiowmark 水印帧长（内部采样率下的样本数）.
+const WATERMARK_FRAME_SIZE: u64 = 1024;
+/// 接缝每一侧的重叠帧数（交叉淡化总长为其两倍）.
+const OVERLAP_FRAMES: u64 = 16;
+/// audiowmark 单个水印块的帧数：同步 6 比特 × 85 帧 + 卷积码 858 比特 × 每比特 2 帧.
+const WATERMARK_BLOCK_FRAMES: u64 = 6 * 85 + 858 * 2;
+/// 接缝校验窗口在跨接缝水印块两侧各留的帧数（供同步搜索）.
+const VERIFY_MARGIN_FRAMES: u64 = 128;
+/// 允许的最短分段时长（秒）；更短的分段会让接缝损失占比过高.
+pub(crate) const MIN_SEGMENT_SECS: u32 = 120;
+
+/// 对齐到水印帧周期的分段方案.
+#[derive(Debug, PartialEq, Eq)]
+struct SegmentPlan {
+    /// 段边界（含首尾，单位为样本帧）.
+    boundaries: Vec<usize>,
+    /// 接缝每一侧的重叠样本数.
+    overlap: usize,
+}
+
+impl SegmentPlan {
+    /// 按 `segment_secs` 规划 `total` 帧的分段；末段过短时并入前一段.
+    fn new(total: usize, sample_rate: u32, segment_secs: u32) -> Self {
+        let frames_per_segment =
+            (u64::from(segment_secs) * WATERMARK_RATE / WATERMARK_FRAME_SIZE).max(1);
+        let to_samples = |frames: u64| frames_to_samples(frames, sample_rate);
+        let segment_len = to_samples(frames_per_segment);
+        let mut boundaries = vec![0];
+        let mut index = 1_u64;
+        loop {
+            let boundary = to_samples(frames_per_segment * index);
+            if boundary == 0 || boundary.saturating_add(segment_len / 2) >= total {
+                break;
+            }
+            boundaries.push(boundary);
+            index += 1;
+        }
+        boundaries.push(total);
+        let overlap = to_samples(OVERLAP_FRAMES).min(segment_len / 4);
+        Self {
+            boundaries,
+            overlap,
+        }
+    }
+
+    /// 分段数.
+    const fn len(&self) -> usize {
+        self.boundaries.len() - 1
+    }
+
+    /// 第 `index` 段送入 audiowmark 的样本范围（含两侧重叠）.
+    fn embed_range(&self, index: usize) -> (usize, usize) {
+        let total = self.boundaries[self.len()];
+        let start = if index == 0 {
+            0
+        } else {
+            self.boundaries[index] - self.overlap
+        };
+        let end = if index + 1 == self.len() {
+            total
+        } else {
+            (self.boundaries[index + 1] + self.overlap).min(total)
+        };
+        (start, end)
+    }
+}
+
+/// 把内部采样率下的水印帧数换算为 `sample_rate` 下的样本帧数（四舍五入）.
+fn frames_to_samples(frames: u64, sample_rate: u32) -> usize {
+    let scaled = frames * WATERMARK_FRAME_SIZE * u64::from(sample_rate);
+    usize::try_from((scaled + WATERMARK_RATE / 2) / WATERMARK_RATE).unwrap_or(usize::MAX)
+}
+
+/// 分段并行嵌入 `audio` 并写出 `output`；`verify` 时逐个接缝检测.
+///
+/// # Errors
+/// 当任一分段嵌入失败、输出长度不符、写出失败或操作被取消时返回错误。.
+pub fn embed_segmented(
+    audio_engine: &Audio,
+    audio: &AudioBuffer,
+    output: &std::path::Path,
+    message: &[u8; MESSAGE_LEN],
+    segment_secs: u32,
+    verify: bool,
+) -> Result<Option<EmbedVerification>> {
+    let plan = SegmentPlan::new(audio.num_samples(), audio.sample_rate(), segment_secs);
+    let hex = bytes_to_hex(message);
+    let total_units = u64::try_from(plan.len()).unwrap_or(u64::MAX);
+    audio_engine.progress_update_current_units(0, Some(total_units));
+    let parallelism = std::thread::available_parallelism()
+        .map_or(1, std::num::NonZero::get)
+        .min(plan.len());
+    let done = AtomicU64::new(0);
+    let segments: Vec<Result<AudioBuffer>> = with_route_thread_pool(parallelism, || {
+        (0..plan.len())
+            .into_par_iter()
+            .map(|index| {
+                let segment = embed_segment(audio_engine, audio, plan.embed_range(index), &hex);
+                let completed = done.fetch_add(1, Ordering::Relaxed) + 1;
+                audio_engine.progress_update_current_units(completed, Some(total_units));
+                segment
+            })
+            .collect()
+    })?;
+    let mut embedded = Vec::with_capacity(segments.len());
+    let mut first_error = None;
+    for segment in segments {
+        match segment {
+            Ok(buffer) => embedded.push(buffer),
+            Err(err) => {
+                first_error.get_or_insert(err);
+            }
+        }
+    }
+    if let Some(err) = first_error {
+        embedded.into_iter().for_each(AudioBuffer::recycle);
+        return Err(err);
+    }
+
+    let stitched = stitch(audio, &plan, &embedded);
+    embedded.into_iter().for_each(AudioBuffer::recycle);
+    let stitched = stitched?;
+
+    let verification = if verify {
+        let (written, verification) = std::thread::scope(|scope| {
+            let verifier = scope.spawn(|| verify_seams(audio_engine, &stitched, &plan, message));
+            (stitched.to_wav(output), verifier.join())
+        });
+        written?;
+        Some(
+            verification
+                .map_err(|_| Error::AudiowmarkExec("verify thread panicked".to_string()))??,
+        )
+    } else {
+        stitched.to_wav(output)?;
+        None
+    };
+    stitched.recycle();
+    Ok(verification)
+}
+
+/// Internal helper function.
+fn embed_segment(
+    audio_engine: &Audio,
+    audio: &AudioBuffer,
+    (start, end): (usize, usize),
+    message_hex: &str,
+) -> Result<AudioBuffer> {
+    audio_engine.cancellation().check()?;
+    let segment = slice_buffer(audio, start, end)?;
+    let input_bytes = segment.to_wav_bytes();
+    segment.recycle();
+    let output_bytes = run_audiowmark_add_bytes(audio_engine, input_bytes?, message_hex)?;
+    let processed = AudioBuffer::from_wav_bytes(&output_bytes);
+    buffer_pool::give_bytes(output_bytes);
+    let processed = processed?;
+    if processed.num_channels() != audio.num_channels() || processed.num_samples() != end - start {
+        let detail = format!(
+            "segment output mismatch: expected {}ch x {}, got {}ch x {}",
+            audio.num_channels(),
+            end - start,
+            processed.num_channels(),
+            processed.num_samples()
+        );
+        processed.recycle();
+        return Err(Error::AudiowmarkExec(detail));
+    }
+    Ok(processed)
+}
+
+/// 复制 `audio` 的 `[start, end)` 帧为新缓冲.
+fn slice_buffer(audio: &AudioBuffer, start: usize, end: usize) -> Result<AudioBuffer> {
+    let channels = (0..audio.num_channels())
+        .map(|channel| {
+            audio
+                .channel_samples(channel)
+                .map(|samples| buffer_pool::copy_samples(&samples[start..end]))
+        })
+        .collect::<Result<Vec<_>>>()?;
+    AudioBuffer::new(channels, audio.sample_rate(), audio.sample_format())
+}
+
+/// 按分段方案拼接嵌入结果：段内直接复制，接缝处线性交叉淡化.
+fn stitch(
+    audio: &AudioBuffer,
+    plan: &SegmentPlan,
+    segments: &[AudioBuffer],
+) -> Result<AudioBuffer> {
+    let total = audio.num_samples();
+    let mut channels = Vec::with_capacity(audio.num_channels());
+    for channel in 0..audio.num_channels() {
+        let mut out = buffer_pool::take_samples(total);
+        for (index, segment) in segments.iter().enumerate() {
+            let samples = segment.channel_samples(channel)?;
+            let (offset, _) = plan.embed_range(index);
+            let core_end = if index + 1 == segments.len() {
+                total
+            } else {
+                plan.boundaries[index + 1] - plan.overlap
+            };
+            let mut cursor = offset;
+            if index > 0 {
+                let previous = segments[index - 1].channel_samples(channel)?;
+                let (previous_offset, _) = plan.embed_range(index - 1);
+                let fade_end = plan.boundaries[index] + plan.overlap;
+                crossfade(
+                    &mut out,
+                    &previous[cursor - previous_offset..fade_end - previous_offset],
+                    &samples[..fade_end - offset],
+                );
+                cursor = fade_end;
+            }
+            out.extend_from_slice(&samples[cursor - offset..core_end - offset]);
+        }
+        channels.push(out);
+    }
+    AudioBuffer::new(channels, audio.sample_rate(), audio.sample_format())
+}
+
+/// 从 `from` 线性过渡到 `to`（等长），结果追加到 `out`.
+fn crossfade(out: &mut Vec<i32>, from: &[i32], to: &[i32]) {
+    let span = i64::try_from(from.len())
+        .unwrap_or(i64::MAX)
+        .saturating_mul(2);
+    for (position, (&a, &b)) in from.iter().zip(to).enumerate() {
+        // 在样本中点取权重，首尾两端都不会整段偏向一侧。
+        let weight = i64::try_from(position).unwrap_or(0) * 2 + 1;
+        let mixed = (i64::from(a) * (span - weight) + i64::from(b) * weight) / span;
+        out.push(i32::try_from(mixed).unwrap_or(a));
+    }
+}
+
+/// 逐个接缝检测；单段输入检测整段输出.
+fn verify_seams(
+    audio_engine: &Audio,
+    stitched: &AudioBuffer,
+    plan: &SegmentPlan,
+    message: &[u8; MESSAGE_LEN],
+) -> Result<EmbedVerification> {
+    let windows = seam_windows(plan, stitched.sample_rate());
+    verify_windows(audio_engine.cancellation(), &windows, message, |range| {
+        let window = slice_buffer(stitched, range.start, range.end)?;
+        let wav_bytes = window.to_wav_bytes();
+        window.recycle();
+        let output = run_audiowmark_get_bytes(audio_engine, wav_bytes?)?;
+        let stdout = String::from_utf8_lossy(&output.stdout);
+        let stderr = String::from_utf8_lossy(&output.stderr);
+        Ok(parse_detect_output(&stdout, &stderr))
+    })
+}
+
+/// 各接缝的校验窗口 `(名称, 样本范围)`.
+///
+/// 后一段的水印从其嵌入起点（接缝前 `overlap` 处）重新开始，第一个水印块覆盖整个交叉淡化
+/// 区。窗口只比这个块多出两侧的同步余量，不足两个块长，因此容纳不下接缝两侧任何其他完整
+/// 的块：检出即说明跨接缝的块完好。.
+fn seam_windows(plan: &SegmentPlan, sample_rate: u32) -> Vec<(String, Range<usize>)> {
+    let total = plan.boundaries[plan.len()];
+    if plan.len() == 1 {
+        return vec![("stereo".to_string(), 0..total)];
+    }
+    let block = frames_to_samples(WATERMARK_BLOCK_FRAMES, sample_rate);
+    let margin = frames_to_samples(VERIFY_MARGIN_FRAMES, sample_rate);
+    (1..plan.len())
+        .map(|index| {
+            let (block_start, _) = plan.embed_range(index);
+            let end = block_start
+                .saturating_add(block)
+                .saturating_add(margin)
+                .min(total);
+            (
+                format!("seam {index}"),
+                block_start.saturating_sub(margin)..end,
+            )
+        })
+        .collect()
+}
+
+/// 依次检测 `windows`，返回第一个未通过的结果或最后一个结果.
+fn verify_windows<F>(
+    cancel: &CancellationToken,
+    windows: &[(String, Range<usize>)],
+    message: &[u8; MESSAGE_LEN],
+    mut detect: F,
+) -> Result<EmbedVerification>
+where
+    F: FnMut(Range<usize>) -> Result<Option<DetectResult>>,
+{
+    let mut last = None;
+    for (name, range) in windows {
+        cancel.check()?;
+        let verification = EmbedVerification::new(name, detect(range.clone())?, message);
+        if !verification.passed {
+            return Ok(verification);
+        }
+        last = Some(verification);
+    }
+    last.ok_or_else(|| Error::InvalidInput("no segments to verify".to_string()))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::multichannel::SampleFormat;
+
+    #[test]
+    fn plan_aligns_boundaries_to_watermark_frames() {
+        let plan = SegmentPlan::new(44_100 * 1000, 44_100, 300);
+        let frames_per_segment = 300 * 44_100 / 1024;
+        assert_eq!(plan.boundaries.first(), Some(&0));
+        assert_eq!(plan.boundaries.last(), Some(&(44_100 * 1000)));
+        for boundary in &plan.boundaries[1..plan.len()] {
+            assert_eq!(boundary % (1024 * frames_per_segment), 0);
+        }
+        // 末段不足半段时并入前一段
+        assert_eq!(plan.len(), 3);
+        assert_eq!(plan.overlap, 16 * 1024);
+
+        let short = SegmentPlan::new(44_100 * 30, 48_000, 300);
+        assert_eq!(short.boundaries, vec![0, 44_100 * 30]);
+    }
+
+    #[test]
+    fn stitch_reassembles_identical_segments_exactly() {
+        let total = 50_000;
+        let samples: Vec<i32> = (0..total).map(|value| value - 25_000).collect();
+        let audio = AudioBuffer::new(vec![samples.clone()], 1024, SampleFormat::Int16);
+        assert!(audio.is_ok());
+        let Ok(audio) = audio else {
+            return;
+        };
+        let plan = SegmentPlan {
+            boundaries: vec![0, 20_000, 40_000, 50_000],
+            overlap: 1_000,
+        };
+        let segments: Vec<AudioBuffer> = (0..plan.len())
+            .filter_map(|index| {
+                let (start, end) = plan.embed_range(index);
+                slice_buffer(&audio, start, end).ok()
+            })
+            .collect();
+        assert_eq!(segments.len(), 3);
+
+        let stitched = stitch(&audio, &plan, &segments);
+        assert!(stitched.is_ok());
+        let Ok(stitched) = stitched else {
+            return;
+        };
+        assert_eq!(stitched.channel_samples(0).ok(), Some(samples.as_slice()));
+    }
+
+    #[test]
+    fn crossfade_moves_from_first_to_second_input() {
+        let mut out = Vec::new();
+        crossfade(&mut out, &[1000; 4], &[0; 4]);
+        assert_eq!(out, vec![875, 625, 375, 125]);
+    }
+
+    #[test]
+    fn corrupted_seam_fails_verification() {
+        let sample_rate = 441;
+        let plan = SegmentPlan::new(441 * 400, sample_rate, 120);
+        assert_eq!(plan.len(), 3);
+        let block = frames_to_samples(WATERMARK_BLOCK_FRAMES, sample_rate);
+        // 模拟 audiowmark：每段从嵌入起点起按块重复，段内容在拼接输出中止于下一接缝的
+        // 交叉淡化末端；窗口内有完整且未损坏的块即检出。
+        let blocks: Vec<Range<usize>> = (0..plan.len())
+            .flat_map(|index| {
+                let (start, end) = plan.embed_range(index);
+                (start..end)
+                    .step_by(block)
+                    .map(move |first| first..first + block)
+                    .filter(move |candidate| candidate.end <= end)
+            })
+            .collect();
+        let message = [7_u8; MESSAGE_LEN];
+        let detect = |corrupt: Range<usize>| {
+            let blocks = &blocks;
+            move |range: Range<usize>| -> Result<Option<DetectResult>> {
+                let found = blocks.iter().any(|candidate| {
+                    candidate.start >= range.start
+                        && candidate.end <= range.end
+                        && (corrupt.end <= candidate.start || corrupt.start >= candidate.end)
+                });
+                Ok(found.then(|| DetectResult {
+                    raw_message: message,
+                    pattern: "all".to_string(),
+                    detect_score: None,
+                    bit_errors: 0,
+                    match_found: true,
+                }))
+            }
+        };
+        let windows = seam_windows(&plan, sample_rate);
+        assert!(windows.iter().all(|(_, range)| range.len() < 2 * block));
+        let cancel = CancellationToken::new();
+
+        let intact = verify_windows(&cancel, &windows, &message, detect(0..0));
+        assert!(intact.is_ok_and(|verification| verification.passed));
+
+        let seam = plan.boundaries[2];
+        let broken = verify_windows(&cancel, &windows, &message, detect(seam - 5..seam + 5));
+        assert!(broken
+            .is_ok_and(|verification| { !verification.passed && verification.step == "seam 2" }));
+    }
+}
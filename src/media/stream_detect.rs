@@ -0,0 +1,401 @@
+//! 压缩多声道输入（E-AC-3/AAC 等）的流式检测.
+//!
+//! 解码帧按路由步骤反交错后经有界通道交给各步骤的写线程，直接写入并行运行的
+//! audiowmark `get -` 子进程；读线程逐行收集 stdout，一旦某个步骤报告零比特错误的
+//! pattern，其余步骤随即停止（与逐步检测的提前退出语义一致）。全程不分配整段 PCM。.
+
+use std::io::{BufReader, BufWriter, Read, Write};
+use std::path::Path;
+use std::process::{Child, ChildStdin, ExitStatus, Stdio};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::mpsc::{self, Receiver, SyncSender};
+
+use crate::audio::{
+    finalize_detect_step_results, is_pipe_compatibility_error, log_route_warnings,
+    parse_detect_output, validate_layout_channels, Audio, DetectStepTaskResult,
+    MultichannelDetectResult, PIPE_BUF_SIZE,
+};
+use crate::buffer_pool;
+use crate::error::{Error, Result};
+use crate::media::multi_key_detect::collect_stdout;
+use crate::media::MediaStream;
+use crate::multichannel::{
+    build_smart_route_plan, effective_lfe_mode, push_wav_header, ChannelLayout, RouteMode,
+    RouteStep, SampleFormat,
+};
+
+/// 主线程到每个写线程的在途块数上限（背压）.
+const WRITER_QUEUE: usize = 2;
+/// 解码输出的样本字节宽度（packed i16）.
+const SAMPLE_BYTES: usize = 2;
+
+/// 流式检测 `input`；无法以 `FFmpeg` 打开或 audiowmark 不支持管道输入时返回 `Ok(None)`.
+///
+/// # Errors
+/// 当布局与声道数不匹配、解码失败、audiowmark 启动失败或操作被取消时返回错误。.
+pub fn detect_media_streaming(
+    audio_engine: &Audio,
+    input: &Path,
+    layout: Option<ChannelLayout>,
+) -> Result<Option<MultichannelDetectResult>> {
+    let Ok(stream) = MediaStream::open(input) else {
+        return Ok(None);
+    };
+    let num_channels = usize::from(stream.channels());
+    let steps: Vec<(usize, RouteStep, Vec<usize>)> = if num_channels <= 2 {
+        // 单声道或立体声：audiowmark 原生支持，整路送入一个步骤
+        vec![(
+            0,
+            RouteStep {
+                name: "FL+FR".to_string(),
+                mode: if num_channels == 2 {
+                    RouteMode::Pair(0, 1)
+                } else {
+                    RouteMode::Mono(0)
+                },
+            },
+            (0..num_channels).collect(),
+        )]
+    } else {
+        let layout = layout.unwrap_or_else(|| ChannelLayout::from_channels(stream.channels()));
+        validate_layout_channels(layout, num_channels)?;
+        let route_plan = build_smart_route_plan(layout, num_channels, effective_lfe_mode());
+        log_route_warnings("detect-stream", input, &route_plan.warnings);
+        route_plan
+            .detectable_steps()
+            .into_iter()
+            .filter_map(|(idx, step)| {
+                let channels = match step.mode {
+                    RouteMode::Pair(left, right) => vec![left, right],
+                    RouteMode::Mono(channel) => vec![channel],
+                    RouteMode::Skip { .. } => return None,
+                };
+                Some((idx, step.clone(), channels))
+            })
+            .collect()
+    };
+
+    let mut children: Vec<Child> = Vec::with_capacity(steps.len());
+    let mut pipes = Vec::with_capacity(steps.len());
+    for _ in &steps {
+        match spawn_step(audio_engine) {
+            Ok((child, step_pipes)) => {
+                children.push(child);
+                pipes.push(step_pipes);
+            }
+            Err(err) => {
+                kill_all(&mut children);
+                return Err(err);
+            }
+        }
+    }
+
+    let perfect: Vec<AtomicBool> = steps.iter().map(|_| AtomicBool::new(false)).collect();
+    let step_channels: Vec<&[usize]> = steps.iter().map(|(_, _, ch)| ch.as_slice()).collect();
+    let (decode_result, outputs) = std::thread::scope(|scope| {
+        let mut txs = Vec::with_capacity(steps.len());
+        let mut writers = Vec::with_capacity(steps.len());
+        let mut readers = Vec::with_capacity(steps.len());
+        let mut stderr_readers = Vec::with_capacity(steps.len());
+        for (step_pipes, flag) in pipes.into_iter().zip(&perfect) {
+            let (tx, rx) = mpsc::sync_channel::<Vec<u8>>(WRITER_QUEUE);
+            txs.push(Some(tx));
+            let (stdin, stdout, stderr) = step_pipes;
+            writers.push(scope.spawn(move || feed_step(stdin, &rx)));
+            readers.push(scope.spawn(move || collect_stdout(BufReader::new(stdout), flag)));
+            stderr_readers.push(scope.spawn(move || {
+                let mut stderr = stderr;
+                let mut buf = String::new();
+                let _ = stderr.read_to_string(&mut buf);
+                buf
+            }));
+        }
+
+        let sample_rate = stream.sample_rate();
+        let decode_result = send_headers(&mut txs, &step_channels, sample_rate).and_then(|()| {
+            let mut frames_done = 0_u64;
+            stream.decode(audio_engine.cancellation(), |bytes| {
+                let frames = dispatch_frames(bytes, num_channels, &step_channels, &mut txs);
+                // 任一步骤已完美命中：停止全部步骤
+                if perfect.iter().any(|flag| flag.load(Ordering::Relaxed)) {
+                    txs.iter_mut().for_each(|tx| *tx = None);
+                }
+                // 所有步骤都已停止或退出：无需继续解码
+                if txs.iter().all(Option::is_none) {
+                    return Err(std::io::Error::other(StepsFinished).into());
+                }
+                frames_done = frames_done.saturating_add(u64::try_from(frames).unwrap_or(0));
+                audio_engine.progress_update_current_units(frames_done, None);
+                Ok(())
+            })
+        });
+        drop(txs);
+        let stopped_early = decode_result.as_ref().is_err_and(is_steps_finished);
+        let perfect_hit = perfect.iter().any(|flag| flag.load(Ordering::Relaxed));
+        if perfect_hit || (decode_result.is_err() && !stopped_early) {
+            kill_all(&mut children);
+        }
+        for writer in writers {
+            // 子进程被停止或提前退出时写入失败是预期的，结果以 stdout/stderr 为准。
+            let _ = writer.join();
+        }
+        let outputs: Vec<(String, String)> = readers
+            .into_iter()
+            .zip(stderr_readers)
+            .map(|(stdout, stderr)| {
+                (
+                    stdout.join().unwrap_or_default(),
+                    stderr.join().unwrap_or_default(),
+                )
+            })
+            .collect();
+        (decode_result, outputs)
+    });
+
+    let mut statuses = Vec::with_capacity(children.len());
+    for child in &mut children {
+        statuses.push(child.wait());
+    }
+    let perfect_hit = perfect.iter().any(|flag| flag.load(Ordering::Relaxed));
+    match decode_result {
+        Ok(0) => {
+            return Err(Error::FfmpegDecodeFailed(
+                "no decodable audio samples found".to_string(),
+            ));
+        }
+        Ok(_) => {}
+        Err(err) if is_steps_finished(&err) => {}
+        // 包括用户取消：原样传播。
+        Err(err) => return Err(err),
+    }
+
+    // 未命中且没有任何步骤正常结束时以第一个失败步骤的错误为准，而不是返回空结果。
+    let any_completed = statuses
+        .iter()
+        .any(|status| status.as_ref().is_ok_and(ExitStatus::success));
+    let first_failure = statuses
+        .iter()
+        .zip(&outputs)
+        .find_map(|(status, (_, stderr))| step_failure(status, stderr));
+
+    let mut step_results = Vec::with_capacity(steps.len());
+    for (((step_idx, step, _), (stdout, stderr)), (status, flag)) in steps
+        .into_iter()
+        .zip(outputs)
+        .zip(statuses.into_iter().zip(&perfect))
+    {
+        let completed = status.is_ok_and(|status| status.success());
+        if !perfect_hit && !completed && is_pipe_compatibility_error(&stderr) {
+            return Ok(None);
+        }
+        // 提前停止时，未命中的步骤没有完整结果，与逐步检测一样不计入
+        if perfect_hit && !flag.load(Ordering::Relaxed) {
+            continue;
+        }
+        step_results.push(DetectStepTaskResult {
+            step_idx,
+            step,
+            outcome: parse_detect_output(&stdout, &stderr),
+        });
+    }
+    if !perfect_hit && !any_completed {
+        if let Some(err) = first_failure {
+            return Err(err);
+        }
+    }
+    Ok(Some(finalize_detect_step_results(step_results)))
+}
+
+/// 解码回调的内部停止信号：所有步骤都已结束，无需继续解码（不是用户取消）.
+#[derive(Debug)]
+struct StepsFinished;
+
+impl std::fmt::Display for StepsFinished {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.write_str("all route steps finished")
+    }
+}
+
+impl std::error::Error for StepsFinished {}
+
+/// `err` 是否为 [`StepsFinished`] 停止信号.
+fn is_steps_finished(err: &Error) -> bool {
+    matches!(err, Error::Io(io) if io.get_ref().is_some_and(|inner| inner.is::<StepsFinished>()))
+}
+
+/// 把异常退出的步骤转换为错误；正常结束时返回 `None`.
+fn step_failure(status: &std::io::Result<ExitStatus>, stderr: &str) -> Option<Error> {
+    match status {
+        Ok(status) if status.success() => None,
+        Ok(status) if stderr.trim().is_empty() => Some(Error::AudiowmarkExec(format!(
+            "audiowmark exited with {status}"
+        ))),
+        Ok(_) => Some(Error::AudiowmarkExec(stderr.trim().to_string())),
+        Err(err) => Some(Error::AudiowmarkExec(err.to_string())),
+    }
+}
+
+/// Internal type alias.
+type StepPipes = (
+    ChildStdin,
+    std::process::ChildStdout,
+    std::process::ChildStderr,
+);
+
+/// Internal helper function.
+fn spawn_step(audio_engine: &Audio) -> Result<(Child, StepPipes)> {
+    let mut child = audio_engine
+        .get_wav_pipe_command()
+        .stdin(Stdio::piped())
+        .stdout(Stdio::piped())
+        .stderr(Stdio::piped())
+        .spawn()
+        .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+    let handles = (child.stdin.take(), child.stdout.take(), child.stderr.take());
+    let (Some(stdin), Some(stdout), Some(stderr)) = handles else {
+        let _ = child.kill();
+        let _ = child.wait();
+        return Err(Error::AudiowmarkExec(
+            "failed to take audiowmark pipe handles".to_string(),
+        ));
+    };
+    Ok((child, (stdin, stdout, stderr)))
+}
+
+/// Internal helper function.
+fn kill_all(children: &mut [Child]) {
+    for child in children {
+        let _ = child.kill();
+    }
+}
+
+/// 向各步骤发送 16 位 wav-pipe 头（长度字段未知）.
+fn send_headers(
+    txs: &mut [Option<SyncSender<Vec<u8>>>],
+    step_channels: &[&[usize]],
+    sample_rate: u32,
+) -> Result<()> {
+    for (tx, channels) in txs.iter_mut().zip(step_channels) {
+        let mut header = Vec::with_capacity(44);
+        push_wav_header(
+            &mut header,
+            channels.len(),
+            sample_rate,
+            SampleFormat::Int16,
+            0,
+        )?;
+        header[4..8].copy_from_slice(&u32::MAX.to_le_bytes());
+        header[40..44].copy_from_slice(&u32::MAX.to_le_bytes());
+        if tx
+            .as_ref()
+            .is_some_and(|sender| sender.send(header).is_err())
+        {
+            *tx = None;
+        }
+    }
+    Ok(())
+}
+
+/// 把一段交错 packed i16 帧按步骤声道拆分发送；写线程已退出的步骤被移除。返回帧数.
+fn dispatch_frames(
+    bytes: &[u8],
+    num_channels: usize,
+    step_channels: &[&[usize]],
+    txs: &mut [Option<SyncSender<Vec<u8>>>],
+) -> usize {
+    let frame_bytes = num_channels * SAMPLE_BYTES;
+    let frames = bytes.len() / frame_bytes;
+    for (tx, channels) in txs.iter_mut().zip(step_channels) {
+        let Some(sender) = tx.as_ref() else {
+            continue;
+        };
+        let mut chunk = buffer_pool::take_bytes(frames * channels.len() * SAMPLE_BYTES);
+        for frame in bytes.chunks_exact(frame_bytes) {
+            for &channel in *channels {
+                let offset = channel * SAMPLE_BYTES;
+                let sample = i16::from_ne_bytes([frame[offset], frame[offset + 1]]);
+                chunk.extend_from_slice(&sample.to_le_bytes());
+            }
+        }
+        if sender.send(chunk).is_err() {
+            *tx = None;
+        }
+    }
+    frames
+}
+
+/// 写线程：把分发来的字节块写入子进程 stdin，结束时关闭 stdin.
+fn feed_step(stdin: ChildStdin, rx: &Receiver<Vec<u8>>) -> std::io::Result<()> {
+    let mut stdin = BufWriter::with_capacity(PIPE_BUF_SIZE, stdin);
+    for chunk in rx {
+        let written = stdin.write_all(&chunk);
+        buffer_pool::give_bytes(chunk);
+        written?;
+    }
+    stdin.flush()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn dispatch_splits_interleaved_frames_per_step() {
+        let samples: [i16; 6] = [1, 2, 3, -1, -2, -3];
+        let bytes: Vec<u8> = samples.iter().flat_map(|s| s.to_ne_bytes()).collect();
+        let (pair_tx, pair_rx) = mpsc::sync_channel(WRITER_QUEUE);
+        let (mono_tx, mono_rx) = mpsc::sync_channel(WRITER_QUEUE);
+        let mut txs = vec![Some(pair_tx), Some(mono_tx)];
+        let step_channels: [&[usize]; 2] = [&[0, 1], &[2]];
+
+        assert_eq!(dispatch_frames(&bytes, 3, &step_channels, &mut txs), 2);
+        let pair: Vec<u8> = [1_i16, 2, -1, -2]
+            .iter()
+            .flat_map(|s| s.to_le_bytes())
+            .collect();
+        let mono: Vec<u8> = [3_i16, -3].iter().flat_map(|s| s.to_le_bytes()).collect();
+        assert_eq!(pair_rx.try_recv().ok(), Some(pair));
+        assert_eq!(mono_rx.try_recv().ok(), Some(mono));
+
+        // 写线程退出后该步骤被移除
+        drop(mono_rx);
+        let _ = dispatch_frames(&bytes, 3, &step_channels, &mut txs);
+        assert!(txs[0].is_some());
+        assert!(txs[1].is_none());
+    }
+
+    #[test]
+    fn perfect_pattern_line_sets_flag() {
+        let perfect = AtomicBool::new(false);
+        let stdout = "pattern  all 0101c1d05978131b57f7deb8e22a0b78 3\n";
+        let collected = collect_stdout(stdout.as_bytes(), &perfect);
+        assert_eq!(collected, stdout);
+        assert!(!perfect.load(Ordering::Relaxed));
+
+        let stdout = "pattern  all 0101c1d05978131b57f7deb8e22a0b78 0\n";
+        let _ = collect_stdout(stdout.as_bytes(), &perfect);
+        assert!(perfect.load(Ordering::Relaxed));
+    }
+
+    #[test]
+    fn stop_signal_is_distinct_from_cancellation() {
+        let stop: Error = std::io::Error::other(StepsFinished).into();
+        assert!(is_steps_finished(&stop));
+        assert!(!is_steps_finished(&Error::Cancelled));
+        assert!(!is_steps_finished(&Error::from(std::io::Error::other(
+            "pipe closed"
+        ))));
+    }
+
+    #[cfg(unix)]
+    #[test]
+    fn failed_step_reports_its_stderr() {
+        use std::os::unix::process::ExitStatusExt;
+
+        assert!(step_failure(&Ok(ExitStatus::from_raw(0)), "").is_none());
+        let failed = step_failure(&Ok(ExitStatus::from_raw(1 << 8)), "bad key\n");
+        assert!(matches!(failed, Some(Error::AudiowmarkExec(message)) if message == "bad key"));
+        let silent = step_failure(&Ok(ExitStatus::from_raw(1 << 8)), "");
+        assert!(matches!(silent, Some(Error::AudiowmarkExec(_))));
+    }
+}
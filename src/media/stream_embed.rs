@@ -0,0 +1,802 @@
+//! 有界内存的流式多声道嵌入.
+//!
+//! 主线程按块从内存映射的 WAV/RF64 中解出样本并按路由步骤分组，经有界通道交给各步骤的写线程写入 audiowmark
+//! stdin；读线程增量解析各子进程的 wav-pipe stdout 并转交合并线程；合并线程在所有步骤都
+//! 产出同一段样本后立即重交错写出。原始块与各步骤输出块都经有界通道交给合并线程：合并落后
+//! 时读线程与主线程被背压挡住，在途块数不超过 `inflight_blocks`。该上限覆盖 audiowmark
+//! 的处理延迟，因此背压不会让等待输出的合并线程与等待输入的子进程互相阻塞。
+//!
+//! 输出头部预留 `JUNK` chunk，数据超过 RIFF 32 位大小上限时收尾原地改写为 RF64。.
+
+use std::fs::{self, File};
+use std::io::{BufReader, BufWriter, Read, Seek, SeekFrom, Write};
+use std::ops::Range;
+use std::path::Path;
+use std::process::{Child, ChildStdin, ChildStdout, Stdio};
+use std::sync::mpsc::{self, Receiver, SyncSender};
+
+use crate::audio::{
+    bytes_to_hex, log_route_warnings, validate_layout_channels, Audio, PIPE_BUF_SIZE,
+};
+use crate::buffer_pool;
+use crate::error::{Error, Result};
+use crate::media::wav_map::{decode_sample, InterleavedView, MappedWav};
+use crate::message::MESSAGE_LEN;
+use crate::multichannel::{
+    build_smart_route_plan, effective_lfe_mode, push_wav_header, push_wav_sample, ChannelLayout,
+    RouteMode, SampleFormat,
+};
+
+/// 每块帧数.
+const BLOCK_FRAMES: usize = 16 * 1024;
+/// 主线程到每个写线程的在途块数上限（背压）.
+const WRITER_QUEUE: usize = 2;
+/// 合并线程在途块需覆盖的 audiowmark 处理延迟（秒，含余量）.
+const LATENCY_BUDGET_SECS: usize = 2;
+/// 在途块数在延迟覆盖之外的余量：步骤输出块与原始块不对齐，各差一块.
+const INFLIGHT_SLACK: usize = 2;
+/// 子进程 fmt chunk 的合理大小上限.
+const MAX_FMT_CHUNK: usize = 1024;
+/// 输出头中为 `ds64` 预留的 `JUNK` 负载长度.
+const DS64_LEN: usize = 28;
+/// 输出头长度：RIFF(12) + JUNK(8+28) + fmt(8+16) + data 头(8).
+const OUTPUT_HEADER_LEN: usize = 80;
+
+/// 按声道拆开的样本块 `[channel][frame]`.
+type Block = Vec<Vec<i32>>;
+
+/// 流式嵌入 `input`；输入不是可直接映射读取的 PCM/float WAV/RF64 时返回 `Ok(false)`.
+///
+/// 单声道/立体声输入直接交给 audiowmark（其本身按流处理文件）。.
+///
+/// # Errors
+/// 当布局与声道数不匹配、audiowmark 启动/执行失败、任一路由步骤输出异常、
+/// 输出写入失败或操作被取消时返回错误；此时删除未完成的输出文件。.
+pub fn embed_wav_streaming(
+    audio_engine: &Audio,
+    input: &Path,
+    output: &Path,
+    message: &[u8; MESSAGE_LEN],
+    layout: Option<ChannelLayout>,
+) -> Result<bool> {
+    let Some(mapped) = MappedWav::open(input) else {
+        return Ok(false);
+    };
+    let num_channels = mapped.layout().channels;
+    if num_channels <= 2 {
+        drop(mapped);
+        audio_engine.embed(input, output, message)?;
+        return Ok(true);
+    }
+    let Some(view) = mapped.view() else {
+        return Ok(false);
+    };
+    let Ok(channel_count) = u16::try_from(num_channels) else {
+        return Ok(false);
+    };
+
+    let layout = layout.unwrap_or_else(|| ChannelLayout::from_channels(channel_count));
+    validate_layout_channels(layout, num_channels)?;
+    let route_plan = build_smart_route_plan(layout, num_channels, effective_lfe_mode());
+    log_route_warnings("embed-stream", input, &route_plan.warnings);
+    let steps: Vec<Vec<usize>> = route_plan
+        .steps
+        .iter()
+        .filter_map(|step| match step.mode {
+            RouteMode::Pair(left, right) => Some(vec![left, right]),
+            RouteMode::Mono(channel) => Some(vec![channel]),
+            RouteMode::Skip { .. } => None,
+        })
+        .collect();
+
+    let stream = StreamSpec {
+        num_channels,
+        sample_rate: mapped.layout().sample_rate,
+        sample_format: mapped.layout().sample_format,
+        total_frames: u64::try_from(view.layout().frames()).unwrap_or(u64::MAX),
+    };
+    let result = run_pipeline(audio_engine, &view, output, message, &steps, &stream);
+    if result.is_err() {
+        let _ = fs::remove_file(output);
+    }
+    result.map(|()| true)
+}
+
+/// Internal struct.
+struct StreamSpec {
+    /// Internal field.
+    num_channels: usize,
+    /// Internal field.
+    sample_rate: u32,
+    /// Internal field.
+    sample_format: SampleFormat,
+    /// Internal field.
+    total_frames: u64,
+}
+
+/// Internal struct.
+struct StepPipes {
+    /// Internal field.
+    stdin: ChildStdin,
+    /// Internal field.
+    stdout: ChildStdout,
+    /// Internal field.
+    stderr: std::process::ChildStderr,
+}
+
+/// Internal helper function.
+fn run_pipeline(
+    audio_engine: &Audio,
+    view: &InterleavedView<'_>,
+    output: &Path,
+    message: &[u8; MESSAGE_LEN],
+    steps: &[Vec<usize>],
+    stream: &StreamSpec,
+) -> Result<()> {
+    let writer = StreamWavWriter::create(output, stream)?;
+
+    let hex = bytes_to_hex(message);
+    let mut children: Vec<Child> = Vec::with_capacity(steps.len());
+    let mut pipes: Vec<StepPipes> = Vec::with_capacity(steps.len());
+    for _ in steps {
+        match spawn_step(audio_engine, &hex) {
+            Ok((child, step_pipes)) => {
+                children.push(child);
+                pipes.push(step_pipes);
+            }
+            Err(err) => {
+                kill_all(&mut children);
+                return Err(err);
+            }
+        }
+    }
+
+    let (feed_result, merge_result, thread_results, stderrs) = std::thread::scope(|scope| {
+        let depth = inflight_blocks(stream.sample_rate);
+        let (orig_tx, orig_rx) = mpsc::sync_channel::<Block>(depth);
+        let mut step_txs = Vec::with_capacity(steps.len());
+        let mut cursors = Vec::with_capacity(steps.len());
+        let mut workers = Vec::with_capacity(steps.len() * 2);
+        let mut stderr_readers = Vec::with_capacity(steps.len());
+        for (channels, step_pipes) in steps.iter().zip(pipes) {
+            let (bytes_tx, bytes_rx) = mpsc::sync_channel::<Vec<u8>>(WRITER_QUEUE);
+            let (block_tx, block_rx) = mpsc::sync_channel::<Result<Block>>(depth);
+            step_txs.push(bytes_tx);
+            cursors.push(StepCursor::new(block_rx));
+            let StepPipes {
+                stdin,
+                stdout,
+                stderr,
+            } = step_pipes;
+            let step_channels = channels.len();
+            let target_format = stream.sample_format;
+            workers.push(scope.spawn(move || feed_step(stdin, &bytes_rx)));
+            workers.push(scope.spawn(move || {
+                read_step_output(stdout, step_channels, target_format, &block_tx);
+                Ok(())
+            }));
+            stderr_readers.push(scope.spawn(move || {
+                let mut stderr = stderr;
+                let mut buf = Vec::new();
+                let _ = stderr.read_to_end(&mut buf);
+                buf
+            }));
+        }
+        let merger = scope.spawn(move || merge_blocks(writer, &orig_rx, cursors, steps));
+
+        let feed_result = feed_blocks(audio_engine, view, steps, stream, &step_txs, &orig_tx);
+        drop(step_txs);
+        drop(orig_tx);
+        if feed_result.is_err() {
+            kill_all(&mut children);
+        }
+        let merge_result = merger
+            .join()
+            .unwrap_or_else(|_| Err(Error::AudiowmarkExec("merge thread panicked".to_string())));
+        let thread_results: Vec<std::io::Result<()>> = workers
+            .into_iter()
+            .map(|worker| {
+                worker
+                    .join()
+                    .unwrap_or_else(|_| Err(std::io::Error::other("route stream thread panicked")))
+            })
+            .collect();
+        let stderrs: Vec<Vec<u8>> = stderr_readers
+            .into_iter()
+            .map(|handle| handle.join().unwrap_or_default())
+            .collect();
+        (feed_result, merge_result, thread_results, stderrs)
+    });
+
+    let mut statuses = Vec::with_capacity(children.len());
+    for child in &mut children {
+        statuses.push(child.wait());
+    }
+    // 取消与输入读取错误优先于由此引发的子进程错误；下游提前关闭时以子进程/合并错误为准。
+    let completed = feed_result?;
+    for (status, stderr) in statuses.into_iter().zip(&stderrs) {
+        let status = status.map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+        if !status.success() {
+            return Err(Error::AudiowmarkExec(
+                String::from_utf8_lossy(stderr).to_string(),
+            ));
+        }
+    }
+    merge_result?;
+    for result in thread_results {
+        result.map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+    }
+    if completed {
+        Ok(())
+    } else {
+        Err(Error::AudiowmarkExec(
+            "route stream stopped early".to_string(),
+        ))
+    }
+}
+
+/// Internal helper function.
+fn spawn_step(audio_engine: &Audio, hex: &str) -> Result<(Child, StepPipes)> {
+    let mut child = audio_engine
+        .add_wav_pipe_command(hex)
+        .stdin(Stdio::piped())
+        .stdout(Stdio::piped())
+        .stderr(Stdio::piped())
+        .spawn()
+        .map_err(|e| Error::AudiowmarkExec(e.to_string()))?;
+    let handles = (child.stdin.take(), child.stdout.take(), child.stderr.take());
+    let (Some(stdin), Some(stdout), Some(stderr)) = handles else {
+        let _ = child.kill();
+        let _ = child.wait();
+        return Err(Error::AudiowmarkExec(
+            "failed to take audiowmark pipe handles".to_string(),
+        ));
+    };
+    Ok((
+        child,
+        StepPipes {
+            stdin,
+            stdout,
+            stderr,
+        },
+    ))
+}
+
+/// Internal helper function.
+fn kill_all(children: &mut [Child]) {
+    for child in children {
+        let _ = child.kill();
+    }
+}
+
+/// 主线程：按块读取输入，分发给各步骤写线程与合并线程.
+///
+/// 某个步骤或合并线程提前退出时返回 `Ok(false)`，具体原因由调用方从子进程与合并结果中取得。.
+fn feed_blocks(
+    audio_engine: &Audio,
+    view: &InterleavedView<'_>,
+    steps: &[Vec<usize>],
+    stream: &StreamSpec,
+    step_txs: &[SyncSender<Vec<u8>>],
+    orig_tx: &SyncSender<Block>,
+) -> Result<bool> {
+    for (channels, tx) in steps.iter().zip(step_txs) {
+        let mut header = Vec::with_capacity(44);
+        push_wav_header(
+            &mut header,
+            channels.len(),
+            stream.sample_rate,
+            stream.sample_format,
+            0,
+        )?;
+        // wav-pipe 输入：RIFF/data 长度未知，长输入不受 4 GiB 头字段限制。
+        header[4..8].copy_from_slice(&u32::MAX.to_le_bytes());
+        header[40..44].copy_from_slice(&u32::MAX.to_le_bytes());
+        if tx.send(header).is_err() {
+            return Ok(false);
+        }
+    }
+
+    let width = usize::from(stream.sample_format.bits_per_sample() / 8);
+    let total = view.layout().frames();
+    let mut start = 0_usize;
+    while start < total {
+        audio_engine.cancellation().check()?;
+        let frames = BLOCK_FRAMES.min(total - start);
+        let block = read_block(view, start..start + frames);
+        start += frames;
+        for (channels, tx) in steps.iter().zip(step_txs) {
+            let mut bytes = buffer_pool::take_bytes(frames * channels.len() * width);
+            for frame in 0..frames {
+                for &channel in channels {
+                    push_wav_sample(
+                        &mut bytes,
+                        stream.sample_format,
+                        block[channel][frame],
+                        frame,
+                    )?;
+                }
+            }
+            if tx.send(bytes).is_err() {
+                recycle(block);
+                return Ok(false);
+            }
+        }
+        if orig_tx.send(block).is_err() {
+            return Ok(false);
+        }
+        let frames_done = u64::try_from(start).unwrap_or(u64::MAX);
+        audio_engine.progress_update_current_units(frames_done, Some(stream.total_frames));
+    }
+    Ok(true)
+}
+
+/// 合并通道的容量（块）：覆盖 `sample_rate` 下 [`LATENCY_BUDGET_SECS`] 秒的输入并留余量.
+///
+/// 容量小于子进程的处理延迟时，主线程会在原始块通道上等待合并线程，而合并线程在等待
+/// 尚未收到足够输入的子进程输出，形成死锁。.
+fn inflight_blocks(sample_rate: u32) -> usize {
+    let rate = usize::try_from(sample_rate).unwrap_or(usize::MAX);
+    rate.saturating_mul(LATENCY_BUDGET_SECS)
+        .div_ceil(BLOCK_FRAMES)
+        .saturating_add(INFLIGHT_SLACK)
+}
+
+/// 从映射的输入中解出 `frames` 范围内的全部声道.
+fn read_block(view: &InterleavedView<'_>, frames: Range<usize>) -> Block {
+    (0..view.layout().channels)
+        .map(|channel| {
+            let mut samples = buffer_pool::take_samples(frames.len());
+            view.extend_channel_frames(channel, frames.clone(), &mut samples);
+            samples
+        })
+        .collect()
+}
+
+/// 写线程：把分发来的字节块写入子进程 stdin，结束时关闭 stdin.
+fn feed_step(stdin: ChildStdin, rx: &Receiver<Vec<u8>>) -> std::io::Result<()> {
+    let mut stdin = BufWriter::with_capacity(PIPE_BUF_SIZE, stdin);
+    for chunk in rx {
+        let written = stdin.write_all(&chunk);
+        buffer_pool::give_bytes(chunk);
+        written?;
+    }
+    stdin.flush()
+}
+
+/// 子进程输出的样本格式.
+#[derive(Clone, Copy)]
+struct PipeFormat {
+    /// Internal field.
+    channels: usize,
+    /// Internal field.
+    sample_format: SampleFormat,
+}
+
+/// 读线程：增量解析 wav-pipe stdout，按块发送所需声道.
+///
+/// 出错时把错误交给合并线程，然后继续读空 stdout，避免子进程阻塞在写出上。.
+fn read_step_output(
+    stdout: ChildStdout,
+    step_channels: usize,
+    target_format: SampleFormat,
+    tx: &SyncSender<Result<Block>>,
+) {
+    let mut stdout = BufReader::with_capacity(PIPE_BUF_SIZE, stdout);
+    if let Err(err) = forward_step_blocks(&mut stdout, step_channels, target_format, tx) {
+        let _ = tx.send(Err(err));
+    }
+    let _ = std::io::copy(&mut stdout, &mut std::io::sink());
+}
+
+/// Internal helper function.
+fn forward_step_blocks<R: Read>(
+    stdout: &mut R,
+    step_channels: usize,
+    target_format: SampleFormat,
+    tx: &SyncSender<Result<Block>>,
+) -> Result<()> {
+    let format = read_pipe_header(stdout)?;
+    if format.channels < step_channels {
+        return Err(Error::AudiowmarkExec(format!(
+            "route step output expects {step_channels} channels, got {}",
+            format.channels
+        )));
+    }
+    let width = usize::from(format.sample_format.bits_per_sample() / 8);
+    let frame_bytes = format.channels * width;
+    let mut bytes = buffer_pool::take_bytes(BLOCK_FRAMES * frame_bytes);
+    loop {
+        bytes.resize(BLOCK_FRAMES * frame_bytes, 0);
+        let filled = read_full(stdout, &mut bytes)?;
+        // 末尾不足一帧的字节是 wav-pipe 的对齐填充。
+        let frames = filled / frame_bytes;
+        if frames > 0 {
+            let mut block: Block = (0..step_channels)
+                .map(|_| buffer_pool::take_samples(frames))
+                .collect();
+            for frame in bytes[..frames * frame_bytes].chunks_exact(frame_bytes) {
+                for (channel, samples) in block.iter_mut().enumerate() {
+                    let offset = channel * width;
+                    let sample =
+                        decode_sample(&frame[offset..offset + width], format.sample_format);
+                    samples.push(rescale(sample, format.sample_format, target_format));
+                }
+            }
+            if tx.send(Ok(block)).is_err() {
+                break;
+            }
+        }
+        if filled < bytes.len() {
+            break;
+        }
+    }
+    buffer_pool::give_bytes(bytes);
+    Ok(())
+}
+
+/// 解析 wav-pipe 头部直到 data chunk 起点.
+fn read_pipe_header<R: Read>(stdout: &mut R) -> Result<PipeFormat> {
+    let invalid = |what: &str| Error::AudiowmarkExec(format!("invalid wav-pipe output: {what}"));
+    let mut riff = [0_u8; 12];
+    stdout.read_exact(&mut riff)?;
+    if &riff[0..4] != b"RIFF" || &riff[8..12] != b"WAVE" {
+        return Err(invalid("missing RIFF/WAVE header"));
+    }
+    let mut format = None;
+    loop {
+        let mut chunk = [0_u8; 8];
+        stdout.read_exact(&mut chunk)?;
+        let size = u32::from_le_bytes([chunk[4], chunk[5], chunk[6], chunk[7]]);
+        if &chunk[0..4] == b"data" {
+            return format.ok_or_else(|| invalid("data chunk before fmt chunk"));
+        }
+        let size = usize::try_from(size).unwrap_or(usize::MAX);
+        let padded = size.saturating_add(size % 2);
+        if &chunk[0..4] == b"fmt " {
+            if !(16..=MAX_FMT_CHUNK).contains(&size) {
+                return Err(invalid("fmt chunk size"));
+            }
+            let mut body = vec![0_u8; padded];
+            stdout.read_exact(&mut body)?;
+            format = Some(parse_fmt_chunk(&body).ok_or_else(|| invalid("sample format"))?);
+        } else {
+            let skip = u64::try_from(padded).unwrap_or(u64::MAX);
+            std::io::copy(&mut stdout.by_ref().take(skip), &mut std::io::sink())?;
+        }
+    }
+}
+
+/// Internal helper function.
+fn parse_fmt_chunk(body: &[u8]) -> Option<PipeFormat> {
+    let mut tag = u16::from_le_bytes([*body.first()?, *body.get(1)?]);
+    let channels = u16::from_le_bytes([*body.get(2)?, *body.get(3)?]);
+    let bits = u16::from_le_bytes([*body.get(14)?, *body.get(15)?]);
+    // WAVE_FORMAT_EXTENSIBLE：真实格式在子格式 GUID 的前两个字节。
+    if tag == 0xFFFE {
+        tag = u16::from_le_bytes([*body.get(24)?, *body.get(25)?]);
+    }
+    let sample_format = match (tag, bits) {
+        (1, 16) => SampleFormat::Int16,
+        (1, 24) => SampleFormat::Int24,
+        (1, 32) => SampleFormat::Int32,
+        (3, 32) => SampleFormat::Float32,
+        _ => return None,
+    };
+    Some(PipeFormat {
+        channels: usize::from(channels),
+        sample_format,
+    })
+}
+
+/// 在整数位深之间换算（float32 的内部表示为满幅 i32，按 32 位处理）.
+fn rescale(sample: i32, from: SampleFormat, to: SampleFormat) -> i32 {
+    let from_bits = i32::from(from.bits_per_sample());
+    let to_bits = i32::from(to.bits_per_sample());
+    match from_bits.cmp(&to_bits) {
+        std::cmp::Ordering::Equal => sample,
+        std::cmp::Ordering::Greater => sample >> (from_bits - to_bits),
+        std::cmp::Ordering::Less => sample << (to_bits - from_bits),
+    }
+}
+
+/// Internal helper function.
+fn read_full<R: Read>(reader: &mut R, buf: &mut [u8]) -> std::io::Result<usize> {
+    let mut filled = 0;
+    while filled < buf.len() {
+        match reader.read(&mut buf[filled..]) {
+            Ok(0) => break,
+            Ok(n) => filled += n,
+            Err(err) if err.kind() == std::io::ErrorKind::Interrupted => {}
+            Err(err) => return Err(err),
+        }
+    }
+    Ok(filled)
+}
+
+/// 合并线程中单个路由步骤的输出游标.
+struct StepCursor {
+    /// Internal field.
+    rx: Receiver<Result<Block>>,
+    /// Internal field.
+    block: Block,
+    /// Internal field.
+    offset: usize,
+}
+
+impl StepCursor {
+    /// Internal associated function.
+    const fn new(rx: Receiver<Result<Block>>) -> Self {
+        Self {
+            rx,
+            block: Vec::new(),
+            offset: 0,
+        }
+    }
+
+    /// 用步骤输出覆盖 `target` 中 `channels` 的前 `frames` 帧.
+    fn fill(&mut self, target: &mut Block, channels: &[usize], frames: usize) -> Result<()> {
+        let mut filled = 0;
+        while filled < frames {
+            let available = self.block.first().map_or(0, Vec::len) - self.offset;
+            if available == 0 {
+                recycle(std::mem::take(&mut self.block));
+                self.block = self.rx.recv().map_err(|_| {
+                    Error::AudiowmarkExec("route step output ended early".to_string())
+                })??;
+                self.offset = 0;
+                continue;
+            }
+            let count = available.min(frames - filled);
+            for (source, &channel) in self.block.iter().zip(channels) {
+                target[channel][filled..filled + count]
+                    .copy_from_slice(&source[self.offset..self.offset + count]);
+            }
+            self.offset += count;
+            filled += count;
+        }
+        Ok(())
+    }
+}
+
+/// 合并线程：逐块覆盖各步骤声道并写出.
+fn merge_blocks(
+    mut writer: StreamWavWriter,
+    orig_rx: &Receiver<Block>,
+    mut cursors: Vec<StepCursor>,
+    steps: &[Vec<usize>],
+) -> Result<()> {
+    for mut block in orig_rx {
+        let frames = block.first().map_or(0, Vec::len);
+        for (cursor, channels) in cursors.iter_mut().zip(steps) {
+            cursor.fill(&mut block, channels, frames)?;
+        }
+        let written = writer.write_block(&block);
+        recycle(block);
+        written?;
+    }
+    writer.finalize()
+}
+
+/// 边写边计数的 WAV 输出.
+///
+/// 头部在 `fmt ` 前预留 28 字节的 `JUNK` chunk：数据未超过 RIFF 32 位上限时收尾只回填
+/// 大小字段，否则把 `JUNK` 原地改写为 `ds64` 并换成 RF64 头，无需预知输出长度。.
+struct StreamWavWriter {
+    /// Internal field.
+    file: BufWriter<File>,
+    /// Internal field.
+    sample_format: SampleFormat,
+    /// Internal field.
+    frame_bytes: u64,
+    /// Internal field.
+    frames: u64,
+    /// Internal field.
+    scratch: Vec<u8>,
+}
+
+impl StreamWavWriter {
+    /// 创建输出文件并写入占位头.
+    fn create(path: &Path, stream: &StreamSpec) -> Result<Self> {
+        let mut riff = Vec::with_capacity(44);
+        push_wav_header(
+            &mut riff,
+            stream.num_channels,
+            stream.sample_rate,
+            stream.sample_format,
+            0,
+        )?;
+        let mut header = Vec::with_capacity(OUTPUT_HEADER_LEN);
+        header.extend_from_slice(&riff[..12]);
+        header.extend_from_slice(b"JUNK");
+        header.extend_from_slice(&28_u32.to_le_bytes());
+        header.resize(header.len() + DS64_LEN, 0);
+        header.extend_from_slice(&riff[12..]);
+        let mut file = BufWriter::with_capacity(PIPE_BUF_SIZE, File::create(path)?);
+        file.write_all(&header)?;
+        let width = u64::from(stream.sample_format.bits_per_sample() / 8);
+        Ok(Self {
+            file,
+            sample_format: stream.sample_format,
+            frame_bytes: width.saturating_mul(u64::try_from(stream.num_channels).unwrap_or(0)),
+            frames: 0,
+            scratch: Vec::new(),
+        })
+    }
+
+    /// 交错写出一个块.
+    fn write_block(&mut self, block: &Block) -> Result<()> {
+        let frames = block.first().map_or(0, Vec::len);
+        let index = usize::try_from(self.frames).unwrap_or(usize::MAX);
+        self.scratch.clear();
+        for frame in 0..frames {
+            for channel in block {
+                push_wav_sample(
+                    &mut self.scratch,
+                    self.sample_format,
+                    channel[frame],
+                    index.saturating_add(frame),
+                )?;
+            }
+        }
+        self.file.write_all(&self.scratch)?;
+        self.frames = self
+            .frames
+            .saturating_add(u64::try_from(frames).unwrap_or(u64::MAX));
+        Ok(())
+    }
+
+    /// 补齐奇数长度填充字节并回填头部大小.
+    fn finalize(self) -> Result<()> {
+        let data_bytes = self.frames.saturating_mul(self.frame_bytes);
+        let mut file = self
+            .file
+            .into_inner()
+            .map_err(|e| Error::Io(e.into_error()))?;
+        if data_bytes % 2 == 1 {
+            file.write_all(&[0])?;
+        }
+        patch_output_sizes(&mut file, data_bytes, self.frames)?;
+        file.flush()?;
+        Ok(())
+    }
+}
+
+/// 回填 RIFF/data 大小；超过 32 位上限时改写为 RF64 + `ds64`.
+fn patch_output_sizes(file: &mut File, data_bytes: u64, frames: u64) -> Result<()> {
+    let header_tail = u64::try_from(OUTPUT_HEADER_LEN - 8).unwrap_or(u64::MAX);
+    let riff_size = header_tail
+        .saturating_add(data_bytes)
+        .saturating_add(data_bytes % 2);
+    match (u32::try_from(riff_size), u32::try_from(data_bytes)) {
+        (Ok(riff_size), Ok(data_size)) => {
+            file.seek(SeekFrom::Start(4))?;
+            file.write_all(&riff_size.to_le_bytes())?;
+            file.seek(SeekFrom::Start(76))?;
+            file.write_all(&data_size.to_le_bytes())?;
+        }
+        _ => write_rf64_sizes(file, riff_size, data_bytes, frames)?,
+    }
+    Ok(())
+}
+
+/// 写入 RF64 头与 `ds64`（大小字段置为 `0xFFFFFFFF`）.
+fn write_rf64_sizes(file: &mut File, riff_size: u64, data_bytes: u64, frames: u64) -> Result<()> {
+    let mut ds64 = Vec::with_capacity(8 + DS64_LEN);
+    ds64.extend_from_slice(b"ds64");
+    ds64.extend_from_slice(&28_u32.to_le_bytes());
+    ds64.extend_from_slice(&riff_size.to_le_bytes());
+    ds64.extend_from_slice(&data_bytes.to_le_bytes());
+    ds64.extend_from_slice(&frames.to_le_bytes());
+    ds64.extend_from_slice(&0_u32.to_le_bytes());
+    file.seek(SeekFrom::Start(0))?;
+    file.write_all(b"RF64")?;
+    file.write_all(&u32::MAX.to_le_bytes())?;
+    file.seek(SeekFrom::Start(12))?;
+    file.write_all(&ds64)?;
+    file.seek(SeekFrom::Start(76))?;
+    file.write_all(&u32::MAX.to_le_bytes())?;
+    Ok(())
+}
+
+/// Internal helper function.
+fn recycle(block: Block) {
+    for channel in block {
+        buffer_pool::give_samples(channel);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn pipe_header_and_blocks_round_trip_through_parser() {
+        let mut bytes = Vec::new();
+        assert!(push_wav_header(&mut bytes, 2, 48_000, SampleFormat::Int16, 3).is_ok());
+        for sample in [1_i32, -1, 2, -2, 3, -3] {
+            assert!(push_wav_sample(&mut bytes, SampleFormat::Int16, sample, 0).is_ok());
+        }
+        bytes.push(0);
+
+        let (tx, rx) = mpsc::sync_channel(4);
+        let forwarded = forward_step_blocks(&mut bytes.as_slice(), 1, SampleFormat::Int24, &tx);
+        assert!(forwarded.is_ok());
+        drop(tx);
+        let blocks: Vec<Block> = rx.into_iter().filter_map(Result::ok).collect();
+        assert_eq!(blocks.len(), 1);
+        // 单声道步骤只取第 0 声道，并从 16 位换算到输入的 24 位。
+        assert_eq!(blocks[0], vec![vec![256, 512, 768]]);
+    }
+
+    #[test]
+    fn output_writer_patches_riff_and_rf64_sizes() {
+        use crate::media::wav_map::WavLayout;
+
+        let path = std::env::temp_dir().join(format!(
+            "awmkit-stream-writer-{}-{:?}.wav",
+            std::process::id(),
+            std::thread::current().id()
+        ));
+        let stream = StreamSpec {
+            num_channels: 3,
+            sample_rate: 48_000,
+            sample_format: SampleFormat::Int24,
+            total_frames: 0,
+        };
+        let writer = StreamWavWriter::create(&path, &stream);
+        assert!(writer.is_ok());
+        let Ok(mut writer) = writer else {
+            return;
+        };
+        let block: Block = vec![vec![1, 2, 3], vec![-1, -2, -3], vec![7, 8, 9]];
+        assert!(writer.write_block(&block).is_ok());
+        assert!(writer.finalize().is_ok());
+
+        let bytes = fs::read(&path).unwrap_or_default();
+        // 3 帧 × 9 字节为奇数，末尾补 1 字节填充。
+        assert_eq!(bytes.len(), OUTPUT_HEADER_LEN + 28);
+        let layout = WavLayout::parse(&bytes);
+        assert_eq!(layout.as_ref().map(WavLayout::frames), Some(3));
+        let view = layout
+            .as_ref()
+            .and_then(|layout| InterleavedView::new(layout, &bytes));
+        assert_eq!(view.and_then(|view| view.sample(2, 2)), Some(9));
+
+        // 大小超过 32 位时改写为 RF64，仍可经 ds64 解析。
+        let patched = File::options()
+            .write(true)
+            .open(&path)
+            .map_err(Error::from)
+            .and_then(|mut file| write_rf64_sizes(&mut file, 100, 27, 3));
+        assert!(patched.is_ok());
+        let bytes = fs::read(&path).unwrap_or_default();
+        assert_eq!(bytes.get(0..4), Some(&b"RF64"[..]));
+        let layout = WavLayout::parse(&bytes);
+        assert_eq!(layout.as_ref().map(WavLayout::frames), Some(3));
+        let _ = fs::remove_file(path);
+    }
+
+    #[test]
+    fn cursor_fills_across_unaligned_step_blocks() {
+        let (tx, rx) = mpsc::channel();
+        let mut cursor = StepCursor::new(rx);
+        assert!(tx.send(Ok(vec![vec![1, 2], vec![10, 20]])).is_ok());
+        assert!(tx.send(Ok(vec![vec![3], vec![30]])).is_ok());
+        drop(tx);
+
+        let mut target = vec![vec![0; 3], vec![7; 3], vec![0; 3]];
+        assert!(cursor.fill(&mut target, &[0, 2], 3).is_ok());
+        assert_eq!(target, vec![vec![1, 2, 3], vec![7; 3], vec![10, 20, 30]]);
+        assert!(cursor.fill(&mut target, &[0, 2], 1).is_err());
+    }
+
+    #[test]
+    fn inflight_depth_covers_latency_budget_at_any_rate() {
+        assert_eq!(inflight_blocks(44_100), 8);
+        for rate in [8_000_u32, 48_000, 96_000, 192_000] {
+            let covered = (inflight_blocks(rate) - INFLIGHT_SLACK) * BLOCK_FRAMES;
+            assert!(covered >= usize::try_from(rate).unwrap_or(0) * LATENCY_BUDGET_SECS);
+        }
+    }
+}
@@ -0,0 +1,383 @@
+//! 免逐样本解析的 WAV/RF64 读取.
+//!
+//! 直接在字节切片上定位 `fmt `/`data` chunk（RF64/BW64 经 `ds64` 取 64 位大小），
+//! 文件输入以内存映射方式提供切片，不经 hound 的逐样本迭代器。
+//! 数据区以交错视图暴露，各声道按需解出，整段反交错时按声道并行。.
+
+use std::fs::File;
+use std::ops::Range;
+use std::path::Path;
+
+use memmap2::Mmap;
+use rayon::prelude::*;
+
+use crate::buffer_pool;
+use crate::multichannel::{scale_float_to_i32, SampleFormat};
+
+/// `WAVE_FORMAT_PCM`.
+const FORMAT_PCM: u16 = 1;
+/// `WAVE_FORMAT_IEEE_FLOAT`.
+const FORMAT_FLOAT: u16 = 3;
+/// `WAVE_FORMAT_EXTENSIBLE`.
+const FORMAT_EXTENSIBLE: u16 = 0xFFFE;
+/// 32 位大小字段的占位值（RF64 或流式 wav-pipe）.
+const SIZE_MARKER: u32 = u32::MAX;
+
+/// 解析出的 WAV 数据布局.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct WavLayout {
+    /// 声道数.
+    pub channels: usize,
+    /// 采样率.
+    pub sample_rate: u32,
+    /// 样本格式.
+    pub sample_format: SampleFormat,
+    /// 每帧字节数.
+    pub block_align: usize,
+    /// `data` 负载在字节流中的范围（已截断到整帧）.
+    pub data: Range<usize>,
+}
+
+impl WavLayout {
+    /// 解析 RIFF/RF64/BW64 头.
+    ///
+    /// 仅接受样本紧密排列的 16/24/32 位整数与 32 位浮点格式；其余情况
+    /// （含 `data` 声明长度超出字节流）返回 `None`，由调用方退回 hound。
+    /// `data` 大小为 `0xFFFFFFFF` 且无 `ds64` 时视为延伸到字节流末尾。.
+    #[must_use]
+    pub fn parse(bytes: &[u8]) -> Option<Self> {
+        let wide = match bytes.get(0..4)? {
+            b"RIFF" => false,
+            b"RF64" | b"BW64" => true,
+            _ => return None,
+        };
+        if bytes.get(8..12)? != b"WAVE" {
+            return None;
+        }
+
+        let mut ds64_data_size: Option<u64> = None;
+        let mut format: Option<(usize, u32, SampleFormat, usize)> = None;
+        let mut pos = 12usize;
+        while let Some(header) = bytes.get(pos..pos.checked_add(8)?) {
+            let size32 = u32::from_le_bytes([header[4], header[5], header[6], header[7]]);
+            let body_start = pos + 8;
+            let remaining = bytes.len() - body_start;
+            match &header[0..4] {
+                b"ds64" if wide => {
+                    let body = bytes.get(body_start..body_start.checked_add(16)?)?;
+                    let mut size = [0u8; 8];
+                    size.copy_from_slice(&body[8..16]);
+                    ds64_data_size = Some(u64::from_le_bytes(size));
+                }
+                b"fmt " => {
+                    let end = body_start.checked_add(usize::try_from(size32).ok()?)?;
+                    format = Some(parse_fmt(bytes.get(body_start..end)?)?);
+                }
+                b"data" => {
+                    let (channels, sample_rate, sample_format, block_align) = format?;
+                    let len = match (size32, ds64_data_size) {
+                        (SIZE_MARKER, Some(size)) if wide => usize::try_from(size).ok()?,
+                        (SIZE_MARKER, _) => remaining,
+                        (size, _) => usize::try_from(size).ok()?,
+                    };
+                    if len > remaining {
+                        return None;
+                    }
+                    let len = len - len % block_align;
+                    return Some(Self {
+                        channels,
+                        sample_rate,
+                        sample_format,
+                        block_align,
+                        data: body_start..body_start + len,
+                    });
+                }
+                _ => {}
+            }
+            let size = usize::try_from(size32).ok()?;
+            pos = body_start.checked_add(size)?.checked_add(size & 1)?;
+        }
+        None
+    }
+
+    /// 每声道样本数.
+    #[must_use]
+    pub const fn frames(&self) -> usize {
+        (self.data.end - self.data.start) / self.block_align
+    }
+}
+
+/// 在原始字节上的交错样本视图.
+#[derive(Debug, Clone, Copy)]
+pub struct InterleavedView<'a> {
+    /// Internal field.
+    layout: &'a WavLayout,
+    /// Internal field.
+    data: &'a [u8],
+}
+
+impl<'a> InterleavedView<'a> {
+    /// 以解析好的布局包装字节流；布局与字节流不匹配时返回 `None`.
+    #[must_use]
+    pub fn new(layout: &'a WavLayout, bytes: &'a [u8]) -> Option<Self> {
+        let data = bytes.get(layout.data.clone())?;
+        Some(Self { layout, data })
+    }
+
+    /// 数据布局.
+    #[must_use]
+    pub const fn layout(&self) -> &WavLayout {
+        self.layout
+    }
+
+    /// 读取单个样本（内部 i32 表示）.
+    #[must_use]
+    pub fn sample(&self, frame: usize, channel: usize) -> Option<i32> {
+        if channel >= self.layout.channels {
+            return None;
+        }
+        let width = sample_width(self.layout.sample_format);
+        let start = frame
+            .checked_mul(self.layout.block_align)?
+            .checked_add(channel * width)?;
+        let bytes = self.data.get(start..start.checked_add(width)?)?;
+        Some(decode_sample(bytes, self.layout.sample_format))
+    }
+
+    /// 解出单个声道并追加到 `out`.
+    pub fn extend_channel(&self, channel: usize, out: &mut Vec<i32>) {
+        self.extend_channel_frames(channel, 0..self.layout.frames(), out);
+    }
+
+    /// 解出单个声道在 `frames` 范围内（超出部分截断）的样本并追加到 `out`.
+    pub fn extend_channel_frames(&self, channel: usize, frames: Range<usize>, out: &mut Vec<i32>) {
+        if channel >= self.layout.channels {
+            return;
+        }
+        let end = frames.end.min(self.layout.frames());
+        let start = frames.start.min(end);
+        let format = self.layout.sample_format;
+        let offset = channel * sample_width(format);
+        let align = self.layout.block_align;
+        out.reserve(end - start);
+        out.extend(
+            self.data[start * align..end * align]
+                .chunks_exact(align)
+                .map(|frame| decode_sample(frame.get(offset..).unwrap_or_default(), format)),
+        );
+    }
+
+    /// 按声道并行反交错到池化缓冲.
+    #[must_use]
+    pub fn deinterleave(&self) -> Vec<Vec<i32>> {
+        let all: Vec<usize> = (0..self.layout.channels).collect();
+        self.deinterleave_channels(&all)
+    }
+
+    /// 只反交错 `channels` 中的声道（按给定顺序），其余声道不解码；越界声道得到空缓冲.
+    #[must_use]
+    pub fn deinterleave_channels(&self, channels: &[usize]) -> Vec<Vec<i32>> {
+        let frames = self.layout.frames();
+        let mut out: Vec<Vec<i32>> = channels
+            .iter()
+            .map(|_| buffer_pool::take_samples(frames))
+            .collect();
+        out.par_iter_mut()
+            .zip(channels.par_iter())
+            .for_each(|(samples, &channel)| self.extend_channel(channel, samples));
+        out
+    }
+}
+
+/// 内存映射的 WAV 文件.
+#[derive(Debug)]
+pub struct MappedWav {
+    /// Internal field.
+    map: Mmap,
+    /// Internal field.
+    layout: WavLayout,
+}
+
+impl MappedWav {
+    /// 映射并解析 WAV 文件.
+    ///
+    /// 文件无法打开或映射、或头部不在快速路径支持范围内时返回 `None`，
+    /// 调用方应退回 hound 以得到原有的错误信息。.
+    #[must_use]
+    pub fn open(path: &Path) -> Option<Self> {
+        let file = File::open(path).ok()?;
+        if file.metadata().ok()?.len() < 12 {
+            return None;
+        }
+        // SAFETY: 映射只读且仅在本次加载期间存活；与其他 WAV 读取路径一样，
+        // 加载过程中文件被外部截断或改写不在支持范围内。
+        #[allow(unsafe_code)]
+        let map = unsafe { Mmap::map(&file) }.ok()?;
+        let layout = WavLayout::parse(&map)?;
+        Some(Self { map, layout })
+    }
+
+    /// 数据布局.
+    #[must_use]
+    pub const fn layout(&self) -> &WavLayout {
+        &self.layout
+    }
+
+    /// 交错样本视图.
+    #[must_use]
+    pub fn view(&self) -> Option<InterleavedView<'_>> {
+        InterleavedView::new(&self.layout, &self.map)
+    }
+}
+
+/// 解析 `fmt ` chunk 负载，返回（声道数, 采样率, 样本格式, 帧字节数）.
+fn parse_fmt(body: &[u8]) -> Option<(usize, u32, SampleFormat, usize)> {
+    let read_u16 = |at: usize| Some(u16::from_le_bytes([*body.get(at)?, *body.get(at + 1)?]));
+    let mut tag = read_u16(0)?;
+    let channels = usize::from(read_u16(2)?);
+    let sample_rate =
+        u32::from_le_bytes([*body.get(4)?, *body.get(5)?, *body.get(6)?, *body.get(7)?]);
+    let block_align = usize::from(read_u16(12)?);
+    let bits = read_u16(14)?;
+    // WAVE_FORMAT_EXTENSIBLE：真实格式在子格式 GUID 的前两个字节。
+    if tag == FORMAT_EXTENSIBLE {
+        tag = read_u16(24)?;
+    }
+    let sample_format = match (tag, bits) {
+        (FORMAT_PCM, 16) => SampleFormat::Int16,
+        (FORMAT_PCM, 24) => SampleFormat::Int24,
+        (FORMAT_PCM, 32) => SampleFormat::Int32,
+        (FORMAT_FLOAT, 32) => SampleFormat::Float32,
+        _ => return None,
+    };
+    // 容器宽于有效位（如 24 位放在 32 位槽中）的情况交给 hound。
+    if channels == 0 || block_align != channels * sample_width(sample_format) {
+        return None;
+    }
+    Some((channels, sample_rate, sample_format, block_align))
+}
+
+/// Internal helper function.
+const fn sample_width(sample_format: SampleFormat) -> usize {
+    (sample_format.bits_per_sample() / 8) as usize
+}
+
+/// 解码一个小端样本为内部 i32 表示（与 hound 路径一致）.
+pub(crate) fn decode_sample(bytes: &[u8], sample_format: SampleFormat) -> i32 {
+    match (sample_format, bytes) {
+        (SampleFormat::Int16, &[b0, b1, ..]) => i32::from(i16::from_le_bytes([b0, b1])),
+        (SampleFormat::Int24, &[b0, b1, b2, ..]) => i32::from_le_bytes([0, b0, b1, b2]) >> 8,
+        (SampleFormat::Int32, &[b0, b1, b2, b3, ..]) => i32::from_le_bytes([b0, b1, b2, b3]),
+        (SampleFormat::Float32, &[b0, b1, b2, b3, ..]) => {
+            scale_float_to_i32(f32::from_le_bytes([b0, b1, b2, b3]))
+        }
+        _ => 0,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::multichannel::AudioBuffer;
+
+    fn stereo_i24() -> Option<AudioBuffer> {
+        let left: Vec<i32> = (0..500)
+            .map(|i| (i * 16_001) % 8_388_607 - 4_000_000)
+            .collect();
+        let right: Vec<i32> = left.iter().map(|s| -s).collect();
+        AudioBuffer::new(vec![left, right], 48_000, SampleFormat::Int24).ok()
+    }
+
+    fn stereo_i24_bytes() -> Option<Vec<u8>> {
+        stereo_i24()?.to_wav_bytes().ok()
+    }
+
+    #[test]
+    fn parse_and_deinterleave_match_source() {
+        let buffer = stereo_i24();
+        assert!(buffer.is_some());
+        let Some(buffer) = buffer else {
+            return;
+        };
+        let bytes = buffer.to_wav_bytes();
+        assert!(bytes.is_ok());
+        let Ok(bytes) = bytes else {
+            return;
+        };
+        let layout = WavLayout::parse(&bytes);
+        assert!(layout.is_some());
+        let Some(layout) = layout else {
+            return;
+        };
+        assert_eq!(layout.channels, 2);
+        assert_eq!(layout.sample_rate, 48_000);
+        assert_eq!(layout.sample_format, SampleFormat::Int24);
+        assert_eq!(layout.frames(), 500);
+
+        let view = InterleavedView::new(&layout, &bytes);
+        assert!(view.is_some());
+        let Some(view) = view else {
+            return;
+        };
+        assert_eq!(
+            view.sample(3, 1),
+            buffer.channel_samples(1).ok().map(|ch| ch[3])
+        );
+        assert_eq!(view.sample(0, 2), None);
+        let mut window = Vec::new();
+        view.extend_channel_frames(0, 498..600, &mut window);
+        assert_eq!(
+            Some(window.as_slice()),
+            buffer.channel_samples(0).ok().map(|ch| &ch[498..])
+        );
+        let channels = view.deinterleave();
+        assert_eq!(channels.len(), 2);
+        for (ch, samples) in channels.iter().enumerate() {
+            assert_eq!(Some(samples.as_slice()), buffer.channel_samples(ch).ok());
+        }
+        let picked = view.deinterleave_channels(&[1, 0]);
+        assert_eq!(picked.len(), 2);
+        assert_eq!(Some(picked[0].as_slice()), buffer.channel_samples(1).ok());
+        assert_eq!(Some(picked[1].as_slice()), buffer.channel_samples(0).ok());
+    }
+
+    #[test]
+    fn pipe_marker_and_rf64_sizes_are_resolved() {
+        let bytes = stereo_i24_bytes();
+        assert!(bytes.is_some());
+        let Some(mut bytes) = bytes else {
+            return;
+        };
+        // wav-pipe：RIFF 与 data 大小均为占位值，末尾带一个不完整帧。
+        bytes[4..8].copy_from_slice(&SIZE_MARKER.to_le_bytes());
+        bytes[40..44].copy_from_slice(&SIZE_MARKER.to_le_bytes());
+        bytes.push(0x7F);
+        assert_eq!(WavLayout::parse(&bytes).map(|l| l.frames()), Some(500));
+
+        // RF64：在 fmt 前插入 ds64，data 大小取自 ds64。
+        let data_size = 3_000u64;
+        let mut rf64 = b"RF64".to_vec();
+        rf64.extend_from_slice(&SIZE_MARKER.to_le_bytes());
+        rf64.extend_from_slice(b"WAVEds64");
+        rf64.extend_from_slice(&28u32.to_le_bytes());
+        rf64.extend_from_slice(&0u64.to_le_bytes());
+        rf64.extend_from_slice(&data_size.to_le_bytes());
+        rf64.extend_from_slice(&[0u8; 12]);
+        rf64.extend_from_slice(&bytes[12..]);
+        assert_eq!(WavLayout::parse(&rf64).map(|l| l.frames()), Some(500));
+    }
+
+    #[test]
+    fn truncated_or_unsupported_headers_fall_back() {
+        let bytes = stereo_i24_bytes();
+        assert!(bytes.is_some());
+        let Some(bytes) = bytes else {
+            return;
+        };
+        assert!(WavLayout::parse(&bytes[..bytes.len() - 6]).is_none());
+
+        let mut eight_bit = bytes;
+        eight_bit[34..36].copy_from_slice(&8u16.to_le_bytes());
+        assert!(WavLayout::parse(&eight_bit).is_none());
+    }
+}
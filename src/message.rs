@@ -36,6 +36,8 @@ const KEY_SLOT_MASK: u32 = (1 << KEY_SLOT_BITS) - 1;
 const MAX_TIMESTAMP_V2_MINUTES: u32 = (1 << (32 - KEY_SLOT_BITS)) - 1;
 /// Internal constant.
 const DEFAULT_KEY_SLOT: u8 = 0;
+/// 批量处理时每个线程至少分到的消息数；更小的批次在调用线程内完成.
+const BATCH_CHUNK: usize = 2048;
 
 /// 解码后的消息结果.
 #[derive(Debug, Clone)]
@@ -60,6 +62,50 @@ impl Decoded {
     }
 }
 
+/// 预先完成密钥调度的 HMAC-SHA256 状态.
+///
+/// 内外层密钥块各压缩一次后缓存，之后每条消息只需克隆状态再压缩两个块；批量编码/校验
+/// 时复用，避免逐条重建密钥调度。.
+#[derive(Clone)]
+pub struct PreparedKey {
+    /// Internal field.
+    mac: HmacSha256,
+}
+
+impl PreparedKey {
+    /// 用 `key` 初始化 HMAC 状态.
+    ///
+    /// # Errors
+    /// 当密钥长度不被 HMAC 接受时返回错误。.
+    pub fn new(key: &[u8]) -> Result<Self> {
+        let mac = HmacSha256::new_from_slice(key)
+            .map_err(|_| Error::InvalidInput("invalid HMAC key length".to_string()))?;
+        Ok(Self { mac })
+    }
+
+    /// 计算 HMAC-SHA256 并截取前 6 字节.
+    fn tag(&self, data: &[u8]) -> [u8; HMAC_LEN] {
+        let mut mac = self.mac.clone();
+        mac.update(data);
+        let result = mac.finalize().into_bytes();
+
+        let mut out = [0u8; HMAC_LEN];
+        out.copy_from_slice(&result[..HMAC_LEN]);
+        out
+    }
+
+    /// 校验 16 字节消息的 HMAC.
+    fn verify(&self, data: &[u8; MESSAGE_LEN]) -> bool {
+        constant_time_eq(&data[10..16], &self.tag(&data[..10]))
+    }
+}
+
+impl std::fmt::Debug for PreparedKey {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.write_str("PreparedKey(..)")
+    }
+}
+
 /// 编码消息.
 ///
 /// # Arguments
@@ -99,6 +145,86 @@ pub fn encode_with_timestamp_and_slot(
     key: &[u8],
     timestamp_minutes: u32,
     key_slot: u8,
+) -> Result<[u8; MESSAGE_LEN]> {
+    let mut msg = build_header(version, tag, timestamp_minutes, key_slot)?;
+
+    // HMAC (6 bytes)
+    let mac = compute_hmac(key, &msg[..10])?;
+    msg[10..16].copy_from_slice(&mac);
+
+    Ok(msg)
+}
+
+/// 批量编码消息：所有 `tags` 共用版本、时间戳、槽位与预置密钥.
+///
+/// 大批次按可用并行度分块在多个线程上计算；SHA-256 压缩函数在运行时按 CPU 支持自动
+/// 选用 SHA-NI 等硬件加速实现。.
+///
+/// # Errors
+/// 当版本不支持或时间戳/槽位越界时返回错误。.
+pub fn encode_batch(
+    version: u8,
+    tags: &[Tag],
+    key: &PreparedKey,
+    timestamp_minutes: u32,
+    key_slot: u8,
+) -> Result<Vec<[u8; MESSAGE_LEN]>> {
+    // 用首个 Tag 校验公共头字段并生成模板，分块计算时不再出错。
+    let template = match tags.first() {
+        Some(tag) => build_header(version, tag, timestamp_minutes, key_slot)?,
+        None => return Ok(Vec::new()),
+    };
+    let mut out = vec![template; tags.len()];
+    for_each_chunk(&mut out, tags, |msgs, chunk_tags| {
+        for (msg, tag) in msgs.iter_mut().zip(chunk_tags) {
+            msg[5..10].copy_from_slice(&tag.to_packed());
+            let mac = key.tag(&msg[..10]);
+            msg[10..16].copy_from_slice(&mac);
+        }
+    });
+    Ok(out)
+}
+
+/// 批量校验消息 HMAC，返回与 `messages` 一一对应的结果.
+#[must_use]
+pub fn verify_batch(messages: &[[u8; MESSAGE_LEN]], key: &PreparedKey) -> Vec<bool> {
+    let mut out = vec![false; messages.len()];
+    for_each_chunk(&mut out, messages, |results, chunk| {
+        for (result, msg) in results.iter_mut().zip(chunk) {
+            *result = key.verify(msg);
+        }
+    });
+    out
+}
+
+/// 把 `out`/`input` 按相同边界分块，大批次分散到多个线程处理.
+fn for_each_chunk<T: Send, U: Sync>(
+    out: &mut [T],
+    input: &[U],
+    work: impl Fn(&mut [T], &[U]) + Sync,
+) {
+    let workers = std::thread::available_parallelism()
+        .map_or(1, std::num::NonZero::get)
+        .min(input.len() / BATCH_CHUNK);
+    if workers <= 1 {
+        work(out, input);
+        return;
+    }
+    let chunk = input.len().div_ceil(workers);
+    std::thread::scope(|scope| {
+        for (out_chunk, in_chunk) in out.chunks_mut(chunk).zip(input.chunks(chunk)) {
+            let work = &work;
+            scope.spawn(move || work(out_chunk, in_chunk));
+        }
+    });
+}
+
+/// 写入版本、时间戳/槽位与 Tag 字段（HMAC 留空）.
+fn build_header(
+    version: u8,
+    tag: &Tag,
+    timestamp_minutes: u32,
+    key_slot: u8,
 ) -> Result<[u8; MESSAGE_LEN]> {
     let mut msg = [0u8; MESSAGE_LEN];
 
@@ -124,10 +250,6 @@ pub fn encode_with_timestamp_and_slot(
     // TagPacked (5 bytes)
     msg[5..10].copy_from_slice(&tag.to_packed());
 
-    // HMAC (6 bytes)
-    let mac = compute_hmac(key, &msg[..10])?;
-    msg[10..16].copy_from_slice(&mac);
-
     Ok(msg)
 }
 
@@ -252,14 +374,7 @@ fn parse_message_fields(data: &[u8]) -> Result<Decoded> {
 
 /// 计算 HMAC-SHA256 并截取前 6 字节.
 fn compute_hmac(key: &[u8], data: &[u8]) -> Result<[u8; HMAC_LEN]> {
-    let mut mac = HmacSha256::new_from_slice(key)
-        .map_err(|_| Error::InvalidInput("invalid HMAC key length".to_string()))?;
-    mac.update(data);
-    let result = mac.finalize().into_bytes();
-
-    let mut out = [0u8; HMAC_LEN];
-    out.copy_from_slice(&result[..HMAC_LEN]);
-    Ok(out)
+    Ok(PreparedKey::new(key)?.tag(data))
 }
 
 /// 常量时间比较.
@@ -297,7 +412,8 @@ fn unpack_timestamp_v2(packed_timestamp: u32) -> (u32, u8) {
 }
 
 /// 获取当前 UTC Unix 分钟数.
-fn current_utc_minutes() -> u32 {
+#[must_use]
+pub fn current_utc_minutes() -> u32 {
     use std::time::{SystemTime, UNIX_EPOCH};
     let secs = SystemTime::now()
         .duration_since(UNIX_EPOCH)
@@ -456,4 +572,86 @@ mod tests {
         };
         assert!(matches!(err, Error::InvalidInput(_)));
     }
+
+    /// 生成 `count` 个互不相同的 Tag.
+    fn roster(count: usize) -> Vec<Tag> {
+        (0..count)
+            .filter_map(|index| {
+                let identity: String = (0..4)
+                    .map(|digit| {
+                        let position = (index >> (digit * 5)) & 31;
+                        char::from(crate::charset::CHARSET[position])
+                    })
+                    .collect();
+                Tag::new(&identity).ok()
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_encode_batch_matches_single_encode() {
+        let key = ok_or_return!(PreparedKey::new(TEST_KEY));
+        // 超过分块阈值，覆盖多线程路径
+        let tags = roster(BATCH_CHUNK * 3 + 7);
+        let batch = ok_or_return!(encode_batch(VERSION_V2, &tags, &key, 29_000_000, 3));
+        assert_eq!(batch.len(), tags.len());
+        for (tag, msg) in tags.iter().zip(&batch).step_by(997) {
+            let single = ok_or_return!(encode_with_timestamp_and_slot(
+                VERSION_V2, tag, TEST_KEY, 29_000_000, 3
+            ));
+            assert_eq!(*msg, single);
+        }
+        assert!(encode_batch(VERSION_V2, &tags, &key, 29_000_000, 32).is_err());
+        assert!(matches!(encode_batch(VERSION_V2, &[], &key, 0, 0), Ok(v) if v.is_empty()));
+    }
+
+    #[test]
+    fn test_verify_batch_flags_tampered_messages() {
+        let key = ok_or_return!(PreparedKey::new(TEST_KEY));
+        let other = ok_or_return!(PreparedKey::new(b"another-key"));
+        let tags = roster(BATCH_CHUNK * 2 + 1);
+        let mut messages = ok_or_return!(encode_batch(VERSION_V2, &tags, &key, 1_000, 0));
+        messages[5][12] ^= 0x01;
+        let results = verify_batch(&messages, &key);
+        assert_eq!(results.len(), messages.len());
+        assert!(!results[5]);
+        assert_eq!(results.iter().filter(|ok| !**ok).count(), 1);
+        assert!(verify_batch(&messages, &other).iter().all(|ok| !ok));
+    }
+
+    /// 吞吐基准：`cargo test --release --lib message::tests::bench_batch_throughput -- --ignored --nocapture`.
+    #[test]
+    #[ignore = "throughput benchmark"]
+    fn bench_batch_throughput() {
+        use std::time::Instant;
+
+        let tags = roster(1 << 18);
+        let key = ok_or_return!(PreparedKey::new(TEST_KEY));
+
+        let started = Instant::now();
+        for tag in &tags {
+            let _ = encode_with_timestamp_and_slot(VERSION_V2, tag, TEST_KEY, 1_000, 0);
+        }
+        let serial = started.elapsed();
+
+        let started = Instant::now();
+        let messages = ok_or_return!(encode_batch(VERSION_V2, &tags, &key, 1_000, 0));
+        let batch = started.elapsed();
+
+        let started = Instant::now();
+        let verified = verify_batch(&messages, &key);
+        let verify = started.elapsed();
+        assert!(verified.iter().all(|ok| *ok));
+
+        let rate = |elapsed: std::time::Duration| {
+            u128::try_from(tags.len()).unwrap_or(0) * 1_000_000 / elapsed.as_micros().max(1)
+        };
+        println!(
+            "messages={} serial_encode={}/s batch_encode={}/s batch_verify={}/s",
+            tags.len(),
+            rate(serial),
+            rate(batch),
+            rate(verify)
+        );
+    }
 }
@@ -4,7 +4,10 @@
 
 use std::path::Path;
 
+use crate::buffer_pool;
 use crate::error::{Error, Result};
+#[cfg(feature = "multichannel")]
+use crate::media::wav_map::{InterleavedView, MappedWav, WavLayout};
 
 /// 声道布局.
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -85,7 +88,18 @@ pub(crate) struct RouteStep {
     pub mode: RouteMode,
 }
 
-#[derive(Debug, Clone, PartialEq, Eq)]
+#[derive(Debug, Clone, Copy, PartialEq)]
+/// 镜像声道：不单独嵌入，合并时叠加源声道嵌入前后的差值（乘以 `gain`）.
+pub(crate) struct ChannelMirror {
+    /// Internal field.
+    pub channel: usize,
+    /// Internal field.
+    pub source: usize,
+    /// Internal field.
+    pub gain: f32,
+}
+
+#[derive(Debug, Clone, PartialEq)]
 /// Internal struct.
 pub(crate) struct RoutePlan {
     /// Internal field.
@@ -95,6 +109,8 @@ pub(crate) struct RoutePlan {
     /// Internal field.
     pub steps: Vec<RouteStep>,
     /// Internal field.
+    pub mirrors: Vec<ChannelMirror>,
+    /// Internal field.
     pub warnings: Vec<String>,
 }
 
@@ -122,42 +138,62 @@ pub(crate) fn build_smart_route_plan(
             layout,
             channels,
             steps: vec![pair_step(0, 1, "FL+FR")],
+            mirrors: Vec::new(),
             warnings: Vec::new(),
         },
         ChannelLayout::Surround51 if channels == 6 => RoutePlan {
             layout,
             channels,
             steps: known_surround_steps(layout, lfe_mode),
+            mirrors: Vec::new(),
             warnings: Vec::new(),
         },
         ChannelLayout::Surround512 | ChannelLayout::Surround71 if channels == 8 => RoutePlan {
             layout,
             channels,
             steps: known_surround_steps(layout, lfe_mode),
+            mirrors: Vec::new(),
             warnings: Vec::new(),
         },
         ChannelLayout::Surround712 if channels == 10 => RoutePlan {
             layout,
             channels,
             steps: known_surround_steps(layout, lfe_mode),
+            mirrors: Vec::new(),
             warnings: Vec::new(),
         },
         ChannelLayout::Surround714 if channels == 12 => RoutePlan {
             layout,
             channels,
             steps: known_surround_steps(layout, lfe_mode),
+            mirrors: Vec::new(),
             warnings: Vec::new(),
         },
         ChannelLayout::Surround916 if channels == 16 => RoutePlan {
             layout,
             channels,
             steps: known_surround_steps(layout, lfe_mode),
+            mirrors: Vec::new(),
             warnings: Vec::new(),
         },
         _ => fallback_route_plan(layout, channels),
     }
 }
 
+/// 布局是否有固定路由表；否则 [`build_smart_route_plan`] 走顺序配对兜底.
+#[must_use]
+pub(crate) const fn has_fixed_routing(layout: ChannelLayout, channels: usize) -> bool {
+    matches!(
+        (layout, channels),
+        (ChannelLayout::Stereo, 2)
+            | (ChannelLayout::Surround51, 6)
+            | (ChannelLayout::Surround512 | ChannelLayout::Surround71, 8)
+            | (ChannelLayout::Surround712, 10)
+            | (ChannelLayout::Surround714, 12)
+            | (ChannelLayout::Surround916, 16)
+    )
+}
+
 /// Internal helper function.
 fn known_surround_steps(layout: ChannelLayout, lfe_mode: LfeMode) -> Vec<RouteStep> {
     let mut steps = Vec::new();
@@ -234,6 +270,7 @@ fn fallback_route_plan(layout: ChannelLayout, channels: usize) -> RoutePlan {
         layout,
         channels,
         steps,
+        mirrors: Vec::new(),
         warnings: vec![format!(
             "smart routing fallback is used for layout {:?} ({} channels)",
             layout, channels
@@ -242,7 +279,7 @@ fn fallback_route_plan(layout: ChannelLayout, channels: usize) -> RoutePlan {
 }
 
 /// Internal helper function.
-fn pair_step(ch_a: usize, ch_b: usize, name: &str) -> RouteStep {
+pub(crate) fn pair_step(ch_a: usize, ch_b: usize, name: &str) -> RouteStep {
     RouteStep {
         name: name.to_string(),
         mode: RouteMode::Pair(ch_a, ch_b),
@@ -250,7 +287,7 @@ fn pair_step(ch_a: usize, ch_b: usize, name: &str) -> RouteStep {
 }
 
 /// Internal helper function.
-fn mono_step(channel: usize, name: &str) -> RouteStep {
+pub(crate) fn mono_step(channel: usize, name: &str) -> RouteStep {
     RouteStep {
         name: name.to_string(),
         mode: RouteMode::Mono(channel),
@@ -258,7 +295,7 @@ fn mono_step(channel: usize, name: &str) -> RouteStep {
 }
 
 /// Internal helper function.
-fn skip_step(channel: usize, name: &str, reason: &'static str) -> RouteStep {
+pub(crate) fn skip_step(channel: usize, name: &str, reason: &'static str) -> RouteStep {
     RouteStep {
         name: name.to_string(),
         mode: RouteMode::Skip { channel, reason },
@@ -451,12 +488,21 @@ impl AudioBuffer {
 
     /// 从 WAV 文件加载.
     ///
+    /// 样本紧密排列的 RIFF/RF64/BW64 文件经内存映射直接解析并按声道并行反交错，
+    /// 其余格式退回 hound。.
+    ///
     /// # Errors
     /// 当文件无法读取、WAV 头无效、样本格式不支持或样本解析失败时返回错误。.
     #[cfg(feature = "multichannel")]
     pub fn from_wav<P: AsRef<Path>>(path: P) -> Result<Self> {
         use hound::WavReader;
 
+        if let Some(mapped) = MappedWav::open(path.as_ref()) {
+            if let Some(view) = mapped.view() {
+                return Self::from_view(&view);
+            }
+        }
+
         let reader = WavReader::open(path.as_ref())
             .map_err(|e| Error::InvalidInput(format!("failed to open WAV: {e}")))?;
 
@@ -464,43 +510,9 @@ impl AudioBuffer {
         let num_channels = spec.channels as usize;
         let sample_rate = spec.sample_rate;
 
-        let sample_format = match (spec.sample_format, spec.bits_per_sample) {
-            (hound::SampleFormat::Int, 16) => SampleFormat::Int16,
-            (hound::SampleFormat::Int, 24) => SampleFormat::Int24,
-            (hound::SampleFormat::Int, 32) => SampleFormat::Int32,
-            (hound::SampleFormat::Float, 32) => SampleFormat::Float32,
-            _ => {
-                return Err(Error::InvalidInput(format!(
-                    "unsupported sample format: {:?} {}bit",
-                    spec.sample_format, spec.bits_per_sample
-                )))
-            }
-        };
-
-        // 读取所有样本
-        let all_samples: Vec<i32> = match sample_format {
-            SampleFormat::Float32 => reader
-                .into_samples::<f32>()
-                .map(|s| {
-                    s.map(scale_float_to_i32)
-                        .map_err(|e| Error::InvalidInput(format!("read error: {e}")))
-                })
-                .collect::<Result<Vec<_>>>()?,
-            _ => reader
-                .into_samples::<i32>()
-                .map(|s| s.map_err(|e| Error::InvalidInput(format!("read error: {e}"))))
-                .collect::<Result<Vec<_>>>()?,
-        };
-
-        // 反交错为独立声道
-        let num_samples = all_samples.len() / num_channels;
-        let mut channels = vec![Vec::with_capacity(num_samples); num_channels];
-
-        for (i, sample) in all_samples.into_iter().enumerate() {
-            let ch = i % num_channels;
-            channels[ch].push(sample);
-        }
+        let sample_format = sample_format_from_spec(spec)?;
 
+        let channels = deinterleave_hound(reader, num_channels, sample_format)?;
         Self::new(channels, sample_rate, sample_format)
     }
 
@@ -584,84 +596,23 @@ impl AudioBuffer {
     /// 当 WAV 头字段溢出、样本超出目标位深范围或序列化失败时返回错误。.
     #[cfg(feature = "multichannel")]
     pub fn to_wav_bytes(&self) -> Result<Vec<u8>> {
-        let channels = self.num_channels();
-        let sample_width: usize = match self.sample_format {
-            SampleFormat::Int16 => 2,
-            SampleFormat::Int24 => 3,
-            SampleFormat::Int32 | SampleFormat::Float32 => 4,
-        };
         let num_samples = self.num_samples();
-        let data_size = num_samples * channels * sample_width;
-
-        let mut buf = Vec::with_capacity(44 + data_size);
-
-        // RIFF header
-        buf.extend_from_slice(b"RIFF");
-        let riff_size = u32::try_from(data_size + 36)
-            .map_err(|_| Error::InvalidInput("audio data too large for WAV format".to_string()))?;
-        buf.extend_from_slice(&riff_size.to_le_bytes());
-        buf.extend_from_slice(b"WAVE");
-
-        // fmt chunk
-        buf.extend_from_slice(b"fmt ");
-        buf.extend_from_slice(&16u32.to_le_bytes());
-        let format_tag: u16 = if matches!(self.sample_format, SampleFormat::Float32) {
-            3
-        } else {
-            1
-        };
-        buf.extend_from_slice(&format_tag.to_le_bytes());
-        let ch_u16 = u16::try_from(channels).map_err(|_| {
-            Error::InvalidInput("channel count overflow for WAV header".to_string())
-        })?;
-        buf.extend_from_slice(&ch_u16.to_le_bytes());
-        buf.extend_from_slice(&self.sample_rate.to_le_bytes());
-        let sample_width_u32 = u32::try_from(sample_width)
-            .map_err(|_| Error::InvalidInput("sample width overflow for WAV header".to_string()))?;
-        let byte_rate = self.sample_rate * u32::from(ch_u16) * sample_width_u32;
-        buf.extend_from_slice(&byte_rate.to_le_bytes());
-        let sample_width_u16 = u16::try_from(sample_width)
-            .map_err(|_| Error::InvalidInput("sample width overflow for WAV header".to_string()))?;
-        let block_align = ch_u16 * sample_width_u16;
-        buf.extend_from_slice(&block_align.to_le_bytes());
-        let bits: u16 = sample_width_u16 * 8;
-        buf.extend_from_slice(&bits.to_le_bytes());
-
-        // data chunk
-        buf.extend_from_slice(b"data");
-        let data_size_u32 = u32::try_from(data_size)
-            .map_err(|_| Error::InvalidInput("audio data too large for WAV format".to_string()))?;
-        buf.extend_from_slice(&data_size_u32.to_le_bytes());
+        let sample_width = usize::from(self.sample_format.bits_per_sample() / 8);
+        let data_size = num_samples * self.num_channels() * sample_width;
+
+        let mut buf = buffer_pool::take_bytes(44 + data_size);
+        push_wav_header(
+            &mut buf,
+            self.num_channels(),
+            self.sample_rate,
+            self.sample_format,
+            num_samples,
+        )?;
 
         // 交错样本
         for i in 0..num_samples {
             for ch in &self.channels {
-                match self.sample_format {
-                    SampleFormat::Int16 => {
-                        let v = i16::try_from(ch[i]).map_err(|_| {
-                            Error::InvalidInput(format!("sample out of 16-bit range at index {i}"))
-                        })?;
-                        buf.extend_from_slice(&v.to_le_bytes());
-                    }
-                    SampleFormat::Int24 => {
-                        let s = ch[i];
-                        let le = s.to_le_bytes();
-                        buf.push(le[0]);
-                        buf.push(le[1]);
-                        buf.push(le[2]);
-                    }
-                    SampleFormat::Int32 => {
-                        buf.extend_from_slice(&ch[i].to_le_bytes());
-                    }
-                    SampleFormat::Float32 => {
-                        let clamped = (ch[i] >> 16).clamp(i32::from(i16::MIN), i32::from(i16::MAX));
-                        let sample_i16 = i16::try_from(clamped).map_err(|_| {
-                            Error::InvalidInput(format!("float32 sample out of range at index {i}"))
-                        })?;
-                        let f = f32::from(sample_i16) / f32::from(i16::MAX);
-                        buf.extend_from_slice(&f.to_bits().to_le_bytes());
-                    }
-                }
+                push_wav_sample(&mut buf, self.sample_format, ch[i], i)?;
             }
         }
 
@@ -680,6 +631,12 @@ impl AudioBuffer {
         use hound::WavReader;
         use std::io::Cursor;
 
+        if let Some(layout) = WavLayout::parse(bytes) {
+            if let Some(view) = InterleavedView::new(&layout, bytes) {
+                return Self::from_view(&view);
+            }
+        }
+
         let normalized = normalize_wav_pipe_sizes(bytes);
         let reader = WavReader::new(Cursor::new(normalized.as_ref()))
             .map_err(|e| Error::InvalidInput(format!("failed to parse WAV bytes: {e}")))?;
@@ -688,40 +645,47 @@ impl AudioBuffer {
         let num_channels = spec.channels as usize;
         let sample_rate = spec.sample_rate;
 
-        let sample_format = match (spec.sample_format, spec.bits_per_sample) {
-            (hound::SampleFormat::Int, 16) => SampleFormat::Int16,
-            (hound::SampleFormat::Int, 24) => SampleFormat::Int24,
-            (hound::SampleFormat::Int, 32) => SampleFormat::Int32,
-            (hound::SampleFormat::Float, 32) => SampleFormat::Float32,
-            _ => {
-                return Err(Error::InvalidInput(format!(
-                    "unsupported sample format: {:?} {}bit",
-                    spec.sample_format, spec.bits_per_sample
-                )))
-            }
-        };
+        let sample_format = sample_format_from_spec(spec)?;
 
-        let all_samples: Vec<i32> = match sample_format {
-            SampleFormat::Float32 => reader
-                .into_samples::<f32>()
-                .map(|s| {
-                    s.map(scale_float_to_i32)
-                        .map_err(|e| Error::InvalidInput(format!("read error: {e}")))
-                })
-                .collect::<Result<Vec<_>>>()?,
-            _ => reader
-                .into_samples::<i32>()
-                .map(|s| s.map_err(|e| Error::InvalidInput(format!("read error: {e}"))))
-                .collect::<Result<Vec<_>>>()?,
-        };
+        let channels = deinterleave_hound(reader, num_channels, sample_format)?;
+        Self::new(channels, sample_rate, sample_format)
+    }
 
-        let num_samples = all_samples.len() / num_channels;
-        let mut channels = vec![Vec::with_capacity(num_samples); num_channels];
-        for (i, sample) in all_samples.into_iter().enumerate() {
-            channels[i % num_channels].push(sample);
-        }
+    /// 从交错样本视图按声道并行解出.
+    ///
+    /// # Errors
+    /// 当声道为空或长度不一致时返回错误。.
+    #[cfg(feature = "multichannel")]
+    fn from_view(view: &InterleavedView<'_>) -> Result<Self> {
+        let layout = view.layout();
+        Self::new(
+            view.deinterleave(),
+            layout.sample_rate,
+            layout.sample_format,
+        )
+    }
 
-        Self::new(channels, sample_rate, sample_format)
+    /// 只从交错样本视图解出 `channels` 中的声道，按给定顺序组成新缓冲；其余声道不解码.
+    ///
+    /// # Errors
+    /// 当 `channels` 为空或含越界声道时返回错误。.
+    #[cfg(feature = "multichannel")]
+    pub(crate) fn from_view_channels(
+        view: &InterleavedView<'_>,
+        channels: &[usize],
+    ) -> Result<Self> {
+        let layout = view.layout();
+        if let Some(&channel) = channels.iter().find(|&&ch| ch >= layout.channels) {
+            return Err(Error::InvalidInput(format!(
+                "channel index {channel} out of range for {} channels",
+                layout.channels
+            )));
+        }
+        Self::new(
+            view.deinterleave_channels(channels),
+            layout.sample_rate,
+            layout.sample_format,
+        )
     }
 
     /// 保存为 WAV 文件.
@@ -730,26 +694,9 @@ impl AudioBuffer {
     /// 当输出文件无法创建/写入，或样本超出目标位深范围时返回错误。.
     #[cfg(feature = "multichannel")]
     pub fn to_wav<P: AsRef<Path>>(&self, path: P) -> Result<()> {
-        use hound::{SampleFormat as HoundFormat, WavSpec, WavWriter};
-
-        let (hound_format, bits) = match self.sample_format {
-            SampleFormat::Int16 => (HoundFormat::Int, 16),
-            SampleFormat::Int24 => (HoundFormat::Int, 24),
-            SampleFormat::Int32 => (HoundFormat::Int, 32),
-            SampleFormat::Float32 => (HoundFormat::Float, 32),
-        };
-
-        let channels = u16::try_from(self.num_channels()).map_err(|_| {
-            Error::InvalidInput("channel count overflow for WAV writer".to_string())
-        })?;
-
-        let spec = WavSpec {
-            channels,
-            sample_rate: self.sample_rate,
-            bits_per_sample: bits,
-            sample_format: hound_format,
-        };
+        use hound::WavWriter;
 
+        let spec = wav_spec(self.num_channels(), self.sample_rate, self.sample_format)?;
         let mut writer = WavWriter::create(path.as_ref(), spec)
             .map_err(|e| Error::InvalidInput(format!("failed to create WAV: {e}")))?;
 
@@ -758,33 +705,7 @@ impl AudioBuffer {
         // 交错写入
         for i in 0..num_samples {
             for ch in &self.channels {
-                match self.sample_format {
-                    SampleFormat::Int16 => {
-                        let sample_i16 = i16::try_from(ch[i]).map_err(|_| {
-                            Error::InvalidInput(format!("sample out of 16-bit range at index {i}"))
-                        })?;
-                        writer
-                            .write_sample(sample_i16)
-                            .map_err(|e| Error::InvalidInput(format!("write error: {e}")))?;
-                    }
-                    SampleFormat::Int24 | SampleFormat::Int32 => {
-                        writer
-                            .write_sample(ch[i])
-                            .map_err(|e| Error::InvalidInput(format!("write error: {e}")))?;
-                    }
-                    SampleFormat::Float32 => {
-                        let sample_i16 = i16::try_from(
-                            (ch[i] >> 16).clamp(i32::from(i16::MIN), i32::from(i16::MAX)),
-                        )
-                        .map_err(|_| {
-                            Error::InvalidInput(format!("sample out of float32 range at index {i}"))
-                        })?;
-                        let f = f32::from(sample_i16) / f32::from(i16::MAX);
-                        writer
-                            .write_sample(f)
-                            .map_err(|e| Error::InvalidInput(format!("write error: {e}")))?;
-                    }
-                }
+                write_wav_sample(&mut writer, self.sample_format, ch[i], i)?;
             }
         }
 
@@ -858,10 +779,17 @@ impl AudioBuffer {
             .channels
             .get_mut(index)
             .ok_or_else(|| Error::InvalidInput(format!("channel index {index} out of range")))?;
-        *channel = samples;
+        buffer_pool::give_samples(std::mem::replace(channel, samples));
         Ok(())
     }
 
+    /// 将各声道缓冲归还缓冲池.
+    pub(crate) fn recycle(self) {
+        for channel in self.channels {
+            buffer_pool::give_samples(channel);
+        }
+    }
+
     /// 从立体声对合并.
     ///
     /// # Errors
@@ -999,8 +927,191 @@ fn normalize_wav_pipe_sizes(bytes: &[u8]) -> std::borrow::Cow<'_, [u8]> {
     std::borrow::Cow::Owned(patched)
 }
 
+/// 将 hound 样本规格映射为内部样本格式.
+#[cfg(feature = "multichannel")]
+pub(crate) fn sample_format_from_spec(spec: hound::WavSpec) -> Result<SampleFormat> {
+    match (spec.sample_format, spec.bits_per_sample) {
+        (hound::SampleFormat::Int, 16) => Ok(SampleFormat::Int16),
+        (hound::SampleFormat::Int, 24) => Ok(SampleFormat::Int24),
+        (hound::SampleFormat::Int, 32) => Ok(SampleFormat::Int32),
+        (hound::SampleFormat::Float, 32) => Ok(SampleFormat::Float32),
+        _ => Err(Error::InvalidInput(format!(
+            "unsupported sample format: {:?} {}bit",
+            spec.sample_format, spec.bits_per_sample
+        ))),
+    }
+}
+
+/// 构造写出用的 hound 规格.
+#[cfg(feature = "multichannel")]
+pub(crate) fn wav_spec(
+    num_channels: usize,
+    sample_rate: u32,
+    sample_format: SampleFormat,
+) -> Result<hound::WavSpec> {
+    let channels = u16::try_from(num_channels)
+        .map_err(|_| Error::InvalidInput("channel count overflow for WAV writer".to_string()))?;
+    let sample_format_hound = if matches!(sample_format, SampleFormat::Float32) {
+        hound::SampleFormat::Float
+    } else {
+        hound::SampleFormat::Int
+    };
+    Ok(hound::WavSpec {
+        channels,
+        sample_rate,
+        bits_per_sample: sample_format.bits_per_sample(),
+        sample_format: sample_format_hound,
+    })
+}
+
+/// 追加 44 字节的 PCM/float WAV 头（`num_samples` 为每声道样本数）.
+#[cfg(feature = "multichannel")]
+pub(crate) fn push_wav_header(
+    buf: &mut Vec<u8>,
+    num_channels: usize,
+    sample_rate: u32,
+    sample_format: SampleFormat,
+    num_samples: usize,
+) -> Result<()> {
+    let sample_width = usize::from(sample_format.bits_per_sample() / 8);
+    let data_size = num_samples * num_channels * sample_width;
+
+    // RIFF header
+    buf.extend_from_slice(b"RIFF");
+    let riff_size = u32::try_from(data_size + 36)
+        .map_err(|_| Error::InvalidInput("audio data too large for WAV format".to_string()))?;
+    buf.extend_from_slice(&riff_size.to_le_bytes());
+    buf.extend_from_slice(b"WAVE");
+
+    // fmt chunk
+    buf.extend_from_slice(b"fmt ");
+    buf.extend_from_slice(&16u32.to_le_bytes());
+    let format_tag: u16 = if matches!(sample_format, SampleFormat::Float32) {
+        3
+    } else {
+        1
+    };
+    buf.extend_from_slice(&format_tag.to_le_bytes());
+    let ch_u16 = u16::try_from(num_channels)
+        .map_err(|_| Error::InvalidInput("channel count overflow for WAV header".to_string()))?;
+    buf.extend_from_slice(&ch_u16.to_le_bytes());
+    buf.extend_from_slice(&sample_rate.to_le_bytes());
+    let sample_width_u32 = u32::try_from(sample_width)
+        .map_err(|_| Error::InvalidInput("sample width overflow for WAV header".to_string()))?;
+    let byte_rate = sample_rate * u32::from(ch_u16) * sample_width_u32;
+    buf.extend_from_slice(&byte_rate.to_le_bytes());
+    let sample_width_u16 = u16::try_from(sample_width)
+        .map_err(|_| Error::InvalidInput("sample width overflow for WAV header".to_string()))?;
+    let block_align = ch_u16 * sample_width_u16;
+    buf.extend_from_slice(&block_align.to_le_bytes());
+    let bits: u16 = sample_width_u16 * 8;
+    buf.extend_from_slice(&bits.to_le_bytes());
+
+    // data chunk
+    buf.extend_from_slice(b"data");
+    let data_size_u32 = u32::try_from(data_size)
+        .map_err(|_| Error::InvalidInput("audio data too large for WAV format".to_string()))?;
+    buf.extend_from_slice(&data_size_u32.to_le_bytes());
+    Ok(())
+}
+
+/// 按样本格式追加一个小端样本（`index` 仅用于错误信息）.
+#[cfg(feature = "multichannel")]
+pub(crate) fn push_wav_sample(
+    buf: &mut Vec<u8>,
+    sample_format: SampleFormat,
+    sample: i32,
+    index: usize,
+) -> Result<()> {
+    match sample_format {
+        SampleFormat::Int16 => {
+            let v = i16::try_from(sample).map_err(|_| {
+                Error::InvalidInput(format!("sample out of 16-bit range at index {index}"))
+            })?;
+            buf.extend_from_slice(&v.to_le_bytes());
+        }
+        SampleFormat::Int24 => {
+            let le = sample.to_le_bytes();
+            buf.push(le[0]);
+            buf.push(le[1]);
+            buf.push(le[2]);
+        }
+        SampleFormat::Int32 => {
+            buf.extend_from_slice(&sample.to_le_bytes());
+        }
+        SampleFormat::Float32 => {
+            let f = float32_from_i32(sample, index)?;
+            buf.extend_from_slice(&f.to_bits().to_le_bytes());
+        }
+    }
+    Ok(())
+}
+
+/// 按样本格式经 hound 写出一个样本（`index` 仅用于错误信息）.
+#[cfg(feature = "multichannel")]
+pub(crate) fn write_wav_sample<W: std::io::Write + std::io::Seek>(
+    writer: &mut hound::WavWriter<W>,
+    sample_format: SampleFormat,
+    sample: i32,
+    index: usize,
+) -> Result<()> {
+    let written = match sample_format {
+        SampleFormat::Int16 => {
+            let sample_i16 = i16::try_from(sample).map_err(|_| {
+                Error::InvalidInput(format!("sample out of 16-bit range at index {index}"))
+            })?;
+            writer.write_sample(sample_i16)
+        }
+        SampleFormat::Int24 | SampleFormat::Int32 => writer.write_sample(sample),
+        SampleFormat::Float32 => writer.write_sample(float32_from_i32(sample, index)?),
+    };
+    written.map_err(|e| Error::InvalidInput(format!("write error: {e}")))
+}
+
+/// 内部 i32 表示还原为 float32 样本（取高 16 位）.
+#[cfg(feature = "multichannel")]
+fn float32_from_i32(sample: i32, index: usize) -> Result<f32> {
+    let clamped = (sample >> 16).clamp(i32::from(i16::MIN), i32::from(i16::MAX));
+    let sample_i16 = i16::try_from(clamped).map_err(|_| {
+        Error::InvalidInput(format!("float32 sample out of range at index {index}"))
+    })?;
+    Ok(f32::from(sample_i16) / f32::from(i16::MAX))
+}
+
+/// 逐样本反交错到池化声道缓冲，不经过整段交错样本的中间 `Vec`.
+#[cfg(feature = "multichannel")]
+fn deinterleave_hound<R: std::io::Read>(
+    reader: hound::WavReader<R>,
+    num_channels: usize,
+    sample_format: SampleFormat,
+) -> Result<Vec<Vec<i32>>> {
+    if num_channels == 0 {
+        return Err(Error::InvalidInput("no channels".into()));
+    }
+    let frames = usize::try_from(reader.duration()).unwrap_or(0);
+    let mut channels: Vec<Vec<i32>> = (0..num_channels)
+        .map(|_| buffer_pool::take_samples(frames))
+        .collect();
+    let mut push = |i: usize, sample: i32| channels[i % num_channels].push(sample);
+    match sample_format {
+        SampleFormat::Float32 => {
+            for (i, s) in reader.into_samples::<f32>().enumerate() {
+                let s = s.map_err(|e| Error::InvalidInput(format!("read error: {e}")))?;
+                push(i, scale_float_to_i32(s));
+            }
+        }
+        _ => {
+            for (i, s) in reader.into_samples::<i32>().enumerate() {
+                let s = s.map_err(|e| Error::InvalidInput(format!("read error: {e}")))?;
+                push(i, s);
+            }
+        }
+    }
+    Ok(channels)
+}
+
 /// Internal helper function.
-fn scale_float_to_i32(sample: f32) -> i32 {
+pub(crate) fn scale_float_to_i32(sample: f32) -> i32 {
     use num_traits::ToPrimitive;
 
     const I32_MIN_F64: f64 = -2_147_483_648.0_f64;
@@ -1192,4 +1303,44 @@ mod tests {
         assert_eq!(ch2.unwrap_or(&[]), &[7, 8, 9]);
         assert_eq!(ch3.unwrap_or(&[]), &[1000, 2000, 3000]);
     }
+
+    #[test]
+    fn test_from_view_channels_loads_selected_only() {
+        let audio = AudioBuffer::new(
+            vec![vec![1, 2, 3], vec![10, 20, 30], vec![100, 200, 300]],
+            48_000,
+            SampleFormat::Int16,
+        );
+        assert!(audio.is_ok());
+        let Ok(audio) = audio else {
+            return;
+        };
+        let bytes = audio.to_wav_bytes();
+        assert!(bytes.is_ok());
+        let Ok(bytes) = bytes else {
+            return;
+        };
+        let layout = WavLayout::parse(&bytes);
+        assert!(layout.is_some());
+        let Some(layout) = layout else {
+            return;
+        };
+        let view = InterleavedView::new(&layout, &bytes);
+        assert!(view.is_some());
+        let Some(view) = view else {
+            return;
+        };
+
+        let picked = AudioBuffer::from_view_channels(&view, &[2, 0]);
+        assert!(picked.is_ok());
+        let Ok(picked) = picked else {
+            return;
+        };
+        assert_eq!(picked.num_channels(), 2);
+        assert_eq!(picked.sample_rate(), 48_000);
+        assert_eq!(picked.channel_samples(0).unwrap_or(&[]), &[100, 200, 300]);
+        assert_eq!(picked.channel_samples(1).unwrap_or(&[]), &[1, 2, 3]);
+        assert!(AudioBuffer::from_view_channels(&view, &[3]).is_err());
+        assert!(AudioBuffer::from_view_channels(&view, &[]).is_err());
+    }
 }
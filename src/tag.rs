@@ -2,7 +2,9 @@
 //!
 //! Tag 结构: 7 字符身份 + 1 校验位 = 8 字符 = 40 bit (5-bit packed).
 
-use crate::charset::{char_to_index, index_to_char, is_valid_char, CHARSET, PRIMES};
+use crate::charset::{
+    char_to_index, index_to_char, is_valid_char, CHARSET, CHAR_INDEX, INVALID_INDEX, PRIMES,
+};
 use crate::error::{Error, Result};
 
 /// 8 字符 Tag，包含 7 字符身份 + 1 校验位.
@@ -67,6 +69,13 @@ impl Tag {
     /// 当长度不是 8、包含非法字符或校验位不匹配时返回错误。.
     ///
     pub fn parse(s: &str) -> Result<Self> {
+        // 查表快速路径；失败时再走下方逐项检查以给出具体错误。
+        if let Some(chars) = <&[u8; 8]>::try_from(s.as_bytes())
+            .ok()
+            .and_then(normalize_raw)
+        {
+            return Ok(Self { chars });
+        }
         let s = s.to_ascii_uppercase();
 
         if s.len() != 8 {
@@ -200,6 +209,44 @@ impl std::str::FromStr for Tag {
     }
 }
 
+/// 批量校验定长 8 字节 Tag（大小写不敏感），返回与 `tags` 一一对应的结果.
+///
+/// 每项只做 8 次查表与一次加权求和，无分配、无逐字符分支，固定长度的内层循环可由
+/// 编译器展开并向量化。.
+#[must_use]
+pub fn verify_batch(tags: &[[u8; 8]]) -> Vec<bool> {
+    tags.iter()
+        .map(|raw| normalize_raw(raw).is_some())
+        .collect()
+}
+
+/// 批量解析定长 8 字节 Tag；非法项为 `None`.
+#[must_use]
+pub fn parse_batch(tags: &[[u8; 8]]) -> Vec<Option<Tag>> {
+    tags.iter()
+        .map(|raw| normalize_raw(raw).map(|chars| Tag { chars }))
+        .collect()
+}
+
+/// 校验 8 字节 Tag 并返回大写形式；任一字符非法或校验位不匹配时返回 `None`.
+#[inline]
+pub(crate) fn normalize_raw(raw: &[u8; 8]) -> Option<[u8; 8]> {
+    let indices = raw.map(|c| CHAR_INDEX[usize::from(c)]);
+    if indices.iter().fold(0, |acc, &index| acc | index) & INVALID_INDEX != 0 {
+        return None;
+    }
+    let total: u32 = indices
+        .iter()
+        .zip(PRIMES)
+        .map(|(&index, prime)| u32::from(index) * prime)
+        .sum();
+    // 字符集是双射：比较索引等价于比较校验字符。
+    if total % 32 != u32::from(indices[7]) {
+        return None;
+    }
+    Some(indices.map(|index| CHARSET[usize::from(index)]))
+}
+
 /// 计算 7 字符的校验位.
 fn calc_checksum(tag7: [u8; 7]) -> u8 {
     let total: u32 = tag7
@@ -287,4 +334,39 @@ mod tests {
         let result = Tag::parse("SAKUZY_A"); // 错误的校验位
         assert!(matches!(result, Err(Error::ChecksumMismatch { .. })));
     }
+
+    /// 生成一批合法 Tag 与按位置篡改的非法 Tag.
+    fn candidates(count: usize) -> Vec<[u8; 8]> {
+        (0..count)
+            .map(|i| {
+                let identity: String = (0..7)
+                    .map(|pos| char::from(CHARSET[(i / 32_usize.pow(pos)) % 32]))
+                    .collect();
+                let mut raw = Tag::new(&identity).map_or([b'0'; 8], |tag| *tag.as_bytes());
+                match i % 5 {
+                    1 => raw[i % 8] = b'O',
+                    2 => raw[7] = CHARSET[(usize::from(raw[7]) + 1) % 32],
+                    3 => raw = raw.map(|c| c.to_ascii_lowercase()),
+                    _ => {}
+                }
+                raw
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_batch_matches_single_parse() {
+        let tags = candidates(4096);
+        let valid = verify_batch(&tags);
+        let parsed = parse_batch(&tags);
+        assert_eq!(valid.len(), tags.len());
+        for ((raw, ok), tag) in tags.iter().zip(&valid).zip(&parsed) {
+            let single = std::str::from_utf8(raw).ok().map(Tag::parse);
+            assert_eq!(*ok, single.as_ref().is_some_and(Result::is_ok));
+            assert_eq!(tag.as_ref(), single.and_then(Result::ok).as_ref());
+        }
+        assert!(valid.iter().any(|ok| *ok));
+        assert!(valid.iter().any(|ok| !ok));
+        assert!(verify_batch(&[*b"SAKUZY\xff_"]).iter().all(|ok| !ok));
+    }
 }
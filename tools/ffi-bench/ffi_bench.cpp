@@ -0,0 +1,773 @@
+// Benchmark and stress harness for the awmkit C API (include/awmkit.h).
+//
+// Measures per-call latency (p50/p99/max) and throughput for each API family,
+// then hammers shared and per-thread audio handles, progress callbacks and the
+// database calls from many threads against a stub audiowmark. Exits non-zero
+// when a call breaks the header contract or when fds/RSS grow across rounds.
+//
+// POSIX only (Linux, macOS). HOME is pointed at a scratch directory so the
+// database calls never touch the user's real ~/.awmkit; the directory is removed
+// again on every exit path.
+
+#include "awmkit.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <ftw.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+#ifndef AWMKIT_BENCH_STUB
+#define AWMKIT_BENCH_STUB ""
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int iterations = 20000;      // tag/message calls per benchmark
+    int audio_iterations = 200;  // embed/detect calls per benchmark
+    int db_iterations = 500;     // database calls per benchmark
+    int threads = 8;
+    int rounds = 5;              // stress rounds; leak checks compare first vs last
+    long max_rss_growth_kb = 65536;
+    std::string stub = AWMKIT_BENCH_STUB;
+};
+
+const uint8_t kKey[32] = {
+    0x41, 0x57, 0x4d, 0x4b, 0x69, 0x74, 0x2d, 0x66, 0x66, 0x69, 0x2d,
+    0x62, 0x65, 0x6e, 0x63, 0x68, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55,
+    0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+};
+
+std::atomic<int> g_failures{0};
+
+void fail(const std::string& what) {
+    if (g_failures.fetch_add(1) < 20) {
+        std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+    }
+}
+
+void expect_rc(int32_t rc, int32_t want, const char* call) {
+    if (rc != want) {
+        fail(std::string(call) + " returned " + std::to_string(rc) + ", expected " +
+             std::to_string(want));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Latency reporting
+// ---------------------------------------------------------------------------
+
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t idx = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+void print_header(const char* family) {
+    std::printf("\n[%s]\n%-34s %9s %11s %11s %11s %14s\n", family, "call", "calls", "p50 us",
+                "p99 us", "max us", "calls/s");
+}
+
+void report(const char* name, std::vector<double> samples_us, double wall_s) {
+    std::sort(samples_us.begin(), samples_us.end());
+    double per_sec = wall_s > 0.0 ? static_cast<double>(samples_us.size()) / wall_s : 0.0;
+    std::printf("%-34s %9zu %11.2f %11.2f %11.2f %14.0f\n", name, samples_us.size(),
+                percentile(samples_us, 0.50), percentile(samples_us, 0.99),
+                samples_us.empty() ? 0.0 : samples_us.back(), per_sec);
+}
+
+// Times `count` sequential calls of `call(i)`.
+void bench(const char* name, int count, const std::function<void(int)>& call) {
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(count));
+    auto start = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        auto t0 = Clock::now();
+        call(i);
+        samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+    }
+    report(name, std::move(samples), std::chrono::duration<double>(Clock::now() - start).count());
+}
+
+// Runs `per_thread` calls of `call(thread, i)` on `threads` threads and reports the merged
+// latencies against the wall time of the whole batch.
+void bench_concurrent(const char* name, int threads, int per_thread,
+                      const std::function<void(int, int)>& call) {
+    std::vector<std::vector<double>> per(static_cast<size_t>(threads));
+    std::vector<std::thread> workers;
+    auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            auto& samples = per[static_cast<size_t>(t)];
+            samples.reserve(static_cast<size_t>(per_thread));
+            for (int i = 0; i < per_thread; ++i) {
+                auto t0 = Clock::now();
+                call(t, i);
+                samples.push_back(
+                    std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    std::vector<double> merged;
+    for (auto& samples : per) {
+        merged.insert(merged.end(), samples.begin(), samples.end());
+    }
+    report(name, std::move(merged), wall);
+}
+
+// ---------------------------------------------------------------------------
+// Process resource probes (leak detection)
+// ---------------------------------------------------------------------------
+
+long resident_kb() {
+#if defined(__APPLE__)
+    mach_task_basic_info info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info),
+                  &count) != KERN_SUCCESS) {
+        return -1;
+    }
+    return static_cast<long>(info.resident_size / 1024);
+#else
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) {
+        return -1;
+    }
+    long pages = 0;
+    long resident = 0;
+    int read = std::fscanf(statm, "%ld %ld", &pages, &resident);
+    std::fclose(statm);
+    return read == 2 ? resident * (sysconf(_SC_PAGESIZE) / 1024) : -1;
+#endif
+}
+
+int open_fds() {
+#if defined(__APPLE__)
+    const char* dir_path = "/dev/fd";
+#else
+    const char* dir_path = "/proc/self/fd";
+#endif
+    DIR* dir = opendir(dir_path);
+    if (dir == nullptr) {
+        return -1;
+    }
+    int count = 0;
+    while (readdir(dir) != nullptr) {
+        ++count;
+    }
+    closedir(dir);
+    return count;
+}
+
+// Reaps and counts audiowmark children the library exited without waiting for.
+int reap_zombies() {
+    int zombies = 0;
+    int status = 0;
+    while (waitpid(-1, &status, WNOHANG) > 0) {
+        ++zombies;
+    }
+    return zombies;
+}
+
+// ---------------------------------------------------------------------------
+// Fixtures
+// ---------------------------------------------------------------------------
+
+bool write_wav(const std::string& path, int channels, int frames, int sample_rate) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    auto u32 = [&](uint32_t v) {
+        uint8_t b[4] = {uint8_t(v), uint8_t(v >> 8), uint8_t(v >> 16), uint8_t(v >> 24)};
+        std::fwrite(b, 1, 4, file);
+    };
+    auto u16 = [&](uint16_t v) {
+        uint8_t b[2] = {uint8_t(v), uint8_t(v >> 8)};
+        std::fwrite(b, 1, 2, file);
+    };
+    uint32_t data_len = static_cast<uint32_t>(frames) * static_cast<uint32_t>(channels) * 2;
+    std::fwrite("RIFF", 1, 4, file);
+    u32(36 + data_len);
+    std::fwrite("WAVEfmt ", 1, 8, file);
+    u32(16);
+    u16(1);
+    u16(static_cast<uint16_t>(channels));
+    u32(static_cast<uint32_t>(sample_rate));
+    u32(static_cast<uint32_t>(sample_rate * channels * 2));
+    u16(static_cast<uint16_t>(channels * 2));
+    u16(16);
+    std::fwrite("data", 1, 4, file);
+    u32(data_len);
+    // Each channel gets its own sawtooth period so routing sees distinct content.
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int ch = 0; ch < channels; ++ch) {
+            int period = 40 + ch * 7;
+            int value = ((frame % period) * 2000 / period) - 1000;
+            u16(static_cast<uint16_t>(static_cast<int16_t>(value)));
+        }
+    }
+    bool ok = std::ferror(file) == 0;
+    return std::fclose(file) == 0 && ok;
+}
+
+std::string hex(const uint8_t* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < len; ++i) {
+        out.push_back(digits[data[i] >> 4]);
+        out.push_back(digits[data[i] & 0x0f]);
+    }
+    return out;
+}
+
+// Two-step string fetch; retries when the payload grows between the calls.
+int32_t fetch_string(const std::function<int32_t(char*, size_t, size_t*)>& call,
+                     std::string& out) {
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        size_t required = 0;
+        int32_t rc = call(nullptr, 0, &required);
+        if (rc != AWM_SUCCESS) {
+            return rc;
+        }
+        std::vector<char> buffer(required);
+        rc = call(buffer.data(), buffer.size(), &required);
+        if (rc == AWM_ERROR_INVALID_MESSAGE_LENGTH) {
+            continue;
+        }
+        if (rc == AWM_SUCCESS) {
+            if (required == 0 || buffer[required - 1] != '\0') {
+                fail("two-step string is not NUL-terminated at out_required_len");
+            }
+            out.assign(buffer.data());
+        }
+        return rc;
+    }
+    return AWM_ERROR_INVALID_MESSAGE_LENGTH;
+}
+
+// Owns the mkdtemp scratch directory and deletes the whole tree (fixtures, embed
+// outputs, the awmkit database under HOME) when main returns, including early exits.
+class ScratchDir {
+public:
+    explicit ScratchDir(std::string path) : path_(std::move(path)) {}
+    ~ScratchDir() {
+        if (nftw(path_.c_str(), remove_entry, 16, FTW_DEPTH | FTW_PHYS) != 0) {
+            std::fprintf(stderr, "warning: failed to remove scratch %s\n", path_.c_str());
+        }
+    }
+    ScratchDir(const ScratchDir&) = delete;
+    ScratchDir& operator=(const ScratchDir&) = delete;
+
+    const std::string& path() const { return path_; }
+
+private:
+    static int remove_entry(const char* path, const struct stat*, int, struct FTW*) {
+        return std::remove(path) == 0 ? 0 : -1;
+    }
+
+    std::string path_;
+};
+
+struct Fixture {
+    std::string dir;
+    std::string stereo;
+    std::string surround;
+    uint8_t message[AWM_MESSAGE_LENGTH] = {};
+    char tag[AWM_TAG_LENGTH + 1] = {};
+};
+
+// ---------------------------------------------------------------------------
+// Benchmarks
+// ---------------------------------------------------------------------------
+
+void bench_tags(const Options& opt, const Fixture& fx) {
+    print_header("tag");
+    const char* identities[] = {"SAKUZY", "ALICE", "BOB42", "Z"};
+    bench("awm_tag_new", opt.iterations, [&](int i) {
+        char out[AWM_TAG_LENGTH + 1];
+        expect_rc(awm_tag_new(identities[i % 4], out), AWM_SUCCESS, "awm_tag_new");
+    });
+    bench("awm_tag_verify", opt.iterations, [&](int) {
+        if (!awm_tag_verify(fx.tag)) {
+            fail("awm_tag_verify rejected a freshly created tag");
+        }
+    });
+    bench("awm_tag_identity", opt.iterations, [&](int) {
+        char out[AWM_TAG_LENGTH];
+        expect_rc(awm_tag_identity(fx.tag, out), AWM_SUCCESS, "awm_tag_identity");
+    });
+
+    const size_t batch = 1024;
+    std::string packed;
+    for (size_t i = 0; i < batch; ++i) {
+        packed.append(fx.tag, AWM_TAG_LENGTH);
+    }
+    std::unique_ptr<bool[]> owned(new bool[batch]);
+    bool* valid = owned.get();
+    bench("awm_tag_verify_batch (x1024)", std::max(1, opt.iterations / 100), [&](int) {
+        expect_rc(awm_tag_verify_batch(packed.data(), batch, valid), AWM_SUCCESS,
+                  "awm_tag_verify_batch");
+        if (!std::all_of(valid, valid + batch, [](bool v) { return v; })) {
+            fail("awm_tag_verify_batch rejected a valid tag");
+        }
+    });
+}
+
+void bench_messages(const Options& opt, const Fixture& fx) {
+    print_header("message");
+    bench("awm_message_encode_with_slot", opt.iterations, [&](int i) {
+        uint8_t out[AWM_MESSAGE_LENGTH];
+        expect_rc(awm_message_encode_with_slot(2, fx.tag, kKey, sizeof kKey,
+                                               static_cast<uint8_t>(i % 32), out),
+                  AWM_SUCCESS, "awm_message_encode_with_slot");
+    });
+    bench("awm_message_decode", opt.iterations, [&](int) {
+        AWMResult result{};
+        expect_rc(awm_message_decode(fx.message, kKey, sizeof kKey, &result), AWM_SUCCESS,
+                  "awm_message_decode");
+    });
+    bench("awm_message_verify", opt.iterations, [&](int) {
+        if (!awm_message_verify(fx.message, kKey, sizeof kKey)) {
+            fail("awm_message_verify rejected a valid message");
+        }
+    });
+
+    const size_t batch = 256;
+    std::vector<const char*> tags(batch, fx.tag);
+    std::vector<uint8_t> encoded(batch * AWM_MESSAGE_LENGTH);
+    bench("awm_message_encode_batch (x256)", std::max(1, opt.iterations / 100), [&](int) {
+        expect_rc(awm_message_encode_batch(2, tags.data(), batch, kKey, sizeof kKey, 0,
+                                           encoded.data()),
+                  AWM_SUCCESS, "awm_message_encode_batch");
+    });
+    std::unique_ptr<bool[]> owned(new bool[batch]);
+    bool* valid = owned.get();
+    bench("awm_message_verify_batch (x256)", std::max(1, opt.iterations / 100), [&](int) {
+        expect_rc(awm_message_verify_batch(encoded.data(), batch, kKey, sizeof kKey, valid),
+                  AWM_SUCCESS, "awm_message_verify_batch");
+        if (!std::all_of(valid, valid + batch, [](bool v) { return v; })) {
+            fail("awm_message_verify_batch rejected a valid message");
+        }
+    });
+
+    bench_concurrent("encode+decode (threads)", opt.threads, opt.iterations / opt.threads,
+                     [&](int t, int i) {
+                         uint8_t out[AWM_MESSAGE_LENGTH];
+                         uint8_t slot = static_cast<uint8_t>((t + i) % 32);
+                         expect_rc(awm_message_encode_with_slot(2, fx.tag, kKey, sizeof kKey,
+                                                                slot, out),
+                                   AWM_SUCCESS, "awm_message_encode_with_slot");
+                         AWMResult result{};
+                         expect_rc(awm_message_decode(out, kKey, sizeof kKey, &result),
+                                   AWM_SUCCESS, "awm_message_decode");
+                         if (result.key_slot != slot ||
+                             std::strncmp(result.tag, fx.tag, AWM_TAG_LENGTH) != 0) {
+                             fail("concurrent encode/decode round trip mismatch");
+                         }
+                     });
+}
+
+void check_detect(const AWMDetectResult& result, const Fixture& fx) {
+    if (!result.found || std::memcmp(result.raw_message, fx.message, AWM_MESSAGE_LENGTH) != 0) {
+        fail("awm_audio_detect did not return the embedded message");
+    }
+}
+
+void bench_audio(const Options& opt, const Fixture& fx, AWMAudioHandle* handle) {
+    print_header("audio (stub audiowmark)");
+    std::string out = fx.dir + "/bench_out.wav";
+    std::string out_mc = fx.dir + "/bench_out_mc.wav";
+    bench("awm_audio_embed", opt.audio_iterations, [&](int) {
+        expect_rc(awm_audio_embed(handle, fx.stereo.c_str(), out.c_str(), fx.message),
+                  AWM_SUCCESS, "awm_audio_embed");
+    });
+    bench("awm_audio_detect", opt.audio_iterations, [&](int) {
+        AWMDetectResult result{};
+        expect_rc(awm_audio_detect(handle, out.c_str(), &result), AWM_SUCCESS,
+                  "awm_audio_detect");
+        check_detect(result, fx);
+    });
+    bench("awm_audio_embed_multichannel 5.1", opt.audio_iterations / 2, [&](int) {
+        expect_rc(awm_audio_embed_multichannel(handle, fx.surround.c_str(), out_mc.c_str(),
+                                               fx.message, AWM_CHANNEL_LAYOUT_SURROUND_51),
+                  AWM_SUCCESS, "awm_audio_embed_multichannel");
+    });
+    bench("awm_audio_detect_multichannel 5.1", opt.audio_iterations / 2, [&](int) {
+        AWMMultichannelDetectResult result{};
+        expect_rc(awm_audio_detect_multichannel(handle, out_mc.c_str(),
+                                                AWM_CHANNEL_LAYOUT_SURROUND_51, &result),
+                  AWM_SUCCESS, "awm_audio_detect_multichannel");
+        if (!result.has_best ||
+            std::memcmp(result.best_raw_message, fx.message, AWM_MESSAGE_LENGTH) != 0) {
+            fail("awm_audio_detect_multichannel did not return the embedded message");
+        }
+    });
+    bench("awm_audio_progress_get", opt.iterations, [&](int) {
+        AWMProgressSnapshot snapshot{};
+        expect_rc(awm_audio_progress_get(handle, &snapshot), AWM_SUCCESS,
+                  "awm_audio_progress_get");
+    });
+}
+
+// Returns false when the library was built without the `app` feature.
+bool bench_db(const Options& opt, const Fixture& fx) {
+    uint64_t tags = 0;
+    uint64_t evidence = 0;
+    if (awm_db_summary(&tags, &evidence) != AWM_SUCCESS) {
+        std::printf("\n[db] skipped: library built without the `app` feature\n");
+        return false;
+    }
+    print_header("db (scratch HOME)");
+    bench("awm_db_tag_save_if_absent", opt.db_iterations, [&](int i) {
+        std::string user = "bench_user_" + std::to_string(i);
+        bool inserted = false;
+        expect_rc(awm_db_tag_save_if_absent(user.c_str(), fx.tag, &inserted), AWM_SUCCESS,
+                  "awm_db_tag_save_if_absent");
+    });
+    bench("awm_db_tag_lookup", opt.db_iterations, [&](int i) {
+        std::string user = "bench_user_" + std::to_string(i);
+        std::string tag;
+        expect_rc(fetch_string(
+                      [&](char* out, size_t len, size_t* required) {
+                          return awm_db_tag_lookup(user.c_str(), out, len, required);
+                      },
+                      tag),
+                  AWM_SUCCESS, "awm_db_tag_lookup");
+        if (tag != fx.tag) {
+            fail("awm_db_tag_lookup returned " + tag + " for " + user);
+        }
+    });
+    bench("awm_db_tag_list_json (100)", opt.db_iterations, [&](int) {
+        std::string json;
+        expect_rc(fetch_string(
+                      [](char* out, size_t len, size_t* required) {
+                          return awm_db_tag_list_json(100, out, len, required);
+                      },
+                      json),
+                  AWM_SUCCESS, "awm_db_tag_list_json");
+        if (json.empty() || json.front() != '[') {
+            fail("awm_db_tag_list_json did not return a JSON array");
+        }
+    });
+    bench("awm_db_evidence_list_json (100)", opt.db_iterations, [&](int) {
+        std::string json;
+        expect_rc(fetch_string(
+                      [](char* out, size_t len, size_t* required) {
+                          return awm_db_evidence_list_json(100, out, len, required);
+                      },
+                      json),
+                  AWM_SUCCESS, "awm_db_evidence_list_json");
+    });
+    bench("awm_db_summary", opt.db_iterations, [&](int) {
+        uint64_t t = 0;
+        uint64_t e = 0;
+        expect_rc(awm_db_summary(&t, &e), AWM_SUCCESS, "awm_db_summary");
+    });
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Stress
+// ---------------------------------------------------------------------------
+
+struct CallbackProbe {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> bad{0};
+};
+
+void progress_probe(const AWMProgressSnapshot* snapshot, void* user_data) {
+    auto* probe = static_cast<CallbackProbe*>(user_data);
+    probe->calls.fetch_add(1, std::memory_order_relaxed);
+    bool labelled = std::memchr(snapshot->phase_label, '\0', sizeof snapshot->phase_label) !=
+                    nullptr;
+    bool running = snapshot->state == AWM_PROGRESS_STATE_RUNNING;
+    if (!labelled || (running && snapshot->op_id == 0) ||
+        (snapshot->determinate && snapshot->total_units > 0 &&
+         snapshot->completed_units > snapshot->total_units)) {
+        probe->bad.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// One stress round: a shared handle under concurrent embed/detect with a callback and a
+// progress poller, per-thread handle churn, a cancel storm, and concurrent DB writers.
+void stress_round(const Options& opt, const Fixture& fx, int round, bool with_db) {
+    AWMAudioHandle* shared = awm_audio_new_with_binary(opt.stub.c_str());
+    if (shared == nullptr) {
+        fail("awm_audio_new_with_binary returned NULL");
+        return;
+    }
+    CallbackProbe probe;
+    expect_rc(awm_audio_progress_set_callback(shared, progress_probe, &probe), AWM_SUCCESS,
+              "awm_audio_progress_set_callback");
+
+    std::atomic<bool> polling{true};
+    std::thread poller([&] {
+        std::vector<uint64_t> ids;
+        while (polling.load()) {
+            size_t required = 0;
+            expect_rc(awm_audio_progress_list_ops(shared, nullptr, 0, &required), AWM_SUCCESS,
+                      "awm_audio_progress_list_ops");
+            ids.assign(required, 0);
+            if (!ids.empty()) {
+                awm_audio_progress_list_ops(shared, ids.data(), ids.size(), &required);
+                AWMProgressSnapshot snapshot{};
+                expect_rc(awm_audio_progress_get_op(shared, ids.front(), &snapshot), AWM_SUCCESS,
+                          "awm_audio_progress_get_op");
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    std::printf("\n[stress round %d]\n%-34s %9s %11s %11s %11s %14s\n", round + 1, "scenario",
+                "calls", "p50 us", "p99 us", "max us", "calls/s");
+    int per_thread = std::max(1, opt.audio_iterations / opt.threads);
+    bench_concurrent("shared handle embed+detect", opt.threads, per_thread, [&](int t, int i) {
+        std::string out = fx.dir + "/stress_" + std::to_string(t) + "_" + std::to_string(i % 2) +
+                          ".wav";
+        expect_rc(awm_audio_embed(shared, fx.stereo.c_str(), out.c_str(), fx.message),
+                  AWM_SUCCESS, "awm_audio_embed (shared)");
+        AWMDetectResult result{};
+        expect_rc(awm_audio_detect(shared, out.c_str(), &result), AWM_SUCCESS,
+                  "awm_audio_detect (shared)");
+        check_detect(result, fx);
+    });
+    polling.store(false);
+    poller.join();
+    if (probe.calls.load() == 0) {
+        fail("progress callback never fired");
+    }
+    if (probe.bad.load() != 0) {
+        fail(std::to_string(probe.bad.load()) + " malformed progress snapshots");
+    }
+
+    bench_concurrent("per-thread handle new/embed/free", opt.threads, per_thread,
+                     [&](int t, int) {
+                         AWMAudioHandle* own = awm_audio_new_with_binary(opt.stub.c_str());
+                         if (own == nullptr) {
+                             fail("awm_audio_new_with_binary returned NULL");
+                             return;
+                         }
+                         awm_audio_set_strength(own, static_cast<uint8_t>(1 + t % 30));
+                         std::string out = fx.dir + "/own_" + std::to_string(t) + ".wav";
+                         expect_rc(awm_audio_embed(own, fx.stereo.c_str(), out.c_str(),
+                                                   fx.message),
+                                   AWM_SUCCESS, "awm_audio_embed (own handle)");
+                         awm_audio_free(own);
+                     });
+
+    // Cancel storm: every in-flight call must end in success or AWM_ERROR_CANCELLED, and
+    // the handle must work again after awm_audio_cancel_reset.
+    std::vector<std::thread> workers;
+    std::atomic<int> unexpected{0};
+    for (int t = 0; t < opt.threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::string out = fx.dir + "/cancel_" + std::to_string(t) + ".wav";
+            int32_t rc = awm_audio_embed(shared, fx.surround.c_str(), out.c_str(), fx.message);
+            if (rc != AWM_SUCCESS && rc != AWM_ERROR_CANCELLED) {
+                unexpected.fetch_add(1);
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    awm_audio_cancel(shared);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (unexpected.load() != 0) {
+        fail(std::to_string(unexpected.load()) + " cancelled calls returned an unexpected code");
+    }
+    awm_audio_cancel_reset(shared);
+    std::string after = fx.dir + "/after_cancel.wav";
+    expect_rc(awm_audio_embed(shared, fx.stereo.c_str(), after.c_str(), fx.message), AWM_SUCCESS,
+              "awm_audio_embed after cancel_reset");
+    awm_audio_free(shared);
+
+    if (with_db) {
+        std::atomic<int> inserted_total{0};
+        int per_writer = std::max(1, opt.db_iterations / opt.threads);
+        bench_concurrent("db save_if_absent+list_json", opt.threads, per_writer,
+                         [&](int t, int i) {
+                             std::string user = "stress_r" + std::to_string(round) + "_t" +
+                                                std::to_string(t) + "_" + std::to_string(i);
+                             bool inserted = false;
+                             expect_rc(awm_db_tag_save_if_absent(user.c_str(), fx.tag,
+                                                                 &inserted),
+                                       AWM_SUCCESS, "awm_db_tag_save_if_absent (threads)");
+                             if (inserted) {
+                                 inserted_total.fetch_add(1);
+                             }
+                             std::string json;
+                             expect_rc(fetch_string(
+                                           [](char* out, size_t len, size_t* required) {
+                                               return awm_db_tag_list_json(20, out, len,
+                                                                           required);
+                                           },
+                                           json),
+                                       AWM_SUCCESS, "awm_db_tag_list_json (threads)");
+                         });
+        if (inserted_total.load() != opt.threads * per_writer) {
+            fail("concurrent awm_db_tag_save_if_absent lost inserts");
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Driver
+// ---------------------------------------------------------------------------
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (arg == "--smoke") {
+            opt.iterations = 500;
+            opt.audio_iterations = 16;
+            opt.db_iterations = 40;
+            opt.threads = 4;
+            opt.rounds = 2;
+            continue;
+        }
+        if ((v = value()) == nullptr) {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        if (arg == "--iterations") {
+            opt.iterations = std::max(1, std::atoi(v));
+        } else if (arg == "--audio-iterations") {
+            opt.audio_iterations = std::max(2, std::atoi(v));
+        } else if (arg == "--db-iterations") {
+            opt.db_iterations = std::max(1, std::atoi(v));
+        } else if (arg == "--threads") {
+            opt.threads = std::max(1, std::atoi(v));
+        } else if (arg == "--rounds") {
+            opt.rounds = std::max(1, std::atoi(v));
+        } else if (arg == "--max-rss-growth-kb") {
+            opt.max_rss_growth_kb = std::atol(v);
+        } else if (arg == "--stub") {
+            opt.stub = v;
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        std::fprintf(stderr,
+                     "usage: %s [--smoke] [--iterations N] [--audio-iterations N] "
+                     "[--db-iterations N] [--threads N] [--rounds N] "
+                     "[--max-rss-growth-kb N] [--stub PATH]\n",
+                     argv[0]);
+        return 2;
+    }
+    if (opt.stub.empty() || access(opt.stub.c_str(), X_OK) != 0) {
+        std::fprintf(stderr, "stub audiowmark not executable: '%s'\n", opt.stub.c_str());
+        return 2;
+    }
+
+    char dir_template[] = "/tmp/awmkit-ffi-bench-XXXXXX";
+    if (mkdtemp(dir_template) == nullptr) {
+        std::perror("mkdtemp");
+        return 2;
+    }
+    ScratchDir scratch(dir_template);
+    Fixture fx;
+    fx.dir = scratch.path();
+    setenv("HOME", fx.dir.c_str(), 1);
+    fx.stereo = fx.dir + "/stereo.wav";
+    fx.surround = fx.dir + "/surround51.wav";
+    if (!write_wav(fx.stereo, 2, 48000, 48000) || !write_wav(fx.surround, 6, 48000, 48000)) {
+        std::fprintf(stderr, "failed to write fixtures under %s\n", fx.dir.c_str());
+        return 2;
+    }
+    expect_rc(awm_tag_new("BENCH", fx.tag), AWM_SUCCESS, "awm_tag_new");
+    expect_rc(awm_message_encode(awm_current_version(), fx.tag, kKey, sizeof kKey, fx.message),
+              AWM_SUCCESS, "awm_message_encode");
+    // Children inherit the environment: the stub reports the embedded message on `get`.
+    setenv("AWMKIT_STUB_PATTERN", hex(fx.message, AWM_MESSAGE_LENGTH).c_str(), 1);
+
+    std::printf("awmkit C API bench: threads=%d iterations=%d audio=%d db=%d rounds=%d\n",
+                opt.threads, opt.iterations, opt.audio_iterations, opt.db_iterations,
+                opt.rounds);
+    std::printf("scratch: %s\nstub: %s\n", fx.dir.c_str(), opt.stub.c_str());
+
+    bench_tags(opt, fx);
+    bench_messages(opt, fx);
+
+    AWMAudioHandle* handle = awm_audio_new_with_binary(opt.stub.c_str());
+    if (handle == nullptr || !awm_audio_is_available(handle)) {
+        std::fprintf(stderr, "stub audiowmark rejected by awm_audio_new_with_binary\n");
+        return 1;
+    }
+    bench_audio(opt, fx, handle);
+    awm_audio_free(handle);
+    bool with_db = bench_db(opt, fx);
+
+    // Round 0 warms caches, pools and lazy statics; later rounds must not keep growing.
+    long rss_base = 0;
+    int fds_base = 0;
+    for (int round = 0; round < opt.rounds; ++round) {
+        stress_round(opt, fx, round, with_db);
+        if (round == 0) {
+            rss_base = resident_kb();
+            fds_base = open_fds();
+        }
+    }
+    long rss_end = resident_kb();
+    int fds_end = open_fds();
+
+    int zombies = reap_zombies();
+    std::printf("\n[leaks]\nrss_kb: %ld -> %ld (growth %ld, limit %ld)\nopen_fds: %d -> %d\n"
+                "unreaped children: %d\n",
+                rss_base, rss_end, rss_end - rss_base, opt.max_rss_growth_kb, fds_base, fds_end,
+                zombies);
+    if (zombies != 0) {
+        fail("audiowmark children were left unreaped");
+    }
+    if (opt.rounds > 1) {
+        if (fds_end > fds_base) {
+            fail("file descriptors leaked across stress rounds");
+        }
+        if (rss_base > 0 && rss_end - rss_base > opt.max_rss_growth_kb) {
+            fail("resident memory kept growing across stress rounds");
+        }
+    }
+
+    int failures = g_failures.load();
+    std::printf("\nresult: %s (%d failure%s)\n", failures == 0 ? "ok" : "FAILED", failures,
+                failures == 1 ? "" : "s");
+    return failures == 0 ? 0 : 1;
+}
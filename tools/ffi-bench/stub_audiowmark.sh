@@ -0,0 +1,67 @@
+#!/bin/sh
+# Stand-in for audiowmark used by the C API benchmark harness.
+#
+# - `--version` prints a version line.
+# - `add [opts] IN OUT HEX` copies IN to OUT unchanged (`-` means stdin/stdout).
+# - `get [opts] IN` drains IN and reports AWMKIT_STUB_PATTERN (32 hex chars) as a
+#   clean hit, so detect results can be checked against the embedded message.
+#
+# AWMKIT_STUB_DELAY_MS adds a fixed per-call delay to model real embed/detect cost.
+
+set -eu
+
+if [ "${AWMKIT_STUB_DELAY_MS:-0}" -gt 0 ]; then
+  sleep "$(awk "BEGIN { print ${AWMKIT_STUB_DELAY_MS} / 1000 }")"
+fi
+
+cmd="${1:-}"
+[ $# -gt 0 ] && shift
+
+# Drop option flags (and their values) so only positional arguments remain.
+skip_opts() {
+  while [ $# -gt 0 ]; do
+    case "$1" in
+      --strength|--key|--input-format|--output-format|--format) shift 2 ;;
+      --*) shift ;;
+      *) break ;;
+    esac
+  done
+  printf '%s\n' "$@"
+}
+
+case "$cmd" in
+  --version)
+    echo "audiowmark 0.6.5 (awmkit ffi-bench stub)"
+    ;;
+  add)
+    set -- $(skip_opts "$@")
+    input="${1:-}"
+    output="${2:-}"
+    if [ -z "$input" ] || [ -z "$output" ] || [ -z "${3:-}" ]; then
+      echo "usage: add [opts] IN OUT HEX" >&2
+      exit 2
+    fi
+    if [ "$output" = "-" ]; then
+      if [ "$input" = "-" ]; then cat; else cat "$input"; fi
+    elif [ "$input" = "-" ]; then
+      cat >"$output"
+    else
+      cp "$input" "$output"
+    fi
+    ;;
+  get)
+    set -- $(skip_opts "$@")
+    input="${1:-}"
+    if [ "$input" = "-" ]; then
+      cat >/dev/null
+    elif [ ! -r "$input" ]; then
+      echo "cannot open $input" >&2
+      exit 1
+    fi
+    echo "pattern  all ${AWMKIT_STUB_PATTERN:-00000000000000000000000000000000} 0"
+    ;;
+  *)
+    echo "unsupported command: $cmd" >&2
+    exit 2
+    ;;
+esac
@@ -434,9 +434,28 @@ internal static class AwmNative
         IntPtr handle,
         IntPtr result);
 
+    [DllImport(Lib, EntryPoint = "awm_audio_progress_get_op", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+    internal static extern int awm_audio_progress_get_op(
+        IntPtr handle,
+        ulong opId,
+        IntPtr result);
+
+    [DllImport(Lib, EntryPoint = "awm_audio_progress_list_ops", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+    internal static extern int awm_audio_progress_list_ops(
+        IntPtr handle,
+        [Out] ulong[]? outIds,
+        nuint outLen,
+        out nuint outRequiredLen);
+
     [DllImport(Lib, EntryPoint = "awm_audio_progress_clear", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
     internal static extern void awm_audio_progress_clear(IntPtr handle);
 
+    [DllImport(Lib, EntryPoint = "awm_audio_cancel", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+    internal static extern void awm_audio_cancel(IntPtr handle);
+
+    [DllImport(Lib, EntryPoint = "awm_audio_cancel_reset", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+    internal static extern void awm_audio_cancel_reset(IntPtr handle);
+
     [DllImport(Lib, EntryPoint = "awm_audio_embed", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
     internal static extern int awm_audio_embed(
         IntPtr handle,
@@ -500,6 +519,27 @@ internal static class AwmNative
         [MarshalAs(UnmanagedType.U1)] bool isForcedEmbed,
         IntPtr result);
 
+    [DllImport(Lib, EntryPoint = "awm_evidence_queue_start", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+    internal static extern int awm_evidence_queue_start();
+
+    [DllImport(Lib, EntryPoint = "awm_evidence_enqueue_embed_file", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+    internal static extern int awm_evidence_enqueue_embed_file(
+        [MarshalAs(UnmanagedType.LPUTF8Str)] string inputPath,
+        [MarshalAs(UnmanagedType.LPUTF8Str)] string outputPath,
+        IntPtr rawMessage,
+        IntPtr key,
+        nuint keyLen);
+
+    [DllImport(Lib, EntryPoint = "awm_evidence_queue_stats", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+    internal static extern int awm_evidence_queue_stats(IntPtr result);
+
+    [DllImport(Lib, EntryPoint = "awm_evidence_queue_wait_idle", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool awm_evidence_queue_wait_idle(uint timeoutMs);
+
+    [DllImport(Lib, EntryPoint = "awm_evidence_queue_stop", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
+    internal static extern void awm_evidence_queue_stop([MarshalAs(UnmanagedType.U1)] bool drain);
+
     [DllImport(Lib, EntryPoint = "awm_audio_is_available", CallingConvention = CallingConvention.Cdecl, ExactSpelling = true)]
     [return: MarshalAs(UnmanagedType.U1)]
     internal static extern bool awm_audio_is_available(IntPtr handle);
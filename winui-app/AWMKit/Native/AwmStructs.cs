@@ -23,6 +23,7 @@ public enum AwmError
     AdmUnsupported = -12,
     AdmPreserveFailed = -13,
     AdmPcmFormatUnsupported = -14,
+    Cancelled = -15,
 }
 
 /// <summary>Multichannel layout enum matching AWMChannelLayout in C header.</summary>